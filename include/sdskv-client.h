@@ -15,6 +15,37 @@ typedef struct sdskv_client* sdskv_client_t;
 typedef struct sdskv_provider_handle* sdskv_provider_handle_t;
 #define SDSKV_PROVIDER_HANDLE_NULL ((sdskv_provider_handle_t)NULL)
 
+typedef uint64_t sdskv_watch_id_t;
+
+/* change of a watched key; value is NULL unless the watch was created
+ * with values and the key was put */
+typedef struct {
+    sdskv_watch_event_type_t type;
+    const void*              key;
+    hg_size_t                ksize;
+    const void*              value;
+    hg_size_t                vsize;
+} sdskv_watch_event_t;
+
+/* change recorded in the change log of a database; value is NULL unless
+ * the key was put */
+typedef struct {
+    uint64_t                 seq;
+    sdskv_watch_event_type_t type;
+    const void*              key;
+    hg_size_t                ksize;
+    const void*              value;
+    hg_size_t                vsize;
+} sdskv_change_t;
+
+/* called with a batch of changes of a watch; the events and the data they
+ * point to are only valid during the call. flags may contain
+ * SDSKV_WATCH_OVERFLOW. */
+typedef void (*sdskv_watch_fn)(void*                      uargs,
+                               size_t                     num_events,
+                               const sdskv_watch_event_t* events,
+                               int                        flags);
+
 /**
  * @brief Global variable recording the last error encountered by REMI.
  */
@@ -77,6 +108,20 @@ int sdskv_provider_handle_get_info(sdskv_provider_handle_t ph,
                                    hg_addr_t*              addr,
                                    uint16_t*               provider_id);
 
+/**
+ * @brief Sets the request id sent with the data operations (put, get,
+ * erase, list, etc.) issued through this provider handle, until it is
+ * changed. Providers with tracing enabled tag the traces of these requests
+ * with this id. The default request id is 0.
+ *
+ * @param[in] handle provider handle.
+ * @param[in] request_id request id.
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_handle_set_request_id(sdskv_provider_handle_t handle,
+                                         uint64_t                request_id);
+
 /**
  * @brief Increments the reference counter of a provider handle.
  *
@@ -159,6 +204,32 @@ int sdskv_put(sdskv_provider_handle_t provider,
               const void*             value,
               hg_size_t               vsize);
 
+/**
+ * @brief Puts a key/value pair that expires after a given time into the
+ * database, which must have been opened with a "ttl" option. Once expired,
+ * the pair is no longer returned by gets and listings. The key and value
+ * are sent within the RPC, so they must fit in an RPC message.
+ *
+ * @param provider provider handle managing the database
+ * @param db_id targeted database id
+ * @param key key to store
+ * @param ksize size (in bytes) of the key
+ * @param value value to store
+ * @param vsize size (in bytes) of the value
+ * @param ttl_ms time to live in milliseconds, 0 for a pair that never
+ * expires
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h,
+ * SDSKV_OP_NOT_IMPL if the database has no "ttl" option
+ */
+int sdskv_put_ttl(sdskv_provider_handle_t provider,
+                  sdskv_database_id_t     db_id,
+                  const void*             key,
+                  hg_size_t               ksize,
+                  const void*             value,
+                  hg_size_t               vsize,
+                  uint64_t                ttl_ms);
+
 /**
  * @brief Puts multiple key/value pairs into the database.
  * This method will send all the key/value pairs in batch,
@@ -207,6 +278,32 @@ int sdskv_put_packed(sdskv_provider_handle_t provider,
                      const void*             packed_values,
                      const hg_size_t*        vsizes);
 
+/**
+ * @brief Same as sdskv_put_packed, but compresses the packed key sizes,
+ * value sizes, keys, and values with the given codec before sending them.
+ * Payloads that are small or that do not shrink are sent as they are,
+ * and so are they if the codec is not available on either side.
+ *
+ * @param provider provider handle managing the database
+ * @param db_id targeted database id
+ * @param num number of key/value pairs to put
+ * @param packed_keys buffer containing the keys
+ * @param ksizes array of key sizes
+ * @param packed_values buffer containing the values
+ * @param vsizes array of value sizes
+ * @param compression codec to compress the payload with
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_put_packed_compressed(sdskv_provider_handle_t provider,
+                                sdskv_database_id_t     db_id,
+                                size_t                  num,
+                                const void*             packed_keys,
+                                const hg_size_t*        ksizes,
+                                const void*             packed_values,
+                                const hg_size_t*        vsizes,
+                                sdskv_compression_t     compression);
+
 /**
  * @brief Puts multiple key/value pairs into the database.
  * This method will send all the key/value pairs in batch,
@@ -326,6 +423,36 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
                      void*                   packed_values,
                      hg_size_t*              vsizes);
 
+/**
+ * @brief Same as sdskv_get_packed, but asks the provider to compress the
+ * value sizes and values it sends back with the given codec. The provider
+ * sends them as they are if they are small, if they do not shrink, or if
+ * it does not have the codec. Note that the value buffer may be used as
+ * scratch space beyond the values actually retrieved.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[inout] num number of values to retrieve, number of values actually
+ * retrieved
+ * @param[in] keys buffer of packed keys to retrieve
+ * @param[in] ksizes size of the keys
+ * @param[in] vbufsize size of the buffer allocated for the values
+ * @param[out] values buffer allocated to receive packed values
+ * @param[out] vsizes sizes of the values
+ * @param[in] compression codec to compress the values with
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_packed_compressed(sdskv_provider_handle_t provider,
+                                sdskv_database_id_t     db_id,
+                                size_t*                 num,
+                                const void*             packed_keys,
+                                const hg_size_t*        ksizes,
+                                hg_size_t               vbufsize,
+                                void*                   packed_values,
+                                hg_size_t*              vsizes,
+                                sdskv_compression_t     compression);
+
 /**
  * @brief Gets the length of a value associated with a given key.
  *
@@ -455,6 +582,225 @@ int sdskv_erase_multi(sdskv_provider_handle_t handle,
                       const void* const*      keys,
                       const hg_size_t*        ksizes);
 
+/**
+ * @brief Erases all the key/value pairs whose key is in the range
+ * [lower, upper) of the database. A NULL bound stands for the start
+ * (resp. end) of the database. The keys are erased by the provider,
+ * without being transferred to the client.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] lower lower bound of the range (can be NULL)
+ * @param[in] lower_size size of the lower bound
+ * @param[in] upper upper bound of the range, excluded (can be NULL)
+ * @param[in] upper_size size of the upper bound
+ * @param[out] num_erased number of key/value pairs erased (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_erase_range(sdskv_provider_handle_t handle,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lower_size,
+                      const void*             upper,
+                      hg_size_t               upper_size,
+                      hg_size_t*              num_erased);
+
+/**
+ * @brief Erases all the key/value pairs whose key starts with the given
+ * prefix. The keys are erased by the provider, without being transferred
+ * to the client.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] prefix prefix
+ * @param[in] prefix_size size of the prefix
+ * @param[out] num_erased number of key/value pairs erased (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_erase_prefixed(sdskv_provider_handle_t handle,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               prefix_size,
+                         hg_size_t*              num_erased);
+
+/**
+ * @brief Counts the key/value pairs whose key is in the range [lower, upper)
+ * of the database, and the total size of their keys and values. A NULL
+ * bound stands for the start (resp. end) of the database. The count is
+ * computed by the provider, without transferring the keys. The sizes are
+ * only computed if key_bytes or value_bytes is not NULL, which may require
+ * the provider to read the values; counting the keys of a whole map or LMDB
+ * database without their sizes takes constant time.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] lower lower bound of the range (can be NULL)
+ * @param[in] lower_size size of the lower bound
+ * @param[in] upper upper bound of the range, excluded (can be NULL)
+ * @param[in] upper_size size of the upper bound
+ * @param[out] num_keys number of key/value pairs (can be NULL)
+ * @param[out] key_bytes total size of the keys (can be NULL)
+ * @param[out] value_bytes total size of the values (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_count_range(sdskv_provider_handle_t handle,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lower_size,
+                      const void*             upper,
+                      hg_size_t               upper_size,
+                      hg_size_t*              num_keys,
+                      hg_size_t*              key_bytes,
+                      hg_size_t*              value_bytes);
+
+/**
+ * @brief Counts the key/value pairs whose key starts with the given prefix,
+ * and the total size of their keys and values (see sdskv_count_range).
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] prefix prefix
+ * @param[in] prefix_size size of the prefix
+ * @param[out] num_keys number of key/value pairs (can be NULL)
+ * @param[out] key_bytes total size of the keys (can be NULL)
+ * @param[out] value_bytes total size of the values (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_count_prefixed(sdskv_provider_handle_t handle,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               prefix_size,
+                         hg_size_t*              num_keys,
+                         hg_size_t*              key_bytes,
+                         hg_size_t*              value_bytes);
+
+/**
+ * @brief Atomically replaces the value associated with a key by the given
+ * value if the current value is equal to the expected one. If expected is
+ * NULL, the key/value pair is only put if the key does not exist.
+ * Values are sent along with the RPC and should be small.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] expected expected current value (can be NULL)
+ * @param[in] expected_size size of the expected value
+ * @param[in] value new value
+ * @param[in] vsize size of the new value
+ * @param[out] swapped set to 1 if the value was replaced, 0 otherwise
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_compare_and_swap(sdskv_provider_handle_t handle,
+                           sdskv_database_id_t     db_id,
+                           const void*             key,
+                           hg_size_t               ksize,
+                           const void*             expected,
+                           hg_size_t               expected_size,
+                           const void*             value,
+                           hg_size_t               vsize,
+                           int*                    swapped);
+
+/**
+ * @brief Atomically adds delta to the integer value associated with a key
+ * and returns the previous value. The value must be a 4 or 8-byte integer
+ * in the byte order of the provider; a key that does not exist is created
+ * with an 8-byte value of delta (its previous value being 0).
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] delta value to add
+ * @param[out] previous value before the addition (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ * (SDSKV_ERR_SIZE if the value is not a 4 or 8-byte integer)
+ */
+int sdskv_fetch_add(sdskv_provider_handle_t handle,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    int64_t                 delta,
+                    int64_t*                previous);
+
+/**
+ * @brief Atomically appends data to the value associated with a key, which
+ * is created if it does not exist. The data is sent along with the RPC and
+ * should be small.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] data data to append
+ * @param[in] size size of the data
+ * @param[out] new_size size of the value after the append (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_append(sdskv_provider_handle_t handle,
+                 sdskv_database_id_t     db_id,
+                 const void*             key,
+                 hg_size_t               ksize,
+                 const void*             data,
+                 hg_size_t               size,
+                 hg_size_t*              new_size);
+
+/**
+ * @brief Reads the bytes of the value associated with a key that start at
+ * a given offset. Only these bytes are transferred, using RDMA, and backends
+ * that support it (BerkeleyDB, LMDB) do not read the rest of the value.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] offset offset of the first byte to read in the value
+ * @param[out] data buffer receiving the bytes
+ * @param[inout] size number of bytes to read as input, number of bytes
+ * read as output (fewer if the value ends before offset + size)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_range(sdskv_provider_handle_t handle,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    hg_size_t               offset,
+                    void*                   data,
+                    hg_size_t*              size);
+
+/**
+ * @brief Writes bytes at a given offset in the value associated with a key.
+ * The value is created if the key does not exist, and is extended with
+ * zeros if it is shorter than offset. Only these bytes are transferred,
+ * using RDMA, and backends that support it (BerkeleyDB, map) do not rewrite
+ * the rest of the value.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] offset offset in the value at which to write
+ * @param[in] data bytes to write
+ * @param[in] size number of bytes to write
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_put_range(sdskv_provider_handle_t handle,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    hg_size_t               offset,
+                    const void*             data,
+                    hg_size_t               size);
+
 /**
  * Lists at most max_keys keys starting strictly after start_key,
  * whether start_key is effectively in the database or not. "strictly after"
@@ -734,6 +1080,272 @@ int sdskv_migrate_database(sdskv_provider_handle_t source,
                            const char*             dest_root,
                            int                     flag);
 
+/**
+ * @brief Compacts an entire database. Compaction is run by the provider
+ * in a dedicated execution stream and this function returns once it has
+ * completed. Only LevelDB databases support compaction, other backends
+ * return SDSKV_OP_NOT_IMPL.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_compact(sdskv_provider_handle_t handle, sdskv_database_id_t db_id);
+
+/**
+ * @brief Compacts the keys in the range [lower, upper] of a database.
+ * A NULL bound stands for the start (resp. end) of the database.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] lower lower bound of the range (can be NULL)
+ * @param[in] lower_size size of the lower bound
+ * @param[in] upper upper bound of the range (can be NULL)
+ * @param[in] upper_size size of the upper bound
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_compact_range(sdskv_provider_handle_t handle,
+                        sdskv_database_id_t     db_id,
+                        const void*             lower,
+                        hg_size_t               lower_size,
+                        const void*             upper,
+                        hg_size_t               upper_size);
+
+/**
+ * @brief Gets the statistics of a provider as a JSON string: the number
+ * of calls, errors, bytes transferred, and histograms of the latency, time
+ * spent in the database, and time spent in bulk transfers, for each type
+ * of RPC, both for the provider as a whole and for each of its databases.
+ * The string is allocated by this function and must be freed by the caller.
+ *
+ * @param[in] handle provider handle
+ * @param[out] statistics JSON statistics
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_statistics(sdskv_provider_handle_t handle, char** statistics);
+
+/**
+ * @brief Asks a provider with tracing enabled to write the spans of the
+ * requests it recently handled to a file, in the Chrome trace event format
+ * (viewable with chrome://tracing or Perfetto), and to empty its trace
+ * buffer. The file is written on the provider's node.
+ *
+ * @param[in] handle provider handle
+ * @param[in] filename file to write, or NULL to use the file set in the
+ * provider's configuration
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ * (SDSKV_ERR_INVALID_ARG if tracing is disabled or no file is known)
+ */
+/**
+ * @brief Gets the provider's log of slow RPCs as a JSON string: the RPCs
+ * that took longer than the threshold of their type, most recent last, with
+ * their database, request id, a hash of the first bytes of their key, the
+ * sizes they transferred, and how their time splits between waiting for the
+ * provider's lock, the database, and bulk transfers. The string is allocated
+ * by this function and must be freed by the caller.
+ *
+ * @param[in] handle provider handle
+ * @param[out] slow_ops JSON log of slow RPCs
+ * @param[in] clear whether to empty the log
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_slow_ops(sdskv_provider_handle_t handle,
+                       char**                  slow_ops,
+                       int                     clear);
+
+int sdskv_flush_trace(sdskv_provider_handle_t handle, const char* filename);
+
+/**
+ * @brief Gets the hottest keys of a database, with an estimate of how many
+ * times each was accessed by put and get operations, hottest first. The
+ * estimates come from a sample of the accesses, so they are approximate
+ * and may be too high for keys sharing counters with other hot keys. This
+ * information can be used to decide which key ranges to move to another
+ * provider with sdskv_migrate_key_range. The keys are allocated by this
+ * function and must be freed by the caller.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[inout] num_keys maximum number of keys requested,
+ * set to the number of keys returned
+ * @param[out] keys array of num_keys pointers to the returned keys
+ * @param[out] ksizes array of num_keys key sizes
+ * @param[out] counts array of num_keys estimated access counts
+ * @param[in] reset whether to reset the database's access counts
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_hot_keys(sdskv_provider_handle_t handle,
+                       sdskv_database_id_t     db_id,
+                       hg_size_t*              num_keys,
+                       void**                  keys,
+                       hg_size_t*              ksizes,
+                       uint64_t*               counts,
+                       int                     reset);
+
+/**
+ * @brief Watches the keys of a database in [lower, upper), an empty bound
+ * (size 0) being open. The keys put and erased in this range are sent back
+ * to this client in batches and passed to fn, from a ULT of the client's
+ * margo instance. A key modified several times between two batches is only
+ * reported once, with its last change. Changes are not reported in key
+ * order across batches, and expired entries are not reported. If this
+ * client does not keep up, queued changes are dropped and the next batch
+ * is passed SDSKV_WATCH_OVERFLOW in its flags; the watch is cancelled if a
+ * batch is not acknowledged in time. The next batch is only sent once fn
+ * has returned.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] lower lower bound, included
+ * @param[in] lsize size of the lower bound
+ * @param[in] upper upper bound, excluded
+ * @param[in] usize size of the upper bound
+ * @param[in] with_values whether the new values of the keys put are sent
+ * @param[in] fn function called with each batch of changes
+ * @param[in] uargs argument passed to fn
+ * @param[out] watch_id id of the watch, to pass to sdskv_unwatch
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_watch_range(sdskv_provider_handle_t handle,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lsize,
+                      const void*             upper,
+                      hg_size_t               usize,
+                      int                     with_values,
+                      sdskv_watch_fn          fn,
+                      void*                   uargs,
+                      sdskv_watch_id_t*       watch_id);
+
+/**
+ * @brief Watches the keys of a database starting with a prefix.
+ * See sdskv_watch_range.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] prefix prefix of the keys
+ * @param[in] psize size of the prefix
+ * @param[in] with_values whether the new values of the keys put are sent
+ * @param[in] fn function called with each batch of changes
+ * @param[in] uargs argument passed to fn
+ * @param[out] watch_id id of the watch, to pass to sdskv_unwatch
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_watch_prefixed(sdskv_provider_handle_t handle,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               psize,
+                         int                     with_values,
+                         sdskv_watch_fn          fn,
+                         void*                   uargs,
+                         sdskv_watch_id_t*       watch_id);
+
+/**
+ * @brief Cancels a watch. fn is not called for the batches received after
+ * this function returns.
+ *
+ * @param[in] handle provider handle the watch was created with
+ * @param[in] watch_id id of the watch
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_unwatch(sdskv_provider_handle_t handle, sdskv_watch_id_t watch_id);
+
+/**
+ * @brief Gets the changes recorded in the change log of a database after
+ * the change of sequence number since, in order. The keys and values are
+ * received in buffer, to which the changes point. Fewer changes than asked
+ * are returned when they don't fit in buffer, and none, with SDSKV_ERR_SIZE,
+ * when the first one doesn't. SDSKV_ERR_LOG_TRUNCATED is returned if some
+ * of the changes asked for were truncated, in which case the database must
+ * be copied again; SDSKV_OP_NOT_IMPL is returned if the database has no
+ * change log.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] since sequence number of the last change already seen, or 0
+ * @param[inout] num_changes max number of changes, then number returned
+ * @param[out] changes array of num_changes changes
+ * @param[out] buffer buffer receiving the keys and values of the changes
+ * @param[in] bufsize size of the buffer
+ * @param[out] last_seq sequence number of the last change recorded
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_changes(sdskv_provider_handle_t handle,
+                      sdskv_database_id_t     db_id,
+                      uint64_t                since,
+                      hg_size_t*              num_changes,
+                      sdskv_change_t*         changes,
+                      void*                   buffer,
+                      hg_size_t               bufsize,
+                      uint64_t*               last_seq);
+
+/**
+ * @brief Erases from the change log of a database the changes up to the
+ * one of sequence number upto, once they have been applied elsewhere.
+ *
+ * @param[in] handle provider handle
+ * @param[in] db_id database id
+ * @param[in] upto sequence number of the last change to erase
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_truncate_changes(sdskv_provider_handle_t handle,
+                           sdskv_database_id_t     db_id,
+                           uint64_t                upto);
+
+/**
+ * @brief Adds a backup to a database: a database of another provider, to
+ * which the database is copied, and then its puts and erasures are sent in
+ * the order they are made. The writes to the database wait for a sync
+ * backup to apply them, and for an async backup to lag by at most the
+ * "max_lag" of the provider's "replication" configuration. A backup that
+ * fails stops receiving the writes, and the writes that were waiting for it
+ * return SDSKV_ERR_REPLICATION; it can then be added again. The backup can
+ * be read directly by clients.
+ *
+ * @param[in] handle provider handle of the database
+ * @param[in] db_id database id
+ * @param[in] backup_addr address of the backup's provider
+ * @param[in] backup_provider_id id of the backup's provider
+ * @param[in] backup_db_id id of the backup in its provider
+ * @param[in] sync whether writes wait for the backup to apply them
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_add_backup(sdskv_provider_handle_t handle,
+                     sdskv_database_id_t     db_id,
+                     const char*             backup_addr,
+                     uint16_t                backup_provider_id,
+                     sdskv_database_id_t     backup_db_id,
+                     int                     sync);
+
+/**
+ * @brief Stops sending the writes to a database to one of its backups.
+ *
+ * @param[in] handle provider handle of the database
+ * @param[in] db_id database id
+ * @param[in] backup_addr address of the backup's provider
+ * @param[in] backup_provider_id id of the backup's provider
+ * @param[in] backup_db_id id of the backup in its provider
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_remove_backup(sdskv_provider_handle_t handle,
+                        sdskv_database_id_t     db_id,
+                        const char*             backup_addr,
+                        uint16_t                backup_provider_id,
+                        sdskv_database_id_t     backup_db_id);
+
 /**
  * Shuts down a remote SDSKV service (given an address).
  * This will shutdown all the providers on the target address.
@@ -220,6 +220,36 @@ class client {
             object_size(value));
     }
 
+    /**
+     * @brief Equivalent of sdskv_put_ttl.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key in bytes.
+     * @param value Value.
+     * @param vsize Size of the value in bytes.
+     * @param ttl_ms Time to live in milliseconds, 0 for no expiration.
+     */
+    void put_ttl(const database& db,
+                 const void*     key,
+                 hg_size_t       ksize,
+                 const void*     value,
+                 hg_size_t       vsize,
+                 uint64_t        ttl_ms) const;
+
+    /**
+     * @brief Templated version of put_ttl, see put.
+     */
+    template <typename K, typename V>
+    inline void put_ttl(const database& db,
+                        const K&        key,
+                        const V&        value,
+                        uint64_t        ttl_ms) const
+    {
+        put_ttl(db, object_data(key), object_size(key), object_data(value),
+                object_size(value), ttl_ms);
+    }
+
     //////////////////////////
     // PUT_MULTI methods
     //////////////////////////
@@ -361,13 +391,16 @@ class client {
      * @param ksizes Array of key sizes.
      * @param values Buffer of values.
      * @param vsizes Array of value sizes.
+     * @param compression Codec to compress the payload with.
      */
-    void put_packed(const database&  db,
-                    hg_size_t        count,
-                    const void*      keys,
-                    const hg_size_t* ksizes,
-                    const void*      values,
-                    const hg_size_t* vsizes) const;
+    void put_packed(const database&     db,
+                    hg_size_t           count,
+                    const void*         keys,
+                    const hg_size_t*    ksizes,
+                    const void*         values,
+                    const hg_size_t*    vsizes,
+                    sdskv_compression_t compression
+                    = SDSKV_COMPRESSION_NONE) const;
 
     /**
      * @brief Version of put taking std::strings instead of pointers.
@@ -377,15 +410,18 @@ class client {
      * @param ksizes Vector of key sizes.
      * @param values Vector of pointers to values.
      * @param vsizes Vector of value sizes.
+     * @param compression Codec to compress the payload with.
      */
     inline void put_packed(const database&               db,
                            const std::string&            packed_keys,
                            const std::vector<hg_size_t>& ksizes,
                            const std::string&            packed_values,
-                           const std::vector<hg_size_t>& vsizes) const
+                           const std::vector<hg_size_t>& vsizes,
+                           sdskv_compression_t           compression
+                           = SDSKV_COMPRESSION_NONE) const
     {
         put_packed(db, ksizes.size(), packed_keys.data(), ksizes.data(),
-                   packed_values.data(), vsizes.data());
+                   packed_values.data(), vsizes.data(), compression);
     }
 
     /**
@@ -858,14 +894,17 @@ class client {
      * @param valbufsize Size of the value buffer.
      * @param values Buffer of packed values.
      * @param vsizes Array of sizes of value buffers.
+     * @param compression Codec to compress the values with.
      */
-    bool get_packed(const database&  db,
-                    hg_size_t*       count,
-                    const void*      keys,
-                    const hg_size_t* ksizes,
-                    hg_size_t        valbufsize,
-                    void*            values,
-                    hg_size_t*       vsizes) const;
+    bool get_packed(const database&     db,
+                    hg_size_t*          count,
+                    const void*         keys,
+                    const hg_size_t*    ksizes,
+                    hg_size_t           valbufsize,
+                    void*               values,
+                    hg_size_t*          vsizes,
+                    sdskv_compression_t compression
+                    = SDSKV_COMPRESSION_NONE) const;
 
     /**
      * @brief Get multiple key/val pairs using std::string packed buffers
@@ -878,18 +917,22 @@ class client {
      * @param ksizes Vector of key sizes.
      * @param values Vector of value addresses.
      * @param vsizes Vector of value sizes.
+     * @param compression Codec to compress the values with.
      */
     inline bool get_packed(const database&               db,
                            const std::string&            packed_keys,
                            const std::vector<hg_size_t>& ksizes,
                            std::string&                  packed_values,
-                           std::vector<hg_size_t>&       vsizes) const
+                           std::vector<hg_size_t>&       vsizes,
+                           sdskv_compression_t           compression
+                           = SDSKV_COMPRESSION_NONE) const
     {
         hg_size_t count = ksizes.size();
         vsizes.resize(count);
-        bool b = get_packed(
-            db, &count, packed_keys.data(), ksizes.data(), packed_values.size(),
-            const_cast<char*>(packed_values.data()), vsizes.data());
+        bool b = get_packed(db, &count, packed_keys.data(), ksizes.data(),
+                            packed_values.size(),
+                            const_cast<char*>(packed_values.data()),
+                            vsizes.data(), compression);
         vsizes.resize(count);
         return b;
     }
@@ -963,6 +1006,369 @@ class client {
         return erase_multi(db, keys.size(), kdata.data(), ksizes.data());
     }
 
+    /**
+     * @brief Equivalent to sdskv_erase_range.
+     *
+     * @param db Database instance.
+     * @param lower Lower bound (NULL for the start of the database).
+     * @param lower_size Size of the lower bound.
+     * @param upper Upper bound, excluded (NULL for the end of the database).
+     * @param upper_size Size of the upper bound.
+     *
+     * @return the number of key/value pairs erased.
+     */
+    hg_size_t erase_range(const database& db,
+                          const void*     lower,
+                          hg_size_t       lower_size,
+                          const void*     upper,
+                          hg_size_t       upper_size) const;
+
+    /**
+     * @brief Templated erase_range method, meant to be used
+     * with keys of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param lower Lower bound.
+     * @param upper Upper bound, excluded.
+     *
+     * @return the number of key/value pairs erased.
+     */
+    template <typename K>
+    inline hg_size_t
+    erase_range(const database& db, const K& lower, const K& upper) const
+    {
+        return erase_range(db, object_data(lower), object_size(lower),
+                           object_data(upper), object_size(upper));
+    }
+
+    /**
+     * @brief Equivalent to sdskv_erase_prefixed.
+     *
+     * @param db Database instance.
+     * @param prefix Prefix.
+     * @param prefix_size Size of the prefix.
+     *
+     * @return the number of key/value pairs erased.
+     */
+    hg_size_t erase_prefixed(const database& db,
+                             const void*     prefix,
+                             hg_size_t       prefix_size) const;
+
+    /**
+     * @brief Templated erase_prefixed method, meant to be used
+     * with prefixes of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Prefix type.
+     * @param db Database instance.
+     * @param prefix Prefix.
+     *
+     * @return the number of key/value pairs erased.
+     */
+    template <typename K>
+    inline hg_size_t erase_prefixed(const database& db, const K& prefix) const
+    {
+        return erase_prefixed(db, object_data(prefix), object_size(prefix));
+    }
+
+    //////////////////////////
+    // COUNT methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_count_range.
+     *
+     * @param db Database instance.
+     * @param lower Lower bound (NULL for the start of the database).
+     * @param lower_size Size of the lower bound.
+     * @param upper Upper bound, excluded (NULL for the end of the database).
+     * @param upper_size Size of the upper bound.
+     * @param key_bytes Total size of the keys (can be NULL).
+     * @param value_bytes Total size of the values (can be NULL).
+     *
+     * @return the number of key/value pairs in the range.
+     */
+    hg_size_t count_range(const database& db,
+                          const void*     lower,
+                          hg_size_t       lower_size,
+                          const void*     upper,
+                          hg_size_t       upper_size,
+                          hg_size_t*      key_bytes   = nullptr,
+                          hg_size_t*      value_bytes = nullptr) const;
+
+    /**
+     * @brief Templated count_range method, meant to be used
+     * with keys of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param lower Lower bound.
+     * @param upper Upper bound, excluded.
+     * @param key_bytes Total size of the keys (can be NULL).
+     * @param value_bytes Total size of the values (can be NULL).
+     *
+     * @return the number of key/value pairs in the range.
+     */
+    template <typename K>
+    inline hg_size_t count_range(const database& db,
+                                 const K&        lower,
+                                 const K&        upper,
+                                 hg_size_t*      key_bytes   = nullptr,
+                                 hg_size_t*      value_bytes = nullptr) const
+    {
+        return count_range(db, object_data(lower), object_size(lower),
+                           object_data(upper), object_size(upper), key_bytes,
+                           value_bytes);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_count_prefixed.
+     *
+     * @param db Database instance.
+     * @param prefix Prefix.
+     * @param prefix_size Size of the prefix.
+     * @param key_bytes Total size of the keys (can be NULL).
+     * @param value_bytes Total size of the values (can be NULL).
+     *
+     * @return the number of key/value pairs whose key starts with prefix.
+     */
+    hg_size_t count_prefixed(const database& db,
+                             const void*     prefix,
+                             hg_size_t       prefix_size,
+                             hg_size_t*      key_bytes   = nullptr,
+                             hg_size_t*      value_bytes = nullptr) const;
+
+    /**
+     * @brief Templated count_prefixed method, meant to be used
+     * with prefixes of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Prefix type.
+     * @param db Database instance.
+     * @param prefix Prefix.
+     * @param key_bytes Total size of the keys (can be NULL).
+     * @param value_bytes Total size of the values (can be NULL).
+     *
+     * @return the number of key/value pairs whose key starts with prefix.
+     */
+    template <typename K>
+    inline hg_size_t count_prefixed(const database& db,
+                                    const K&        prefix,
+                                    hg_size_t*      key_bytes   = nullptr,
+                                    hg_size_t*      value_bytes = nullptr) const
+    {
+        return count_prefixed(db, object_data(prefix), object_size(prefix),
+                              key_bytes, value_bytes);
+    }
+
+    //////////////////////////
+    // READ-MODIFY-WRITE methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_compare_and_swap.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param expected Expected value (NULL if the key should not exist).
+     * @param expected_size Size of the expected value.
+     * @param value New value.
+     * @param vsize Size of the new value.
+     *
+     * @return true if the value was replaced.
+     */
+    bool compare_and_swap(const database& db,
+                          const void*     key,
+                          hg_size_t       ksize,
+                          const void*     expected,
+                          hg_size_t       expected_size,
+                          const void*     value,
+                          hg_size_t       vsize) const;
+
+    /**
+     * @brief Templated compare_and_swap method, meant to be used
+     * with keys and values of type std::string or std::vector<X>
+     * where X is a standard layout type.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param expected Expected value.
+     * @param value New value.
+     *
+     * @return true if the value was replaced.
+     */
+    template <typename K, typename V>
+    inline bool compare_and_swap(const database& db,
+                                 const K&        key,
+                                 const V&        expected,
+                                 const V&        value) const
+    {
+        return compare_and_swap(db, object_data(key), object_size(key),
+                                object_data(expected), object_size(expected),
+                                object_data(value), object_size(value));
+    }
+
+    /**
+     * @brief Equivalent to sdskv_fetch_add.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param delta Value to add.
+     *
+     * @return the value before the addition.
+     */
+    int64_t fetch_add(const database& db,
+                      const void*     key,
+                      hg_size_t       ksize,
+                      int64_t         delta) const;
+
+    /**
+     * @brief Templated fetch_add method, meant to be used
+     * with keys of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param delta Value to add.
+     *
+     * @return the value before the addition.
+     */
+    template <typename K>
+    inline int64_t
+    fetch_add(const database& db, const K& key, int64_t delta) const
+    {
+        return fetch_add(db, object_data(key), object_size(key), delta);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_append.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param data Data to append.
+     * @param size Size of the data.
+     *
+     * @return the size of the value after the append.
+     */
+    hg_size_t append(const database& db,
+                     const void*     key,
+                     hg_size_t       ksize,
+                     const void*     data,
+                     hg_size_t       size) const;
+
+    /**
+     * @brief Templated append method, meant to be used
+     * with keys and data of type std::string or std::vector<X>
+     * where X is a standard layout type.
+     *
+     * @tparam K Key type.
+     * @tparam V Data type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param data Data to append.
+     *
+     * @return the size of the value after the append.
+     */
+    template <typename K, typename V>
+    inline hg_size_t
+    append(const database& db, const K& key, const V& data) const
+    {
+        return append(db, object_data(key), object_size(key), object_data(data),
+                      object_size(data));
+    }
+
+    /**
+     * @brief Equivalent to sdskv_get_range.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param offset Offset of the first byte to read in the value.
+     * @param data Buffer receiving the bytes.
+     * @param size Number of bytes to read.
+     *
+     * @return the number of bytes read.
+     */
+    hg_size_t get_range(const database& db,
+                        const void*     key,
+                        hg_size_t       ksize,
+                        hg_size_t       offset,
+                        void*           data,
+                        hg_size_t       size) const;
+
+    /**
+     * @brief Templated get_range method, meant to be used
+     * with keys and data of type std::string or std::vector<X>
+     * where X is a standard layout type. The data object must
+     * be sized to the number of bytes to read, and is resized
+     * to the number of bytes actually read.
+     *
+     * @tparam K Key type.
+     * @tparam V Data type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param offset Offset of the first byte to read in the value.
+     * @param data Object receiving the bytes.
+     *
+     * @return the number of bytes read.
+     */
+    template <typename K, typename V>
+    inline hg_size_t
+    get_range(const database& db, const K& key, hg_size_t offset, V& data) const
+    {
+        hg_size_t s = get_range(db, object_data(key), object_size(key), offset,
+                                object_data(data), object_size(data));
+        object_resize(data, s);
+        return s;
+    }
+
+    /**
+     * @brief Equivalent to sdskv_put_range.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param offset Offset in the value at which to write.
+     * @param data Bytes to write.
+     * @param size Number of bytes to write.
+     */
+    void put_range(const database& db,
+                   const void*     key,
+                   hg_size_t       ksize,
+                   hg_size_t       offset,
+                   const void*     data,
+                   hg_size_t       size) const;
+
+    /**
+     * @brief Templated put_range method, meant to be used
+     * with keys and data of type std::string or std::vector<X>
+     * where X is a standard layout type.
+     *
+     * @tparam K Key type.
+     * @tparam V Data type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param offset Offset in the value at which to write.
+     * @param data Bytes to write.
+     */
+    template <typename K, typename V>
+    inline void
+    put_range(const database& db, const K& key, hg_size_t offset,
+              const V& data) const
+    {
+        put_range(db, object_data(key), object_size(key), offset,
+                  object_data(data), object_size(data));
+    }
+
     //////////////////////////
     // LIST_KEYS methods
     //////////////////////////
@@ -1407,6 +1813,206 @@ class client {
                  const std::string& dest_root,
                  int                flag = SDSKV_KEEP_ORIGINAL) const;
 
+    //////////////////////////
+    // COMPACT methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_compact.
+     *
+     * @param db Database instance.
+     */
+    void compact(const database& db) const;
+
+    /**
+     * @brief Equivalent to sdskv_compact_range.
+     *
+     * @param db Database instance.
+     * @param lower Lower bound (NULL for the start of the database).
+     * @param lower_size Size of the lower bound.
+     * @param upper Upper bound (NULL for the end of the database).
+     * @param upper_size Size of the upper bound.
+     */
+    void compact(const database& db,
+                 const void*     lower,
+                 hg_size_t       lower_size,
+                 const void*     upper,
+                 hg_size_t       upper_size) const;
+
+    /**
+     * @brief Templated compact method, meant to be used
+     * with keys of type std::string or std::vector<X> where X is a
+     * standard layout type.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param lower Lower bound.
+     * @param upper Upper bound.
+     */
+    template <typename K>
+    inline void
+    compact(const database& db, const K& lower, const K& upper) const
+    {
+        compact(db, object_data(lower), object_size(lower), object_data(upper),
+                object_size(upper));
+    }
+
+    //////////////////////////
+    // STATISTICS method
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_get_statistics.
+     *
+     * @param ph Provider handle.
+     *
+     * @return The provider's statistics as a JSON string.
+     */
+    std::string get_statistics(const provider_handle& ph) const;
+
+    /**
+     * @brief Equivalent to sdskv_get_slow_ops.
+     *
+     * @param ph Provider handle.
+     * @param clear Whether to empty the log.
+     *
+     * @return The provider's log of slow RPCs as a JSON string.
+     */
+    std::string get_slow_ops(const provider_handle& ph,
+                             bool                   clear = false) const;
+
+    /**
+     * @brief Equivalent to sdskv_flush_trace.
+     *
+     * @param ph Provider handle.
+     * @param filename File to write on the provider's node (empty to use the
+     * provider's configured file).
+     */
+    void flush_trace(const provider_handle& ph,
+                     const std::string&     filename = "") const;
+
+    /**
+     * @brief Equivalent to sdskv_get_hot_keys.
+     *
+     * @param db Database instance.
+     * @param max_keys Maximum number of keys to return.
+     * @param reset Whether to reset the access counts.
+     *
+     * @return The hottest keys with their estimated access counts.
+     */
+    std::vector<std::pair<std::string, uint64_t>>
+    get_hot_keys(const database& db, hg_size_t max_keys,
+                 bool reset = false) const;
+
+    //////////////////////////
+    // WATCH methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent of sdskv_watch_range.
+     *
+     * @param db Database instance.
+     * @param lower Lower bound, included (empty for none).
+     * @param upper Upper bound, excluded (empty for none).
+     * @param with_values Whether the new values are sent.
+     * @param fn Function called with each batch of changes.
+     * @param uargs Argument passed to fn.
+     *
+     * @return The id of the watch.
+     */
+    sdskv_watch_id_t watch_range(const database&    db,
+                                 const std::string& lower,
+                                 const std::string& upper,
+                                 bool               with_values,
+                                 sdskv_watch_fn     fn,
+                                 void*              uargs) const;
+
+    /**
+     * @brief Equivalent of sdskv_watch_prefixed.
+     *
+     * @param db Database instance.
+     * @param prefix Prefix of the keys.
+     * @param with_values Whether the new values are sent.
+     * @param fn Function called with each batch of changes.
+     * @param uargs Argument passed to fn.
+     *
+     * @return The id of the watch.
+     */
+    sdskv_watch_id_t watch_prefixed(const database&    db,
+                                    const std::string& prefix,
+                                    bool               with_values,
+                                    sdskv_watch_fn     fn,
+                                    void*              uargs) const;
+
+    /**
+     * @brief Equivalent of sdskv_unwatch.
+     *
+     * @param ph Provider handle the watch was created with.
+     * @param watch_id Id of the watch.
+     */
+    void unwatch(const provider_handle& ph, sdskv_watch_id_t watch_id) const;
+
+    //////////////////////////
+    // CHANGE LOG methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent of sdskv_get_changes. At most changes.size()
+     * changes are fetched, after which changes is resized to the number
+     * fetched; they point into buffer.
+     *
+     * @param db Database instance.
+     * @param since Sequence number of the last change already seen.
+     * @param changes Changes.
+     * @param buffer Buffer receiving the keys and values of the changes.
+     *
+     * @return The sequence number of the last change recorded.
+     */
+    uint64_t get_changes(const database&              db,
+                         uint64_t                     since,
+                         std::vector<sdskv_change_t>& changes,
+                         std::vector<char>&           buffer) const;
+
+    /**
+     * @brief Equivalent of sdskv_truncate_changes.
+     *
+     * @param db Database instance.
+     * @param upto Sequence number of the last change to erase.
+     */
+    void truncate_changes(const database& db, uint64_t upto) const;
+
+    //////////////////////////
+    // REPLICATION methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent of sdskv_add_backup.
+     *
+     * @param db Database instance.
+     * @param backup_addr Address of the backup's provider.
+     * @param backup_provider_id Id of the backup's provider.
+     * @param backup_db_id Id of the backup in its provider.
+     * @param sync Whether writes wait for the backup to apply them.
+     */
+    void add_backup(const database&     db,
+                    const std::string&  backup_addr,
+                    uint16_t            backup_provider_id,
+                    sdskv_database_id_t backup_db_id,
+                    bool                sync) const;
+
+    /**
+     * @brief Equivalent of sdskv_remove_backup.
+     *
+     * @param db Database instance.
+     * @param backup_addr Address of the backup's provider.
+     * @param backup_provider_id Id of the backup's provider.
+     * @param backup_db_id Id of the backup in its provider.
+     */
+    void remove_backup(const database&     db,
+                       const std::string&  backup_addr,
+                       uint16_t            backup_provider_id,
+                       sdskv_database_id_t backup_db_id) const;
+
     //////////////////////////
     // SHUTDOWN method
     //////////////////////////
@@ -1520,6 +2126,19 @@ class provider_handle {
             sdskv_provider_handle_release(m_ph);
     }
 
+    /**
+     * @brief Sets the request id sent with the data operations issued
+     * through this provider handle (and its copies), which providers use
+     * to tag traced requests.
+     *
+     * @param request_id Request id.
+     */
+    void set_request_id(uint64_t request_id)
+    {
+        int ret = sdskv_provider_handle_set_request_id(m_ph, request_id);
+        _CHECK_RET(ret);
+    }
+
     /**
      * @brief Cast operator to sdskv_provider_handle_t.
      *
@@ -1594,6 +2213,14 @@ class database {
         m_ph.m_client->put(*this, std::forward<T>(args)...);
     }
 
+    /**
+     * @brief @see client::put_ttl.
+     */
+    template <typename... T> void put_ttl(T&&... args) const
+    {
+        m_ph.m_client->put_ttl(*this, std::forward<T>(args)...);
+    }
+
     /**
      * @brief @see client::put_multi.
      */
@@ -1690,6 +2317,79 @@ class database {
         m_ph.m_client->erase_multi(*this, std::forward<T>(args)...);
     }
 
+    /**
+     * @brief @see client::erase_range.
+     */
+    template <typename... T> hg_size_t erase_range(T&&... args) const
+    {
+        return m_ph.m_client->erase_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::erase_prefixed.
+     */
+    template <typename... T> hg_size_t erase_prefixed(T&&... args) const
+    {
+        return m_ph.m_client->erase_prefixed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::count_range.
+     */
+    template <typename... T> hg_size_t count_range(T&&... args) const
+    {
+        return m_ph.m_client->count_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::count_prefixed.
+     */
+    template <typename... T> hg_size_t count_prefixed(T&&... args) const
+    {
+        return m_ph.m_client->count_prefixed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::compare_and_swap.
+     */
+    template <typename... T> bool compare_and_swap(T&&... args) const
+    {
+        return m_ph.m_client->compare_and_swap(*this,
+                                               std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::fetch_add.
+     */
+    template <typename... T> int64_t fetch_add(T&&... args) const
+    {
+        return m_ph.m_client->fetch_add(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::append.
+     */
+    template <typename... T> hg_size_t append(T&&... args) const
+    {
+        return m_ph.m_client->append(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get_range.
+     */
+    template <typename... T> hg_size_t get_range(T&&... args) const
+    {
+        return m_ph.m_client->get_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::put_range.
+     */
+    template <typename... T> void put_range(T&&... args) const
+    {
+        m_ph.m_client->put_range(*this, std::forward<T>(args)...);
+    }
+
     /**
      * @brief @see client::list_keys.
      */
@@ -1706,6 +2406,79 @@ class database {
         return m_ph.m_client->list_keyvals(*this, std::forward<T>(args)...);
     }
 
+    /**
+     * @brief @see client::compact.
+     */
+    template <typename... T> void compact(T&&... args) const
+    {
+        m_ph.m_client->compact(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get_hot_keys.
+     */
+    template <typename... T> decltype(auto) get_hot_keys(T&&... args) const
+    {
+        return m_ph.m_client->get_hot_keys(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::watch_range.
+     */
+    template <typename... T> sdskv_watch_id_t watch_range(T&&... args) const
+    {
+        return m_ph.m_client->watch_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::watch_prefixed.
+     */
+    template <typename... T>
+    sdskv_watch_id_t watch_prefixed(T&&... args) const
+    {
+        return m_ph.m_client->watch_prefixed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::unwatch.
+     */
+    void unwatch(sdskv_watch_id_t watch_id) const
+    {
+        m_ph.m_client->unwatch(m_ph, watch_id);
+    }
+
+    /**
+     * @brief @see client::get_changes.
+     */
+    template <typename... T> uint64_t get_changes(T&&... args) const
+    {
+        return m_ph.m_client->get_changes(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::truncate_changes.
+     */
+    template <typename... T> void truncate_changes(T&&... args) const
+    {
+        m_ph.m_client->truncate_changes(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::add_backup.
+     */
+    template <typename... T> void add_backup(T&&... args) const
+    {
+        m_ph.m_client->add_backup(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::remove_backup.
+     */
+    template <typename... T> void remove_backup(T&&... args) const
+    {
+        m_ph.m_client->remove_backup(*this, std::forward<T>(args)...);
+    }
+
     /**
      * @brief @see client::migrate.
      */
@@ -1767,6 +2540,18 @@ inline void client::put(const database& db,
     _CHECK_RET(ret);
 }
 
+inline void client::put_ttl(const database& db,
+                            const void*     key,
+                            hg_size_t       ksize,
+                            const void*     value,
+                            hg_size_t       vsize,
+                            uint64_t        ttl_ms) const
+{
+    int ret = sdskv_put_ttl(db.m_ph.m_ph, db.m_db_id, key, ksize, value,
+                            vsize, ttl_ms);
+    _CHECK_RET(ret);
+}
+
 inline void client::put_multi(const database&    db,
                               hg_size_t          count,
                               const void* const* keys,
@@ -1779,15 +2564,17 @@ inline void client::put_multi(const database&    db,
     _CHECK_RET(ret);
 }
 
-inline void client::put_packed(const database&  db,
-                               hg_size_t        count,
-                               const void*      keys,
-                               const hg_size_t* ksizes,
-                               const void*      values,
-                               const hg_size_t* vsizes) const
+inline void client::put_packed(const database&     db,
+                               hg_size_t           count,
+                               const void*         keys,
+                               const hg_size_t*    ksizes,
+                               const void*         values,
+                               const hg_size_t*    vsizes,
+                               sdskv_compression_t compression) const
 {
-    int ret = sdskv_put_packed(db.m_ph.m_ph, db.m_db_id, count, keys, ksizes,
-                               values, vsizes);
+    int ret = sdskv_put_packed_compressed(db.m_ph.m_ph, db.m_db_id, count,
+                                          keys, ksizes, values, vsizes,
+                                          compression);
     _CHECK_RET(ret);
 }
 
@@ -1884,16 +2671,18 @@ inline bool client::get_multi(const database&    db,
     return true;
 }
 
-inline bool client::get_packed(const database&  db,
-                               hg_size_t*       count,
-                               const void*      keys,
-                               const hg_size_t* ksizes,
-                               hg_size_t        valbufsize,
-                               void*            values,
-                               hg_size_t*       vsizes) const
+inline bool client::get_packed(const database&     db,
+                               hg_size_t*          count,
+                               const void*         keys,
+                               const hg_size_t*    ksizes,
+                               hg_size_t           valbufsize,
+                               void*               values,
+                               hg_size_t*          vsizes,
+                               sdskv_compression_t compression) const
 {
-    int ret = sdskv_get_packed(db.m_ph.m_ph, db.m_db_id, count, keys, ksizes,
-                               valbufsize, values, vsizes);
+    int ret = sdskv_get_packed_compressed(db.m_ph.m_ph, db.m_db_id, count,
+                                          keys, ksizes, valbufsize, values,
+                                          vsizes, compression);
     _CHECK_RET(ret);
     return true;
 }
@@ -1914,6 +2703,126 @@ inline void client::erase_multi(const database&    db,
     _CHECK_RET(ret);
 }
 
+inline hg_size_t client::erase_range(const database& db,
+                                     const void*     lower,
+                                     hg_size_t       lower_size,
+                                     const void*     upper,
+                                     hg_size_t       upper_size) const
+{
+    hg_size_t num_erased = 0;
+    int ret = sdskv_erase_range(db.m_ph.m_ph, db.m_db_id, lower, lower_size,
+                                upper, upper_size, &num_erased);
+    _CHECK_RET(ret);
+    return num_erased;
+}
+
+inline hg_size_t client::erase_prefixed(const database& db,
+                                        const void*     prefix,
+                                        hg_size_t       prefix_size) const
+{
+    hg_size_t num_erased = 0;
+    int ret = sdskv_erase_prefixed(db.m_ph.m_ph, db.m_db_id, prefix,
+                                   prefix_size, &num_erased);
+    _CHECK_RET(ret);
+    return num_erased;
+}
+
+inline hg_size_t client::count_range(const database& db,
+                                     const void*     lower,
+                                     hg_size_t       lower_size,
+                                     const void*     upper,
+                                     hg_size_t       upper_size,
+                                     hg_size_t*      key_bytes,
+                                     hg_size_t*      value_bytes) const
+{
+    hg_size_t num_keys = 0;
+    int ret = sdskv_count_range(db.m_ph.m_ph, db.m_db_id, lower, lower_size,
+                                upper, upper_size, &num_keys, key_bytes,
+                                value_bytes);
+    _CHECK_RET(ret);
+    return num_keys;
+}
+
+inline hg_size_t client::count_prefixed(const database& db,
+                                        const void*     prefix,
+                                        hg_size_t       prefix_size,
+                                        hg_size_t*      key_bytes,
+                                        hg_size_t*      value_bytes) const
+{
+    hg_size_t num_keys = 0;
+    int ret = sdskv_count_prefixed(db.m_ph.m_ph, db.m_db_id, prefix,
+                                   prefix_size, &num_keys, key_bytes,
+                                   value_bytes);
+    _CHECK_RET(ret);
+    return num_keys;
+}
+
+inline bool client::compare_and_swap(const database& db,
+                                     const void*     key,
+                                     hg_size_t       ksize,
+                                     const void*     expected,
+                                     hg_size_t       expected_size,
+                                     const void*     value,
+                                     hg_size_t       vsize) const
+{
+    int swapped = 0;
+    int ret = sdskv_compare_and_swap(db.m_ph.m_ph, db.m_db_id, key, ksize,
+                                     expected, expected_size, value, vsize,
+                                     &swapped);
+    _CHECK_RET(ret);
+    return swapped;
+}
+
+inline int64_t client::fetch_add(const database& db,
+                                 const void*     key,
+                                 hg_size_t       ksize,
+                                 int64_t         delta) const
+{
+    int64_t previous = 0;
+    int     ret      = sdskv_fetch_add(db.m_ph.m_ph, db.m_db_id, key, ksize,
+                                       delta, &previous);
+    _CHECK_RET(ret);
+    return previous;
+}
+
+inline hg_size_t client::append(const database& db,
+                                const void*     key,
+                                hg_size_t       ksize,
+                                const void*     data,
+                                hg_size_t       size) const
+{
+    hg_size_t new_size = 0;
+    int ret = sdskv_append(db.m_ph.m_ph, db.m_db_id, key, ksize, data, size,
+                           &new_size);
+    _CHECK_RET(ret);
+    return new_size;
+}
+
+inline hg_size_t client::get_range(const database& db,
+                                   const void*     key,
+                                   hg_size_t       ksize,
+                                   hg_size_t       offset,
+                                   void*           data,
+                                   hg_size_t       size) const
+{
+    int ret = sdskv_get_range(db.m_ph.m_ph, db.m_db_id, key, ksize, offset,
+                              data, &size);
+    _CHECK_RET(ret);
+    return size;
+}
+
+inline void client::put_range(const database& db,
+                              const void*     key,
+                              hg_size_t       ksize,
+                              hg_size_t       offset,
+                              const void*     data,
+                              hg_size_t       size) const
+{
+    int ret = sdskv_put_range(db.m_ph.m_ph, db.m_db_id, key, ksize, offset,
+                              data, size);
+    _CHECK_RET(ret);
+}
+
 inline void client::list_keys(const database& db,
                               const void*     start_key,
                               hg_size_t       start_ksize,
@@ -2082,6 +2991,151 @@ inline void client::migrate(database&          db,
     db.m_ph = std::move(dest_ph);
 }
 
+inline void client::compact(const database& db) const
+{
+    int ret = sdskv_compact(db.m_ph.m_ph, db.m_db_id);
+    _CHECK_RET(ret);
+}
+
+inline void client::compact(const database& db,
+                            const void*     lower,
+                            hg_size_t       lower_size,
+                            const void*     upper,
+                            hg_size_t       upper_size) const
+{
+    int ret = sdskv_compact_range(db.m_ph.m_ph, db.m_db_id, lower, lower_size,
+                                  upper, upper_size);
+    _CHECK_RET(ret);
+}
+
+inline std::string client::get_statistics(const provider_handle& ph) const
+{
+    char* statistics = nullptr;
+    int   ret        = sdskv_get_statistics(ph.m_ph, &statistics);
+    _CHECK_RET(ret);
+    std::string result(statistics);
+    free(statistics);
+    return result;
+}
+
+inline std::string client::get_slow_ops(const provider_handle& ph,
+                                        bool                   clear) const
+{
+    char* slow_ops = nullptr;
+    int   ret      = sdskv_get_slow_ops(ph.m_ph, &slow_ops, clear);
+    _CHECK_RET(ret);
+    std::string result(slow_ops);
+    free(slow_ops);
+    return result;
+}
+
+inline void client::flush_trace(const provider_handle& ph,
+                                const std::string&     filename) const
+{
+    int ret = sdskv_flush_trace(ph.m_ph, filename.c_str());
+    _CHECK_RET(ret);
+}
+
+inline std::vector<std::pair<std::string, uint64_t>>
+client::get_hot_keys(const database& db, hg_size_t max_keys, bool reset) const
+{
+    std::vector<void*>     keys(max_keys);
+    std::vector<hg_size_t> ksizes(max_keys);
+    std::vector<uint64_t>  counts(max_keys);
+    hg_size_t              num_keys = max_keys;
+    int ret = sdskv_get_hot_keys(db.m_ph.m_ph, db.m_db_id, &num_keys,
+                                 keys.data(), ksizes.data(), counts.data(),
+                                 reset);
+    _CHECK_RET(ret);
+    std::vector<std::pair<std::string, uint64_t>> result;
+    result.reserve(num_keys);
+    for (hg_size_t i = 0; i < num_keys; i++) {
+        result.emplace_back(std::string((const char*)keys[i], ksizes[i]),
+                            counts[i]);
+        free(keys[i]);
+    }
+    return result;
+}
+
+inline sdskv_watch_id_t client::watch_range(const database&    db,
+                                            const std::string& lower,
+                                            const std::string& upper,
+                                            bool               with_values,
+                                            sdskv_watch_fn     fn,
+                                            void*              uargs) const
+{
+    sdskv_watch_id_t watch_id = 0;
+    int ret = sdskv_watch_range(db.m_ph.m_ph, db.m_db_id, lower.data(),
+                                lower.size(), upper.data(), upper.size(),
+                                with_values, fn, uargs, &watch_id);
+    _CHECK_RET(ret);
+    return watch_id;
+}
+
+inline sdskv_watch_id_t client::watch_prefixed(const database&    db,
+                                               const std::string& prefix,
+                                               bool               with_values,
+                                               sdskv_watch_fn     fn,
+                                               void*              uargs) const
+{
+    sdskv_watch_id_t watch_id = 0;
+    int ret = sdskv_watch_prefixed(db.m_ph.m_ph, db.m_db_id, prefix.data(),
+                                   prefix.size(), with_values, fn, uargs,
+                                   &watch_id);
+    _CHECK_RET(ret);
+    return watch_id;
+}
+
+inline void client::unwatch(const provider_handle& ph,
+                            sdskv_watch_id_t       watch_id) const
+{
+    int ret = sdskv_unwatch(ph.m_ph, watch_id);
+    _CHECK_RET(ret);
+}
+
+inline uint64_t client::get_changes(const database&              db,
+                                    uint64_t                     since,
+                                    std::vector<sdskv_change_t>& changes,
+                                    std::vector<char>&           buffer) const
+{
+    hg_size_t num_changes = changes.size();
+    uint64_t  last_seq    = 0;
+    int ret = sdskv_get_changes(db.m_ph.m_ph, db.m_db_id, since, &num_changes,
+                                changes.data(), buffer.data(), buffer.size(),
+                                &last_seq);
+    _CHECK_RET(ret);
+    changes.resize(num_changes);
+    return last_seq;
+}
+
+inline void client::truncate_changes(const database& db, uint64_t upto) const
+{
+    int ret = sdskv_truncate_changes(db.m_ph.m_ph, db.m_db_id, upto);
+    _CHECK_RET(ret);
+}
+
+inline void client::add_backup(const database&     db,
+                               const std::string&  backup_addr,
+                               uint16_t            backup_provider_id,
+                               sdskv_database_id_t backup_db_id,
+                               bool                sync) const
+{
+    int ret = sdskv_add_backup(db.m_ph.m_ph, db.m_db_id, backup_addr.c_str(),
+                               backup_provider_id, backup_db_id, sync);
+    _CHECK_RET(ret);
+}
+
+inline void client::remove_backup(const database&     db,
+                                  const std::string&  backup_addr,
+                                  uint16_t            backup_provider_id,
+                                  sdskv_database_id_t backup_db_id) const
+{
+    int ret = sdskv_remove_backup(db.m_ph.m_ph, db.m_db_id,
+                                  backup_addr.c_str(), backup_provider_id,
+                                  backup_db_id);
+    _CHECK_RET(ret);
+}
+
 } // namespace sdskv
 
 #undef _CHECK_RET
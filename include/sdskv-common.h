@@ -12,12 +12,34 @@ typedef enum sdskv_db_type_t
     KVDB_BWTREE,     /* Datastore implementation using a BwTree   */
     KVDB_LEVELDB,    /* Datastore implementation using LevelDB    */
     KVDB_BERKELEYDB, /* Datastore implementation using BerkeleyDB */
-    KVDB_FORWARDDB   /* Datastore implementation forwarding to secondary DB */
+    KVDB_FORWARDDB,  /* Datastore implementation forwarding to secondary DB */
+    KVDB_LMDB,       /* Datastore implementation using LMDB */
+    KVDB_ROCKSDB     /* Datastore implementation using RocksDB */
 } sdskv_db_type_t;
 
 typedef uint64_t sdskv_database_id_t;
 #define SDSKV_DATABASE_ID_INVALID 0
 
+/* codecs with which the packed RPCs may compress their payloads; a codec
+ * that is not available on both sides falls back to no compression */
+typedef enum sdskv_compression_t
+{
+    SDSKV_COMPRESSION_NONE = 0, /* payloads are sent as they are */
+    SDSKV_COMPRESSION_LZ4,      /* payloads are compressed with LZ4 */
+    SDSKV_COMPRESSION_ZSTD      /* payloads are compressed with Zstd */
+} sdskv_compression_t;
+
+/* types of the changes reported to the clients watching a database */
+typedef enum sdskv_watch_event_type_t
+{
+    SDSKV_WATCH_PUT = 0, /* the key was put, or modified in place */
+    SDSKV_WATCH_ERASE    /* the key was erased */
+} sdskv_watch_event_type_t;
+
+/* flag passed with a batch of changes when changes had to be dropped since
+ * the previous batch, because the watcher did not keep up */
+#define SDSKV_WATCH_OVERFLOW 1
+
 #define SDSKV_KEEP_ORIGINAL 0 /* for migration operations, keep original */
 #define SDSKV_REMOVE_ORIGINAL \
     1 /* for migration operations, remove the origin after migrating */
@@ -47,6 +69,13 @@ typedef uint64_t sdskv_database_id_t;
     X(SDSKV_ERR_REMI, "REMI error")                       \
     X(SDSKV_ERR_KEYEXISTS, "Key exists")                  \
     X(SDSKV_ERR_CONFIG, "Bad configuration")              \
+    X(SDSKV_ERR_READ, "Error reading from the database")  \
+    X(SDSKV_ERR_COMPRESSION, "Compression error")         \
+    X(SDSKV_ERR_FULL, "Database memory limit reached")    \
+    X(SDSKV_ERR_UNKNOWN_WATCH, "Invalid watch id")        \
+    X(SDSKV_ERR_LOG_TRUNCATED, "Changes truncated")       \
+    X(SDSKV_ERR_UNKNOWN_BACKUP, "Invalid backup")         \
+    X(SDSKV_ERR_REPLICATION, "Replication error")         \
     X(SDSKV_ERR_MAX, "End of range for valid error codes")
 
 #define X(__err__, __msg__) __err__,
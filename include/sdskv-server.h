@@ -21,6 +21,15 @@ extern "C" {
 
 typedef struct sdskv_server_context_t* sdskv_provider_t;
 typedef int (*sdskv_compare_fn)(const void*, hg_size_t, const void*, hg_size_t);
+/* shortens start in place into a key k such that start <= k < limit,
+ * returns the new size of start (its size if left unchanged) */
+typedef hg_size_t (*sdskv_shortest_separator_fn)(void*       start,
+                                                 hg_size_t   start_size,
+                                                 const void* limit,
+                                                 hg_size_t   limit_size);
+/* shortens key in place into a key k such that k >= key,
+ * returns the new size of key (its size if left unchanged) */
+typedef hg_size_t (*sdskv_short_successor_fn)(void* key, hg_size_t key_size);
 
 typedef struct sdskv_config_t {
     const char*     db_name; // name of the database
@@ -81,6 +90,33 @@ int sdskv_provider_register(margo_instance_id                      mid,
  */
 char* sdskv_provider_get_config(sdskv_provider_t provider);
 
+/**
+ * @brief Obtain a JSON string with the provider's RPC statistics
+ * (see sdskv_get_statistics). The string must be freed by the caller.
+ *
+ */
+char* sdskv_provider_get_statistics(sdskv_provider_t provider);
+
+/**
+ * @brief Obtain a JSON string with the provider's log of slow RPCs
+ * (see sdskv_get_slow_ops). The string must be freed by the caller.
+ *
+ * @param[in] provider provider
+ * @param[in] clear whether to empty the log
+ */
+char* sdskv_provider_get_slow_ops(sdskv_provider_t provider, int clear);
+
+/**
+ * @brief Writes the spans of the recently traced requests to a Chrome trace
+ * file and empties the provider's trace buffer (see sdskv_flush_trace).
+ *
+ * @param[in] provider provider
+ * @param[in] filename file to write, or NULL to use the configured one
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_flush_trace(sdskv_provider_t provider, const char* filename);
+
 /**
  * @brief Obtain underlying margo identifier
  */
@@ -119,6 +155,25 @@ int sdskv_provider_add_comparison_function(sdskv_provider_t provider,
 int sdskv_provider_find_comparison_function(sdskv_provider_t provider,
                                             const char*      library,
                                             const char*      function_name);
+
+/**
+ * @brief Registers the key-shortening functions matching a comparison
+ * function previously registered under the same name. Backends that build
+ * index blocks (LevelDB) use them to store shorter separator keys. Without
+ * them, databases using a custom comparison function keep full-length keys.
+ *
+ * @param provider provider
+ * @param function_name name of the comparison function
+ * @param separator_fn shortest separator function (can be NULL)
+ * @param successor_fn short successor function (can be NULL)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_add_key_shortening_functions(
+    sdskv_provider_t            provider,
+    const char*                 function_name,
+    sdskv_shortest_separator_fn separator_fn,
+    sdskv_short_successor_fn    successor_fn);
 /**
  * Makes the provider start managing a database. The database will
  * be created if it does not exist. Otherwise, the provider will start
@@ -156,6 +211,46 @@ int sdskv_provider_remove_database(sdskv_provider_t    provider,
  */
 int sdskv_provider_remove_all_databases(sdskv_provider_t provider);
 
+/**
+ * Adds a backup to a database: a database of another provider, which is
+ * populated with a copy of the database, then sent its puts and erasures
+ * in the order they are made. The writes to the database wait for a sync
+ * backup to apply them, and for an async backup to lag by at most the
+ * "max_lag" of the provider's "replication" configuration.
+ *
+ * @param provider provider
+ * @param db_id id of the database
+ * @param backup_addr address of the backup's provider
+ * @param backup_provider_id id of the backup's provider
+ * @param backup_db_id id of the backup in its provider
+ * @param sync whether writes wait for the backup to apply them
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_add_backup(sdskv_provider_t    provider,
+                              sdskv_database_id_t db_id,
+                              const char*         backup_addr,
+                              uint16_t            backup_provider_id,
+                              sdskv_database_id_t backup_db_id,
+                              int                 sync);
+
+/**
+ * Stops sending the writes to a database to one of its backups.
+ *
+ * @param provider provider
+ * @param db_id id of the database
+ * @param backup_addr address of the backup's provider
+ * @param backup_provider_id id of the backup's provider
+ * @param backup_db_id id of the backup in its provider
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_remove_backup(sdskv_provider_t    provider,
+                                 sdskv_database_id_t db_id,
+                                 const char*         backup_addr,
+                                 uint16_t            backup_provider_id,
+                                 sdskv_database_id_t backup_db_id);
+
 /**
  * Returns the number of databases that this provider manages.
  *
@@ -109,6 +109,22 @@ class provider {
         _CHECK_RET(ret);
     }
 
+    /**
+     * @brief Add key-shortening functions for a comparison function.
+     *
+     * @param name Name of the comparison function.
+     * @param separator_fn Shortest separator function pointer.
+     * @param successor_fn Short successor function pointer.
+     */
+    void add_key_shortening_functions(const std::string&          name,
+                                      sdskv_shortest_separator_fn separator_fn,
+                                      sdskv_short_successor_fn    successor_fn)
+    {
+        int ret = sdskv_provider_add_key_shortening_functions(
+            m_provider, name.c_str(), separator_fn, successor_fn);
+        _CHECK_RET(ret);
+    }
+
     /**
      * @brief Attach a database and returns the database id.
      *
@@ -4,6 +4,7 @@
 #define bulk_h
 
 #include <stddef.h>
+#include <stdint.h>
 #include "kv-config.h"
 //#include <boost/functional/hash.hpp>
 #include <vector>
@@ -23,6 +24,18 @@ struct ds_bulk_hash {
     }
 };
 
+// 64-bit FNV-1a of a key, used to sample, summarize, and filter keys
+inline uint64_t ds_hash_key(const void* key, size_t ksize)
+{
+    const unsigned char* p = (const unsigned char*)key;
+    uint64_t             h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < ksize; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
 struct ds_bulk_equal {
     bool operator()(const ds_bulk_t& v1, const ds_bulk_t& v2) const
     {
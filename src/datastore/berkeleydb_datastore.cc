@@ -27,11 +27,23 @@ BerkeleyDBDataStore::BerkeleyDBDataStore(bool eraseOnGet, bool debug)
 
 BerkeleyDBDataStore::~BerkeleyDBDataStore()
 {
+    _key_filter.detach();
     //  delete _dbm;
     delete _wrapper;
     delete _dbenv;
 };
 
+bool BerkeleyDBDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry (all optional):
+     * {
+     *    "key_filter" : { ... }  (in-memory filters, see KeyFilter)
+     * }
+     **/
+    return _key_filter.configure(config);
+}
+
 bool BerkeleyDBDataStore::openDatabase(const std::string& db_name,
                                        const std::string& db_path)
 {
@@ -126,6 +138,22 @@ bool BerkeleyDBDataStore::openDatabase(const std::string& db_name,
             std::cerr << "status = " << status << std::endl;
         }
     }
+    if (status == 0) {
+        _key_filter.attach([this](const KeyFilter::key_fn& fn) {
+            Dbc* cursorp;
+            Dbt  key, data;
+            if (_dbm->cursor(NULL, &cursorp, 0) != 0) return;
+            key.set_flags(DB_DBT_REALLOC);
+            /* only the keys are needed */
+            data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+            data.set_ulen(0);
+            data.set_dlen(0);
+            while (cursorp->get(&key, &data, DB_NEXT) == 0)
+                fn(key.get_data(), key.get_size());
+            free(key.get_data());
+            cursorp->close();
+        });
+    }
     return (status == 0);
 };
 
@@ -149,7 +177,10 @@ int BerkeleyDBDataStore::put(const void* key,
     db_data.set_flags(DB_DBT_USERMEM);
     int flag = _no_overwrite ? DB_NOOVERWRITE : 0;
     status   = _dbm->put(NULL, &db_key, &db_data, flag);
-    if (status == 0) return SDSKV_SUCCESS;
+    if (status == 0) {
+        _key_filter.add(key, ksize);
+        return SDSKV_SUCCESS;
+    }
     if (status == DB_KEYEXIST) return SDSKV_ERR_KEYEXISTS;
     return SDSKV_ERR_PUT;
 };
@@ -194,13 +225,153 @@ int BerkeleyDBDataStore::put_multi(hg_size_t          num_items,
     int flag = DB_MULTIPLE;
     if (!_no_overwrite) flag |= DB_OVERWRITE_DUP;
     int status = _dbm->put(NULL, &mkey, &mdata, flag);
+    /* a failed bulk put may have written some of the keys */
+    for (hg_size_t i = 0; i < num_items; i++)
+        _key_filter.add(keys[i], ksizes[i]);
     if (status == DB_KEYEXIST) return SDSKV_ERR_KEYEXISTS;
     if (status != 0) return SDSKV_ERR_PUT;
     return SDSKV_SUCCESS;
 }
 
+/* only the requested bytes are read, using a partial DBT */
+bool BerkeleyDBDataStore::get_range_view(const void*    key,
+                                         hg_size_t      ksize,
+                                         hg_size_t      offset,
+                                         hg_size_t      size,
+                                         const view_fn& fn)
+{
+    if (_eraseOnGet)
+        return AbstractDataStore::get_range_view(key, ksize, offset, size, fn);
+    if (_comp_fun_name.empty() && !_key_filter.may_contain(key, ksize))
+        return false;
+    std::vector<char> buffer(size);
+    Dbt               db_key((void*)key, ksize);
+    Dbt               db_data;
+    db_key.set_flags(DB_DBT_USERMEM);
+    db_data.set_data(buffer.data());
+    db_data.set_ulen(size);
+    db_data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+    db_data.set_doff(offset);
+    db_data.set_dlen(size);
+    int status = _dbm->get(NULL, &db_key, &db_data, 0);
+    if (status != 0) return false;
+    fn(buffer.data(), db_data.get_size());
+    return true;
+}
+
+/* only the written bytes are sent to BerkeleyDB, which pads the value with
+ * zeros if it is shorter than offset */
+int BerkeleyDBDataStore::put_range(const ds_bulk_t& key,
+                                   hg_size_t        offset,
+                                   const void*      data,
+                                   hg_size_t        size)
+{
+    /* partial DBTs have 32-bit offsets and lengths */
+    if (size > UINT32_MAX || offset > UINT32_MAX - size) return SDSKV_ERR_SIZE;
+    Dbt db_key((void*)key.data(), key.size());
+    Dbt db_data((void*)data, size);
+    db_key.set_flags(DB_DBT_USERMEM);
+    db_data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+    db_data.set_doff(offset);
+    db_data.set_dlen(size);
+    int flag   = _no_overwrite ? DB_NOOVERWRITE : 0;
+    int status = _dbm->put(NULL, &db_key, &db_data, flag);
+    if (status == 0) {
+        _key_filter.add(key.data(), key.size());
+        return SDSKV_SUCCESS;
+    }
+    if (status == DB_KEYEXIST) return SDSKV_ERR_KEYEXISTS;
+    return SDSKV_ERR_PUT;
+}
+
+/* the chunks are read with partial DBTs within a transaction, whose read
+ * lock keeps the value consistent from one chunk to the next */
+bool BerkeleyDBDataStore::get_stream(const void*          key,
+                                     hg_size_t            ksize,
+                                     hg_size_t            chunk_size,
+                                     const chunk_sink_fn& fn)
+{
+    if (_eraseOnGet)
+        return AbstractDataStore::get_stream(key, ksize, chunk_size, fn);
+    if (_comp_fun_name.empty() && !_key_filter.may_contain(key, ksize))
+        return false;
+    DbTxn* txn;
+    if (_dbenv->txn_begin(NULL, &txn, 0) != 0) return false;
+    Dbt db_key((void*)key, ksize);
+    Dbt db_data;
+    db_key.set_flags(DB_DBT_USERMEM);
+    /* a zero-length buffer makes BerkeleyDB report the size of the value */
+    db_data.set_flags(DB_DBT_USERMEM);
+    db_data.set_ulen(0);
+    int status = _dbm->get(txn, &db_key, &db_data, 0);
+    if (status != 0 && status != DB_BUFFER_SMALL) {
+        txn->abort();
+        return false;
+    }
+    hg_size_t         vsize = db_data.get_size();
+    std::vector<char> buffer(std::min(chunk_size, vsize));
+    hg_size_t         offset = 0;
+    do {
+        hg_size_t size = std::min(chunk_size, vsize - offset);
+        db_data.set_data(buffer.data());
+        db_data.set_ulen(size);
+        db_data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+        db_data.set_doff(offset);
+        db_data.set_dlen(size);
+        if (size && _dbm->get(txn, &db_key, &db_data, 0) != 0) break;
+        if (!fn(vsize, buffer.data(), size)) break;
+        offset += size;
+    } while (offset < vsize);
+    txn->commit(0);
+    return true;
+}
+
+/* the first chunk replaces the value and the next ones are appended with
+ * partial DBTs, in a single transaction so that readers never see a value
+ * that is partially written */
+int BerkeleyDBDataStore::put_stream(const ds_bulk_t&       key,
+                                    hg_size_t              vsize,
+                                    const chunk_source_fn& next)
+{
+    DbTxn* txn;
+    if (_dbenv->txn_begin(NULL, &txn, 0) != 0) return SDSKV_ERR_PUT;
+    Dbt       db_key((void*)key.data(), key.size());
+    hg_size_t offset = 0;
+    int       status = 0;
+    do {
+        hg_size_t   size  = 0;
+        const void* chunk = vsize ? next(size) : "";
+        if (!chunk || size > vsize - offset || (vsize && size == 0)) {
+            txn->abort();
+            return SDSKV_ERR_PUT;
+        }
+        Dbt db_data((void*)chunk, size);
+        int flag = 0;
+        if (offset == 0) {
+            flag = _no_overwrite ? DB_NOOVERWRITE : 0;
+        } else {
+            db_data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+            db_data.set_doff(offset);
+            db_data.set_dlen(size);
+        }
+        status = _dbm->put(txn, &db_key, &db_data, flag);
+        if (status != 0) break;
+        offset += size;
+    } while (offset < vsize);
+    if (status != 0) {
+        txn->abort();
+        return status == DB_KEYEXIST ? SDSKV_ERR_KEYEXISTS : SDSKV_ERR_PUT;
+    }
+    status = txn->commit(0);
+    if (status == 0) _key_filter.add(key.data(), key.size());
+    return status == 0 ? SDSKV_SUCCESS : SDSKV_ERR_PUT;
+}
+
 bool BerkeleyDBDataStore::exists(const void* key, hg_size_t size) const
 {
+    /* keys are only compared byte-wise by the filter */
+    if (_comp_fun_name.empty() && !_key_filter.may_contain(key, size))
+        return false;
     Dbt db_key((void*)key, size);
     db_key.set_flags(DB_DBT_USERMEM);
     int status = _dbm->exists(NULL, &db_key, 0);
@@ -211,9 +382,157 @@ bool BerkeleyDBDataStore::erase(const ds_bulk_t& key)
 {
     Dbt db_key((void*)key.data(), key.size());
     int status = _dbm->del(NULL, &db_key, 0);
+    if (status == 0) _key_filter.erased();
     return status == 0;
 }
 
+/* the keys are deleted with a cursor, in transactions of at most
+ * erase_batch_size keys so that large ranges do not exhaust the locks */
+int BerkeleyDBDataStore::erase_range(const ds_bulk_t& lower,
+                                     const ds_bulk_t& upper,
+                                     hg_size_t*       num_erased)
+{
+    Dbt       upper_key((void*)upper.data(), upper.size());
+    ds_bulk_t from = lower;
+    bool      done = false;
+
+    *num_erased = 0;
+    while (!done) {
+        DbTxn* txn;
+        Dbc*   cursorp;
+        if (_dbenv->txn_begin(NULL, &txn, 0) != 0) return SDSKV_ERR_ERASE;
+        if (_dbm->cursor(txn, &cursorp, 0) != 0) {
+            txn->abort();
+            return SDSKV_ERR_ERASE;
+        }
+        /* the key is reallocated by the cursor, so it starts as a copy */
+        Dbt key, data;
+        key.set_data(malloc(from.size() + 1));
+        key.set_size(from.size());
+        key.set_flags(DB_DBT_REALLOC);
+        if (from.size()) memcpy(key.get_data(), from.data(), from.size());
+        /* only the keys are needed */
+        data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+        data.set_ulen(0);
+        data.set_dlen(0);
+
+        hg_size_t n   = 0;
+        int       ret = cursorp->get(&key, &data,
+                               from.size() ? DB_SET_RANGE : DB_FIRST);
+        done          = true;
+        while (ret == 0) {
+            if (upper.size()
+                && compkeys(_dbm, &key, &upper_key, nullptr) >= 0)
+                break;
+            if (n == erase_batch_size) {
+                /* continue from this key in a new transaction */
+                from.assign((char*)key.get_data(),
+                            (char*)key.get_data() + key.get_size());
+                done = false;
+                break;
+            }
+            ret = cursorp->del(0);
+            if (ret != 0) break;
+            n += 1;
+            ret = cursorp->get(&key, &data, DB_NEXT);
+        }
+        free(key.get_data());
+        cursorp->close();
+        if (ret != 0 && ret != DB_NOTFOUND) {
+            txn->abort();
+            return SDSKV_ERR_ERASE;
+        }
+        if (txn->commit(0) != 0) return SDSKV_ERR_ERASE;
+        _key_filter.erased(n);
+        *num_erased += n;
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* the value is read with a write lock (DB_RMW) so that concurrent updates of
+ * the same key are serialized; transactions chosen by the deadlock detector
+ * are retried */
+int BerkeleyDBDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    Dbt db_key((void*)key.data(), key.size());
+    while (true) {
+        DbTxn* txn;
+        if (_dbenv->txn_begin(NULL, &txn, 0) != 0) return SDSKV_ERR_PUT;
+        Dbt db_data;
+        db_data.set_flags(DB_DBT_MALLOC);
+        int status = _dbm->get(txn, &db_key, &db_data, DB_RMW);
+        if (status != 0 && status != DB_NOTFOUND) {
+            txn->abort();
+            if (status == DB_LOCK_DEADLOCK) continue;
+            return SDSKV_ERR_READ;
+        }
+        ds_bulk_t value, new_value;
+        bool      found = status == 0;
+        if (found) {
+            value.assign((char*)db_data.get_data(),
+                         (char*)db_data.get_data() + db_data.get_size());
+            free(db_data.get_data());
+        }
+        if (!fn(found ? &value : nullptr, new_value)) {
+            txn->abort();
+            return SDSKV_SUCCESS;
+        }
+        Dbt new_data((void*)new_value.data(), new_value.size());
+        int flag = _no_overwrite ? DB_NOOVERWRITE : 0;
+        status   = _dbm->put(txn, &db_key, &new_data, flag);
+        if (status != 0) {
+            txn->abort();
+            if (status == DB_LOCK_DEADLOCK) continue;
+            return status == DB_KEYEXIST ? SDSKV_ERR_KEYEXISTS : SDSKV_ERR_PUT;
+        }
+        status = txn->commit(0);
+        if (status == 0) _key_filter.add(key.data(), key.size());
+        return status == 0 ? SDSKV_SUCCESS : SDSKV_ERR_PUT;
+    }
+}
+
+int BerkeleyDBDataStore::count_range(const ds_bulk_t& lower,
+                                     const ds_bulk_t& upper,
+                                     bool             with_sizes,
+                                     ds_count_t&      result) const
+{
+    Dbt  upper_key((void*)upper.data(), upper.size());
+    Dbt  key, data;
+    Dbc* cursorp;
+
+    result = ds_count_t();
+    if (_dbm->cursor(NULL, &cursorp, 0) != 0) return SDSKV_ERR_READ;
+    key.set_data(malloc(lower.size() + 1));
+    key.set_size(lower.size());
+    key.set_flags(DB_DBT_REALLOC);
+    if (lower.size()) memcpy(key.get_data(), lower.data(), lower.size());
+    if (with_sizes) {
+        data.set_flags(DB_DBT_REALLOC);
+    } else {
+        /* the values do not need to be read */
+        data.set_flags(DB_DBT_USERMEM | DB_DBT_PARTIAL);
+        data.set_ulen(0);
+        data.set_dlen(0);
+    }
+
+    int ret = cursorp->get(&key, &data, lower.size() ? DB_SET_RANGE : DB_FIRST);
+    while (ret == 0) {
+        if (upper.size() && compkeys(_dbm, &key, &upper_key, nullptr) >= 0)
+            break;
+        result.num_keys += 1;
+        if (with_sizes) {
+            result.key_bytes += key.get_size();
+            result.value_bytes += data.get_size();
+        }
+        ret = cursorp->get(&key, &data, DB_NEXT);
+    }
+    free(key.get_data());
+    if (with_sizes) free(data.get_data());
+    cursorp->close();
+    if (ret != 0 && ret != DB_NOTFOUND) return SDSKV_ERR_READ;
+    return SDSKV_SUCCESS;
+}
+
 void BerkeleyDBDataStore::sync() { _dbm->sync(0); }
 
 // In the case where Duplicates::ALLOW, this will return the first
@@ -224,6 +543,9 @@ bool BerkeleyDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
     bool success = false;
 
     data.clear();
+    if (_comp_fun_name.empty()
+        && !_key_filter.may_contain(key.data(), key.size()))
+        return false;
 
     Dbt db_key((void*)&(key[0]), uint32_t(key.size()));
     db_key.set_ulen(uint32_t(key.size()));
@@ -250,6 +572,8 @@ bool BerkeleyDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
             success = false;
             // std::cerr << "BerkeleyDBDataStore::get: BerkeleyDB error on
             // delete (eraseOnGet) = " << status << std::endl;
+        } else {
+            _key_filter.erased();
         }
     }
 
@@ -282,10 +606,19 @@ std::vector<ds_bulk_t> BerkeleyDBDataStore::vlist_keys(
     Dbc*                   cursorp;
     Dbt                    key, data;
     int                    ret;
+    if (!_key_filter.may_contain_prefix(prefix)) return keys;
     _dbm->cursor(NULL, &cursorp, 0);
 
     /* 'start' is like RADOS: not inclusive  */
-    if (start.size()) {
+    if (seek_to_prefix(start, prefix)) {
+        key.set_size(prefix.size());
+        key.set_data((void*)prefix.data());
+        ret = cursorp->get(&key, &data, DB_SET_RANGE);
+        if (ret != 0) {
+            cursorp->close();
+            return keys;
+        }
+    } else if (start.size()) {
         key.set_size(start.size());
         key.set_data((void*)start.data());
         ret = cursorp->get(&key, &data, DB_SET_RANGE);
@@ -307,7 +640,7 @@ std::vector<ds_bulk_t> BerkeleyDBDataStore::vlist_keys(
      * requested key, but we want strictly greater than */
     int c = 0;
     if (k != start) {
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, k.data(), k.size());
         if (c == 0) { keys.push_back(std::move(k)); }
     }
     while (keys.size() < count && c >= 0) {
@@ -316,7 +649,7 @@ std::vector<ds_bulk_t> BerkeleyDBDataStore::vlist_keys(
 
         ds_bulk_t k((char*)key.get_data(),
                     ((char*)key.get_data()) + key.get_size());
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, k.data(), k.size());
         if (c == 0) { keys.push_back(std::move(k)); }
     }
     cursorp->close();
@@ -330,10 +663,19 @@ std::vector<std::pair<ds_bulk_t, ds_bulk_t>> BerkeleyDBDataStore::vlist_keyvals(
     Dbc*                                         cursorp;
     Dbt                                          key, data;
     int                                          ret;
+    if (!_key_filter.may_contain_prefix(prefix)) return result;
     _dbm->cursor(NULL, &cursorp, 0);
 
     /* 'start' is like RADOS: not inclusive  */
-    if (start.size()) {
+    if (seek_to_prefix(start, prefix)) {
+        key.set_size(prefix.size());
+        key.set_data((void*)prefix.data());
+        ret = cursorp->get(&key, &data, DB_SET_RANGE);
+        if (ret != 0) {
+            cursorp->close();
+            return result;
+        }
+    } else if (start.size()) {
         key.set_size(start.size());
         key.set_data((void*)start.data());
         ret = cursorp->get(&key, &data, DB_SET_RANGE);
@@ -358,7 +700,7 @@ std::vector<std::pair<ds_bulk_t, ds_bulk_t>> BerkeleyDBDataStore::vlist_keyvals(
      * requested key, but we want strictly greater than */
     int c = 0;
     if (k != start) {
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, k.data(), k.size());
         if (c == 0) {
             result.push_back(std::make_pair(std::move(k), std::move(v)));
         }
@@ -372,7 +714,7 @@ std::vector<std::pair<ds_bulk_t, ds_bulk_t>> BerkeleyDBDataStore::vlist_keyvals(
         ds_bulk_t v((char*)data.get_data(),
                     ((char*)data.get_data()) + data.get_size());
 
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, k.data(), k.size());
         if (c == 0) {
             result.push_back(std::make_pair(std::move(k), std::move(v)));
         }
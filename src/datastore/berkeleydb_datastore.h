@@ -5,6 +5,7 @@
 
 #include "kv-config.h"
 #include "datastore/datastore.h"
+#include "datastore/key_filter.h"
 #include <db_cxx.h>
 #include <dbstl_map.h>
 #include "sdskv-common.h"
@@ -32,6 +33,7 @@ class BerkeleyDBDataStore : public AbstractDataStore {
     BerkeleyDBDataStore();
     BerkeleyDBDataStore(bool eraseOnGet, bool debug);
     virtual ~BerkeleyDBDataStore();
+    virtual bool configure(const Json::Value& config) override;
     virtual bool openDatabase(const std::string& db_name,
                               const std::string& path) override;
     virtual int  put(const void* key,
@@ -46,8 +48,32 @@ class BerkeleyDBDataStore : public AbstractDataStore {
     virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
     virtual bool get(const ds_bulk_t&        key,
                      std::vector<ds_bulk_t>& data) override;
+    virtual bool get_range_view(const void*    key,
+                                hg_size_t      ksize,
+                                hg_size_t      offset,
+                                hg_size_t      size,
+                                const view_fn& fn) override;
+    virtual int  put_range(const ds_bulk_t& key,
+                           hg_size_t        offset,
+                           const void*      data,
+                           hg_size_t        size) override;
+    virtual bool get_stream(const void*          key,
+                            hg_size_t            ksize,
+                            hg_size_t            chunk_size,
+                            const chunk_sink_fn& fn) override;
+    virtual int  put_stream(const ds_bulk_t&       key,
+                            hg_size_t              vsize,
+                            const chunk_source_fn& next) override;
     virtual bool exists(const void* key, hg_size_t ksize) const override;
     virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
     virtual void
     set_in_memory(bool enable) override; // enable/disable in-memory mode
     virtual void set_comparison_function(const std::string& name,
@@ -77,6 +103,7 @@ class BerkeleyDBDataStore : public AbstractDataStore {
     DbEnv*     _dbenv   = nullptr;
     Db*        _dbm     = nullptr;
     DbWrapper* _wrapper = nullptr;
+    KeyFilter  _key_filter;
 };
 
 #endif // bdb_datastore_h
@@ -0,0 +1,605 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "cached_datastore.h"
+#include "kv-config.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/* memory taken by a cached entry beyond its key and value: the list and
+ * hash table nodes, and the shared value's control block */
+static const hg_size_t entry_overhead = 128;
+
+/* One shard of the cache, with a capacity of c bytes. ARC keeps the cached
+ * entries in two LRU lists, T1 for the keys read once since they entered
+ * the cache and T2 for those read again, and remembers the keys recently
+ * evicted from each in two "ghost" lists, B1 and B2. A miss on a ghost key
+ * grows the share of the capacity targeted for T1 (p) if it was in B1, and
+ * shrinks it if it was in B2. Sizes are counted in bytes rather than in
+ * entries, and the ghosts remember the size of their entry so that the
+ * lists are balanced in bytes. Values are shared pointers, so that they
+ * can be read after the shard's lock is released. */
+class CachedDataStore::Shard {
+
+  public:
+    Shard(hg_size_t capacity) : _capacity(capacity)
+    {
+        ABT_mutex_create(&_mutex);
+    }
+
+    ~Shard() { ABT_mutex_free(&_mutex); }
+
+    value_ptr lookup(const std::string& key, uint64_t* epoch)
+    {
+        value_ptr result;
+        ABT_mutex_lock(_mutex);
+        auto it = _index.find(key);
+        if (it != _index.end() && it->second->list <= T2) {
+            move_to(it->second, T2);
+            result = it->second->value;
+            _hits += 1;
+        } else {
+            *epoch = _epoch;
+            _misses += 1;
+        }
+        ABT_mutex_unlock(_mutex);
+        return result;
+    }
+
+    // caches the value read for key unless the key may have been modified
+    // since the epoch of the miss
+    void fill(const std::string& key, value_ptr value, uint64_t epoch)
+    {
+        hg_size_t size = key.size() + value->size() + entry_overhead;
+        if (size > _capacity / 4) return; // would flush too much of the shard
+        ABT_mutex_lock(_mutex);
+        if (epoch != _epoch) {
+            ABT_mutex_unlock(_mutex);
+            return;
+        }
+        auto it = _index.find(key);
+        if (it == _index.end()) {
+            /* the key is new: trim the ghosts of T1 and then those of T2
+             * so that ARC's bounds hold once it is added */
+            while (_bytes[T1] + _bytes[B1] + size > _capacity
+                   && !_lists[B1].empty())
+                drop(std::prev(_lists[B1].end()));
+            while (total() + size > 2 * _capacity && !_lists[B2].empty())
+                drop(std::prev(_lists[B2].end()));
+            make_room(size, false);
+            _lists[T1].push_front(entry{key, value, size, T1});
+            _bytes[T1] += size;
+            _index[key] = _lists[T1].begin();
+        } else if (it->second->list <= T2) {
+            /* filled concurrently by another reader */
+            ABT_mutex_unlock(_mutex);
+            return;
+        } else {
+            /* a ghost hit: adapt the target size of T1 */
+            bool      in_b2 = it->second->list == B2;
+            hg_size_t hit   = _bytes[in_b2 ? B2 : B1];
+            hg_size_t other = _bytes[in_b2 ? B1 : B2];
+            hg_size_t delta = std::max(size, hit ? size * other / hit : size);
+            if (in_b2)
+                _target = _target > delta ? _target - delta : 0;
+            else
+                _target = std::min(_capacity, _target + delta);
+            drop(it->second);
+            make_room(size, in_b2);
+            _lists[T2].push_front(entry{key, value, size, T2});
+            _bytes[T2] += size;
+            _index[key] = _lists[T2].begin();
+        }
+        trim_ghosts();
+        ABT_mutex_unlock(_mutex);
+    }
+
+    void invalidate(const std::string& key)
+    {
+        ABT_mutex_lock(_mutex);
+        _epoch += 1;
+        auto it = _index.find(key);
+        if (it != _index.end() && it->second->list <= T2) {
+            drop(it->second);
+            _invalidations += 1;
+        }
+        ABT_mutex_unlock(_mutex);
+    }
+
+    void clear()
+    {
+        ABT_mutex_lock(_mutex);
+        _epoch += 1;
+        _invalidations += _lists[T1].size() + _lists[T2].size();
+        for (auto& l : _lists) l.clear();
+        for (auto& b : _bytes) b = 0;
+        _index.clear();
+        _target = 0;
+        ABT_mutex_unlock(_mutex);
+    }
+
+    void add_usage(ds_cache_t& usage) const
+    {
+        ABT_mutex_lock(_mutex);
+        usage.used_bytes += _bytes[T1] + _bytes[T2];
+        usage.max_bytes += _capacity;
+        usage.hits += _hits;
+        usage.misses += _misses;
+        usage.evictions += _evictions;
+        usage.invalidations += _invalidations;
+        ABT_mutex_unlock(_mutex);
+    }
+
+  private:
+    enum list_id { T1 = 0, T2 = 1, B1 = 2, B2 = 3 };
+
+    struct entry {
+        std::string key;
+        value_ptr   value; // null in the ghost lists
+        hg_size_t   size;
+        list_id     list;
+    };
+    typedef std::list<entry>::iterator entry_it;
+
+    hg_size_t total() const
+    {
+        return _bytes[T1] + _bytes[T2] + _bytes[B1] + _bytes[B2];
+    }
+
+    void move_to(entry_it e, list_id list)
+    {
+        _bytes[e->list] -= e->size;
+        _lists[list].splice(_lists[list].begin(), _lists[e->list], e);
+        e->list = list;
+        _bytes[list] += e->size;
+    }
+
+    void drop(entry_it e)
+    {
+        _bytes[e->list] -= e->size;
+        _index.erase(e->key);
+        _lists[e->list].erase(e);
+    }
+
+    // ARC's replace: evicts the LRU entries of T1 or T2 into their ghost
+    // list until size more bytes fit in the cache
+    void make_room(hg_size_t size, bool in_b2)
+    {
+        while (_bytes[T1] + _bytes[T2] + size > _capacity
+               && !(_lists[T1].empty() && _lists[T2].empty())) {
+            bool from_t1 = !_lists[T1].empty()
+                        && (_bytes[T1] > _target
+                            || (in_b2 && _bytes[T1] == _target)
+                            || _lists[T2].empty());
+            auto e       = std::prev(_lists[from_t1 ? T1 : T2].end());
+            e->value.reset();
+            move_to(e, from_t1 ? B1 : B2);
+            _evictions += 1;
+        }
+    }
+
+    // the ghosts remember at most the capacity of the shard
+    void trim_ghosts()
+    {
+        while (_bytes[B1] + _bytes[B2] > _capacity) {
+            list_id l = _bytes[B1] > _bytes[B2] ? B1 : B2;
+            drop(std::prev(_lists[l].end()));
+        }
+    }
+
+    hg_size_t                                 _capacity;
+    hg_size_t                                 _target = 0; // for T1, p in ARC
+    std::list<entry>                          _lists[4];
+    hg_size_t                                 _bytes[4] = {0, 0, 0, 0};
+    std::unordered_map<std::string, entry_it> _index;
+    uint64_t                                  _epoch         = 0;
+    uint64_t                                  _hits          = 0;
+    uint64_t                                  _misses        = 0;
+    uint64_t                                  _evictions     = 0;
+    uint64_t                                  _invalidations = 0;
+    mutable ABT_mutex                         _mutex         = ABT_MUTEX_NULL;
+};
+
+/* the keys evicted by the inner datastore are dropped from the cache */
+CachedDataStore::CachedDataStore(AbstractDataStore* inner)
+    : AbstractDataStore(false, false), _inner(inner)
+{
+    _inner->set_eviction_handler([this](const void* key, hg_size_t ksize) {
+        invalidate(key, ksize);
+        if (_on_evicted) _on_evicted(key, ksize);
+    });
+}
+
+CachedDataStore::~CachedDataStore() {}
+
+bool CachedDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry:
+     * "cache" : {
+     *    "size" : <bytes>,   (required, total capacity of the cache)
+     *    "shards" : <int>    (default 16, number of independently locked
+     *                         parts of the cache)
+     * }
+     **/
+    const Json::Value& cfg = config["cache"];
+    if (!cfg.isObject()) {
+        std::cerr << "CachedDataStore::configure: \"cache\" should"
+                  << " be an object" << std::endl;
+        return false;
+    }
+    if (!cfg["size"].isUInt64() || cfg["size"].asUInt64() == 0) {
+        std::cerr << "CachedDataStore::configure: \"size\" should"
+                  << " be a positive integer" << std::endl;
+        return false;
+    }
+    Json::Value shards = cfg.get("shards", 16);
+    if (!shards.isUInt() || shards.asUInt() == 0) {
+        std::cerr << "CachedDataStore::configure: \"shards\" should"
+                  << " be a positive integer" << std::endl;
+        return false;
+    }
+    hg_size_t shard_size = cfg["size"].asUInt64() / shards.asUInt();
+    _shards.clear();
+    for (unsigned i = 0; i < shards.asUInt(); i++)
+        _shards.emplace_back(new Shard(shard_size));
+    return true;
+}
+
+/* the inner datastore is already open */
+bool CachedDataStore::openDatabase(const std::string& db_name,
+                                   const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+    return true;
+}
+
+CachedDataStore::Shard& CachedDataStore::shard_of(const std::string& key) const
+{
+    return *_shards[std::hash<std::string>()(key) % _shards.size()];
+}
+
+CachedDataStore::value_ptr
+CachedDataStore::lookup(const void* key, hg_size_t ksize, uint64_t* epoch) const
+{
+    std::string k((const char*)key, ksize);
+    return shard_of(k).lookup(k, epoch);
+}
+
+void CachedDataStore::fill(const void* key,
+                           hg_size_t   ksize,
+                           value_ptr   value,
+                           uint64_t    epoch) const
+{
+    std::string k((const char*)key, ksize);
+    shard_of(k).fill(k, std::move(value), epoch);
+}
+
+void CachedDataStore::invalidate(const void* key, hg_size_t ksize)
+{
+    std::string k((const char*)key, ksize);
+    shard_of(k).invalidate(k);
+}
+
+void CachedDataStore::invalidate_all()
+{
+    for (auto& shard : _shards) shard->clear();
+}
+
+int CachedDataStore::put(const void* key,
+                         hg_size_t   ksize,
+                         const void* value,
+                         hg_size_t   vsize)
+{
+    int ret = _inner->put(key, ksize, value, vsize);
+    invalidate(key, ksize);
+    return ret;
+}
+
+int CachedDataStore::put(ds_bulk_t&& key, ds_bulk_t&& data)
+{
+    std::string k(key.data(), key.size());
+    int         ret = _inner->put(std::move(key), std::move(data));
+    shard_of(k).invalidate(k);
+    return ret;
+}
+
+int CachedDataStore::put_multi(hg_size_t          num_items,
+                               const void* const* keys,
+                               const hg_size_t*   ksizes,
+                               const void* const* values,
+                               const hg_size_t*   vsizes)
+{
+    int ret = _inner->put_multi(num_items, keys, ksizes, values, vsizes);
+    for (hg_size_t i = 0; i < num_items; i++) invalidate(keys[i], ksizes[i]);
+    return ret;
+}
+
+int CachedDataStore::put_packed(hg_size_t        num_items,
+                                const char*      keys,
+                                const hg_size_t* ksizes,
+                                const char*      values,
+                                const hg_size_t* vsizes)
+{
+    int ret = _inner->put_packed(num_items, keys, ksizes, values, vsizes);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        invalidate(keys, ksizes[i]);
+        keys += ksizes[i];
+    }
+    return ret;
+}
+
+bool CachedDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    uint64_t epoch;
+    auto     value = lookup(key.data(), key.size(), &epoch);
+    if (value) {
+        data = *value;
+        return true;
+    }
+    if (!_inner->get(key, data)) return false;
+    fill(key.data(), key.size(), std::make_shared<const ds_bulk_t>(data),
+         epoch);
+    return true;
+}
+
+/* used by databases allowing duplicate keys, which are not cached */
+bool CachedDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    return _inner->get(key, data);
+}
+
+bool CachedDataStore::get_view(const void*    key,
+                               hg_size_t      ksize,
+                               const view_fn& fn)
+{
+    uint64_t epoch;
+    auto     value = lookup(key, ksize, &epoch);
+    if (value) {
+        fn(value->data(), value->size());
+        return true;
+    }
+    bool found
+        = _inner->get_view(key, ksize, [&](const void* data, hg_size_t size) {
+              const char* begin = (const char*)data;
+              value = std::make_shared<const ds_bulk_t>(begin, begin + size);
+              fn(data, size);
+          });
+    if (found) fill(key, ksize, std::move(value), epoch);
+    return found;
+}
+
+/* the keys missing from the cache are read from the inner datastore in a
+ * single call, then fn is called in the order of the keys */
+void CachedDataStore::get_multi_view(hg_size_t            num_keys,
+                                     const void* const*   keys,
+                                     const hg_size_t*     ksizes,
+                                     const multi_view_fn& fn)
+{
+    std::vector<value_ptr>   values(num_keys);
+    std::vector<uint64_t>    epochs(num_keys);
+    std::vector<hg_size_t>   missing;
+    std::vector<const void*> missing_keys;
+    std::vector<hg_size_t>   missing_ksizes;
+    for (hg_size_t i = 0; i < num_keys; i++) {
+        values[i] = lookup(keys[i], ksizes[i], &epochs[i]);
+        if (values[i]) continue;
+        missing.push_back(i);
+        missing_keys.push_back(keys[i]);
+        missing_ksizes.push_back(ksizes[i]);
+    }
+    if (!missing.empty()) {
+        _inner->get_multi_view(
+            missing.size(), missing_keys.data(), missing_ksizes.data(),
+            [&](hg_size_t j, const void* data, hg_size_t size) {
+                hg_size_t i = missing[j];
+                values[i]   = std::make_shared<const ds_bulk_t>(
+                    (const char*)data, (const char*)data + size);
+                fill(keys[i], ksizes[i], values[i], epochs[i]);
+            });
+    }
+    for (hg_size_t i = 0; i < num_keys; i++)
+        if (values[i]) fn(i, values[i]->data(), values[i]->size());
+}
+
+/* partial reads are served from the cache but do not fill it, so that
+ * large values read in pieces do not evict the rest of the cache */
+bool CachedDataStore::get_range_view(const void*    key,
+                                     hg_size_t      ksize,
+                                     hg_size_t      offset,
+                                     hg_size_t      size,
+                                     const view_fn& fn)
+{
+    uint64_t epoch;
+    auto     value = lookup(key, ksize, &epoch);
+    if (!value) return _inner->get_range_view(key, ksize, offset, size, fn);
+    hg_size_t start = std::min(offset, (hg_size_t)value->size());
+    fn(value->data() + start, std::min(size, value->size() - start));
+    return true;
+}
+
+bool CachedDataStore::get_stream(const void*          key,
+                                 hg_size_t            ksize,
+                                 hg_size_t            chunk_size,
+                                 const chunk_sink_fn& fn)
+{
+    uint64_t epoch;
+    auto     value = lookup(key, ksize, &epoch);
+    if (!value) return _inner->get_stream(key, ksize, chunk_size, fn);
+    hg_size_t vsize = value->size();
+    if (vsize == 0) {
+        fn(0, value->data(), 0);
+        return true;
+    }
+    for (hg_size_t offset = 0; offset < vsize; offset += chunk_size) {
+        if (!fn(vsize, value->data() + offset,
+                std::min(chunk_size, vsize - offset)))
+            break;
+    }
+    return true;
+}
+
+bool CachedDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    uint64_t epoch;
+    auto     value = lookup(key.data(), key.size(), &epoch);
+    if (!value) return _inner->length(key, vsize);
+    *vsize = value->size();
+    return true;
+}
+
+bool CachedDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    uint64_t epoch;
+    if (lookup(key, ksize, &epoch)) return true;
+    return _inner->exists(key, ksize);
+}
+
+bool CachedDataStore::erase(const ds_bulk_t& key)
+{
+    bool ret = _inner->erase(key);
+    invalidate(key.data(), key.size());
+    return ret;
+}
+
+int CachedDataStore::erase_range(const ds_bulk_t& lower,
+                                 const ds_bulk_t& upper,
+                                 hg_size_t*       num_erased)
+{
+    int ret = _inner->erase_range(lower, upper, num_erased);
+    invalidate_all();
+    return ret;
+}
+
+int CachedDataStore::erase_prefixed(const ds_bulk_t& prefix,
+                                    hg_size_t*       num_erased)
+{
+    int ret = _inner->erase_prefixed(prefix, num_erased);
+    invalidate_all();
+    return ret;
+}
+
+int CachedDataStore::count_range(const ds_bulk_t& lower,
+                                 const ds_bulk_t& upper,
+                                 bool             with_sizes,
+                                 ds_count_t&      result) const
+{
+    return _inner->count_range(lower, upper, with_sizes, result);
+}
+
+int CachedDataStore::count_prefixed(const ds_bulk_t& prefix,
+                                    bool             with_sizes,
+                                    ds_count_t&      result) const
+{
+    return _inner->count_prefixed(prefix, with_sizes, result);
+}
+
+int CachedDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    int ret = _inner->update(key, fn);
+    invalidate(key.data(), key.size());
+    return ret;
+}
+
+int CachedDataStore::put_range(const ds_bulk_t& key,
+                               hg_size_t        offset,
+                               const void*      data,
+                               hg_size_t        size)
+{
+    int ret = _inner->put_range(key, offset, data, size);
+    invalidate(key.data(), key.size());
+    return ret;
+}
+
+int CachedDataStore::put_stream(const ds_bulk_t&       key,
+                                hg_size_t              vsize,
+                                const chunk_source_fn& next)
+{
+    int ret = _inner->put_stream(key, vsize, next);
+    invalidate(key.data(), key.size());
+    return ret;
+}
+
+void CachedDataStore::set_in_memory(bool enable)
+{
+    _inner->set_in_memory(enable);
+}
+
+void CachedDataStore::set_comparison_function(const std::string& name,
+                                              comparator_fn      less)
+{
+    _comp_fun_name = name;
+    _inner->set_comparison_function(name, less);
+}
+
+void CachedDataStore::set_key_shortening_functions(separator_fn separator,
+                                                   successor_fn successor)
+{
+    _inner->set_key_shortening_functions(separator, successor);
+}
+
+void CachedDataStore::set_no_overwrite()
+{
+    _no_overwrite = true;
+    _inner->set_no_overwrite();
+}
+
+void CachedDataStore::sync() { _inner->sync(); }
+
+int CachedDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    return _inner->compact(lower, upper);
+}
+
+bool CachedDataStore::memory_usage(ds_memory_t& usage) const
+{
+    return _inner->memory_usage(usage);
+}
+
+bool CachedDataStore::cache_usage(ds_cache_t& usage) const
+{
+    usage = ds_cache_t();
+    for (const auto& shard : _shards) shard->add_usage(usage);
+    return true;
+}
+
+std::vector<ds_bulk_t> CachedDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    return _inner->list_keys(start, count, prefix);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+CachedDataStore::vlist_keyvals(const ds_bulk_t& start,
+                               hg_size_t        count,
+                               const ds_bulk_t& prefix) const
+{
+    return _inner->list_keyvals(start, count, prefix);
+}
+
+std::vector<ds_bulk_t>
+CachedDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                 const ds_bulk_t& upper_bound,
+                                 hg_size_t        max_keys) const
+{
+    return _inner->list_key_range(lower_bound, upper_bound, max_keys);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+CachedDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                    const ds_bulk_t& upper_bound,
+                                    hg_size_t        max_keys) const
+{
+    return _inner->list_keyval_range(lower_bound, upper_bound, max_keys);
+}
+
+#ifdef USE_REMI
+remi_fileset_t CachedDataStore::create_and_populate_fileset() const
+{
+    return _inner->create_and_populate_fileset();
+}
+#endif
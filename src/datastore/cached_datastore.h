@@ -0,0 +1,135 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef cached_datastore_h
+#define cached_datastore_h
+
+#include <memory>
+#include <vector>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// datastore caching the decoded values of another datastore, which it
+// owns, in memory. The cache is split in shards by hash of the key, each
+// with its own lock and an equal share of the capacity, and each replacing
+// its entries with ARC (adaptive replacement cache), which keeps both the
+// recently and the frequently read keys. Writes go to the inner datastore
+// and then invalidate the keys they modify; erasures of ranges of keys
+// empty the cache.
+class CachedDataStore : public AbstractDataStore {
+
+  public:
+    CachedDataStore(AbstractDataStore* inner);
+    virtual ~CachedDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put(ds_bulk_t&& key, ds_bulk_t&& data) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool
+    get_view(const void* key, hg_size_t ksize, const view_fn& fn) override;
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn) override;
+    virtual bool get_range_view(const void*    key,
+                                hg_size_t      ksize,
+                                hg_size_t      offset,
+                                hg_size_t      size,
+                                const view_fn& fn) override;
+    virtual bool get_stream(const void*          key,
+                            hg_size_t            ksize,
+                            hg_size_t            chunk_size,
+                            const chunk_sink_fn& fn) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  erase_prefixed(const ds_bulk_t& prefix,
+                                hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual int  count_prefixed(const ds_bulk_t& prefix,
+                                bool             with_sizes,
+                                ds_count_t&      result) const override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  put_range(const ds_bulk_t& key,
+                           hg_size_t        offset,
+                           const void*      data,
+                           hg_size_t        size) override;
+    virtual int  put_stream(const ds_bulk_t&       key,
+                            hg_size_t              vsize,
+                            const chunk_source_fn& next) override;
+    virtual void set_in_memory(bool enable) override;
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
+    virtual void set_no_overwrite() override;
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+    virtual bool memory_usage(ds_memory_t& usage) const override;
+    virtual bool cache_usage(ds_cache_t& usage) const override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+  private:
+    class Shard;
+    typedef std::shared_ptr<const ds_bulk_t> value_ptr;
+
+    Shard& shard_of(const std::string& key) const;
+    // returns the cached value of key, if any, and otherwise sets epoch to
+    // the value to give to fill once the value is read
+    value_ptr lookup(const void* key, hg_size_t ksize, uint64_t* epoch) const;
+    void      fill(const void* key,
+                   hg_size_t   ksize,
+                   value_ptr   value,
+                   uint64_t    epoch) const;
+    void      invalidate(const void* key, hg_size_t ksize);
+    void      invalidate_all();
+
+    std::unique_ptr<AbstractDataStore>  _inner;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+#endif // cached_datastore_h
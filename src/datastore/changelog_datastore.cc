@@ -0,0 +1,277 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "changelog_datastore.h"
+#include "kv-config.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+// the changes are stored under their sequence number in big-endian order,
+// 7 bits per byte so that the log sorts in the order of the changes whether
+// its backend compares bytes as unsigned or signed chars, and followed by a
+// key sorting after all of them, which holds the last sequence number
+// reserved and the last one truncated
+static const hg_size_t seq_key_size = 10; // 7-bit digits of a uint64_t
+static const ds_bulk_t meta_key(seq_key_size + 1, (char)0x7f);
+
+static ds_bulk_t seq_key(uint64_t seq)
+{
+    ds_bulk_t key(seq_key_size);
+    for (hg_size_t i = 0; i < seq_key_size; i++)
+        key[i] = (char)((seq >> (7 * (seq_key_size - 1 - i))) & 0x7f);
+    return key;
+}
+
+static uint64_t key_seq(const ds_bulk_t& key)
+{
+    uint64_t seq = 0;
+    for (hg_size_t i = 0; i < seq_key_size; i++)
+        seq = (seq << 7) | (key[i] & 0x7f);
+    return seq;
+}
+
+// appends the changes reported by the WatchedDataStore to the log; changed
+// is called with the order lock of the WatchedDataStore held
+class ChangeLogDataStore::Recorder : public ChangeListener {
+
+  public:
+    Recorder(AbstractDataStore* log) : _log(log)
+    {
+        ABT_mutex_create(&_meta_mutex);
+    }
+    ~Recorder() { ABT_mutex_free(&_meta_mutex); }
+
+    void set_reserve(uint64_t reserve) { _reserve = reserve; }
+
+    bool active() const override { return true; }
+
+    void changed(sdskv_watch_event_type_t type,
+                 const void*              key,
+                 hg_size_t                ksize,
+                 const void*              value,
+                 hg_size_t                vsize) override
+    {
+        uint64_t seq = _next++;
+        if (seq > _reserved) {
+            ABT_mutex_lock(_meta_mutex);
+            _reserved = seq + _reserve - 1;
+            bool ok   = write_meta();
+            if (!ok) _reserved = seq - 1; // retried by the next change
+            ABT_mutex_unlock(_meta_mutex);
+            if (!ok) {
+                lost(seq, "could not reserve sequence number");
+                return;
+            }
+        }
+        if (type != SDSKV_WATCH_PUT) vsize = 0;
+        uint64_t  ksize64 = ksize;
+        ds_bulk_t record(1 + sizeof(ksize64) + ksize + vsize);
+        record[0] = (char)type;
+        memcpy(record.data() + 1, &ksize64, sizeof(ksize64));
+        memcpy(record.data() + 1 + sizeof(ksize64), key, ksize);
+        if (vsize)
+            memcpy(record.data() + 1 + sizeof(ksize64) + ksize, value, vsize);
+        if (_log->put(seq_key(seq), std::move(record)) != SDSKV_SUCCESS) {
+            lost(seq, "could not record change");
+            return;
+        }
+        _last.store(seq);
+    }
+
+    // reads the sequence numbers saved in the log
+    bool load()
+    {
+        ds_bulk_t meta;
+        if (_log->get(meta_key, meta)) {
+            if (meta.size() != 2 * sizeof(uint64_t)) {
+                std::cerr << "ChangeLogDataStore: invalid change log metadata"
+                          << std::endl;
+                return false;
+            }
+            uint64_t truncated;
+            memcpy(&_reserved, meta.data(), sizeof(uint64_t));
+            memcpy(&truncated, meta.data() + sizeof(uint64_t),
+                   sizeof(uint64_t));
+            _truncated.store(truncated);
+        }
+        _next = _reserved + 1;
+        _last.store(_reserved);
+        return true;
+    }
+
+    int get_changes(uint64_t                  since,
+                    hg_size_t                 max_changes,
+                    hg_size_t                 max_bytes,
+                    std::vector<ds_change_t>& changes,
+                    uint64_t*                 last_seq) const
+    {
+        /* changes recorded after this point are left for the next call */
+        uint64_t last = _last.load();
+        *last_seq     = last;
+        if (since < _truncated.load()) return SDSKV_ERR_LOG_TRUNCATED;
+        ds_bulk_t start = seq_key(since);
+        hg_size_t bytes = 0;
+        while (changes.size() < max_changes) {
+            hg_size_t count = std::min<hg_size_t>(max_changes - changes.size(),
+                                                  list_batch_size);
+            auto records = _log->list_keyvals(start, count);
+            for (auto& r : records) {
+                if (r.first.size() != seq_key_size) return SDSKV_SUCCESS;
+                ds_change_t change;
+                change.seq = key_seq(r.first);
+                if (change.seq > last) return SDSKV_SUCCESS;
+                uint64_t ksize = 0;
+                if (r.second.size() >= 1 + sizeof(ksize))
+                    memcpy(&ksize, r.second.data() + 1, sizeof(ksize));
+                if (r.second.size() < 1 + sizeof(ksize) + ksize) {
+                    std::cerr << "ChangeLogDataStore: invalid change "
+                              << change.seq << std::endl;
+                    return SDSKV_ERR_READ;
+                }
+                hg_size_t size = r.second.size() - 1 - sizeof(ksize);
+                if (bytes + size > max_bytes)
+                    return changes.empty() ? SDSKV_ERR_SIZE : SDSKV_SUCCESS;
+                bytes += size;
+                auto k      = r.second.begin() + 1 + sizeof(ksize);
+                change.type = (sdskv_watch_event_type_t)r.second[0];
+                change.key.assign(k, k + ksize);
+                change.value.assign(k + ksize, r.second.end());
+                changes.push_back(std::move(change));
+            }
+            if (records.size() < count) break;
+            start = records.back().first;
+        }
+        return SDSKV_SUCCESS;
+    }
+
+    int truncate(uint64_t upto)
+    {
+        uint64_t last = _last.load();
+        if (upto > last) upto = last;
+        ABT_mutex_lock(_meta_mutex);
+        /* readers asking for the changes being erased fail from now on; the
+         * log may already be marked truncated after a lost change, while
+         * the changes before it are still to be erased */
+        bool ok = true;
+        if (upto > _truncated.load()) {
+            _truncated.store(upto);
+            ok = write_meta();
+        }
+        ABT_mutex_unlock(_meta_mutex);
+        if (!ok) return SDSKV_ERR_PUT;
+        hg_size_t num_erased;
+        return _log->erase_range(seq_key(0), seq_key(upto + 1), &num_erased);
+    }
+
+    void sync() { _log->sync(); }
+
+  private:
+    // number of changes read from the log at once
+    static const hg_size_t list_batch_size = 256;
+
+    // a change that could not be recorded is made to look truncated, so
+    // that the readers that have not read the changes before it are told
+    // to copy the database again rather than silently missing it
+    void lost(uint64_t seq, const char* what)
+    {
+        std::cerr << "ChangeLogDataStore: " << what << " " << seq << std::endl;
+        ABT_mutex_lock(_meta_mutex);
+        if (seq > _truncated.load()) {
+            _truncated.store(seq);
+            write_meta();
+        }
+        ABT_mutex_unlock(_meta_mutex);
+        _last.store(seq);
+    }
+
+    /* must be called with _meta_mutex locked */
+    bool write_meta()
+    {
+        uint64_t  truncated = _truncated.load();
+        ds_bulk_t meta(2 * sizeof(uint64_t));
+        memcpy(meta.data(), &_reserved, sizeof(uint64_t));
+        memcpy(meta.data() + sizeof(uint64_t), &truncated, sizeof(uint64_t));
+        return _log->put(meta_key.data(), meta_key.size(), meta.data(),
+                         meta.size())
+            == SDSKV_SUCCESS;
+    }
+
+    std::unique_ptr<AbstractDataStore> _log;
+    uint64_t                           _reserve  = 1024;
+    uint64_t                           _next     = 1; // next sequence number
+    uint64_t                           _reserved = 0; // last one reserved
+    std::atomic<uint64_t>              _last{0};      // last one recorded
+    std::atomic<uint64_t>              _truncated{0}; // last one truncated
+    ABT_mutex                          _meta_mutex = ABT_MUTEX_NULL;
+};
+
+ChangeLogDataStore::ChangeLogDataStore(AbstractDataStore* inner,
+                                       AbstractDataStore* log)
+    : ChangeLogDataStore(inner, std::make_shared<Recorder>(log))
+{
+}
+
+ChangeLogDataStore::ChangeLogDataStore(AbstractDataStore*        inner,
+                                       std::shared_ptr<Recorder> recorder)
+    : WatchedDataStore(inner, recorder, true), _recorder(recorder)
+{
+}
+
+ChangeLogDataStore::~ChangeLogDataStore() {}
+
+bool ChangeLogDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry:
+     * "change_log" : {
+     *    "reserve" : <int>   (default 1024, sequence numbers reserved at
+     *                         once, which are skipped if unused when the
+     *                         database is reopened)
+     * }
+     **/
+    const Json::Value& cfg = config["change_log"];
+    if (!cfg.isObject()) {
+        std::cerr << "ChangeLogDataStore::configure: \"change_log\" should"
+                  << " be an object" << std::endl;
+        return false;
+    }
+    if (cfg.isMember("reserve")) {
+        if (!cfg["reserve"].isUInt64() || cfg["reserve"].asUInt64() == 0) {
+            std::cerr << "ChangeLogDataStore::configure: \"reserve\" should"
+                      << " be a positive integer" << std::endl;
+            return false;
+        }
+        _recorder->set_reserve(cfg["reserve"].asUInt64());
+    }
+    return true;
+}
+
+/* the inner datastore and the log are already open */
+bool ChangeLogDataStore::openDatabase(const std::string& db_name,
+                                      const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+    return _recorder->load();
+}
+
+int ChangeLogDataStore::get_changes(uint64_t                  since,
+                                    hg_size_t                 max_changes,
+                                    hg_size_t                 max_bytes,
+                                    std::vector<ds_change_t>& changes,
+                                    uint64_t*                 last_seq) const
+{
+    return _recorder->get_changes(since, max_changes, max_bytes, changes,
+                                  last_seq);
+}
+
+int ChangeLogDataStore::truncate_changes(uint64_t upto)
+{
+    return _recorder->truncate(upto);
+}
+
+void ChangeLogDataStore::sync()
+{
+    WatchedDataStore::sync();
+    _recorder->sync();
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef changelog_datastore_h
+#define changelog_datastore_h
+
+#include <memory>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+#include "datastore/watched_datastore.h"
+
+// datastore recording the keys put and erased in another datastore in a
+// change log, a second datastore, both of which it owns. Each change is
+// stored in the log under its sequence number, written after the change
+// itself, so that reading the log in order replays the changes in the order
+// they were made. Sequence numbers increase but are not contiguous: they
+// are reserved by blocks, and the rest of the last block reserved is skipped
+// when the database is reopened.
+class ChangeLogDataStore : public WatchedDataStore {
+
+  public:
+    ChangeLogDataStore(AbstractDataStore* inner, AbstractDataStore* log);
+    virtual ~ChangeLogDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  get_changes(uint64_t                  since,
+                             hg_size_t                 max_changes,
+                             hg_size_t                 max_bytes,
+                             std::vector<ds_change_t>& changes,
+                             uint64_t*                 last_seq) const override;
+    virtual int  truncate_changes(uint64_t upto) override;
+    virtual void sync() override;
+
+  private:
+    class Recorder;
+
+    ChangeLogDataStore(AbstractDataStore*        inner,
+                       std::shared_ptr<Recorder> recorder);
+
+    std::shared_ptr<Recorder> _recorder;
+};
+
+#endif // changelog_datastore_h
@@ -0,0 +1,468 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "compressed_datastore.h"
+#include "kv-config.h"
+#include <cstring>
+#include <iostream>
+#ifdef USE_LZ4
+    #include <lz4.h>
+    #include <lz4hc.h>
+#endif
+#ifdef USE_ZSTD
+    #include <zstd.h>
+#endif
+
+/* Encoded values start with a 12-byte header: 3 magic bytes, the codec, and
+ * the size of the original value as a 64-bit little-endian integer. */
+static const unsigned char header_magic[3] = {0xc5, 'S', 'Z'};
+static const hg_size_t     header_size     = 12;
+
+static void write_header(char* out, uint8_t codec, hg_size_t vsize)
+{
+    std::memcpy(out, header_magic, sizeof(header_magic));
+    out[3] = (char)codec;
+    for (int i = 0; i < 8; i++) out[4 + i] = (char)(vsize >> (8 * i));
+}
+
+static bool
+read_header(const void* data, hg_size_t size, uint8_t* codec, hg_size_t* vsize)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    if (size < header_size
+        || std::memcmp(p, header_magic, sizeof(header_magic)) != 0)
+        return false;
+    *codec = p[3];
+    *vsize = 0;
+    for (int i = 0; i < 8; i++) *vsize |= (hg_size_t)p[4 + i] << (8 * i);
+    return true;
+}
+
+/* compresses src into out, after room left for the header; returns the
+ * compressed size, 0 on failure */
+static hg_size_t compress_value(uint8_t     codec,
+                                int         level,
+                                const void* src,
+                                hg_size_t   size,
+                                ds_bulk_t&  out)
+{
+    switch (codec) {
+#ifdef USE_LZ4
+    case CompressedDataStore::CODEC_LZ4: {
+        if (size > LZ4_MAX_INPUT_SIZE) return 0;
+        int bound = LZ4_compressBound((int)size);
+        out.resize(header_size + bound);
+        char* dst = out.data() + header_size;
+        int   n   = level > 0 ? LZ4_compress_HC((const char*)src, dst,
+                                                (int)size, bound, level)
+                              : LZ4_compress_default((const char*)src, dst,
+                                                     (int)size, bound);
+        return n > 0 ? n : 0;
+    }
+#endif
+#ifdef USE_ZSTD
+    case CompressedDataStore::CODEC_ZSTD: {
+        size_t bound = ZSTD_compressBound(size);
+        out.resize(header_size + bound);
+        size_t n = ZSTD_compress(out.data() + header_size, bound, src, size,
+                                 level);
+        return ZSTD_isError(n) ? 0 : n;
+    }
+#endif
+    default:
+        return 0;
+    }
+}
+
+/* decompresses the csize bytes of src into the vsize bytes of dst; the
+ * expected size is checked against the payload before anything is
+ * allocated, since a value stored as is may happen to look like a header */
+static bool decompress_value(uint8_t     codec,
+                             const char* src,
+                             hg_size_t   csize,
+                             ds_bulk_t&  dst,
+                             hg_size_t   vsize)
+{
+    switch (codec) {
+    case CompressedDataStore::CODEC_NONE:
+        if (csize != vsize) return false;
+        dst.assign(src, src + csize);
+        return true;
+#ifdef USE_LZ4
+    case CompressedDataStore::CODEC_LZ4: {
+        /* LZ4 cannot compress by more than a factor 255 */
+        if (vsize > LZ4_MAX_INPUT_SIZE || vsize / 255 > csize) return false;
+        dst.resize(vsize);
+        int n = LZ4_decompress_safe(src, dst.data(), (int)csize, (int)vsize);
+        return n >= 0 && (hg_size_t)n == vsize;
+    }
+#endif
+#ifdef USE_ZSTD
+    case CompressedDataStore::CODEC_ZSTD: {
+        if (ZSTD_getFrameContentSize(src, csize) != vsize) return false;
+        dst.resize(vsize);
+        size_t n = ZSTD_decompress(dst.data(), vsize, src, csize);
+        return !ZSTD_isError(n) && n == vsize;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+CompressedDataStore::CompressedDataStore(AbstractDataStore* inner)
+    : AbstractDataStore(false, false), _inner(inner)
+{
+}
+
+CompressedDataStore::~CompressedDataStore() {}
+
+bool CompressedDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry:
+     * "value_compression" : {
+     *    "codec" : "lz4" | "zstd",
+     *    "level" : <int>,        (default 0, i.e. LZ4's fast mode or Zstd's
+     *                             default level; LZ4 uses its high
+     *                             compression mode for levels above 0)
+     *    "min_size" : <bytes>    (default 128, smaller values are stored
+     *                             as they are)
+     * }
+     **/
+    if (!config.isObject() || !config.isMember("value_compression"))
+        return true;
+    const Json::Value& cfg = config["value_compression"];
+    if (!cfg.isObject()) {
+        std::cerr << "CompressedDataStore::configure: \"value_compression\""
+                  << " should be an object" << std::endl;
+        return false;
+    }
+    std::string codec = cfg.get("codec", "").asString();
+    if (codec == "lz4") {
+#ifdef USE_LZ4
+        _codec = CODEC_LZ4;
+#else
+        std::cerr << "CompressedDataStore::configure: SDSKV was built without"
+                  << " LZ4 support" << std::endl;
+        return false;
+#endif
+    } else if (codec == "zstd") {
+#ifdef USE_ZSTD
+        _codec = CODEC_ZSTD;
+#else
+        std::cerr << "CompressedDataStore::configure: SDSKV was built without"
+                  << " Zstd support" << std::endl;
+        return false;
+#endif
+    } else {
+        std::cerr << "CompressedDataStore::configure: invalid codec \""
+                  << codec << "\"" << std::endl;
+        return false;
+    }
+    if (cfg.isMember("level")) {
+        if (!cfg["level"].isInt()) {
+            std::cerr << "CompressedDataStore::configure: \"level\" should"
+                      << " be an integer" << std::endl;
+            return false;
+        }
+        _level = cfg["level"].asInt();
+    }
+    if (cfg.isMember("min_size")) {
+        if (!cfg["min_size"].isUInt64()) {
+            std::cerr << "CompressedDataStore::configure: \"min_size\" should"
+                      << " be a positive integer" << std::endl;
+            return false;
+        }
+        _min_size = cfg["min_size"].asUInt64();
+    }
+    return true;
+}
+
+/* the inner datastore is already open */
+bool CompressedDataStore::openDatabase(const std::string& db_name,
+                                       const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+    return true;
+}
+
+bool CompressedDataStore::encode(const void* value,
+                                 hg_size_t   vsize,
+                                 ds_bulk_t&  out) const
+{
+    if (vsize >= _min_size) {
+        ds_bulk_t buffer;
+        hg_size_t csize = compress_value(_codec, _level, value, vsize, buffer);
+        if (csize && header_size + csize < vsize) {
+            /* copied so that the stored value does not keep the capacity
+             * of the compression buffer */
+            write_header(buffer.data(), _codec, vsize);
+            out.assign(buffer.begin(), buffer.begin() + header_size + csize);
+            return true;
+        }
+    }
+    /* values that look like encoded ones are stored behind a header so
+     * that they are not mistaken for them */
+    uint8_t   codec;
+    hg_size_t size;
+    if (!read_header(value, vsize, &codec, &size)) return false;
+    out.resize(header_size + vsize);
+    write_header(out.data(), CODEC_NONE, vsize);
+    std::memcpy(out.data() + header_size, value, vsize);
+    return true;
+}
+
+bool CompressedDataStore::decode(const void* data,
+                                 hg_size_t   size,
+                                 ds_bulk_t&  out) const
+{
+    uint8_t   codec;
+    hg_size_t vsize;
+    if (!read_header(data, size, &codec, &vsize)) return false;
+    if (decompress_value(codec, (const char*)data + header_size,
+                         size - header_size, out, vsize))
+        return true;
+    out.clear();
+    return false;
+}
+
+void CompressedDataStore::decode(ds_bulk_t& value) const
+{
+    ds_bulk_t out;
+    if (decode(value.data(), value.size(), out)) value.swap(out);
+}
+
+int CompressedDataStore::put(const void* key,
+                             hg_size_t   ksize,
+                             const void* value,
+                             hg_size_t   vsize)
+{
+    ds_bulk_t encoded;
+    if (encode(value, vsize, encoded))
+        return _inner->put(key, ksize, encoded.data(), encoded.size());
+    return _inner->put(key, ksize, value, vsize);
+}
+
+int CompressedDataStore::put(ds_bulk_t&& key, ds_bulk_t&& data)
+{
+    ds_bulk_t encoded;
+    if (encode(data.data(), data.size(), encoded))
+        return _inner->put(std::move(key), std::move(encoded));
+    return _inner->put(std::move(key), std::move(data));
+}
+
+int CompressedDataStore::put_multi(hg_size_t          num_items,
+                                   const void* const* keys,
+                                   const hg_size_t*   ksizes,
+                                   const void* const* values,
+                                   const hg_size_t*   vsizes)
+{
+    std::vector<ds_bulk_t>   encoded(num_items);
+    std::vector<const void*> ptrs(values, values + num_items);
+    std::vector<hg_size_t>   sizes(vsizes, vsizes + num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        if (encode(values[i], vsizes[i], encoded[i])) {
+            ptrs[i]  = encoded[i].data();
+            sizes[i] = encoded[i].size();
+        }
+    }
+    return _inner->put_multi(num_items, keys, ksizes, ptrs.data(),
+                             sizes.data());
+}
+
+int CompressedDataStore::put_packed(hg_size_t        num_items,
+                                    const char*      keys,
+                                    const hg_size_t* ksizes,
+                                    const char*      values,
+                                    const hg_size_t* vsizes)
+{
+    std::vector<const void*> kptrs(num_items);
+    std::vector<const void*> vptrs(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        kptrs[i] = keys;
+        vptrs[i] = values;
+        keys += ksizes[i];
+        values += vsizes[i];
+    }
+    return put_multi(num_items, kptrs.data(), ksizes, vptrs.data(), vsizes);
+}
+
+bool CompressedDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    if (!_inner->get(key, data)) return false;
+    decode(data);
+    return true;
+}
+
+bool CompressedDataStore::get(const ds_bulk_t&        key,
+                              std::vector<ds_bulk_t>& data)
+{
+    if (!_inner->get(key, data)) return false;
+    for (auto& value : data) decode(value);
+    return true;
+}
+
+bool CompressedDataStore::get_view(const void*    key,
+                                   hg_size_t      ksize,
+                                   const view_fn& fn)
+{
+    return _inner->get_view(key, ksize, [&](const void* data, hg_size_t size) {
+        ds_bulk_t value;
+        if (decode(data, size, value))
+            fn(value.data(), value.size());
+        else
+            fn(data, size);
+    });
+}
+
+/* the size of encoded values is read from their header */
+bool CompressedDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    return _inner->get_view(
+        key.data(), key.size(), [&](const void* data, hg_size_t size) {
+            uint8_t   codec;
+            hg_size_t original;
+            *vsize = read_header(data, size, &codec, &original) ? original
+                                                                : size;
+        });
+}
+
+bool CompressedDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    return _inner->exists(key, ksize);
+}
+
+bool CompressedDataStore::erase(const ds_bulk_t& key)
+{
+    return _inner->erase(key);
+}
+
+int CompressedDataStore::erase_range(const ds_bulk_t& lower,
+                                     const ds_bulk_t& upper,
+                                     hg_size_t*       num_erased)
+{
+    return _inner->erase_range(lower, upper, num_erased);
+}
+
+int CompressedDataStore::erase_prefixed(const ds_bulk_t& prefix,
+                                        hg_size_t*       num_erased)
+{
+    return _inner->erase_prefixed(prefix, num_erased);
+}
+
+/* value sizes are those of the stored, possibly compressed, values */
+int CompressedDataStore::count_range(const ds_bulk_t& lower,
+                                     const ds_bulk_t& upper,
+                                     bool             with_sizes,
+                                     ds_count_t&      result) const
+{
+    return _inner->count_range(lower, upper, with_sizes, result);
+}
+
+int CompressedDataStore::count_prefixed(const ds_bulk_t& prefix,
+                                        bool             with_sizes,
+                                        ds_count_t&      result) const
+{
+    return _inner->count_prefixed(prefix, with_sizes, result);
+}
+
+/* fn sees decoded values and its result is encoded, all within the update
+ * of the inner datastore so that it remains atomic */
+int CompressedDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    return _inner->update(
+        key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+            ds_bulk_t value, result;
+            if (current && !decode(current->data(), current->size(), value))
+                value = *current;
+            if (!fn(current ? &value : nullptr, result)) return false;
+            if (!encode(result.data(), result.size(), new_value))
+                new_value.swap(result);
+            return true;
+        });
+}
+
+void CompressedDataStore::set_in_memory(bool enable)
+{
+    _inner->set_in_memory(enable);
+}
+
+void CompressedDataStore::set_comparison_function(const std::string& name,
+                                                  comparator_fn      less)
+{
+    _comp_fun_name = name;
+    _inner->set_comparison_function(name, less);
+}
+
+void CompressedDataStore::set_key_shortening_functions(separator_fn separator,
+                                                       successor_fn successor)
+{
+    _inner->set_key_shortening_functions(separator, successor);
+}
+
+void CompressedDataStore::set_no_overwrite()
+{
+    _no_overwrite = true;
+    _inner->set_no_overwrite();
+}
+
+void CompressedDataStore::set_eviction_handler(const evicted_fn& fn)
+{
+    _inner->set_eviction_handler(fn);
+}
+
+void CompressedDataStore::sync() { _inner->sync(); }
+
+int CompressedDataStore::compact(const ds_bulk_t& lower,
+                                 const ds_bulk_t& upper)
+{
+    return _inner->compact(lower, upper);
+}
+
+/* the memory used by the compressed values */
+bool CompressedDataStore::memory_usage(ds_memory_t& usage) const
+{
+    return _inner->memory_usage(usage);
+}
+
+std::vector<ds_bulk_t> CompressedDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    return _inner->list_keys(start, count, prefix);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+CompressedDataStore::vlist_keyvals(const ds_bulk_t& start,
+                                   hg_size_t        count,
+                                   const ds_bulk_t& prefix) const
+{
+    auto result = _inner->list_keyvals(start, count, prefix);
+    for (auto& p : result) decode(p.second);
+    return result;
+}
+
+std::vector<ds_bulk_t>
+CompressedDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                     const ds_bulk_t& upper_bound,
+                                     hg_size_t        max_keys) const
+{
+    return _inner->list_key_range(lower_bound, upper_bound, max_keys);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+CompressedDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                        const ds_bulk_t& upper_bound,
+                                        hg_size_t        max_keys) const
+{
+    auto result = _inner->list_keyval_range(lower_bound, upper_bound, max_keys);
+    for (auto& p : result) decode(p.second);
+    return result;
+}
+
+#ifdef USE_REMI
+remi_fileset_t CompressedDataStore::create_and_populate_fileset() const
+{
+    return _inner->create_and_populate_fileset();
+}
+#endif
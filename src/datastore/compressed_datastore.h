@@ -0,0 +1,110 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef compressed_datastore_h
+#define compressed_datastore_h
+
+#include <memory>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// datastore compressing the values of another datastore, which it owns.
+// Values of at least min_size bytes are stored compressed with LZ4 or Zstd
+// behind a small header, when this makes them smaller; other values are
+// stored as they are, so databases holding values written before
+// compression was enabled remain readable.
+class CompressedDataStore : public AbstractDataStore {
+
+  public:
+    enum codec_t : uint8_t { CODEC_NONE = 0, CODEC_LZ4 = 1, CODEC_ZSTD = 2 };
+
+    CompressedDataStore(AbstractDataStore* inner);
+    virtual ~CompressedDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put(ds_bulk_t&& key, ds_bulk_t&& data) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool
+    get_view(const void* key, hg_size_t ksize, const view_fn& fn) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  erase_prefixed(const ds_bulk_t& prefix,
+                                hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual int  count_prefixed(const ds_bulk_t& prefix,
+                                bool             with_sizes,
+                                ds_count_t&      result) const override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual void set_in_memory(bool enable) override;
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
+    virtual void set_no_overwrite() override;
+    virtual void set_eviction_handler(const evicted_fn& fn) override;
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+    virtual bool memory_usage(ds_memory_t& usage) const override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+  private:
+    // encodes a value into out; returns false if the value should be
+    // stored as it is
+    bool encode(const void* value, hg_size_t vsize, ds_bulk_t& out) const;
+    // decodes a stored value into out; returns false if it is not encoded
+    bool decode(const void* data, hg_size_t size, ds_bulk_t& out) const;
+    // decodes a stored value in place
+    void decode(ds_bulk_t& value) const;
+
+    std::unique_ptr<AbstractDataStore> _inner;
+    codec_t                            _codec    = CODEC_NONE;
+    int                                _level    = 0;
+    hg_size_t                          _min_size = 128;
+};
+
+#endif // compressed_datastore_h
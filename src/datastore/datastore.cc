@@ -12,6 +12,7 @@ AbstractDataStore::AbstractDataStore()
     _eraseOnGet = false;
     _debug      = false;
     _in_memory  = false;
+    ABT_mutex_create(&_update_mutex);
 };
 
 AbstractDataStore::AbstractDataStore(bool eraseOnGet, bool debug)
@@ -19,6 +20,129 @@ AbstractDataStore::AbstractDataStore(bool eraseOnGet, bool debug)
     _eraseOnGet = eraseOnGet;
     _debug      = debug;
     _in_memory  = false;
+    ABT_mutex_create(&_update_mutex);
 };
 
-AbstractDataStore::~AbstractDataStore(){};
+AbstractDataStore::~AbstractDataStore() { ABT_mutex_free(&_update_mutex); };
+
+int AbstractDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    ds_bulk_t value, new_value;
+    int       ret = SDSKV_SUCCESS;
+    ABT_mutex_lock(_update_mutex);
+    bool found = get(key, value);
+    if (fn(found ? &value : nullptr, new_value)) ret = put(key, new_value);
+    ABT_mutex_unlock(_update_mutex);
+    return ret;
+}
+
+/* a NULL expected value means that the key must not exist */
+int AbstractDataStore::compare_and_swap(const ds_bulk_t& key,
+                                        const ds_bulk_t* expected,
+                                        const ds_bulk_t& value,
+                                        bool*            swapped)
+{
+    bool matched = false;
+    int  ret = update(key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+        if (expected)
+            matched = current && *current == *expected;
+        else
+            matched = current == nullptr;
+        if (matched) new_value = value;
+        return matched;
+    });
+    *swapped = matched && ret == SDSKV_SUCCESS;
+    return ret;
+}
+
+/* the value is a 4 or 8-byte integer in the provider's byte order; a key
+ * that does not exist is created with an 8-byte value */
+int AbstractDataStore::fetch_add(const ds_bulk_t& key,
+                                 int64_t          delta,
+                                 int64_t*         previous)
+{
+    int status = SDSKV_SUCCESS;
+    int ret = update(key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+        size_t  width = current ? current->size() : sizeof(int64_t);
+        int64_t value = 0;
+        if (width == sizeof(int32_t)) {
+            int32_t v;
+            std::memcpy(&v, current->data(), sizeof(v));
+            value = v;
+            v     = (int32_t)((uint32_t)v + (uint32_t)delta);
+            new_value.assign((char*)&v, (char*)&v + sizeof(v));
+        } else if (width == sizeof(int64_t)) {
+            if (current) std::memcpy(&value, current->data(), sizeof(value));
+            int64_t v = (int64_t)((uint64_t)value + (uint64_t)delta);
+            new_value.assign((char*)&v, (char*)&v + sizeof(v));
+        } else {
+            status = SDSKV_ERR_SIZE;
+            return false;
+        }
+        *previous = value;
+        return true;
+    });
+    return ret == SDSKV_SUCCESS ? status : ret;
+}
+
+/* a key that does not exist is created with the appended data as value */
+int AbstractDataStore::append(const ds_bulk_t& key,
+                              const void*      data,
+                              hg_size_t        size,
+                              hg_size_t*       new_size)
+{
+    return update(key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+        new_value.reserve((current ? current->size() : 0) + size);
+        if (current) new_value = *current;
+        new_value.insert(new_value.end(), (const char*)data,
+                         (const char*)data + size);
+        *new_size = new_value.size();
+        return true;
+    });
+}
+
+int AbstractDataStore::put_range(const ds_bulk_t& key,
+                                 hg_size_t        offset,
+                                 const void*      data,
+                                 hg_size_t        size)
+{
+    /* offset + size must neither wrap around nor exceed a vector's size */
+    if (offset > ds_bulk_t().max_size() - size) return SDSKV_ERR_SIZE;
+    return update(key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+        if (current) new_value = *current;
+        if (new_value.size() < offset + size) new_value.resize(offset + size);
+        if (size) std::memcpy(new_value.data() + offset, data, size);
+        return true;
+    });
+}
+
+bool AbstractDataStore::get_stream(const void*          key,
+                                   hg_size_t            ksize,
+                                   hg_size_t            chunk_size,
+                                   const chunk_sink_fn& fn)
+{
+    return get_view(key, ksize, [&](const void* value, hg_size_t vsize) {
+        hg_size_t offset = 0;
+        do {
+            hg_size_t size = std::min(chunk_size, vsize - offset);
+            if (!fn(vsize, (const char*)value + offset, size)) return;
+            offset += size;
+        } while (offset < vsize);
+    });
+}
+
+int AbstractDataStore::put_stream(const ds_bulk_t&       key,
+                                  hg_size_t              vsize,
+                                  const chunk_source_fn& next)
+{
+    ds_bulk_t value(vsize);
+    hg_size_t offset = 0;
+    while (offset < vsize) {
+        hg_size_t   size  = 0;
+        const void* chunk = next(size);
+        if (!chunk || size == 0 || size > vsize - offset) return SDSKV_ERR_PUT;
+        std::memcpy(value.data() + offset, chunk, size);
+        offset += size;
+    }
+    return put(ds_bulk_t(key), std::move(value));
+}
@@ -5,23 +5,85 @@
 
 #include "kv-config.h"
 #include "bulk.h"
+#include "sdskv-common.h"
 #include <margo.h>
+#include <json/json.h>
 #ifdef USE_REMI
     #include "remi/remi-common.h"
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <vector>
 
+// number of keys in a range of a database, and the total size of these keys
+// and of their values
+struct ds_count_t {
+    hg_size_t num_keys    = 0;
+    hg_size_t key_bytes   = 0;
+    hg_size_t value_bytes = 0;
+};
+
+// memory used by a database that keeps its data in memory, and the limit
+// set on it with its "max_memory" option
+struct ds_memory_t {
+    hg_size_t used_bytes = 0;
+    hg_size_t max_bytes  = 0; // 0 if there is no limit
+    uint64_t  evictions  = 0; // entries evicted to respect the limit
+    uint64_t  rejections = 0; // writes rejected with SDSKV_ERR_FULL
+};
+
+// state of the value cache of a database opened with a "cache" option
+struct ds_cache_t {
+    hg_size_t used_bytes    = 0;
+    hg_size_t max_bytes     = 0;
+    uint64_t  hits          = 0;
+    uint64_t  misses        = 0;
+    uint64_t  evictions     = 0;
+    uint64_t  invalidations = 0; // entries dropped because of a write
+};
+
+// change recorded in the change log of a database opened with a
+// "change_log" option
+struct ds_change_t {
+    uint64_t                 seq;
+    sdskv_watch_event_type_t type; // SDSKV_WATCH_PUT or SDSKV_WATCH_ERASE
+    ds_bulk_t                key;
+    ds_bulk_t                value; // empty for erasures
+};
+
 class AbstractDataStore {
   public:
     typedef int (*comparator_fn)(const void*,
                                  hg_size_t,
                                  const void*,
                                  hg_size_t);
+    typedef hg_size_t (*separator_fn)(void*, hg_size_t, const void*, hg_size_t);
+    typedef hg_size_t (*successor_fn)(void*, hg_size_t);
+    typedef std::function<void(const void*, hg_size_t)> view_fn;
+    typedef std::function<void(hg_size_t, const void*, hg_size_t)>
+        multi_view_fn;
+    // computes the new value of a key from its current value (nullptr if
+    // the key does not exist); returns false to leave the key unchanged
+    typedef std::function<bool(const ds_bulk_t*, ds_bulk_t&)> update_fn;
+    // returns the next chunk of a value being written and sets size to its
+    // size, the chunk remaining valid until the next call; nullptr on error
+    typedef std::function<const void*(hg_size_t& size)> chunk_source_fn;
+    // called on the consecutive chunks of a value being read, vsize being
+    // the size of the whole value; returns false to stop reading
+    typedef std::function<bool(hg_size_t vsize, const void*, hg_size_t)>
+        chunk_sink_fn;
+    // called with the keys that the datastore erases by itself, e.g. to
+    // respect a memory limit
+    typedef std::function<void(const void*, hg_size_t)> evicted_fn;
 
     AbstractDataStore();
     AbstractDataStore(bool eraseOnGet, bool debug);
     virtual ~AbstractDataStore();
+    // backend-specific options taken from the database's JSON entry,
+    // called before openDatabase; returns false if the options are invalid
+    virtual bool configure(const Json::Value& config) { return true; }
     virtual bool openDatabase(const std::string& db_name,
                               const std::string& path)
         = 0;
@@ -67,8 +129,62 @@ class AbstractDataStore {
         }
         return ret;
     }
+    // puts a value that expires ttl_ms milliseconds from now, 0 meaning
+    // never, in databases opened with a "ttl" option
+    virtual int put_ttl(const void* key,
+                        hg_size_t   ksize,
+                        const void* value,
+                        hg_size_t   vsize,
+                        uint64_t    ttl_ms)
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
     virtual bool get(const ds_bulk_t& key, ds_bulk_t& data)              = 0;
     virtual bool get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data) = 0;
+    // calls fn on the value associated with the key without copying it when
+    // the backend allows it; the value is only valid during the call to fn
+    virtual bool get_view(const void* key, hg_size_t ksize, const view_fn& fn)
+    {
+        auto      k = ds_bulk_t((const char*)key, (const char*)key + ksize);
+        ds_bulk_t data;
+        if (!get(k, data)) return false;
+        fn(data.data(), data.size());
+        return true;
+    }
+    // calls fn(i, value, vsize) for each key i that is found, in order
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn)
+    {
+        for (hg_size_t i = 0; i < num_keys; i++) {
+            get_view(keys[i], ksizes[i], [&](const void* value,
+                                             hg_size_t vsize) {
+                fn(i, value, vsize);
+            });
+        }
+    }
+    // calls fn on the bytes [offset, offset + size) of the value associated
+    // with the key, or on fewer bytes if the value ends before offset + size,
+    // reading only these bytes when the backend allows it
+    virtual bool get_range_view(const void*    key,
+                                hg_size_t      ksize,
+                                hg_size_t      offset,
+                                hg_size_t      size,
+                                const view_fn& fn)
+    {
+        return get_view(key, ksize, [&](const void* value, hg_size_t vsize) {
+            hg_size_t start = std::min(offset, vsize);
+            fn((const char*)value + start, std::min(size, vsize - start));
+        });
+    }
+    // calls fn on consecutive chunks of at most chunk_size bytes of the
+    // value associated with the key (once with an empty chunk if the value
+    // is empty); by default the chunks are taken from get_view
+    virtual bool get_stream(const void*          key,
+                            hg_size_t            ksize,
+                            hg_size_t            chunk_size,
+                            const chunk_sink_fn& fn);
     virtual bool length(const void* key, hg_size_t ksize, size_t* vsize)
     {
         auto k = ds_bulk_t((const char*)key, (const char*)key + ksize);
@@ -87,13 +203,155 @@ class AbstractDataStore {
         return exists(key.data(), key.size());
     }
     virtual bool erase(const ds_bulk_t& key) = 0;
+    // erases the keys in [lower, upper), an empty bound meaning the
+    // start/end of the database, and sets num_erased to their number
+    virtual int erase_range(const ds_bulk_t& lower,
+                            const ds_bulk_t& upper,
+                            hg_size_t*       num_erased)
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
+    // erases the keys starting with prefix; by default this is the range
+    // [prefix, successor of prefix) if the database uses the default
+    // ordering, otherwise the keys are listed and erased one by one
+    virtual int erase_prefixed(const ds_bulk_t& prefix, hg_size_t* num_erased)
+    {
+        if (_comp_fun_name.empty()) {
+            int ret = erase_range(prefix, prefix_successor(prefix), num_erased);
+            if (ret != SDSKV_OP_NOT_IMPL) return ret;
+        }
+        *num_erased = 0;
+        ds_bulk_t start;
+        while (true) {
+            auto keys = list_keys(start, erase_batch_size, prefix);
+            for (const auto& key : keys)
+                if (erase(key)) *num_erased += 1;
+            if (keys.size() < erase_batch_size) break;
+            start = keys.back();
+        }
+        return SDSKV_SUCCESS;
+    }
+    // counts the keys in [lower, upper), an empty bound meaning the
+    // start/end of the database; the key and value sizes are only summed
+    // if with_sizes is true, which may require reading the values
+    virtual int count_range(const ds_bulk_t& lower,
+                            const ds_bulk_t& upper,
+                            bool             with_sizes,
+                            ds_count_t&      result) const
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
+    // counts the keys starting with prefix, in the same way as erase_prefixed
+    virtual int count_prefixed(const ds_bulk_t& prefix,
+                               bool             with_sizes,
+                               ds_count_t&      result) const
+    {
+        if (_comp_fun_name.empty()) {
+            int ret = count_range(prefix, prefix_successor(prefix), with_sizes,
+                                  result);
+            if (ret != SDSKV_OP_NOT_IMPL) return ret;
+        }
+        result = ds_count_t();
+        ds_bulk_t start;
+        while (true) {
+            hg_size_t n;
+            if (with_sizes) {
+                auto pairs = list_keyvals(start, erase_batch_size, prefix);
+                for (const auto& p : pairs) {
+                    result.key_bytes += p.first.size();
+                    result.value_bytes += p.second.size();
+                }
+                n = pairs.size();
+                if (n) start = pairs.back().first;
+            } else {
+                auto keys = list_keys(start, erase_batch_size, prefix);
+                n         = keys.size();
+                if (n) start = keys.back();
+            }
+            result.num_keys += n;
+            if (n < erase_batch_size) break;
+        }
+        return SDSKV_SUCCESS;
+    }
+    // reads the value of key and, if fn returns true, replaces it with the
+    // value computed by fn, atomically; by default the read and the write
+    // are only atomic with respect to other calls to update
+    virtual int update(const ds_bulk_t& key, const update_fn& fn);
+    // read-modify-write operations, implemented with update
+    int compare_and_swap(const ds_bulk_t& key,
+                         const ds_bulk_t* expected,
+                         const ds_bulk_t& value,
+                         bool*            swapped);
+    int fetch_add(const ds_bulk_t& key, int64_t delta, int64_t* previous);
+    int append(const ds_bulk_t& key,
+               const void*      data,
+               hg_size_t        size,
+               hg_size_t*       new_size);
+    // writes size bytes at offset in the value associated with the key,
+    // which is created or extended with zeros if needed; by default the
+    // value is rewritten entirely using update
+    virtual int put_range(const ds_bulk_t& key,
+                          hg_size_t        offset,
+                          const void*      data,
+                          hg_size_t        size);
+    // puts a value of vsize bytes obtained chunk by chunk from next; by
+    // default the chunks are gathered in memory before a single put
+    virtual int put_stream(const ds_bulk_t&       key,
+                           hg_size_t              vsize,
+                           const chunk_source_fn& next);
+    // erases the expired entries among the batch_size keys that follow
+    // cursor, and moves cursor to the last of these keys, or back to the
+    // start of the database once its end is reached
+    virtual int reclaim_expired(ds_bulk_t& cursor,
+                                hg_size_t  batch_size,
+                                hg_size_t* num_erased)
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
+    // fills changes with the changes of the change log that follow since,
+    // in order, up to max_changes of them and max_bytes of keys and values,
+    // and sets last_seq to the sequence number of the last change recorded;
+    // returns SDSKV_ERR_LOG_TRUNCATED if changes following since have been
+    // truncated
+    virtual int get_changes(uint64_t                  since,
+                            hg_size_t                 max_changes,
+                            hg_size_t                 max_bytes,
+                            std::vector<ds_change_t>& changes,
+                            uint64_t*                 last_seq) const
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
+    // drops the changes of the change log up to sequence number upto
+    virtual int truncate_changes(uint64_t upto) { return SDSKV_OP_NOT_IMPL; }
     virtual void set_in_memory(bool enable)
         = 0; // enable/disable in-memory mode (where supported)
     virtual void set_comparison_function(const std::string& name,
                                          comparator_fn      less)
         = 0;
+    // key-shortening functions matching the comparison function, only used
+    // by backends that can take advantage of them
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) {}
     virtual void set_no_overwrite() = 0;
     virtual void sync()             = 0;
+    // sets the function called after keys are evicted, outside of the
+    // datastore's locks; decorators pass on the keys evicted by the
+    // datastore they wrap
+    virtual void set_eviction_handler(const evicted_fn& fn)
+    {
+        _on_evicted = fn;
+    }
+    // compacts the keys in [lower, upper], an empty bound meaning the
+    // start/end of the database
+    virtual int compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+    {
+        return SDSKV_OP_NOT_IMPL;
+    }
+    // fills usage and returns true if the backend keeps its data in memory
+    // and accounts for it
+    virtual bool memory_usage(ds_memory_t& usage) const { return false; }
+    // fills usage and returns true if the values are cached in memory
+    virtual bool cache_usage(ds_cache_t& usage) const { return false; }
 
 #ifdef USE_REMI
     virtual remi_fileset_t create_and_populate_fileset() const = 0;
@@ -147,6 +405,62 @@ class AbstractDataStore {
     bool        _eraseOnGet;
     bool        _debug;
     bool        _in_memory;
+    ABT_mutex   _update_mutex = ABT_MUTEX_NULL; // used by the default update
+    evicted_fn  _on_evicted;
+
+    // maximum number of keys erased (or listed to be erased or counted) at
+    // once by erase_range/erase_prefixed/count_prefixed
+    static const hg_size_t erase_batch_size = 1024;
+
+    // default ordering of the keys: bytewise with unsigned bytes, a key
+    // coming before the keys it is a prefix of, as in the persistent
+    // backends (std::less<ds_bulk_t> compares signed chars)
+    static bool bytewise_less(const ds_bulk_t& a, const ds_bulk_t& b)
+    {
+        size_t n = std::min(a.size(), b.size());
+        int    c = n ? std::memcmp(a.data(), b.data(), n) : 0;
+        return c < 0 || (c == 0 && a.size() < b.size());
+    }
+
+    // with the default ordering, the keys starting with prefix are those in
+    // [prefix, prefix_successor(prefix)); the successor is obtained by
+    // incrementing the last byte that is not 0xff, and is empty (i.e. the
+    // end of the database) if there is no such byte
+    static ds_bulk_t prefix_successor(const ds_bulk_t& prefix)
+    {
+        ds_bulk_t upper = prefix;
+        while (!upper.empty() && (unsigned char)upper.back() == 0xff)
+            upper.pop_back();
+        if (!upper.empty()) upper.back()++;
+        return upper;
+    }
+
+    // returns 0 if the key starts with prefix, < 0 if no key after this one
+    // can start with it, > 0 otherwise (default ordering)
+    static int
+    compare_prefix(const ds_bulk_t& prefix, const void* key, size_t ksize)
+    {
+        if (ksize < prefix.size()) {
+            int c = std::memcmp(prefix.data(), key, ksize);
+            return c == 0 ? 1 : c;
+        }
+        return std::memcmp(prefix.data(), key, prefix.size());
+    }
+
+    // with the default (bytewise) ordering, the keys starting with a prefix
+    // are contiguous and the prefix itself comes first, so a listing of keys
+    // with a prefix after start_key can seek directly to the prefix when
+    // start_key comes before it; returns true if the listing should start at
+    // prefix (inclusive) rather than after start_key
+    bool seek_to_prefix(const ds_bulk_t& start_key,
+                        const ds_bulk_t& prefix) const
+    {
+        if (prefix.empty() || !_comp_fun_name.empty()) return false;
+        if (start_key.empty()) return true;
+        int c = std::memcmp(start_key.data(), prefix.data(),
+                            std::min(start_key.size(), prefix.size()));
+        return c < 0 || (c == 0 && start_key.size() < prefix.size());
+    }
 
     virtual std::vector<ds_bulk_t>
     vlist_keys(const ds_bulk_t& start_key,
@@ -11,6 +11,11 @@
 
 #include "map_datastore.h"
 #include "null_datastore.h"
+#include "forward_datastore.h"
+#include "compressed_datastore.h"
+#include "cached_datastore.h"
+#include "expiring_datastore.h"
+#include "changelog_datastore.h"
 
 #ifdef USE_BWTREE
     #include "bwtree_datastore.h"
@@ -24,13 +29,22 @@
     #include "leveldb_datastore.h"
 #endif
 
+#ifdef USE_LMDB
+    #include "lmdb_datastore.h"
+#endif
+
+#ifdef USE_ROCKSDB
+    #include "rocksdb_datastore.h"
+#endif
+
 class datastore_factory {
 
     static AbstractDataStore* open_map_datastore(const std::string& name,
-                                                 const std::string& path)
+                                                 const std::string& path,
+                                                 const Json::Value& config)
     {
         auto db = new MapDataStore();
-        if (db->openDatabase(name, path)) {
+        if (db->configure(config) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -39,10 +53,30 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_null_datastore(const std::string& name,
-                                                  const std::string& path)
+                                                  const std::string& path,
+                                                  const Json::Value& config)
     {
         auto db = new NullDataStore();
-        if (db->openDatabase(name, path)) {
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    /* the comparison function, if any, is set before the database is opened
+     * since it is part of its on-disk format */
+    static AbstractDataStore*
+    open_forward_datastore(const std::string&               name,
+                           const std::string&               path,
+                           const Json::Value&               config,
+                           const std::string&               fn_name,
+                           AbstractDataStore::comparator_fn less)
+    {
+        auto db = new ForwardDataStore();
+        if (less) db->set_comparison_function(fn_name, less);
+        if (db->configure(config) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -51,11 +85,12 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_bwtree_datastore(const std::string& name,
-                                                    const std::string& path)
+                                                    const std::string& path,
+                                                    const Json::Value& config)
     {
 #ifdef USE_BWTREE
         auto db = new BwTreeDataStore();
-        if (db->openDatabase(name, path)) {
+        if (db->configure(config) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -67,11 +102,12 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_berkeleydb_datastore(const std::string& name,
-                                                        const std::string& path)
+                                                        const std::string& path,
+                                                        const Json::Value& config)
     {
 #ifdef USE_BDB
         auto db = new BerkeleyDBDataStore();
-        if (db->openDatabase(name, path)) {
+        if (db->configure(config) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -83,11 +119,50 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_leveldb_datastore(const std::string& name,
-                                                     const std::string& path)
+                                                     const std::string& path,
+                                                     const Json::Value& config)
     {
 #ifdef USE_LEVELDB
         auto db = new LevelDBDataStore();
-        if (db->openDatabase(name, path)) {
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+#else
+        return nullptr;
+#endif
+    }
+
+    static AbstractDataStore* open_lmdb_datastore(const std::string& name,
+                                                  const std::string& path,
+                                                  const Json::Value& config)
+    {
+#ifdef USE_LMDB
+        auto db = new LMDBDataStore();
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+#else
+        return nullptr;
+#endif
+    }
+
+    static AbstractDataStore*
+    open_rocksdb_datastore(const std::string&               name,
+                           const std::string&               path,
+                           const Json::Value&               config,
+                           const std::string&               fn_name,
+                           AbstractDataStore::comparator_fn less)
+    {
+#ifdef USE_ROCKSDB
+        auto db = new RocksDBDataStore();
+        if (less) db->set_comparison_function(fn_name, less);
+        if (db->configure(config) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -98,30 +173,148 @@ class datastore_factory {
 #endif
     }
 
+    /* takes ownership of the already open inner datastore */
+    static AbstractDataStore*
+    open_compressed_datastore(AbstractDataStore* inner,
+                              const std::string& name,
+                              const std::string& path,
+                              const Json::Value& config)
+    {
+        auto db = new CompressedDataStore(inner);
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    /* takes ownership of the already open inner datastore */
+    static AbstractDataStore*
+    open_expiring_datastore(AbstractDataStore* inner,
+                            const std::string& name,
+                            const std::string& path,
+                            const Json::Value& config)
+    {
+        auto db = new ExpiringDataStore(inner);
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    /* takes ownership of the already open inner datastore */
+    static AbstractDataStore*
+    open_cached_datastore(AbstractDataStore* inner,
+                          const std::string& name,
+                          const std::string& path,
+                          const Json::Value& config)
+    {
+        auto db = new CachedDataStore(inner);
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    /* takes ownership of the already open inner datastore and log */
+    static AbstractDataStore*
+    open_changelog_datastore(AbstractDataStore* inner,
+                             AbstractDataStore* log,
+                             const std::string& name,
+                             const std::string& path,
+                             const Json::Value& config)
+    {
+        auto db = new ChangeLogDataStore(inner, log);
+        if (db->configure(config) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
   public:
 #ifdef SDSKV
-    static AbstractDataStore* open_datastore(sdskv_db_type_t    type,
-                                             const std::string& name,
-                                             const std::string& path)
+    static AbstractDataStore*
+    open_datastore(sdskv_db_type_t                  type,
+                   const std::string&               name,
+                   const std::string&               path,
+                   const Json::Value&               config
+                   = Json::Value(Json::objectValue),
+                   const std::string&               fn_name = std::string(),
+                   AbstractDataStore::comparator_fn less    = nullptr)
 #else
-    static AbstractDataStore* open_datastore(kv_db_type_t type,
-                                             const std::string& name = "db",
-                                             const std::string& path = "db")
+    static AbstractDataStore*
+    open_datastore(kv_db_type_t                     type,
+                   const std::string&               name = "db",
+                   const std::string&               path = "db",
+                   const Json::Value&               config
+                   = Json::Value(Json::objectValue),
+                   const std::string&               fn_name = std::string(),
+                   AbstractDataStore::comparator_fn less    = nullptr)
 #endif
     {
+        AbstractDataStore* db = nullptr;
         switch (type) {
         case KVDB_NULL:
-            return open_null_datastore(name, path);
+            db = open_null_datastore(name, path, config);
+            break;
         case KVDB_MAP:
-            return open_map_datastore(name, path);
+            db = open_map_datastore(name, path, config);
+            break;
         case KVDB_BWTREE:
-            return open_bwtree_datastore(name, path);
+            db = open_bwtree_datastore(name, path, config);
+            break;
         case KVDB_LEVELDB:
-            return open_leveldb_datastore(name, path);
+            db = open_leveldb_datastore(name, path, config);
+            break;
         case KVDB_BERKELEYDB:
-            return open_berkeleydb_datastore(name, path);
+            db = open_berkeleydb_datastore(name, path, config);
+            break;
+        case KVDB_FORWARDDB:
+            db = open_forward_datastore(name, path, config, fn_name, less);
+            break;
+        case KVDB_LMDB:
+            db = open_lmdb_datastore(name, path, config);
+            break;
+        case KVDB_ROCKSDB:
+            db = open_rocksdb_datastore(name, path, config, fn_name, less);
+            break;
         }
-        return nullptr;
+        /* value compression is layered on top of any backend; it has its
+         * own key since "compression" configures the blocks of LevelDB */
+        if (db && config.isObject() && config.isMember("value_compression"))
+            db = open_compressed_datastore(db, name, path, config);
+        /* and values are cached after being decompressed */
+        if (db && config.isObject() && config.isMember("cache"))
+            db = open_cached_datastore(db, name, path, config);
+        /* expiration is checked above the cache, which holds the values
+         * with their expiration time */
+        if (db && config.isObject() && config.isMember("ttl"))
+            db = open_expiring_datastore(db, name, path, config);
+        /* the change log is a second database of the same type, next to
+         * the first one, without the options of the decorators */
+        if (db && config.isObject() && config.isMember("change_log")) {
+            Json::Value log_config = config;
+            for (auto option :
+                 {"value_compression", "cache", "ttl", "change_log",
+                  "key_filter", "max_memory", "memory_policy"})
+                log_config.removeMember(option);
+            auto log = open_datastore(type, name + ".changes", path,
+                                      log_config);
+            if (log) {
+                db = open_changelog_datastore(db, log, name, path, config);
+            } else {
+                delete db;
+                db = nullptr;
+            }
+        }
+        return db;
     };
 };
 
@@ -0,0 +1,524 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "expiring_datastore.h"
+#include "kv-config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+/* Stored values start with a tag, made of a magic byte sequence and a
+ * version, followed by their expiration time, in milliseconds since the
+ * epoch, as a LEB128 varint, 0 meaning that the entry does not expire. The
+ * header of an entry that does not expire is therefore 5 bytes long, and
+ * that of one that does is 10 bytes long until the year 2109. */
+static const unsigned char header_tag[]    = {0xf5, 'T', 'T', 1};
+static const hg_size_t     tag_size        = sizeof(header_tag);
+static const hg_size_t     max_header_size = tag_size + 10;
+
+static uint64_t now_ms()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+static hg_size_t write_header(char* out, uint64_t expires)
+{
+    std::memcpy(out, header_tag, tag_size);
+    hg_size_t n = tag_size;
+    do {
+        uint8_t byte = expires & 0x7f;
+        expires >>= 7;
+        out[n++] = (char)(byte | (expires ? 0x80 : 0));
+    } while (expires);
+    return n;
+}
+
+/* returns the size of the header, 0 if the value does not start with a
+ * valid one (e.g. a value put before the database had a TTL), in which case
+ * the whole value is returned and does not expire */
+static hg_size_t
+read_header(const void* data, hg_size_t size, uint64_t* expires)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    *expires               = 0;
+    if (size < tag_size || std::memcmp(p, header_tag, tag_size) != 0)
+        return 0;
+    for (hg_size_t i = tag_size; i < std::min(size, max_header_size); i++) {
+        *expires |= (uint64_t)(p[i] & 0x7f) << (7 * (i - tag_size));
+        if (!(p[i] & 0x80)) return i + 1;
+    }
+    *expires = 0;
+    return 0;
+}
+
+static inline bool expired(uint64_t expires, uint64_t now)
+{
+    return expires != 0 && expires <= now;
+}
+
+/* calls fn on the value stored in data unless it has expired */
+static bool view_live(const void*                       data,
+                      hg_size_t                         size,
+                      uint64_t                          now,
+                      const AbstractDataStore::view_fn& fn)
+{
+    uint64_t  expires;
+    hg_size_t header = read_header(data, size, &expires);
+    if (expired(expires, now)) return false;
+    fn((const char*)data + header, size - header);
+    return true;
+}
+
+ExpiringDataStore::ExpiringDataStore(AbstractDataStore* inner)
+    : AbstractDataStore(false, false), _inner(inner)
+{
+}
+
+ExpiringDataStore::~ExpiringDataStore() {}
+
+bool ExpiringDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry:
+     * "ttl" : {
+     *    "default_ms" : <ms>   (default 0, TTL of the entries put without
+     *                           one, 0 meaning that they do not expire)
+     * }
+     **/
+    const Json::Value& cfg = config["ttl"];
+    if (!cfg.isObject()) {
+        std::cerr << "ExpiringDataStore::configure: \"ttl\" should"
+                  << " be an object" << std::endl;
+        return false;
+    }
+    if (cfg.isMember("default_ms")) {
+        if (!cfg["default_ms"].isUInt64()) {
+            std::cerr << "ExpiringDataStore::configure: \"default_ms\" should"
+                      << " be a positive integer" << std::endl;
+            return false;
+        }
+        _default_ttl = cfg["default_ms"].asUInt64();
+    }
+    return true;
+}
+
+/* the inner datastore is already open */
+bool ExpiringDataStore::openDatabase(const std::string& db_name,
+                                     const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+    return true;
+}
+
+uint64_t ExpiringDataStore::expiration(uint64_t ttl_ms)
+{
+    return ttl_ms ? now_ms() + ttl_ms : 0;
+}
+
+void ExpiringDataStore::encode(const void* value,
+                               hg_size_t   vsize,
+                               uint64_t    expires,
+                               ds_bulk_t&  out)
+{
+    char      header[max_header_size];
+    hg_size_t n = write_header(header, expires);
+    out.resize(n + vsize);
+    std::copy(header, header + n, out.begin());
+    std::copy((const char*)value, (const char*)value + vsize, out.begin() + n);
+}
+
+bool ExpiringDataStore::decode(ds_bulk_t& value, uint64_t now)
+{
+    uint64_t  expires;
+    hg_size_t header = read_header(value.data(), value.size(), &expires);
+    if (expired(expires, now)) return false;
+    value.erase(value.begin(), value.begin() + header);
+    return true;
+}
+
+int ExpiringDataStore::put_encoded(const void*      key,
+                                   hg_size_t        ksize,
+                                   const ds_bulk_t& data)
+{
+    int ret = _inner->put(key, ksize, data.data(), data.size());
+    if (ret != SDSKV_ERR_KEYEXISTS || exists(key, ksize)) return ret;
+    _inner->erase(ds_bulk_t((const char*)key, (const char*)key + ksize));
+    return _inner->put(key, ksize, data.data(), data.size());
+}
+
+int ExpiringDataStore::put(const void* key,
+                           hg_size_t   ksize,
+                           const void* value,
+                           hg_size_t   vsize)
+{
+    ds_bulk_t encoded;
+    encode(value, vsize, expiration(_default_ttl), encoded);
+    return put_encoded(key, ksize, encoded);
+}
+
+int ExpiringDataStore::put(ds_bulk_t&& key, ds_bulk_t&& data)
+{
+    return put(key.data(), key.size(), data.data(), data.size());
+}
+
+int ExpiringDataStore::put_ttl(const void* key,
+                               hg_size_t   ksize,
+                               const void* value,
+                               hg_size_t   vsize,
+                               uint64_t    ttl_ms)
+{
+    ds_bulk_t encoded;
+    encode(value, vsize, expiration(ttl_ms), encoded);
+    return put_encoded(key, ksize, encoded);
+}
+
+int ExpiringDataStore::put_multi(hg_size_t          num_items,
+                                 const void* const* keys,
+                                 const hg_size_t*   ksizes,
+                                 const void* const* values,
+                                 const hg_size_t*   vsizes)
+{
+    /* expired entries may have to be replaced one by one */
+    if (_no_overwrite)
+        return AbstractDataStore::put_multi(num_items, keys, ksizes, values,
+                                            vsizes);
+    uint64_t                 expires = expiration(_default_ttl);
+    std::vector<ds_bulk_t>   encoded(num_items);
+    std::vector<const void*> ptrs(num_items);
+    std::vector<hg_size_t>   sizes(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        encode(values[i], vsizes[i], expires, encoded[i]);
+        ptrs[i]  = encoded[i].data();
+        sizes[i] = encoded[i].size();
+    }
+    return _inner->put_multi(num_items, keys, ksizes, ptrs.data(),
+                             sizes.data());
+}
+
+int ExpiringDataStore::put_packed(hg_size_t        num_items,
+                                  const char*      keys,
+                                  const hg_size_t* ksizes,
+                                  const char*      values,
+                                  const hg_size_t* vsizes)
+{
+    std::vector<const void*> kptrs(num_items);
+    std::vector<const void*> vptrs(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        kptrs[i] = keys;
+        vptrs[i] = values;
+        keys += ksizes[i];
+        values += vsizes[i];
+    }
+    return put_multi(num_items, kptrs.data(), ksizes, vptrs.data(), vsizes);
+}
+
+bool ExpiringDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    if (!_inner->get(key, data)) return false;
+    if (decode(data, now_ms())) return true;
+    data.clear();
+    return false;
+}
+
+bool ExpiringDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    std::vector<ds_bulk_t> values;
+    if (!_inner->get(key, values)) return false;
+    uint64_t now = now_ms();
+    data.clear();
+    for (auto& value : values)
+        if (decode(value, now)) data.push_back(std::move(value));
+    return !data.empty();
+}
+
+bool ExpiringDataStore::get_view(const void*    key,
+                                 hg_size_t      ksize,
+                                 const view_fn& fn)
+{
+    uint64_t now  = now_ms();
+    bool     live = false;
+    _inner->get_view(key, ksize, [&](const void* data, hg_size_t size) {
+        live = view_live(data, size, now, fn);
+    });
+    return live;
+}
+
+void ExpiringDataStore::get_multi_view(hg_size_t            num_keys,
+                                       const void* const*   keys,
+                                       const hg_size_t*     ksizes,
+                                       const multi_view_fn& fn)
+{
+    uint64_t now = now_ms();
+    _inner->get_multi_view(
+        num_keys, keys, ksizes,
+        [&](hg_size_t i, const void* data, hg_size_t size) {
+            view_live(data, size, now,
+                      [&](const void* value, hg_size_t vsize) {
+                          fn(i, value, vsize);
+                      });
+        });
+}
+
+bool ExpiringDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    return get_view(key.data(), key.size(),
+                    [&](const void* data, hg_size_t size) { *vsize = size; });
+}
+
+bool ExpiringDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    uint64_t now  = now_ms();
+    bool     live = false;
+    _inner->get_view(key, ksize, [&](const void* data, hg_size_t size) {
+        uint64_t expires;
+        read_header(data, size, &expires);
+        live = !expired(expires, now);
+    });
+    return live;
+}
+
+bool ExpiringDataStore::erase(const ds_bulk_t& key)
+{
+    return _inner->erase(key);
+}
+
+int ExpiringDataStore::erase_range(const ds_bulk_t& lower,
+                                   const ds_bulk_t& upper,
+                                   hg_size_t*       num_erased)
+{
+    return _inner->erase_range(lower, upper, num_erased);
+}
+
+int ExpiringDataStore::erase_prefixed(const ds_bulk_t& prefix,
+                                      hg_size_t*       num_erased)
+{
+    return _inner->erase_prefixed(prefix, num_erased);
+}
+
+bool ExpiringDataStore::key_less(const ds_bulk_t& a, const ds_bulk_t& b) const
+{
+    if (_less) return _less(a.data(), a.size(), b.data(), b.size()) < 0;
+    return bytewise_less(a, b);
+}
+
+/* adds an entry to the counts unless it has expired, without its header */
+static void count_live(const ds_bulk_t& key,
+                       ds_bulk_t&       value,
+                       uint64_t         now,
+                       ds_count_t&      result)
+{
+    uint64_t  expires;
+    hg_size_t header = read_header(value.data(), value.size(), &expires);
+    if (expired(expires, now)) return;
+    result.num_keys += 1;
+    result.key_bytes += key.size();
+    result.value_bytes += value.size() - header;
+}
+
+/* the expiration time of each entry has to be read, so the entries of the
+ * range are listed with their values, a batch at a time */
+int ExpiringDataStore::count_range(const ds_bulk_t& lower,
+                                   const ds_bulk_t& upper,
+                                   bool             with_sizes,
+                                   ds_count_t&      result) const
+{
+    uint64_t now = now_ms();
+    result       = ds_count_t();
+    if (!lower.empty() && !upper.empty() && !key_less(lower, upper))
+        return SDSKV_SUCCESS;
+    /* listings start after their first key */
+    ds_bulk_t value;
+    if (!lower.empty() && _inner->get(lower, value))
+        count_live(lower, value, now, result);
+    ds_bulk_t from = lower;
+    while (true) {
+        auto batch = _inner->list_keyvals(from, erase_batch_size);
+        for (auto& p : batch) {
+            if (!upper.empty() && !key_less(p.first, upper))
+                return SDSKV_SUCCESS;
+            count_live(p.first, p.second, now, result);
+        }
+        if (batch.size() < erase_batch_size) break;
+        from = batch.back().first;
+    }
+    return SDSKV_SUCCESS;
+}
+
+int ExpiringDataStore::count_prefixed(const ds_bulk_t& prefix,
+                                      bool             with_sizes,
+                                      ds_count_t&      result) const
+{
+    uint64_t  now = now_ms();
+    ds_bulk_t from;
+    result = ds_count_t();
+    while (true) {
+        auto batch = _inner->list_keyvals(from, erase_batch_size, prefix);
+        for (auto& p : batch) count_live(p.first, p.second, now, result);
+        if (batch.size() < erase_batch_size) break;
+        from = batch.back().first;
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* fn sees an expired entry as missing; the entry keeps its expiration time
+ * if it exists, and otherwise gets the default TTL */
+int ExpiringDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    uint64_t now = now_ms();
+    return _inner->update(
+        key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+            ds_bulk_t value, result;
+            uint64_t  expires = 0;
+            bool      live    = current != nullptr;
+            if (current) {
+                value = *current;
+                read_header(current->data(), current->size(), &expires);
+                live = decode(value, now);
+            }
+            if (!live) expires = expiration(_default_ttl);
+            if (!fn(live ? &value : nullptr, result)) return false;
+            encode(result.data(), result.size(), expires, new_value);
+            return true;
+        });
+}
+
+/* the entries are listed with their values to read their expiration time,
+ * and each expired entry is checked again right before being erased, in
+ * case it was put again in the meantime */
+int ExpiringDataStore::reclaim_expired(ds_bulk_t& cursor,
+                                       hg_size_t  batch_size,
+                                       hg_size_t* num_erased)
+{
+    *num_erased = 0;
+    auto     batch = _inner->list_keyvals(cursor, batch_size);
+    uint64_t now   = now_ms();
+    for (const auto& p : batch) {
+        uint64_t expires;
+        read_header(p.second.data(), p.second.size(), &expires);
+        if (!expired(expires, now) || exists(p.first.data(), p.first.size()))
+            continue;
+        if (_inner->erase(p.first)) *num_erased += 1;
+    }
+    if (batch.size() < batch_size)
+        cursor.clear();
+    else
+        cursor = batch.back().first;
+    return SDSKV_SUCCESS;
+}
+
+void ExpiringDataStore::set_in_memory(bool enable)
+{
+    _inner->set_in_memory(enable);
+}
+
+void ExpiringDataStore::set_comparison_function(const std::string& name,
+                                                comparator_fn      less)
+{
+    _comp_fun_name = name;
+    _less          = less;
+    _inner->set_comparison_function(name, less);
+}
+
+void ExpiringDataStore::set_key_shortening_functions(separator_fn separator,
+                                                     successor_fn successor)
+{
+    _inner->set_key_shortening_functions(separator, successor);
+}
+
+void ExpiringDataStore::set_no_overwrite()
+{
+    _no_overwrite = true;
+    _inner->set_no_overwrite();
+}
+
+void ExpiringDataStore::set_eviction_handler(const evicted_fn& fn)
+{
+    _inner->set_eviction_handler(fn);
+}
+
+void ExpiringDataStore::sync() { _inner->sync(); }
+
+int ExpiringDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    return _inner->compact(lower, upper);
+}
+
+bool ExpiringDataStore::memory_usage(ds_memory_t& usage) const
+{
+    return _inner->memory_usage(usage);
+}
+
+bool ExpiringDataStore::cache_usage(ds_cache_t& usage) const
+{
+    return _inner->cache_usage(usage);
+}
+
+/* the listings skip the expired entries, reading more entries from the
+ * inner datastore until count entries are found or there are no more */
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+ExpiringDataStore::vlist_keyvals(const ds_bulk_t& start,
+                                 hg_size_t        count,
+                                 const ds_bulk_t& prefix) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    ds_bulk_t                                    from = start;
+    uint64_t                                     now  = now_ms();
+    while (result.size() < count) {
+        hg_size_t n     = count - result.size();
+        auto      batch = _inner->list_keyvals(from, n, prefix);
+        if (!batch.empty()) from = batch.back().first;
+        for (auto& p : batch)
+            if (decode(p.second, now)) result.push_back(std::move(p));
+        if (batch.size() < n) break;
+    }
+    return result;
+}
+
+std::vector<ds_bulk_t> ExpiringDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    std::vector<ds_bulk_t> result;
+    for (auto& p : vlist_keyvals(start, count, prefix))
+        result.push_back(std::move(p.first));
+    return result;
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+ExpiringDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                      const ds_bulk_t& upper_bound,
+                                      hg_size_t        max_keys) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    ds_bulk_t                                    from = lower_bound;
+    uint64_t                                     now  = now_ms();
+    while (true) {
+        /* max_keys = 0 means no limit */
+        hg_size_t n     = max_keys ? max_keys - result.size() : 0;
+        auto      batch = _inner->list_keyval_range(from, upper_bound, n);
+        if (!batch.empty()) from = batch.back().first;
+        for (auto& p : batch)
+            if (decode(p.second, now)) result.push_back(std::move(p));
+        if (n == 0 || batch.size() < n || result.size() == max_keys) break;
+    }
+    return result;
+}
+
+std::vector<ds_bulk_t>
+ExpiringDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                   const ds_bulk_t& upper_bound,
+                                   hg_size_t        max_keys) const
+{
+    std::vector<ds_bulk_t> result;
+    for (auto& p : vlist_keyval_range(lower_bound, upper_bound, max_keys))
+        result.push_back(std::move(p.first));
+    return result;
+}
+
+#ifdef USE_REMI
+remi_fileset_t ExpiringDataStore::create_and_populate_fileset() const
+{
+    return _inner->create_and_populate_fileset();
+}
+#endif
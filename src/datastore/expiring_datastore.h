@@ -0,0 +1,128 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef expiring_datastore_h
+#define expiring_datastore_h
+
+#include <memory>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// datastore whose entries expire, on top of another datastore, which it
+// owns. Values are stored behind a header holding their expiration time,
+// given by the TTL of the put or by the database's default TTL. Expired
+// entries are hidden from reads and listings until reclaim_expired erases
+// them.
+class ExpiringDataStore : public AbstractDataStore {
+
+  public:
+    ExpiringDataStore(AbstractDataStore* inner);
+    virtual ~ExpiringDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put(ds_bulk_t&& key, ds_bulk_t&& data) override;
+    virtual int  put_ttl(const void* key,
+                         hg_size_t   ksize,
+                         const void* value,
+                         hg_size_t   vsize,
+                         uint64_t    ttl_ms) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool
+    get_view(const void* key, hg_size_t ksize, const view_fn& fn) override;
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  erase_prefixed(const ds_bulk_t& prefix,
+                                hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual int  count_prefixed(const ds_bulk_t& prefix,
+                                bool             with_sizes,
+                                ds_count_t&      result) const override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  reclaim_expired(ds_bulk_t& cursor,
+                                 hg_size_t  batch_size,
+                                 hg_size_t* num_erased) override;
+    virtual void set_in_memory(bool enable) override;
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
+    virtual void set_no_overwrite() override;
+    virtual void set_eviction_handler(const evicted_fn& fn) override;
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+    virtual bool memory_usage(ds_memory_t& usage) const override;
+    virtual bool cache_usage(ds_cache_t& usage) const override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+  private:
+    // expiration time, in milliseconds since the epoch, of an entry put
+    // now with the given TTL; 0 if it does not expire
+    static uint64_t expiration(uint64_t ttl_ms);
+    static void     encode(const void* value,
+                           hg_size_t   vsize,
+                           uint64_t    expires,
+                           ds_bulk_t&  out);
+    // strips the header of a stored value in place; returns false if the
+    // entry has expired
+    static bool decode(ds_bulk_t& value, uint64_t now);
+    // puts an encoded value, replacing an expired entry of the key in
+    // databases that do not allow overwriting
+    int put_encoded(const void* key, hg_size_t ksize, const ds_bulk_t& data);
+    // ordering of the keys, used to find the end of a counted range
+    bool key_less(const ds_bulk_t& a, const ds_bulk_t& b) const;
+
+    std::unique_ptr<AbstractDataStore> _inner;
+    comparator_fn                      _less        = nullptr;
+    uint64_t                           _default_ttl = 0; // in ms, 0 = none
+};
+
+#endif // expiring_datastore_h
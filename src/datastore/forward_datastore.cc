@@ -0,0 +1,576 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#define SDSKV
+#include "forward_datastore.h"
+#include "datastore_factory.h"
+#include "kv-config.h"
+#include <iostream>
+#include <time.h>
+
+/* approximate memory used by an entry of the front tier besides its key and
+ * value (map and list nodes) */
+static const size_t entry_overhead
+    = 64 + sizeof(ds_bulk_t) + sizeof(void*) * 3;
+
+ForwardDataStore::ForwardDataStore()
+    : AbstractDataStore(false, false), _less(nullptr), _front(keycmp(this))
+{
+    ABT_mutex_create(&_mutex);
+    ABT_cond_create(&_flusher_cond);
+    ABT_cond_create(&_flushed_cond);
+}
+
+ForwardDataStore::ForwardDataStore(bool eraseOnGet, bool debug)
+    : AbstractDataStore(eraseOnGet, debug), _less(nullptr),
+      _front(keycmp(this))
+{
+    ABT_mutex_create(&_mutex);
+    ABT_cond_create(&_flusher_cond);
+    ABT_cond_create(&_flushed_cond);
+}
+
+ForwardDataStore::~ForwardDataStore()
+{
+    if (_flusher != ABT_THREAD_NULL) {
+        ABT_mutex_lock(_mutex);
+        _flusher_stop = true;
+        ABT_cond_signal(_flusher_cond);
+        ABT_mutex_unlock(_mutex);
+        ABT_thread_join(_flusher);
+        ABT_thread_free(&_flusher);
+    }
+    if (_back) {
+        ABT_mutex_lock(_mutex);
+        if (flush() != SDSKV_SUCCESS) {
+            std::cerr << "ForwardDataStore: could not write " << _num_dirty
+                      << " modified entries to the back tier" << std::endl;
+        }
+        ABT_mutex_unlock(_mutex);
+    }
+    ABT_cond_free(&_flushed_cond);
+    ABT_cond_free(&_flusher_cond);
+    ABT_mutex_free(&_mutex);
+}
+
+bool ForwardDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry (all optional):
+     * {
+     *    "backend" : "leveldb" | "berkeleydb" | "lmdb" | "rocksdb",
+     *    "backend_config" : { ... },        (options of the back tier)
+     *    "write_policy" : "write-back" | "write-through",
+     *    "cache_size" : <bytes>,            (memory budget of the front tier)
+     *    "flush_interval" : <seconds>       (period of the write-back flusher)
+     * }
+     **/
+    if (!config.isObject()) return true;
+
+    if (config.isMember("backend")) {
+        std::string backend;
+        if (config["backend"].isString())
+            backend = config["backend"].asString();
+        if (backend == "leveldb" || backend == "ldb")
+            _back_type = KVDB_LEVELDB;
+        else if (backend == "berkeleydb" || backend == "bdb")
+            _back_type = KVDB_BERKELEYDB;
+        else if (backend == "lmdb" || backend == "mdb")
+            _back_type = KVDB_LMDB;
+        else if (backend == "rocksdb" || backend == "rdb")
+            _back_type = KVDB_ROCKSDB;
+        else {
+            std::cerr << "ForwardDataStore::configure: invalid backend \""
+                      << backend << "\"" << std::endl;
+            return false;
+        }
+    }
+    if (config.isMember("backend_config")) {
+        if (!config["backend_config"].isObject()) {
+            std::cerr << "ForwardDataStore::configure: \"backend_config\""
+                      << " should be an object" << std::endl;
+            return false;
+        }
+        _back_config = config["backend_config"];
+    }
+    if (config.isMember("write_policy")) {
+        std::string policy;
+        if (config["write_policy"].isString())
+            policy = config["write_policy"].asString();
+        if (policy == "write-back")
+            _write_back = true;
+        else if (policy == "write-through")
+            _write_back = false;
+        else {
+            std::cerr << "ForwardDataStore::configure: invalid write policy \""
+                      << policy << "\"" << std::endl;
+            return false;
+        }
+    }
+    if (config.isMember("cache_size")) {
+        if (!config["cache_size"].isUInt64()) {
+            std::cerr << "ForwardDataStore::configure: \"cache_size\""
+                      << " should be a positive integer" << std::endl;
+            return false;
+        }
+        _cache_size = config["cache_size"].asUInt64();
+    }
+    if (config.isMember("flush_interval")) {
+        if (!config["flush_interval"].isNumeric()
+            || config["flush_interval"].asDouble() <= 0) {
+            std::cerr << "ForwardDataStore::configure: \"flush_interval\""
+                      << " should be a positive number" << std::endl;
+            return false;
+        }
+        _flush_interval = config["flush_interval"].asDouble();
+    }
+    return true;
+}
+
+bool ForwardDataStore::openDatabase(const std::string& db_name,
+                                    const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+
+    _back.reset(datastore_factory::open_datastore(
+        _back_type, db_name, db_path, _back_config, _comp_fun_name, _less));
+    if (!_back) {
+        std::cerr << "ForwardDataStore::openDatabase: could not open back tier"
+                  << std::endl;
+        return false;
+    }
+    if (_write_back) {
+        /* the flusher runs in the pool of the calling execution stream */
+        ABT_xstream xstream;
+        ABT_pool    pool;
+        ABT_xstream_self(&xstream);
+        ABT_xstream_get_main_pools(xstream, 1, &pool);
+        int ret = ABT_thread_create(pool, flusher_ult, this,
+                                    ABT_THREAD_ATTR_NULL, &_flusher);
+        if (ret != ABT_SUCCESS) {
+            std::cerr << "ForwardDataStore::openDatabase: could not create"
+                      << " flusher thread" << std::endl;
+            _flusher = ABT_THREAD_NULL;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ForwardDataStore::flusher_ult(void* arg)
+{
+    ForwardDataStore* store    = static_cast<ForwardDataStore*>(arg);
+    double            interval = store->_flush_interval;
+
+    ABT_mutex_lock(store->_mutex);
+    while (!store->_flusher_stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)interval;
+        deadline.tv_nsec += (long)((interval - (time_t)interval) * 1e9);
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+        ABT_cond_timedwait(store->_flusher_cond, store->_mutex, &deadline);
+        if (store->_flusher_stop) break;
+        if (store->_num_dirty && store->background_flush() != SDSKV_SUCCESS) {
+            std::cerr << "ForwardDataStore: background flush failed"
+                      << std::endl;
+        }
+    }
+    ABT_mutex_unlock(store->_mutex);
+}
+
+ForwardDataStore::front_t::iterator ForwardDataStore::insert(
+    const ds_bulk_t& key, const ds_bulk_t& value, bool dirty, bool deleted)
+{
+    auto it = _front.find(key);
+    if (it == _front.end()) {
+        it = _front.emplace(key, entry()).first;
+        _lru.push_front(&it->first);
+        it->second.lru = _lru.begin();
+        _front_size += key.size() + entry_overhead;
+    } else {
+        _front_size -= it->second.value.size();
+        if (it->second.dirty) _num_dirty -= 1;
+        touch(it);
+    }
+    it->second.value   = value;
+    it->second.dirty   = dirty;
+    it->second.deleted = deleted;
+    it->second.version = ++_version;
+    _front_size += value.size();
+    if (dirty) _num_dirty += 1;
+    return it;
+}
+
+void ForwardDataStore::remove(front_t::iterator it)
+{
+    _front_size -= it->first.size() + it->second.value.size() + entry_overhead;
+    if (it->second.dirty) _num_dirty -= 1;
+    _lru.erase(it->second.lru);
+    _front.erase(it);
+}
+
+void ForwardDataStore::touch(front_t::iterator it)
+{
+    _lru.splice(_lru.begin(), _lru, it->second.lru);
+}
+
+int ForwardDataStore::write_back(front_t::iterator it)
+{
+    if (!it->second.dirty) return SDSKV_SUCCESS;
+    if (it->second.deleted) {
+        /* the key may never have reached the back tier */
+        _back->erase(it->first);
+    } else {
+        int ret = _back->put(it->first, it->second.value);
+        if (ret != SDSKV_SUCCESS) return ret;
+    }
+    it->second.dirty = false;
+    _num_dirty -= 1;
+    return SDSKV_SUCCESS;
+}
+
+void ForwardDataStore::evict()
+{
+    /* least recently used entries go first, after being written back if
+     * they were modified, which must not race with a background flush */
+    while (_front_size > _cache_size && !_lru.empty()) {
+        auto it = _front.find(*_lru.back());
+        if (it->second.dirty && _flushing) {
+            wait_for_flusher();
+            continue;
+        }
+        if (write_back(it) != SDSKV_SUCCESS) break;
+        remove(it);
+    }
+}
+
+/* a key being written by the background flusher must not be written
+ * concurrently with another value, which could land first */
+void ForwardDataStore::wait_for_flusher()
+{
+    while (_flushing) ABT_cond_wait(_flushed_cond, _mutex);
+}
+
+int ForwardDataStore::flush()
+{
+    wait_for_flusher();
+    int ret = SDSKV_SUCCESS;
+    for (auto it = _front.begin(); it != _front.end();) {
+        auto current = it++;
+        int  r       = write_back(current);
+        if (r != SDSKV_SUCCESS) {
+            ret = r;
+        } else if (current->second.deleted) {
+            remove(current);
+        }
+    }
+    return ret;
+}
+
+/* the dirty entries are copied so that the back tier is written without
+ * blocking the other operations; the entries modified meanwhile stay
+ * dirty, to be written by the next flush */
+int ForwardDataStore::background_flush()
+{
+    struct pending {
+        ds_bulk_t key;
+        ds_bulk_t value;
+        bool      deleted;
+        uint64_t  version; // 0 once the write failed
+    };
+    std::vector<pending> batch;
+    batch.reserve(_num_dirty);
+    for (const auto& e : _front) {
+        if (!e.second.dirty) continue;
+        batch.push_back(
+            {e.first, e.second.value, e.second.deleted, e.second.version});
+    }
+    _flushing = true;
+    ABT_mutex_unlock(_mutex);
+
+    int ret = SDSKV_SUCCESS;
+    for (auto& p : batch) {
+        if (p.deleted) {
+            /* the key may never have reached the back tier */
+            _back->erase(p.key);
+        } else {
+            int r = _back->put(p.key, p.value);
+            if (r != SDSKV_SUCCESS) {
+                ret       = r;
+                p.version = 0;
+            }
+        }
+    }
+
+    ABT_mutex_lock(_mutex);
+    for (const auto& p : batch) {
+        if (p.version == 0) continue;
+        auto it = _front.find(p.key);
+        if (it == _front.end() || it->second.version != p.version) continue;
+        it->second.dirty = false;
+        _num_dirty -= 1;
+        if (it->second.deleted) remove(it);
+    }
+    _flushing = false;
+    ABT_cond_broadcast(_flushed_cond);
+    return ret;
+}
+
+int ForwardDataStore::put(const void* key,
+                          hg_size_t   ksize,
+                          const void* value,
+                          hg_size_t   vsize)
+{
+    ds_bulk_t k((const char*)key, (const char*)key + ksize);
+    ds_bulk_t v((const char*)value, (const char*)value + vsize);
+    int       ret = SDSKV_SUCCESS;
+
+    ABT_mutex_lock(_mutex);
+    if (_no_overwrite) {
+        auto it = _front.find(k);
+        if (it != _front.end() ? !it->second.deleted : _back->exists(k)) {
+            ABT_mutex_unlock(_mutex);
+            return SDSKV_ERR_KEYEXISTS;
+        }
+    }
+    if (_write_back) {
+        insert(k, v, true);
+    } else {
+        ret = _back->put(k, v);
+        if (ret == SDSKV_SUCCESS) insert(k, v, false);
+    }
+    evict();
+    ABT_mutex_unlock(_mutex);
+    return ret;
+}
+
+bool ForwardDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    ABT_mutex_lock(_mutex);
+    auto it = _front.find(key);
+    if (it != _front.end()) {
+        touch(it);
+        bool found = !it->second.deleted;
+        if (found) data = it->second.value;
+        ABT_mutex_unlock(_mutex);
+        return found;
+    }
+    bool found = _back->get(key, data);
+    if (found) {
+        insert(key, data, false);
+        evict();
+    }
+    ABT_mutex_unlock(_mutex);
+    return found;
+}
+
+bool ForwardDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    data.clear();
+    data.resize(1);
+    return get(key, data[0]);
+}
+
+bool ForwardDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    ABT_mutex_lock(_mutex);
+    auto it = _front.find(key);
+    bool found;
+    if (it != _front.end()) {
+        found = !it->second.deleted;
+        if (found) *vsize = it->second.value.size();
+    } else {
+        found = _back->length(key, vsize);
+    }
+    ABT_mutex_unlock(_mutex);
+    return found;
+}
+
+bool ForwardDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    ds_bulk_t k((const char*)key, (const char*)key + ksize);
+    ABT_mutex_lock(_mutex);
+    auto it     = _front.find(k);
+    bool exists = it != _front.end() ? !it->second.deleted : _back->exists(k);
+    ABT_mutex_unlock(_mutex);
+    return exists;
+}
+
+bool ForwardDataStore::erase(const ds_bulk_t& key)
+{
+    ABT_mutex_lock(_mutex);
+    auto it      = _front.find(key);
+    bool existed = it != _front.end() ? !it->second.deleted
+                                      : _back->exists(key);
+    if (existed) {
+        if (_write_back) {
+            /* the tombstone hides the key until it is erased from the back
+             * tier by the flusher */
+            insert(key, ds_bulk_t(), true, true);
+        } else {
+            if (it != _front.end()) remove(it);
+            existed = _back->erase(key);
+        }
+    }
+    ABT_mutex_unlock(_mutex);
+    return existed;
+}
+
+/* the front tier is flushed so that the back tier holds all the keys of the
+ * range, and the keys of the range are dropped from it */
+int ForwardDataStore::erase_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  hg_size_t*       num_erased)
+{
+    ABT_mutex_lock(_mutex);
+    flush();
+    auto it = lower.empty() ? _front.begin() : _front.lower_bound(lower);
+    while (it != _front.end()
+           && (upper.empty() || _front.key_comp()(it->first, upper)))
+        remove(it++);
+    int ret = _back->erase_range(lower, upper, num_erased);
+    ABT_mutex_unlock(_mutex);
+    return ret;
+}
+
+int ForwardDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    ds_bulk_t        value, new_value;
+    const ds_bulk_t* current = nullptr;
+    int              ret     = SDSKV_SUCCESS;
+
+    ABT_mutex_lock(_mutex);
+    auto it = _front.find(key);
+    if (it != _front.end()) {
+        if (!it->second.deleted) current = &it->second.value;
+    } else if (_back->get(key, value)) {
+        current = &value;
+    }
+    if (fn(current, new_value)) {
+        if (current && _no_overwrite) {
+            ret = SDSKV_ERR_KEYEXISTS;
+        } else if (_write_back) {
+            insert(key, new_value, true);
+        } else {
+            ret = _back->put(key, new_value);
+            if (ret == SDSKV_SUCCESS) insert(key, new_value, false);
+        }
+        evict();
+    }
+    ABT_mutex_unlock(_mutex);
+    return ret;
+}
+
+int ForwardDataStore::count_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  bool             with_sizes,
+                                  ds_count_t&      result) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->count_range(lower, upper, with_sizes, result);
+}
+
+int ForwardDataStore::count_prefixed(const ds_bulk_t& prefix,
+                                     bool             with_sizes,
+                                     ds_count_t&      result) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->count_prefixed(prefix, with_sizes, result);
+}
+
+void ForwardDataStore::set_in_memory(bool enable) {}
+
+void ForwardDataStore::set_comparison_function(const std::string& name,
+                                               comparator_fn      less)
+{
+    ABT_mutex_lock(_mutex);
+    _comp_fun_name = name;
+    _less          = less;
+    /* before the database is opened, it is given to the back tier when
+     * the latter is opened */
+    if (_back) _back->set_comparison_function(name, less);
+    ABT_mutex_unlock(_mutex);
+}
+
+void ForwardDataStore::set_key_shortening_functions(separator_fn separator,
+                                                    successor_fn successor)
+{
+    _back->set_key_shortening_functions(separator, successor);
+}
+
+void ForwardDataStore::sync()
+{
+    ABT_mutex_lock(_mutex);
+    flush();
+    ABT_mutex_unlock(_mutex);
+    _back->sync();
+}
+
+int ForwardDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    ABT_mutex_lock(_mutex);
+    flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->compact(lower, upper);
+}
+
+/* listing operations are served by the back tier, after the modifications
+ * held by the front tier have been written to it */
+std::vector<ds_bulk_t> ForwardDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->list_keys(start, count, prefix);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>> ForwardDataStore::vlist_keyvals(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->list_keyvals(start, count, prefix);
+}
+
+std::vector<ds_bulk_t>
+ForwardDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                  const ds_bulk_t& upper_bound,
+                                  hg_size_t        max_keys) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->list_key_range(lower_bound, upper_bound, max_keys);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+ForwardDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                     const ds_bulk_t& upper_bound,
+                                     hg_size_t        max_keys) const
+{
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->list_keyval_range(lower_bound, upper_bound, max_keys);
+}
+
+#ifdef USE_REMI
+remi_fileset_t ForwardDataStore::create_and_populate_fileset() const
+{
+    /* the database is migrated as its back tier */
+    ABT_mutex_lock(_mutex);
+    const_cast<ForwardDataStore*>(this)->flush();
+    ABT_mutex_unlock(_mutex);
+    return _back->create_and_populate_fileset();
+}
+#endif
@@ -0,0 +1,144 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef forward_datastore_h
+#define forward_datastore_h
+
+#include <list>
+#include <map>
+#include <memory>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// two-tier datastore: an in-memory ordered front tier, bounded in size,
+// caching a persistent back tier (e.g. LevelDB or BerkeleyDB) to which
+// modifications are forwarded either immediately (write-through) or by a
+// background flusher (write-back)
+class ForwardDataStore : public AbstractDataStore {
+
+  private:
+    struct keycmp {
+        ForwardDataStore* _store;
+        keycmp(ForwardDataStore* store) : _store(store) {}
+        bool operator()(const ds_bulk_t& a, const ds_bulk_t& b) const
+        {
+            if (_store->_less)
+                return _store->_less((const void*)a.data(), a.size(),
+                                     (const void*)b.data(), b.size())
+                     < 0;
+            else
+                return bytewise_less(a, b);
+        }
+    };
+
+    // entries are kept in LRU order; dirty entries have not been written
+    // to the back tier yet, and deleted entries are dirty tombstones. The
+    // version changes each time the entry is modified.
+    struct entry {
+        ds_bulk_t                             value;
+        bool                                  dirty   = false;
+        bool                                  deleted = false;
+        uint64_t                              version = 0;
+        std::list<const ds_bulk_t*>::iterator lru;
+    };
+
+  public:
+    ForwardDataStore();
+    ForwardDataStore(bool eraseOnGet, bool debug);
+    virtual ~ForwardDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual int  count_prefixed(const ds_bulk_t& prefix,
+                                bool             with_sizes,
+                                ds_count_t&      result) const override;
+    virtual void set_in_memory(bool enable) override; // not supported, a no-op
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
+    virtual void set_no_overwrite() override { _no_overwrite = true; }
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+  private:
+    typedef std::map<ds_bulk_t, entry, keycmp> front_t;
+
+    // the following functions must be called with _mutex locked
+    front_t::iterator insert(const ds_bulk_t& key,
+                             const ds_bulk_t& value,
+                             bool             dirty,
+                             bool             deleted = false);
+    void              remove(front_t::iterator it);
+    void              touch(front_t::iterator it);
+    void              evict();
+    int               write_back(front_t::iterator it);
+    int               flush();
+    // writes the dirty entries to the back tier with _mutex unlocked
+    int               background_flush();
+    void              wait_for_flusher();
+
+    static void flusher_ult(void* arg);
+
+    AbstractDataStore::comparator_fn   _less;
+    std::unique_ptr<AbstractDataStore> _back;
+    sdskv_db_type_t                    _back_type = KVDB_LEVELDB;
+    Json::Value                        _back_config;
+    bool                               _write_back     = true;
+    size_t                             _cache_size     = 64 << 20;
+    double                             _flush_interval = 1.0;
+
+    front_t                     _front;
+    std::list<const ds_bulk_t*> _lru;
+    size_t                      _front_size   = 0;
+    size_t                      _num_dirty    = 0;
+    uint64_t                    _version      = 0;
+    ABT_mutex                   _mutex        = ABT_MUTEX_NULL;
+    ABT_cond                    _flusher_cond = ABT_COND_NULL;
+    ABT_cond                    _flushed_cond = ABT_COND_NULL;
+    ABT_thread                  _flusher      = ABT_THREAD_NULL;
+    bool                        _flusher_stop = false;
+    bool                        _flushing     = false; // background flush
+};
+
+#endif // forward_datastore_h
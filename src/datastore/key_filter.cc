@@ -0,0 +1,279 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "key_filter.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// filters are never sized for fewer keys than this
+static const size_t min_capacity = 1024;
+
+/* FNV-1a followed by a final avalanche step */
+static uint64_t hash_key(const void* data, size_t size)
+{
+    uint64_t h = ds_hash_key(data, size);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+KeyFilter::bitset::bitset(size_t n)
+    : words(new std::atomic<uint64_t>[(n + 63) / 64]),
+      num_bits(((n + 63) / 64) * 64)
+{
+    for (size_t i = 0; i < num_bits / 64; i++)
+        words[i].store(0, std::memory_order_relaxed);
+}
+
+/* the probes are derived from a single hash by double hashing */
+void KeyFilter::bitset::set(uint64_t h, unsigned num_probes)
+{
+    uint64_t delta = (h >> 17) | (h << 47);
+    for (unsigned i = 0; i < num_probes; i++) {
+        uint64_t bit = h % num_bits;
+        words[bit / 64].fetch_or(1ULL << (bit % 64),
+                                 std::memory_order_relaxed);
+        h += delta;
+    }
+}
+
+bool KeyFilter::bitset::test(uint64_t h, unsigned num_probes) const
+{
+    uint64_t delta = (h >> 17) | (h << 47);
+    for (unsigned i = 0; i < num_probes; i++) {
+        uint64_t bit = h % num_bits;
+        if (!(words[bit / 64].load(std::memory_order_relaxed)
+              & (1ULL << (bit % 64))))
+            return false;
+        h += delta;
+    }
+    return true;
+}
+
+KeyFilter::KeyFilter()
+{
+    ABT_rwlock_create(&_lock);
+    ABT_mutex_create(&_pending_mtx);
+    ABT_mutex_create(&_rebuilder_mtx);
+    ABT_cond_create(&_rebuilder_cond);
+}
+
+KeyFilter::~KeyFilter()
+{
+    detach();
+    ABT_cond_free(&_rebuilder_cond);
+    ABT_mutex_free(&_rebuilder_mtx);
+    ABT_rwlock_free(&_lock);
+    ABT_mutex_free(&_pending_mtx);
+}
+
+bool KeyFilter::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry:
+     * "key_filter" : {
+     *    "bits_per_key" : <int>,           (default 10)
+     *    "prefix_length" : <bytes>,        (0, the default, disables the
+     *                                       prefix filter)
+     *    "rebuild_erase_ratio" : <number>  (default 0.5)
+     * }
+     **/
+    if (!config.isObject() || !config.isMember("key_filter")) return true;
+    const Json::Value& cfg = config["key_filter"];
+    if (!cfg.isObject()) {
+        std::cerr << "KeyFilter::configure: \"key_filter\" should be an object"
+                  << std::endl;
+        return false;
+    }
+    _bits_per_key = 10;
+    if (cfg.isMember("bits_per_key")) {
+        if (!cfg["bits_per_key"].isUInt64() || cfg["bits_per_key"] == 0) {
+            std::cerr << "KeyFilter::configure: \"bits_per_key\" should be"
+                      << " a strictly positive integer" << std::endl;
+            return false;
+        }
+        _bits_per_key = cfg["bits_per_key"].asUInt64();
+    }
+    if (cfg.isMember("prefix_length")) {
+        if (!cfg["prefix_length"].isUInt64()) {
+            std::cerr << "KeyFilter::configure: \"prefix_length\" should be"
+                      << " a positive integer" << std::endl;
+            return false;
+        }
+        _prefix_length = cfg["prefix_length"].asUInt64();
+    }
+    if (cfg.isMember("rebuild_erase_ratio")) {
+        if (!cfg["rebuild_erase_ratio"].isNumeric()
+            || cfg["rebuild_erase_ratio"].asDouble() <= 0) {
+            std::cerr << "KeyFilter::configure: \"rebuild_erase_ratio\""
+                      << " should be a strictly positive number" << std::endl;
+            return false;
+        }
+        _rebuild_erase_ratio = cfg["rebuild_erase_ratio"].asDouble();
+    }
+    // optimal number of probes for the false positive rate is bits * ln(2)
+    _num_probes = std::max<unsigned>(
+        1, std::min<unsigned>(30, std::lround(_bits_per_key * 0.69)));
+    return true;
+}
+
+void KeyFilter::attach(scan_fn scan)
+{
+    _scan = std::move(scan);
+    if (!enabled()) return;
+    /* the rebuilder runs in the pool of the calling execution stream */
+    ABT_xstream xstream;
+    ABT_pool    pool;
+    ABT_xstream_self(&xstream);
+    ABT_xstream_get_main_pools(xstream, 1, &pool);
+    if (ABT_thread_create(pool, rebuilder_ult, this, ABT_THREAD_ATTR_NULL,
+                          &_rebuilder)
+        != ABT_SUCCESS) {
+        std::cerr << "KeyFilter::attach: could not create rebuilder thread,"
+                  << " rebuilding the filters synchronously" << std::endl;
+        _rebuilder = ABT_THREAD_NULL;
+    }
+    request_rebuild();
+}
+
+void KeyFilter::detach()
+{
+    if (_rebuilder == ABT_THREAD_NULL) return;
+    ABT_mutex_lock(_rebuilder_mtx);
+    _rebuilder_stop = true;
+    ABT_cond_signal(_rebuilder_cond);
+    ABT_mutex_unlock(_rebuilder_mtx);
+    ABT_thread_join(_rebuilder);
+    ABT_thread_free(&_rebuilder);
+}
+
+/* without a rebuilder, the filters are rebuilt by the caller */
+void KeyFilter::request_rebuild()
+{
+    if (_rebuilder == ABT_THREAD_NULL) {
+        rebuild();
+        return;
+    }
+    ABT_mutex_lock(_rebuilder_mtx);
+    _rebuild_requested = true;
+    ABT_cond_signal(_rebuilder_cond);
+    ABT_mutex_unlock(_rebuilder_mtx);
+}
+
+void KeyFilter::rebuilder_ult(void* arg)
+{
+    KeyFilter* filter = static_cast<KeyFilter*>(arg);
+
+    ABT_mutex_lock(filter->_rebuilder_mtx);
+    while (!filter->_rebuilder_stop) {
+        if (!filter->_rebuild_requested) {
+            ABT_cond_wait(filter->_rebuilder_cond, filter->_rebuilder_mtx);
+            continue;
+        }
+        filter->_rebuild_requested = false;
+        ABT_mutex_unlock(filter->_rebuilder_mtx);
+        filter->rebuild();
+        ABT_mutex_lock(filter->_rebuilder_mtx);
+    }
+    ABT_mutex_unlock(filter->_rebuilder_mtx);
+}
+
+void KeyFilter::add(const void* key, size_t ksize)
+{
+    if (!enabled()) return;
+    /* record the key before setting the bits, so that a rebuild finishing
+     * in between cannot miss it */
+    if (_rebuilding.load()) {
+        ABT_mutex_lock(_pending_mtx);
+        if (_rebuilding.load())
+            _pending.emplace_back((const char*)key, (const char*)key + ksize);
+        ABT_mutex_unlock(_pending_mtx);
+    }
+    uint64_t h    = hash_key(key, ksize);
+    bool     grow = false;
+    ABT_rwlock_rdlock(_lock);
+    if (_keys) {
+        // keys that seem to be present already are overwrites
+        if (!_keys->test(h, _num_probes)) {
+            _keys->set(h, _num_probes);
+            grow = ++_num_keys > _capacity;
+        }
+        if (_prefixes && ksize >= _prefix_length)
+            _prefixes->set(hash_key(key, _prefix_length), _num_probes);
+    }
+    ABT_rwlock_unlock(_lock);
+    if (grow) request_rebuild();
+}
+
+void KeyFilter::erased(size_t count)
+{
+    if (!enabled() || count == 0) return;
+    size_t num_erased = _num_erased += count;
+    if (num_erased > _rebuild_erase_ratio
+                         * std::max<size_t>(_num_keys.load(), min_capacity))
+        request_rebuild();
+}
+
+bool KeyFilter::may_contain(const void* key, size_t ksize) const
+{
+    if (!enabled()) return true;
+    uint64_t h = hash_key(key, ksize);
+    ABT_rwlock_rdlock(_lock);
+    bool result = !_keys || _keys->test(h, _num_probes);
+    ABT_rwlock_unlock(_lock);
+    return result;
+}
+
+bool KeyFilter::may_contain_prefix(const ds_bulk_t& prefix) const
+{
+    if (!enabled() || !_prefix_length || prefix.size() < _prefix_length)
+        return true;
+    uint64_t h = hash_key(prefix.data(), _prefix_length);
+    ABT_rwlock_rdlock(_lock);
+    bool result = !_prefixes || _prefixes->test(h, _num_probes);
+    ABT_rwlock_unlock(_lock);
+    return result;
+}
+
+/* the backend is scanned without holding _lock, so that lookups go on using
+ * the current filters, which remain valid, in the meantime */
+void KeyFilter::rebuild()
+{
+    if (!_scan || _rebuilding.exchange(true)) return;
+
+    std::unique_ptr<bitset> keys, prefixes;
+    size_t capacity = std::max<size_t>(min_capacity, 2 * _num_keys.load());
+    size_t count    = 0;
+    auto   insert   = [&](const void* key, size_t ksize) {
+        keys->set(hash_key(key, ksize), _num_probes);
+        if (prefixes && ksize >= _prefix_length)
+            prefixes->set(hash_key(key, _prefix_length), _num_probes);
+        count += 1;
+    };
+    while (true) {
+        keys.reset(new bitset(capacity * _bits_per_key));
+        if (_prefix_length)
+            prefixes.reset(new bitset(capacity * _bits_per_key));
+        count = 0;
+        _scan(insert);
+        if (count <= capacity) break;
+        // the database had more keys than expected, scan it again
+        capacity = 2 * count;
+    }
+
+    ABT_mutex_lock(_pending_mtx);
+    for (const auto& key : _pending) insert(key.data(), key.size());
+    _pending.clear();
+    ABT_rwlock_wrlock(_lock);
+    _keys.swap(keys);
+    _prefixes.swap(prefixes);
+    _capacity   = capacity;
+    _num_keys   = count;
+    _num_erased = 0;
+    ABT_rwlock_unlock(_lock);
+    _rebuilding = false;
+    ABT_mutex_unlock(_pending_mtx);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef key_filter_h
+#define key_filter_h
+
+#include "kv-config.h"
+#include "bulk.h"
+#include <abt.h>
+#include <json/json.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// in-memory bloom filters over the keys of a database and over their first
+// prefix_length bytes, so that lookups of absent keys and listings of absent
+// prefixes can return without touching the backend. Keys cannot be removed
+// from a bloom filter: the filters are rebuilt from the backend when the
+// database is opened, when they exceed their capacity, and after a number of
+// erasures relative to the number of keys. Rebuilds scan the backend in a
+// ULT of the pool of the execution stream that opened the database, so that
+// the writes that trigger them do not wait; until the first one completes,
+// every key may be present.
+class KeyFilter {
+  public:
+    // calls the given function on each key of the database
+    typedef std::function<void(const void*, size_t)> key_fn;
+    typedef std::function<void(const key_fn&)>        scan_fn;
+
+    KeyFilter();
+    ~KeyFilter();
+    KeyFilter(const KeyFilter&) = delete;
+    KeyFilter& operator=(const KeyFilter&) = delete;
+
+    // reads the "key_filter" object of a database's JSON configuration, if
+    // any; returns false if it is invalid
+    bool configure(const Json::Value& config);
+    // scan_fn is used to rebuild the filters; called once the database is
+    // open, it starts the ULT that rebuilds them and requests the initial
+    // build
+    void attach(scan_fn scan);
+    // stops the ULT, waiting for the rebuild in progress if any; must be
+    // called before the backend is closed
+    void detach();
+    bool enabled() const { return _bits_per_key != 0; }
+
+    // must be called after the key was written to the backend; a failed
+    // write of several keys that may have written some of them must add
+    // all of them
+    void add(const void* key, size_t ksize);
+    // must be called after keys were erased from the backend
+    void erased(size_t count = 1);
+    // false if no key of the database is equal to key
+    bool may_contain(const void* key, size_t ksize) const;
+    // false if no key of the database starts with prefix
+    bool may_contain_prefix(const ds_bulk_t& prefix) const;
+
+  private:
+    struct bitset {
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+        size_t                                   num_bits = 0;
+        bitset(size_t n);
+        void set(uint64_t h, unsigned num_probes);
+        bool test(uint64_t h, unsigned num_probes) const;
+    };
+
+    void        rebuild();
+    void        request_rebuild();
+    static void rebuilder_ult(void* arg);
+
+    size_t  _bits_per_key        = 0;
+    size_t  _prefix_length       = 0;
+    double  _rebuild_erase_ratio = 0.5;
+    scan_fn _scan;
+
+    // protects the bitsets, which are replaced by rebuild()
+    ABT_rwlock              _lock = ABT_RWLOCK_NULL;
+    std::unique_ptr<bitset> _keys;
+    std::unique_ptr<bitset> _prefixes;
+    unsigned                _num_probes = 1;
+    size_t                  _capacity   = 0;
+    std::atomic<size_t>     _num_keys{0};
+    std::atomic<size_t>     _num_erased{0};
+
+    // keys added while a rebuild is scanning the backend are also recorded
+    // here and added to the new bitsets
+    std::atomic<bool>      _rebuilding{false};
+    ABT_mutex              _pending_mtx = ABT_MUTEX_NULL;
+    std::vector<ds_bulk_t> _pending;
+
+    // ULT running the rebuilds requested by add() and erased()
+    ABT_mutex  _rebuilder_mtx     = ABT_MUTEX_NULL;
+    ABT_cond   _rebuilder_cond    = ABT_COND_NULL;
+    ABT_thread _rebuilder         = ABT_THREAD_NULL;
+    bool       _rebuild_requested = false;
+    bool       _rebuilder_stop    = false;
+};
+
+#endif // key_filter_h
@@ -1,8 +1,10 @@
 // Copyright (c) 2017, Los Alamos National Security, LLC.
 // All rights reserved.
 #include "leveldb_datastore.h"
+#include <leveldb/write_batch.h>
 #include "fs_util.h"
 #include "kv-config.h"
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <iostream>
@@ -10,16 +12,24 @@
 
 using namespace std::chrono;
 
+std::mutex LevelDBDataStore::_shared_caches_mtx;
+std::map<std::string, std::weak_ptr<leveldb::Cache>>
+    LevelDBDataStore::_shared_caches;
+
 LevelDBDataStore::LevelDBDataStore()
-    : AbstractDataStore(false, false), _less(nullptr), _keycmp(this)
+    : AbstractDataStore(false, false), _less(nullptr), _separator(nullptr),
+      _successor(nullptr), _keycmp(this)
 {
     _dbm = NULL;
+    ABT_mutex_create(&_write_mutex);
 };
 
 LevelDBDataStore::LevelDBDataStore(bool eraseOnGet, bool debug)
-    : AbstractDataStore(eraseOnGet, debug), _less(nullptr), _keycmp(this)
+    : AbstractDataStore(eraseOnGet, debug), _less(nullptr), _separator(nullptr),
+      _successor(nullptr), _keycmp(this)
 {
     _dbm = NULL;
+    ABT_mutex_create(&_write_mutex);
 };
 
 std::string LevelDBDataStore::toString(const ds_bulk_t& bulk_val)
@@ -42,19 +52,137 @@ ds_bulk_t LevelDBDataStore::fromString(const std::string& str_val)
 
 LevelDBDataStore::~LevelDBDataStore()
 {
+    _key_filter.detach();
+    // the database must go before the cache and filter policy it uses
     delete _dbm;
+    ABT_mutex_free(&_write_mutex);
     // leveldb::Env::Shutdown(); // Riak version only
 };
 
 void LevelDBDataStore::sync() {}
 
+int LevelDBDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    leveldb::Slice begin(lower.data(), lower.size());
+    leveldb::Slice end(upper.data(), upper.size());
+    _dbm->CompactRange(lower.empty() ? nullptr : &begin,
+                       upper.empty() ? nullptr : &end);
+    return SDSKV_SUCCESS;
+}
+
+std::shared_ptr<leveldb::Cache>
+LevelDBDataStore::get_shared_cache(const std::string& name, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_shared_caches_mtx);
+    auto                        cache = _shared_caches[name].lock();
+    if (!cache) {
+        cache = std::shared_ptr<leveldb::Cache>(leveldb::NewLRUCache(capacity));
+        _shared_caches[name] = cache;
+    }
+    return cache;
+}
+
+static bool get_size_option(const Json::Value& config,
+                            const char*        field,
+                            size_t*            value)
+{
+    if (!config.isMember(field)) return true;
+    if (!config[field].isUInt64()) {
+        std::cerr << "LevelDBDataStore::configure: \"" << field
+                  << "\" should be a positive integer" << std::endl;
+        return false;
+    }
+    *value = config[field].asUInt64();
+    return true;
+}
+
+bool LevelDBDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry (all optional):
+     * {
+     *    "block_cache_size" : <bytes>,     (private LRU block cache)
+     *    "shared_block_cache" : true/false (use the provider's block cache)
+     *    "bloom_bits_per_key" : <int>,     (0 disables the bloom filter)
+     *    "write_buffer_size" : <bytes>,
+     *    "max_open_files" : <int>,
+     *    "block_size" : <bytes>,
+     *    "compression" : "snappy" | "none",
+     *    "key_filter" : { ... }            (in-memory filters, see KeyFilter)
+     * }
+     * The provider fills "__shared_block_cache_name__" and
+     * "__shared_block_cache_size__" when "shared_block_cache" is true.
+     **/
+    if (!config.isObject()) return true;
+    if (!_key_filter.configure(config)) return false;
+
+    size_t block_cache_size   = 0;
+    size_t bloom_bits_per_key = 0;
+    size_t max_open_files     = _options.max_open_files;
+    if (!get_size_option(config, "block_cache_size", &block_cache_size)
+        || !get_size_option(config, "bloom_bits_per_key", &bloom_bits_per_key)
+        || !get_size_option(config, "write_buffer_size",
+                            &_options.write_buffer_size)
+        || !get_size_option(config, "max_open_files", &max_open_files)
+        || !get_size_option(config, "block_size", &_options.block_size))
+        return false;
+    _options.max_open_files = max_open_files;
+
+    if (config.isMember("shared_block_cache")
+        && !config["shared_block_cache"].isBool()) {
+        std::cerr << "LevelDBDataStore::configure: \"shared_block_cache\""
+                  << " should be a boolean" << std::endl;
+        return false;
+    }
+    bool shared_cache = config.get("shared_block_cache", false).asBool();
+    if (shared_cache && block_cache_size) {
+        std::cerr << "LevelDBDataStore::configure: \"block_cache_size\""
+                  << " and \"shared_block_cache\" are mutually exclusive"
+                  << std::endl;
+        return false;
+    }
+    if (shared_cache) {
+        // default to the size of LevelDB's own default cache
+        size_t size = config.get("__shared_block_cache_size__", 8 << 20)
+                          .asUInt64();
+        std::string name
+            = config.get("__shared_block_cache_name__", "").asString();
+        _block_cache = get_shared_cache(name, size);
+    } else if (block_cache_size) {
+        _block_cache = std::shared_ptr<leveldb::Cache>(
+            leveldb::NewLRUCache(block_cache_size));
+    }
+    _options.block_cache = _block_cache.get();
+
+    if (bloom_bits_per_key) {
+        _filter_policy.reset(leveldb::NewBloomFilterPolicy(bloom_bits_per_key));
+        _options.filter_policy = _filter_policy.get();
+    }
+
+    if (config.isMember("compression")) {
+        std::string compression;
+        if (config["compression"].isString())
+            compression = config["compression"].asString();
+        if (compression == "snappy") {
+            _options.compression = leveldb::kSnappyCompression;
+        } else if (compression == "none") {
+            _options.compression = leveldb::kNoCompression;
+        } else {
+            std::cerr << "LevelDBDataStore::configure: unknown compression \""
+                      << compression << "\"" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 bool LevelDBDataStore::openDatabase(const std::string& db_name,
                                     const std::string& db_path)
 {
     _name = db_name;
     _path = db_path;
 
-    leveldb::Options options;
+    leveldb::Options options = _options;
     leveldb::Status  status;
 
     if (!db_path.empty()) { mkdirs(db_path.c_str()); }
@@ -72,6 +200,13 @@ bool LevelDBDataStore::openDatabase(const std::string& db_name,
             << status.ToString() << std::endl;
         return false;
     }
+    _key_filter.attach([this](const KeyFilter::key_fn& fn) {
+        leveldb::ReadOptions options;
+        options.fill_cache = false;
+        std::unique_ptr<leveldb::Iterator> it(_dbm->NewIterator(options));
+        for (it->SeekToFirst(); it->Valid(); it->Next())
+            fn(it->key().data(), it->key().size());
+    });
     return true;
 };
 
@@ -82,6 +217,72 @@ void LevelDBDataStore::set_comparison_function(const std::string& name,
     _less          = less;
 }
 
+void LevelDBDataStore::set_key_shortening_functions(separator_fn separator,
+                                                    successor_fn successor)
+{
+    _separator = separator;
+    _successor = successor;
+}
+
+void LevelDBDataStore::LevelDBDataStoreComparator::FindShortestSeparator(
+    std::string* start, const leveldb::Slice& limit) const
+{
+    if (_store->_less) {
+        if (!_store->_separator || start->empty()) return;
+        /* the user-provided function works on a copy and its result is
+         * only kept if it is a valid separator */
+        std::string sep  = *start;
+        hg_size_t   size = _store->_separator(&sep[0], sep.size(),
+                                            limit.data(), limit.size());
+        if (size >= sep.size()) return;
+        sep.resize(size);
+        if (Compare(sep, *start) >= 0 && Compare(sep, limit) < 0)
+            start->swap(sep);
+        return;
+    }
+    /* default bytewise ordering: find the length of the common prefix */
+    size_t min_length = std::min(start->size(), limit.size());
+    size_t diff_index = 0;
+    while ((diff_index < min_length)
+           && ((*start)[diff_index] == limit[diff_index])) {
+        diff_index++;
+    }
+    /* do not shorten if one string is a prefix of the other */
+    if (diff_index >= min_length) return;
+    uint8_t diff_byte = static_cast<uint8_t>((*start)[diff_index]);
+    if (diff_byte < static_cast<uint8_t>(0xff)
+        && diff_byte + 1 < static_cast<uint8_t>(limit[diff_index])) {
+        (*start)[diff_index]++;
+        start->resize(diff_index + 1);
+    }
+}
+
+void LevelDBDataStore::LevelDBDataStoreComparator::FindShortSuccessor(
+    std::string* key) const
+{
+    if (_store->_less) {
+        if (!_store->_successor || key->empty()) return;
+        std::string succ = *key;
+        hg_size_t   size = _store->_successor(&succ[0], succ.size());
+        if (size >= succ.size()) return;
+        succ.resize(size);
+        if (Compare(succ, *key) >= 0) key->swap(succ);
+        return;
+    }
+    /* default bytewise ordering: find the first byte that can be
+     * incremented and drop everything after it */
+    size_t n = key->size();
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t byte = (*key)[i];
+        if (byte != static_cast<uint8_t>(0xff)) {
+            (*key)[i] = byte + 1;
+            key->resize(i + 1);
+            return;
+        }
+    }
+    /* key is a run of 0xffs, leave it alone */
+}
+
 int LevelDBDataStore::put(const void* key,
                           hg_size_t   ksize,
                           const void* value,
@@ -90,13 +291,22 @@ int LevelDBDataStore::put(const void* key,
     leveldb::Status status;
     bool            success = false;
 
+    /* the key is checked and written with the other writes excluded, so
+     * that two no-overwrite puts cannot both find it missing and that
+     * updates do not overwrite the value */
+    ABT_mutex_lock(_write_mutex);
     if (_no_overwrite) {
-        if (exists(key, ksize)) return SDSKV_ERR_KEYEXISTS;
+        if (exists(key, ksize)) {
+            ABT_mutex_unlock(_write_mutex);
+            return SDSKV_ERR_KEYEXISTS;
+        }
     }
 
     status = _dbm->Put(leveldb::WriteOptions(),
                        leveldb::Slice((const char*)key, ksize),
                        leveldb::Slice((const char*)value, vsize));
+    if (status.ok()) _key_filter.add(key, ksize);
+    ABT_mutex_unlock(_write_mutex);
     if (status.ok()) return SDSKV_SUCCESS;
     return SDSKV_ERR_PUT;
 };
@@ -104,14 +314,124 @@ int LevelDBDataStore::put(const void* key,
 bool LevelDBDataStore::erase(const ds_bulk_t& key)
 {
     leveldb::Status status;
+    ABT_mutex_lock(_write_mutex);
     status = _dbm->Delete(leveldb::WriteOptions(), toString(key));
+    ABT_mutex_unlock(_write_mutex);
+    if (status.ok()) _key_filter.erased();
     return status.ok();
 }
 
+/* the value is read and written with the other writes excluded */
+int LevelDBDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    ds_bulk_t value, new_value;
+    int       ret = SDSKV_SUCCESS;
+    ABT_mutex_lock(_write_mutex);
+    bool found = get(key, value);
+    if (fn(found ? &value : nullptr, new_value)) {
+        if (_no_overwrite && found) {
+            ret = SDSKV_ERR_KEYEXISTS;
+        } else {
+            leveldb::Status status = _dbm->Put(
+                leveldb::WriteOptions(), leveldb::Slice(key.data(), key.size()),
+                leveldb::Slice(new_value.data(), new_value.size()));
+            if (status.ok()) {
+                _key_filter.add(key.data(), key.size());
+            } else {
+                std::cerr << "LevelDBDataStore::update: LevelDB error on Put = "
+                          << status.ToString() << std::endl;
+                ret = SDSKV_ERR_PUT;
+            }
+        }
+    }
+    ABT_mutex_unlock(_write_mutex);
+    return ret;
+}
+
+/* LevelDB has no range deletion: the keys are read with an iterator and
+ * deleted in write batches of at most erase_batch_size keys */
+int LevelDBDataStore::erase_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  hg_size_t*       num_erased)
+{
+    leveldb::ReadOptions options;
+    options.fill_cache = false;
+    std::unique_ptr<leveldb::Iterator> it(_dbm->NewIterator(options));
+    leveldb::Slice                     upper_slice(upper.data(), upper.size());
+    leveldb::WriteBatch                batch;
+    hg_size_t                          batch_size = 0;
+
+    *num_erased = 0;
+    auto write_batch = [&]() {
+        ABT_mutex_lock(_write_mutex);
+        leveldb::Status status = _dbm->Write(leveldb::WriteOptions(), &batch);
+        ABT_mutex_unlock(_write_mutex);
+        if (!status.ok()) {
+            std::cerr << "LevelDBDataStore::erase_range: LevelDB error on"
+                      << " Write = " << status.ToString() << std::endl;
+            return false;
+        }
+        _key_filter.erased(batch_size);
+        *num_erased += batch_size;
+        batch.Clear();
+        batch_size = 0;
+        return true;
+    };
+
+    if (lower.size() > 0)
+        it->Seek(leveldb::Slice(lower.data(), lower.size()));
+    else
+        it->SeekToFirst();
+    for (; it->Valid(); it->Next()) {
+        if (upper.size() > 0 && _keycmp.Compare(it->key(), upper_slice) >= 0)
+            break;
+        batch.Delete(it->key());
+        if (++batch_size == erase_batch_size && !write_batch())
+            return SDSKV_ERR_ERASE;
+    }
+    if (batch_size > 0 && !write_batch()) return SDSKV_ERR_ERASE;
+    return SDSKV_SUCCESS;
+}
+
+int LevelDBDataStore::count_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  bool             with_sizes,
+                                  ds_count_t&      result) const
+{
+    leveldb::ReadOptions options;
+    options.fill_cache = false;
+    std::unique_ptr<leveldb::Iterator> it(_dbm->NewIterator(options));
+    leveldb::Slice                     upper_slice(upper.data(), upper.size());
+
+    result = ds_count_t();
+    if (lower.size() > 0)
+        it->Seek(leveldb::Slice(lower.data(), lower.size()));
+    else
+        it->SeekToFirst();
+    for (; it->Valid(); it->Next()) {
+        if (upper.size() > 0 && _keycmp.Compare(it->key(), upper_slice) >= 0)
+            break;
+        result.num_keys += 1;
+        if (with_sizes) {
+            result.key_bytes += it->key().size();
+            result.value_bytes += it->value().size();
+        }
+    }
+    if (!it->status().ok()) {
+        std::cerr << "LevelDBDataStore::count_range: LevelDB error on"
+                  << " iteration = " << it->status().ToString() << std::endl;
+        return SDSKV_ERR_READ;
+    }
+    return SDSKV_SUCCESS;
+}
+
 bool LevelDBDataStore::exists(const void* key, hg_size_t ksize) const
 {
     leveldb::Status status;
     std::string     value;
+    /* keys are only compared byte-wise by the filter */
+    if (_comp_fun_name.empty() && !_key_filter.may_contain(key, ksize))
+        return false;
     status = _dbm->Get(leveldb::ReadOptions(),
                        leveldb::Slice((const char*)key, ksize), &value);
     return status.ok();
@@ -122,8 +442,10 @@ bool LevelDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
     leveldb::Status status;
     bool            success = false;
 
-    // high_resolution_clock::time_point start = high_resolution_clock::now();
     data.clear();
+    if (_comp_fun_name.empty()
+        && !_key_filter.may_contain(key.data(), key.size()))
+        return false;
     std::string value;
     status = _dbm->Get(leveldb::ReadOptions(), toString(key), &value);
     if (status.ok()) {
@@ -133,11 +455,6 @@ bool LevelDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
         std::cerr << "LevelDBDataStore::get: LevelDB error on Get = "
                   << status.ToString() << std::endl;
     }
-    //  uint64_t elapsed =
-    //  duration_cast<microseconds>(high_resolution_clock::now()-start).count();
-    //  std::cout << "LevelDBDataStore::get time = " << elapsed << "
-    //  microseconds" << std::endl;
-
     return success;
 };
 
@@ -161,13 +478,16 @@ std::vector<ds_bulk_t> LevelDBDataStore::vlist_keys(
     const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
 {
     std::vector<ds_bulk_t> keys;
+    if (!_key_filter.may_contain_prefix(prefix)) return keys;
 
     leveldb::Iterator* it = _dbm->NewIterator(leveldb::ReadOptions());
     leveldb::Slice     start_slice(start.data(), start.size());
 
     int c = 0;
 
-    if (start.size() > 0) {
+    if (seek_to_prefix(start, prefix)) {
+        it->Seek(leveldb::Slice(prefix.data(), prefix.size()));
+    } else if (start.size() > 0) {
         it->Seek(start_slice);
         /* we treat 'start' the way RADOS treats it: excluding it from returned
          * keys. LevelDB treats start inclusively, so skip over it if we found
@@ -180,10 +500,10 @@ std::vector<ds_bulk_t> LevelDBDataStore::vlist_keys(
     }
     /* note: iterator initialized above, not in for loop */
     for (; it->Valid() && keys.size() < count; it->Next()) {
-        ds_bulk_t k(it->key().size());
-        memcpy(k.data(), it->key().data(), it->key().size());
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, it->key().data(), it->key().size());
         if (c == 0) {
+            ds_bulk_t k(it->key().size());
+            memcpy(k.data(), it->key().data(), it->key().size());
             keys.push_back(std::move(k));
         } else if (c < 0) {
             break;
@@ -197,13 +517,16 @@ std::vector<std::pair<ds_bulk_t, ds_bulk_t>> LevelDBDataStore::vlist_keyvals(
     const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
 {
     std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    if (!_key_filter.may_contain_prefix(prefix)) return result;
 
     leveldb::Iterator* it = _dbm->NewIterator(leveldb::ReadOptions());
     leveldb::Slice     start_slice(start.data(), start.size());
 
     int c = 0;
 
-    if (start.size() > 0) {
+    if (seek_to_prefix(start, prefix)) {
+        it->Seek(leveldb::Slice(prefix.data(), prefix.size()));
+    } else if (start.size() > 0) {
         it->Seek(start_slice);
         /* we treat 'start' the way RADOS treats it: excluding it from returned
          * keys. LevelDB treats start inclusively, so skip over it if we found
@@ -216,13 +539,12 @@ std::vector<std::pair<ds_bulk_t, ds_bulk_t>> LevelDBDataStore::vlist_keyvals(
     }
     /* note: iterator initialized above, not in for loop */
     for (; it->Valid() && result.size() < count; it->Next()) {
-        ds_bulk_t k(it->key().size());
-        ds_bulk_t v(it->value().size());
-        memcpy(k.data(), it->key().data(), it->key().size());
-        memcpy(v.data(), it->value().data(), it->value().size());
-
-        c = std::memcmp(prefix.data(), k.data(), prefix.size());
+        c = compare_prefix(prefix, it->key().data(), it->key().size());
         if (c == 0) {
+            ds_bulk_t k(it->key().size());
+            ds_bulk_t v(it->value().size());
+            memcpy(k.data(), it->key().data(), it->key().size());
+            memcpy(v.data(), it->value().data(), it->value().size());
             result.push_back(std::make_pair(std::move(k), std::move(v)));
         } else if (c < 0) {
             break;
@@ -7,10 +7,17 @@
 #include <leveldb/db.h>
 #include <leveldb/comparator.h>
 #include <leveldb/env.h>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "sdskv-common.h"
 #include "datastore/datastore.h"
+#include "datastore/key_filter.h"
 
-// may want to implement some caching for persistent stores like LevelDB
+// values read from LevelDB can be cached with the "cache" option, see
+// CachedDataStore
 class LevelDBDataStore : public AbstractDataStore {
   private:
     class LevelDBDataStoreComparator : public leveldb::Comparator {
@@ -30,16 +37,18 @@ class LevelDBDataStore : public AbstractDataStore {
             }
         }
 
-        // Ignore the following methods for now:
         const char* Name() const { return "LevelDBDataStoreComparator"; }
-        void FindShortestSeparator(std::string*, const leveldb::Slice&) const {}
-        void FindShortSuccessor(std::string*) const {}
+        // used by LevelDB to shorten the keys stored in index blocks
+        void FindShortestSeparator(std::string*          start,
+                                   const leveldb::Slice& limit) const;
+        void FindShortSuccessor(std::string* key) const;
     };
 
   public:
     LevelDBDataStore();
     LevelDBDataStore(bool eraseOnGet, bool debug);
     virtual ~LevelDBDataStore();
+    virtual bool configure(const Json::Value& config) override;
     virtual bool openDatabase(const std::string& db_name,
                               const std::string& path) override;
     virtual int  put(const void* key,
@@ -51,11 +60,23 @@ class LevelDBDataStore : public AbstractDataStore {
                      std::vector<ds_bulk_t>& data) override;
     virtual bool exists(const void* key, hg_size_t ksize) const override;
     virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
     virtual void set_in_memory(bool enable) override; // not supported, a no-op
     virtual void set_comparison_function(const std::string& name,
                                          comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
     virtual void set_no_overwrite() override { _no_overwrite = true; }
     virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
 #ifdef USE_REMI
     virtual remi_fileset_t create_and_populate_fileset() const override;
 #endif
@@ -83,7 +104,24 @@ class LevelDBDataStore : public AbstractDataStore {
     static std::string toString(const char* bug, hg_size_t buf_size);
     static ds_bulk_t   fromString(const std::string& keystr);
     AbstractDataStore::comparator_fn _less;
+    AbstractDataStore::separator_fn  _separator;
+    AbstractDataStore::successor_fn  _successor;
     LevelDBDataStoreComparator       _keycmp;
+
+    // options filled by configure() and used by openDatabase()
+    leveldb::Options                             _options;
+    std::shared_ptr<leveldb::Cache>              _block_cache;
+    std::unique_ptr<const leveldb::FilterPolicy> _filter_policy;
+    KeyFilter                                    _key_filter;
+    // serializes the writes, so that updates are atomic with respect to them
+    ABT_mutex _write_mutex = ABT_MUTEX_NULL;
+
+    // block caches shared among the databases of a provider, indexed by name;
+    // a cache is released when the last database using it is closed
+    static std::shared_ptr<leveldb::Cache>
+    get_shared_cache(const std::string& name, size_t capacity);
+    static std::mutex                                           _shared_caches_mtx;
+    static std::map<std::string, std::weak_ptr<leveldb::Cache>> _shared_caches;
 };
 
 #endif // ldb_datastore_h
@@ -0,0 +1,587 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "lmdb_datastore.h"
+#include "fs_util.h"
+#include "kv-config.h"
+#include <cstring>
+#include <iostream>
+
+std::mutex LMDBDataStore::_comparators_mtx;
+AbstractDataStore::comparator_fn
+    LMDBDataStore::_comparators[LMDBDataStore::max_comparators];
+
+LMDBDataStore::LMDBDataStore() : AbstractDataStore(false, false) {}
+
+LMDBDataStore::LMDBDataStore(bool eraseOnGet, bool debug)
+    : AbstractDataStore(eraseOnGet, debug)
+{
+}
+
+LMDBDataStore::~LMDBDataStore()
+{
+    if (_env) mdb_env_close(_env);
+}
+
+template <size_t N>
+int LMDBDataStore::compkeys(const MDB_val* a, const MDB_val* b)
+{
+    return _comparators[N](a->mv_data, a->mv_size, b->mv_data, b->mv_size);
+}
+
+template <size_t... N>
+MDB_cmp_func* LMDBDataStore::trampoline(size_t slot, std::index_sequence<N...>)
+{
+    static MDB_cmp_func* const trampolines[] = {&compkeys<N>...};
+    return trampolines[slot];
+}
+
+MDB_cmp_func* LMDBDataStore::get_comparator_trampoline(comparator_fn less)
+{
+    std::lock_guard<std::mutex> lock(_comparators_mtx);
+    for (size_t i = 0; i < max_comparators; i++) {
+        if (_comparators[i] == nullptr) _comparators[i] = less;
+        if (_comparators[i] == less)
+            return trampoline(i, std::make_index_sequence<max_comparators>());
+    }
+    return nullptr;
+}
+
+static bool get_size_option(const Json::Value& config,
+                            const char*        field,
+                            size_t*            value)
+{
+    if (!config.isMember(field)) return true;
+    if (!config[field].isUInt64()) {
+        std::cerr << "LMDBDataStore::configure: \"" << field
+                  << "\" should be a positive integer" << std::endl;
+        return false;
+    }
+    *value = config[field].asUInt64();
+    return true;
+}
+
+bool LMDBDataStore::configure(const Json::Value& config)
+{
+    /**
+     * Options accepted in the database's JSON entry (all optional):
+     * {
+     *    "map_size" : <bytes>,   (maximum size of the database, default 1 GB)
+     *    "max_readers" : <int>,  (maximum number of concurrent reads)
+     *    "no_sync" : true/false  (do not flush to disk on commit)
+     * }
+     **/
+    if (!config.isObject()) return true;
+
+    size_t max_readers = _max_readers;
+    if (!get_size_option(config, "map_size", &_map_size)
+        || !get_size_option(config, "max_readers", &max_readers))
+        return false;
+    _max_readers = max_readers;
+
+    if (config.isMember("no_sync") && !config["no_sync"].isBool()) {
+        std::cerr << "LMDBDataStore::configure: \"no_sync\""
+                  << " should be a boolean" << std::endl;
+        return false;
+    }
+    _no_sync = config.get("no_sync", false).asBool();
+    return true;
+}
+
+bool LMDBDataStore::openDatabase(const std::string& db_name,
+                                 const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+
+    std::string fullname = db_path;
+    if (!fullname.empty()) fullname += std::string("/");
+    fullname += db_name;
+    mkdirs(fullname.c_str());
+
+    int ret = mdb_env_create(&_env);
+    if (ret == MDB_SUCCESS) ret = mdb_env_set_mapsize(_env, _map_size);
+    if (ret == MDB_SUCCESS && _max_readers)
+        ret = mdb_env_set_maxreaders(_env, _max_readers);
+    /* MDB_NOTLS is needed because a read transaction may be held by a ULT
+     * that yields and resumes on another execution stream */
+    unsigned int flags = MDB_NOTLS;
+    if (_no_sync) flags |= MDB_NOSYNC;
+    if (ret == MDB_SUCCESS)
+        ret = mdb_env_open(_env, fullname.c_str(), flags, 0664);
+    MDB_txn* txn = nullptr;
+    if (ret == MDB_SUCCESS) ret = mdb_txn_begin(_env, nullptr, 0, &txn);
+    if (ret == MDB_SUCCESS) {
+        ret = mdb_dbi_open(txn, nullptr, 0, &_dbi);
+        if (ret == MDB_SUCCESS)
+            ret = mdb_txn_commit(txn);
+        else
+            mdb_txn_abort(txn);
+    }
+
+    if (ret != MDB_SUCCESS) {
+        std::cerr << "LMDBDataStore::openDatabase: LMDB error on open = "
+                  << mdb_strerror(ret) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void LMDBDataStore::set_comparison_function(const std::string& name,
+                                            comparator_fn      less)
+{
+    _comp_fun_name = name;
+    if (!less) return;
+    MDB_cmp_func* cmp = get_comparator_trampoline(less);
+    if (!cmp) {
+        std::cerr << "LMDBDataStore::set_comparison_function: too many"
+                  << " distinct comparison functions (max "
+                  << max_comparators << ")" << std::endl;
+        return;
+    }
+    /* the comparison function is attached to the database handle and must
+     * be set before any data is accessed */
+    MDB_txn* txn;
+    int      ret = mdb_txn_begin(_env, nullptr, 0, &txn);
+    if (ret == MDB_SUCCESS) {
+        mdb_set_compare(txn, _dbi, cmp);
+        ret = mdb_txn_commit(txn);
+    }
+    if (ret != MDB_SUCCESS) {
+        std::cerr << "LMDBDataStore::set_comparison_function: LMDB error = "
+                  << mdb_strerror(ret) << std::endl;
+    }
+}
+
+void LMDBDataStore::sync() { mdb_env_sync(_env, 1); }
+
+void LMDBDataStore::set_in_memory(bool enable) {}
+
+int LMDBDataStore::put_in_txn(MDB_txn*    txn,
+                              const void* key,
+                              hg_size_t   ksize,
+                              const void* value,
+                              hg_size_t   vsize)
+{
+    MDB_val      k     = {ksize, const_cast<void*>(key)};
+    MDB_val      v     = {vsize, const_cast<void*>(value)};
+    unsigned int flags = _no_overwrite ? MDB_NOOVERWRITE : 0;
+    int          ret   = mdb_put(txn, _dbi, &k, &v, flags);
+    if (ret == MDB_SUCCESS) return SDSKV_SUCCESS;
+    if (ret == MDB_KEYEXIST) return SDSKV_ERR_KEYEXISTS;
+    std::cerr << "LMDBDataStore::put: LMDB error on put = " << mdb_strerror(ret)
+              << (ret == MDB_MAP_FULL ? " (consider increasing \"map_size\")"
+                                      : "")
+              << std::endl;
+    return SDSKV_ERR_PUT;
+}
+
+int LMDBDataStore::put(const void* key,
+                       hg_size_t   ksize,
+                       const void* value,
+                       hg_size_t   vsize)
+{
+    return put_multi(1, &key, &ksize, &value, &vsize);
+}
+
+int LMDBDataStore::put_multi(hg_size_t          num_items,
+                             const void* const* keys,
+                             const hg_size_t*   ksizes,
+                             const void* const* values,
+                             const hg_size_t*   vsizes)
+{
+    /* all the pairs are written in a single transaction; an existing key
+     * does not invalidate the transaction, any other error does */
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, 0, &txn) != MDB_SUCCESS)
+        return SDSKV_ERR_PUT;
+    int ret = SDSKV_SUCCESS;
+    for (hg_size_t i = 0; i < num_items; i++) {
+        int r = put_in_txn(txn, keys[i], ksizes[i], values[i], vsizes[i]);
+        if (r == SDSKV_ERR_KEYEXISTS) {
+            ret = r;
+        } else if (r != SDSKV_SUCCESS) {
+            mdb_txn_abort(txn);
+            return r;
+        }
+    }
+    if (mdb_txn_commit(txn) != MDB_SUCCESS) return SDSKV_ERR_PUT;
+    return ret;
+}
+
+int LMDBDataStore::put_packed(hg_size_t        num_items,
+                              const char*      keys,
+                              const hg_size_t* ksizes,
+                              const char*      values,
+                              const hg_size_t* vsizes)
+{
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, 0, &txn) != MDB_SUCCESS)
+        return SDSKV_ERR_PUT;
+    int    ret         = SDSKV_SUCCESS;
+    size_t keys_offset = 0;
+    size_t vals_offset = 0;
+    for (hg_size_t i = 0; i < num_items; i++) {
+        int r = put_in_txn(txn, keys + keys_offset, ksizes[i],
+                           values + vals_offset, vsizes[i]);
+        if (r == SDSKV_ERR_KEYEXISTS) {
+            ret = r;
+        } else if (r != SDSKV_SUCCESS) {
+            mdb_txn_abort(txn);
+            return r;
+        }
+        keys_offset += ksizes[i];
+        vals_offset += vsizes[i];
+    }
+    if (mdb_txn_commit(txn) != MDB_SUCCESS) return SDSKV_ERR_PUT;
+    return ret;
+}
+
+bool LMDBDataStore::get_view(const void*    key,
+                             hg_size_t      ksize,
+                             const view_fn& fn)
+{
+    /* the value points into the memory map and is only valid until the
+     * read transaction ends, i.e. for the duration of fn */
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS)
+        return false;
+    MDB_val k   = {ksize, const_cast<void*>(key)};
+    MDB_val v   = {0, nullptr};
+    int     ret = mdb_get(txn, _dbi, &k, &v);
+    if (ret == MDB_SUCCESS) fn(v.mv_data, v.mv_size);
+    mdb_txn_abort(txn);
+    return ret == MDB_SUCCESS;
+}
+
+void LMDBDataStore::get_multi_view(hg_size_t            num_keys,
+                                   const void* const*   keys,
+                                   const hg_size_t*     ksizes,
+                                   const multi_view_fn& fn)
+{
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS) return;
+    for (hg_size_t i = 0; i < num_keys; i++) {
+        MDB_val k = {ksizes[i], const_cast<void*>(keys[i])};
+        MDB_val v = {0, nullptr};
+        if (mdb_get(txn, _dbi, &k, &v) == MDB_SUCCESS)
+            fn(i, v.mv_data, v.mv_size);
+    }
+    mdb_txn_abort(txn);
+}
+
+bool LMDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    data.clear();
+    return get_view(key.data(), key.size(),
+                    [&data](const void* value, hg_size_t vsize) {
+                        data.assign((const char*)value,
+                                    (const char*)value + vsize);
+                    });
+}
+
+bool LMDBDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    bool success = false;
+
+    data.clear();
+    ds_bulk_t value;
+    if (get(key, value)) {
+        data.push_back(value);
+        success = true;
+    }
+
+    return success;
+}
+
+bool LMDBDataStore::length(const void* key, hg_size_t ksize, size_t* vsize)
+{
+    return get_view(key, ksize, [vsize](const void*, hg_size_t size) {
+        *vsize = size;
+    });
+}
+
+bool LMDBDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    return length(key.data(), key.size(), vsize);
+}
+
+bool LMDBDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS)
+        return false;
+    MDB_val k   = {ksize, const_cast<void*>(key)};
+    MDB_val v   = {0, nullptr};
+    int     ret = mdb_get(txn, _dbi, &k, &v);
+    mdb_txn_abort(txn);
+    return ret == MDB_SUCCESS;
+}
+
+bool LMDBDataStore::erase(const ds_bulk_t& key)
+{
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, 0, &txn) != MDB_SUCCESS) return false;
+    MDB_val k   = {key.size(), const_cast<char*>(key.data())};
+    int     ret = mdb_del(txn, _dbi, &k, nullptr);
+    if (ret != MDB_SUCCESS) {
+        mdb_txn_abort(txn);
+        return false;
+    }
+    return mdb_txn_commit(txn) == MDB_SUCCESS;
+}
+
+/* the keys are deleted with a cursor, in write transactions of at most
+ * erase_batch_size keys */
+int LMDBDataStore::erase_range(const ds_bulk_t& lower,
+                               const ds_bulk_t& upper,
+                               hg_size_t*       num_erased)
+{
+    MDB_val   upper_val = {upper.size(), const_cast<char*>(upper.data())};
+    ds_bulk_t from      = lower;
+    bool      done      = false;
+
+    *num_erased = 0;
+    while (!done) {
+        MDB_txn*    txn;
+        MDB_cursor* cursor;
+        if (mdb_txn_begin(_env, nullptr, 0, &txn) != MDB_SUCCESS)
+            return SDSKV_ERR_ERASE;
+        if (mdb_cursor_open(txn, _dbi, &cursor) != MDB_SUCCESS) {
+            mdb_txn_abort(txn);
+            return SDSKV_ERR_ERASE;
+        }
+        MDB_val   k   = {from.size(), const_cast<char*>(from.data())};
+        MDB_val   v   = {0, nullptr};
+        hg_size_t n   = 0;
+        int       ret = mdb_cursor_get(cursor, &k, &v,
+                                 from.size() > 0 ? MDB_SET_RANGE : MDB_FIRST);
+        done          = true;
+        while (ret == MDB_SUCCESS) {
+            if (upper.size() > 0 && mdb_cmp(txn, _dbi, &k, &upper_val) >= 0)
+                break;
+            if (n == erase_batch_size) {
+                /* continue from this key in a new transaction */
+                const char* data = (const char*)k.mv_data;
+                from.assign(data, data + k.mv_size);
+                done = false;
+                break;
+            }
+            ret = mdb_cursor_del(cursor, 0);
+            if (ret != MDB_SUCCESS) break;
+            n += 1;
+            /* after a deletion, MDB_NEXT moves to the following key */
+            ret = mdb_cursor_get(cursor, &k, &v, MDB_NEXT);
+        }
+        mdb_cursor_close(cursor);
+        if (ret != MDB_SUCCESS && ret != MDB_NOTFOUND) {
+            mdb_txn_abort(txn);
+            return SDSKV_ERR_ERASE;
+        }
+        if (mdb_txn_commit(txn) != MDB_SUCCESS) return SDSKV_ERR_ERASE;
+        *num_erased += n;
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* LMDB has a single writer, so reading the value in the write transaction
+ * makes the update atomic */
+int LMDBDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    MDB_txn* txn;
+    if (mdb_txn_begin(_env, nullptr, 0, &txn) != MDB_SUCCESS)
+        return SDSKV_ERR_PUT;
+    MDB_val k   = {key.size(), const_cast<char*>(key.data())};
+    MDB_val v   = {0, nullptr};
+    int     ret = mdb_get(txn, _dbi, &k, &v);
+    if (ret != MDB_SUCCESS && ret != MDB_NOTFOUND) {
+        mdb_txn_abort(txn);
+        return SDSKV_ERR_READ;
+    }
+    ds_bulk_t value, new_value;
+    if (ret == MDB_SUCCESS)
+        value.assign((const char*)v.mv_data,
+                     (const char*)v.mv_data + v.mv_size);
+    if (!fn(ret == MDB_SUCCESS ? &value : nullptr, new_value)) {
+        mdb_txn_abort(txn);
+        return SDSKV_SUCCESS;
+    }
+    ret = put_in_txn(txn, key.data(), key.size(), new_value.data(),
+                     new_value.size());
+    if (ret != SDSKV_SUCCESS) {
+        mdb_txn_abort(txn);
+        return ret;
+    }
+    if (mdb_txn_commit(txn) != MDB_SUCCESS) return SDSKV_ERR_PUT;
+    return SDSKV_SUCCESS;
+}
+
+/* the values are mapped in memory, so their sizes are always summed */
+int LMDBDataStore::count_range(const ds_bulk_t& lower,
+                               const ds_bulk_t& upper,
+                               bool             with_sizes,
+                               ds_count_t&      result) const
+{
+    MDB_txn*    txn;
+    MDB_cursor* cursor;
+    result = ds_count_t();
+    if (mdb_txn_begin(_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS)
+        return SDSKV_ERR_READ;
+    if (lower.empty() && upper.empty() && !with_sizes) {
+        /* LMDB keeps track of the number of entries */
+        MDB_stat stat;
+        int      ret = mdb_stat(txn, _dbi, &stat);
+        mdb_txn_abort(txn);
+        if (ret != MDB_SUCCESS) return SDSKV_ERR_READ;
+        result.num_keys = stat.ms_entries;
+        return SDSKV_SUCCESS;
+    }
+    if (mdb_cursor_open(txn, _dbi, &cursor) != MDB_SUCCESS) {
+        mdb_txn_abort(txn);
+        return SDSKV_ERR_READ;
+    }
+    MDB_val upper_val = {upper.size(), const_cast<char*>(upper.data())};
+    MDB_val k         = {lower.size(), const_cast<char*>(lower.data())};
+    MDB_val v         = {0, nullptr};
+    int ret = mdb_cursor_get(cursor, &k, &v,
+                             lower.size() > 0 ? MDB_SET_RANGE : MDB_FIRST);
+    while (ret == MDB_SUCCESS) {
+        if (upper.size() > 0 && mdb_cmp(txn, _dbi, &k, &upper_val) >= 0)
+            break;
+        result.num_keys += 1;
+        result.key_bytes += k.mv_size;
+        result.value_bytes += v.mv_size;
+        ret = mdb_cursor_get(cursor, &k, &v, MDB_NEXT);
+    }
+    mdb_cursor_close(cursor);
+    mdb_txn_abort(txn);
+    if (ret != MDB_SUCCESS && ret != MDB_NOTFOUND) return SDSKV_ERR_READ;
+    return SDSKV_SUCCESS;
+}
+
+/* calls f(txn, key, value) on the pairs following start (excluded), in order,
+ * until f returns false; starts at prefix (included) instead when possible */
+template <typename F>
+void LMDBDataStore::iterate(const ds_bulk_t& start,
+                            const ds_bulk_t& prefix,
+                            F&&              f) const
+{
+    MDB_txn*    txn;
+    MDB_cursor* cursor;
+    if (mdb_txn_begin(_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS) return;
+    if (mdb_cursor_open(txn, _dbi, &cursor) != MDB_SUCCESS) {
+        mdb_txn_abort(txn);
+        return;
+    }
+    MDB_val k   = {start.size(), const_cast<char*>(start.data())};
+    MDB_val v   = {0, nullptr};
+    int     ret = MDB_SUCCESS;
+    if (seek_to_prefix(start, prefix)) {
+        k   = {prefix.size(), const_cast<char*>(prefix.data())};
+        ret = mdb_cursor_get(cursor, &k, &v, MDB_SET_RANGE);
+    } else if (start.size() > 0) {
+        MDB_val s = k;
+        ret       = mdb_cursor_get(cursor, &k, &v, MDB_SET_RANGE);
+        /* we treat 'start' the way RADOS treats it: excluding it from
+         * returned keys */
+        if (ret == MDB_SUCCESS && mdb_cmp(txn, _dbi, &k, &s) == 0)
+            ret = mdb_cursor_get(cursor, &k, &v, MDB_NEXT);
+    } else {
+        ret = mdb_cursor_get(cursor, &k, &v, MDB_FIRST);
+    }
+    for (; ret == MDB_SUCCESS; ret = mdb_cursor_get(cursor, &k, &v, MDB_NEXT))
+        if (!f(txn, k, v)) break;
+    mdb_cursor_close(cursor);
+    mdb_txn_abort(txn);
+}
+
+std::vector<ds_bulk_t> LMDBDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    std::vector<ds_bulk_t> keys;
+    if (count == 0) return keys;
+    iterate(start, prefix, [&](MDB_txn*, const MDB_val& k, const MDB_val&) {
+        int c = compare_prefix(prefix, k.mv_data, k.mv_size);
+        if (c == 0) {
+            const char* data = (const char*)k.mv_data;
+            keys.emplace_back(data, data + k.mv_size);
+        }
+        return c >= 0 && keys.size() < count;
+    });
+    return keys;
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>> LMDBDataStore::vlist_keyvals(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    if (count == 0) return result;
+    iterate(start, prefix,
+            [&](MDB_txn*, const MDB_val& k, const MDB_val& v) {
+                int c = compare_prefix(prefix, k.mv_data, k.mv_size);
+                if (c == 0) {
+                    const char* kdata = (const char*)k.mv_data;
+                    const char* vdata = (const char*)v.mv_data;
+                    result.emplace_back(ds_bulk_t(kdata, kdata + k.mv_size),
+                                        ds_bulk_t(vdata, vdata + v.mv_size));
+                }
+                return c >= 0 && result.size() < count;
+            });
+    return result;
+}
+
+std::vector<ds_bulk_t>
+LMDBDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                               const ds_bulk_t& upper_bound,
+                               hg_size_t        max_keys) const
+{
+    std::vector<ds_bulk_t> result;
+    MDB_val upper = {upper_bound.size(), const_cast<char*>(upper_bound.data())};
+    iterate(lower_bound, ds_bulk_t(),
+            [&](MDB_txn* txn, const MDB_val& k, const MDB_val&) {
+                if (upper.mv_size && mdb_cmp(txn, _dbi, &k, &upper) >= 0)
+                    return false;
+                const char* data = (const char*)k.mv_data;
+                result.emplace_back(data, data + k.mv_size);
+                return max_keys == 0 || result.size() < max_keys;
+            });
+    return result;
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+LMDBDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                  const ds_bulk_t& upper_bound,
+                                  hg_size_t        max_keys) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    MDB_val upper = {upper_bound.size(), const_cast<char*>(upper_bound.data())};
+    iterate(lower_bound, ds_bulk_t(),
+            [&](MDB_txn* txn, const MDB_val& k, const MDB_val& v) {
+                if (upper.mv_size && mdb_cmp(txn, _dbi, &k, &upper) >= 0)
+                    return false;
+                const char* kdata = (const char*)k.mv_data;
+                const char* vdata = (const char*)v.mv_data;
+                result.emplace_back(ds_bulk_t(kdata, kdata + k.mv_size),
+                                    ds_bulk_t(vdata, vdata + v.mv_size));
+                return max_keys == 0 || result.size() < max_keys;
+            });
+    return result;
+}
+
+#ifdef USE_REMI
+remi_fileset_t LMDBDataStore::create_and_populate_fileset() const
+{
+    remi_fileset_t fileset    = REMI_FILESET_NULL;
+    std::string    local_root = _path;
+    if (_path[_path.size() - 1] != '/') local_root += "/";
+    remi_fileset_create("sdskv", local_root.c_str(), &fileset);
+    remi_fileset_register_directory(fileset, (_name + "/").c_str());
+    remi_fileset_register_metadata(fileset, "database_type", "lmdb");
+    remi_fileset_register_metadata(fileset, "comparison_function",
+                                   _comp_fun_name.c_str());
+    remi_fileset_register_metadata(fileset, "database_name", _name.c_str());
+    if (_no_overwrite) {
+        remi_fileset_register_metadata(fileset, "no_overwrite", "");
+    }
+    return fileset;
+}
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef lmdb_datastore_h
+#define lmdb_datastore_h
+
+#include "kv-config.h"
+#include <lmdb.h>
+#include <mutex>
+#include <utility>
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// LMDB keeps the whole database in a memory map, so values can be handed
+// out without copying as long as the read transaction is alive
+class LMDBDataStore : public AbstractDataStore {
+  private:
+    /* LMDB comparison functions do not take a context argument, so each
+     * distinct comparator_fn is given one of a fixed number of slots with
+     * its own trampoline */
+    static constexpr int max_comparators = 32;
+    template <size_t N>
+    static int compkeys(const MDB_val* a, const MDB_val* b);
+    template <size_t... N>
+    static MDB_cmp_func* trampoline(size_t slot, std::index_sequence<N...>);
+    static MDB_cmp_func* get_comparator_trampoline(comparator_fn less);
+    static std::mutex    _comparators_mtx;
+    static comparator_fn _comparators[max_comparators];
+
+  public:
+    LMDBDataStore();
+    LMDBDataStore(bool eraseOnGet, bool debug);
+    virtual ~LMDBDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool get_view(const void*    key,
+                          hg_size_t      ksize,
+                          const view_fn& fn) override;
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn) override;
+    virtual bool
+    length(const void* key, hg_size_t ksize, size_t* vsize) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual void set_in_memory(bool enable) override; // not supported, a no-op
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_no_overwrite() override { _no_overwrite = true; }
+    virtual void sync() override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+            vlist_keyval_range(const ds_bulk_t& lower_bound,
+                               const ds_bulk_t& upper_bound,
+                               hg_size_t        max_keys) const override;
+    MDB_env* _env = nullptr;
+    MDB_dbi  _dbi = 0;
+
+  private:
+    int put_in_txn(MDB_txn*    txn,
+                   const void* key,
+                   hg_size_t   ksize,
+                   const void* value,
+                   hg_size_t   vsize);
+    template <typename F>
+    void iterate(const ds_bulk_t& start, const ds_bulk_t& prefix, F&& f) const;
+
+    // options filled by configure() and used by openDatabase()
+    size_t       _map_size    = 1UL << 30;
+    unsigned int _max_readers = 0; // 0 keeps LMDB's default
+    bool         _no_sync     = false;
+};
+
+#endif // lmdb_datastore_h
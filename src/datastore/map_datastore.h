@@ -5,6 +5,7 @@
 
 #include <map>
 #include <cstring>
+#include <iostream>
 #include "kv-config.h"
 #include "bulk.h"
 #include "datastore/datastore.h"
@@ -22,7 +23,7 @@ class MapDataStore : public AbstractDataStore {
                                      (const void*)b.data(), b.size())
                      < 0;
             else
-                return std::less<ds_bulk_t>()(a, b);
+                return bytewise_less(a, b);
         }
     };
 
@@ -41,6 +42,37 @@ class MapDataStore : public AbstractDataStore {
 
     ~MapDataStore() { ABT_rwlock_free(&_map_lock); }
 
+    virtual bool configure(const Json::Value& config) override
+    {
+        /**
+         * Options accepted in the database's JSON entry (all optional):
+         * {
+         *    "max_memory" : <bytes>,            (default 0, no limit)
+         *    "memory_policy" : "reject" | "evict"
+         * }
+         * When a write would take the database above max_memory, it fails
+         * with SDSKV_ERR_FULL ("reject", the default) or other entries are
+         * evicted until it fits ("evict"), going around the keys in order.
+         **/
+        if (!config.isObject()) return true;
+        if (config.isMember("max_memory")) {
+            if (!config["max_memory"].isUInt64()) {
+                std::cerr << "MapDataStore::configure: \"max_memory\" should"
+                          << " be a positive integer" << std::endl;
+                return false;
+            }
+            _max_memory = config["max_memory"].asUInt64();
+        }
+        std::string policy = config.get("memory_policy", "reject").asString();
+        if (policy != "reject" && policy != "evict") {
+            std::cerr << "MapDataStore::configure: invalid memory policy \""
+                      << policy << "\"" << std::endl;
+            return false;
+        }
+        _evict = policy == "evict";
+        return true;
+    }
+
     virtual bool openDatabase(const std::string& db_name,
                               const std::string& path) override
     {
@@ -48,6 +80,8 @@ class MapDataStore : public AbstractDataStore {
         _path = path;
         ABT_rwlock_wrlock(_map_lock);
         _map.clear();
+        _key_bytes   = 0;
+        _value_bytes = 0;
         ABT_rwlock_unlock(_map_lock);
         return true;
     }
@@ -57,26 +91,61 @@ class MapDataStore : public AbstractDataStore {
     virtual int put(const ds_bulk_t& key, const ds_bulk_t& data) override
     {
         ABT_rwlock_wrlock(_map_lock);
-        auto x = _map.count(key);
-        if (_no_overwrite && (x != 0)) {
-            ABT_rwlock_unlock(_map_lock);
-            return SDSKV_ERR_KEYEXISTS;
+        auto it = _map.find(key);
+        if (it != _map.end()) {
+            if (_no_overwrite) {
+                unlock_and_report_evictions();
+                return SDSKV_ERR_KEYEXISTS;
+            }
+            int ret = reserve(key, it->second.size(), data.size());
+            if (ret != SDSKV_SUCCESS) {
+                unlock_and_report_evictions();
+                return ret;
+            }
+            _value_bytes -= it->second.size();
+            it->second = data;
+        } else {
+            int ret = reserve(key, 0, entry_size(key.size(), data.size()));
+            if (ret != SDSKV_SUCCESS) {
+                unlock_and_report_evictions();
+                return ret;
+            }
+            _key_bytes += key.size();
+            _map.emplace(key, data);
         }
-        _map[key] = data;
-        ABT_rwlock_unlock(_map_lock);
+        _value_bytes += data.size();
+        unlock_and_report_evictions();
         return SDSKV_SUCCESS;
     }
 
     virtual int put(ds_bulk_t&& key, ds_bulk_t&& data) override
     {
         ABT_rwlock_wrlock(_map_lock);
-        auto x = _map.count(key);
-        if (_no_overwrite && (x != 0)) {
-            ABT_rwlock_unlock(_map_lock);
-            return SDSKV_ERR_KEYEXISTS;
+        auto   it    = _map.find(key);
+        size_t vsize = data.size();
+        if (it != _map.end()) {
+            if (_no_overwrite) {
+                unlock_and_report_evictions();
+                return SDSKV_ERR_KEYEXISTS;
+            }
+            int ret = reserve(key, it->second.size(), vsize);
+            if (ret != SDSKV_SUCCESS) {
+                unlock_and_report_evictions();
+                return ret;
+            }
+            _value_bytes -= it->second.size();
+            it->second = std::move(data);
+        } else {
+            int ret = reserve(key, 0, entry_size(key.size(), vsize));
+            if (ret != SDSKV_SUCCESS) {
+                unlock_and_report_evictions();
+                return ret;
+            }
+            _key_bytes += key.size();
+            _map.emplace(std::move(key), std::move(data));
         }
-        _map[std::move(key)] = std::move(data);
-        ABT_rwlock_unlock(_map_lock);
+        _value_bytes += vsize;
+        unlock_and_report_evictions();
         return SDSKV_SUCCESS;
     }
 
@@ -130,6 +199,67 @@ class MapDataStore : public AbstractDataStore {
         return true;
     }
 
+    virtual bool get_range_view(const void*    key,
+                                hg_size_t      ksize,
+                                hg_size_t      offset,
+                                hg_size_t      size,
+                                const view_fn& fn) override
+    {
+        ds_bulk_t k((const char*)key, ((const char*)key) + ksize);
+        ds_bulk_t slice;
+        ABT_rwlock_rdlock(_map_lock);
+        auto it = _map.find(k);
+        if (it == _map.end()) {
+            ABT_rwlock_unlock(_map_lock);
+            return false;
+        }
+        /* only the slice is copied, so that fn runs without the lock */
+        const ds_bulk_t& value = it->second;
+        hg_size_t        vsize = value.size();
+        hg_size_t        start = std::min(offset, vsize);
+        hg_size_t        count = std::min(size, vsize - start);
+        slice.assign(value.begin() + start, value.begin() + start + count);
+        ABT_rwlock_unlock(_map_lock);
+        fn(slice.data(), slice.size());
+        return true;
+    }
+
+    virtual int put_range(const ds_bulk_t& key,
+                          hg_size_t        offset,
+                          const void*      data,
+                          hg_size_t        size) override
+    {
+        if (offset > ds_bulk_t().max_size() - size) return SDSKV_ERR_SIZE;
+        ABT_rwlock_wrlock(_map_lock);
+        auto it = _map.find(key);
+        if (it != _map.end() && _no_overwrite) {
+            unlock_and_report_evictions();
+            return SDSKV_ERR_KEYEXISTS;
+        }
+        bool      found    = it != _map.end();
+        hg_size_t old_size = found ? it->second.size() : 0;
+        hg_size_t new_size = std::max(old_size, offset + size);
+        int       ret
+            = found ? reserve(key, old_size, new_size)
+                    : reserve(key, 0, entry_size(key.size(), new_size));
+        if (ret != SDSKV_SUCCESS) {
+            unlock_and_report_evictions();
+            return ret;
+        }
+        if (it == _map.end()) {
+            it = _map.emplace(key, ds_bulk_t()).first;
+            _key_bytes += key.size();
+        }
+        /* the value is modified in place */
+        ds_bulk_t& value = it->second;
+        _value_bytes -= value.size();
+        if (value.size() < offset + size) value.resize(offset + size);
+        if (size) std::memcpy(value.data() + offset, data, size);
+        _value_bytes += value.size();
+        unlock_and_report_evictions();
+        return SDSKV_SUCCESS;
+    }
+
     virtual bool exists(const ds_bulk_t& key) const override
     {
         ABT_rwlock_rdlock(_map_lock);
@@ -146,12 +276,130 @@ class MapDataStore : public AbstractDataStore {
     virtual bool erase(const ds_bulk_t& key) override
     {
         ABT_rwlock_wrlock(_map_lock);
-        bool b = _map.find(key) != _map.end();
-        _map.erase(key);
+        auto it = _map.find(key);
+        bool b  = it != _map.end();
+        if (b) {
+            _key_bytes -= it->first.size();
+            _value_bytes -= it->second.size();
+            _map.erase(it);
+        }
         ABT_rwlock_unlock(_map_lock);
         return b;
     }
 
+    virtual int erase_range(const ds_bulk_t& lower,
+                            const ds_bulk_t& upper,
+                            hg_size_t*       num_erased) override
+    {
+        ABT_rwlock_wrlock(_map_lock);
+        auto first = lower.empty() ? _map.begin() : _map.lower_bound(lower);
+        auto last  = upper.empty() ? _map.end() : _map.lower_bound(upper);
+        if (!lower.empty() && !upper.empty() && _map.key_comp()(upper, lower))
+            last = first; // empty range
+        *num_erased = 0;
+        for (auto it = first; it != last; ++it) {
+            _key_bytes -= it->first.size();
+            _value_bytes -= it->second.size();
+            *num_erased += 1;
+        }
+        _map.erase(first, last);
+        ABT_rwlock_unlock(_map_lock);
+        return SDSKV_SUCCESS;
+    }
+
+    virtual int erase_prefixed(const ds_bulk_t& prefix,
+                               hg_size_t*       num_erased) override
+    {
+        ABT_rwlock_wrlock(_map_lock);
+        *num_erased = 0;
+        /* the keys starting with the prefix are contiguous unless a custom
+         * comparison function is used, in which case all keys are checked */
+        auto it = _less ? _map.begin() : _map.lower_bound(prefix);
+        while (it != _map.end()) {
+            if (compare_prefix(prefix, it->first.data(), it->first.size())
+                == 0) {
+                _key_bytes -= it->first.size();
+                _value_bytes -= it->second.size();
+                it = _map.erase(it);
+                *num_erased += 1;
+            } else if (!_less) {
+                break;
+            } else {
+                ++it;
+            }
+        }
+        ABT_rwlock_unlock(_map_lock);
+        return SDSKV_SUCCESS;
+    }
+
+    virtual int update(const ds_bulk_t& key, const update_fn& fn) override
+    {
+        ABT_rwlock_wrlock(_map_lock);
+        auto      it = _map.find(key);
+        ds_bulk_t new_value;
+        int       ret = SDSKV_SUCCESS;
+        if (fn(it != _map.end() ? &it->second : nullptr, new_value)) {
+            if (it == _map.end()) {
+                ret = reserve(key, 0, entry_size(key.size(), new_value.size()));
+                if (ret == SDSKV_SUCCESS) {
+                    _key_bytes += key.size();
+                    _value_bytes += new_value.size();
+                    _map.emplace(key, std::move(new_value));
+                }
+            } else if (_no_overwrite) {
+                ret = SDSKV_ERR_KEYEXISTS;
+            } else {
+                ret = reserve(key, it->second.size(), new_value.size());
+                if (ret == SDSKV_SUCCESS) {
+                    _value_bytes -= it->second.size();
+                    _value_bytes += new_value.size();
+                    it->second = std::move(new_value);
+                }
+            }
+        }
+        unlock_and_report_evictions();
+        return ret;
+    }
+
+    virtual int count_range(const ds_bulk_t& lower,
+                            const ds_bulk_t& upper,
+                            bool             with_sizes,
+                            ds_count_t&      result) const override
+    {
+        ABT_rwlock_rdlock(_map_lock);
+        result = ds_count_t();
+        if (lower.empty() && upper.empty()) {
+            /* the whole database, for which the sizes are maintained */
+            result.num_keys    = _map.size();
+            result.key_bytes   = _key_bytes;
+            result.value_bytes = _value_bytes;
+            ABT_rwlock_unlock(_map_lock);
+            return SDSKV_SUCCESS;
+        }
+        auto first = lower.empty() ? _map.begin() : _map.lower_bound(lower);
+        auto last  = upper.empty() ? _map.end() : _map.lower_bound(upper);
+        if (!lower.empty() && !upper.empty() && _map.key_comp()(upper, lower))
+            last = first; // empty range
+        for (auto it = first; it != last; ++it) {
+            result.num_keys += 1;
+            result.key_bytes += it->first.size();
+            result.value_bytes += it->second.size();
+        }
+        ABT_rwlock_unlock(_map_lock);
+        return SDSKV_SUCCESS;
+    }
+
+    virtual bool memory_usage(ds_memory_t& usage) const override
+    {
+        ABT_rwlock_rdlock(_map_lock);
+        usage.used_bytes = memory_used();
+        usage.max_bytes  = _max_memory;
+        usage.evictions  = _evictions;
+        usage.rejections = _rejections;
+        ABT_rwlock_unlock(_map_lock);
+        return true;
+    }
+
     virtual void set_in_memory(bool enable) override { _in_memory = enable; }
 
     virtual void set_comparison_function(const std::string& name,
@@ -179,18 +427,24 @@ class MapDataStore : public AbstractDataStore {
         ABT_rwlock_rdlock(_map_lock);
         std::vector<ds_bulk_t> result;
         decltype(_map.begin()) it;
-        if (start_key.size() > 0) {
+        /* the keys starting with the prefix are contiguous, so we can seek
+         * to the prefix and stop at the first key that does not match */
+        bool at_prefix = !prefix.empty() && !_less
+                      && (start_key.empty()
+                          || _map.key_comp()(start_key, prefix));
+        if (at_prefix) {
+            it = _map.lower_bound(prefix);
+        } else if (start_key.size() > 0) {
             it = _map.upper_bound(start_key);
         } else {
             it = _map.begin();
         }
         while (result.size() < count && it != _map.end()) {
             const auto& p = *it;
-            if (prefix.size() > p.first.size()) continue;
-            int c = std::memcmp(prefix.data(), p.first.data(), prefix.size());
+            int c = compare_prefix(prefix, p.first.data(), p.first.size());
             if (c == 0) {
                 result.push_back(p.first);
-            } else if (c < 0) {
+            } else if (c < 0 || at_prefix) {
                 break; // we have exceeded prefix
             }
             it++;
@@ -207,18 +461,24 @@ class MapDataStore : public AbstractDataStore {
         ABT_rwlock_rdlock(_map_lock);
         std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
         decltype(_map.begin())                       it;
-        if (start_key.size() > 0) {
+        /* the keys starting with the prefix are contiguous, so we can seek
+         * to the prefix and stop at the first key that does not match */
+        bool at_prefix = !prefix.empty() && !_less
+                      && (start_key.empty()
+                          || _map.key_comp()(start_key, prefix));
+        if (at_prefix) {
+            it = _map.lower_bound(prefix);
+        } else if (start_key.size() > 0) {
             it = _map.upper_bound(start_key);
         } else {
             it = _map.begin();
         }
         while (result.size() < count && it != _map.end()) {
             const auto& p = *it;
-            if (prefix.size() > p.first.size()) continue;
-            int c = std::memcmp(prefix.data(), p.first.data(), prefix.size());
+            int c = compare_prefix(prefix, p.first.data(), p.first.size());
             if (c == 0) {
                 result.push_back(p);
-            } else if (c < 0) {
+            } else if (c < 0 || at_prefix) {
                 break; // we have exceeded prefix
             }
             it++;
@@ -276,9 +536,83 @@ class MapDataStore : public AbstractDataStore {
     }
 
   private:
+    // memory taken by an entry beyond its key and value: a node of the
+    // red-black tree (color and three pointers) holding the two vectors
+    static constexpr size_t entry_overhead
+        = 4 * sizeof(void*) + sizeof(std::pair<const ds_bulk_t, ds_bulk_t>);
+
+    static size_t entry_size(size_t ksize, size_t vsize)
+    {
+        return ksize + vsize + entry_overhead;
+    }
+
+    size_t memory_used() const
+    {
+        return _key_bytes + _value_bytes + _map.size() * entry_overhead;
+    }
+
+    // checks that the memory limit allows the data associated with key to
+    // go from released to needed bytes, evicting other entries if the
+    // policy allows it; called with _map_lock write-locked
+    int reserve(const ds_bulk_t& key, size_t released, size_t needed)
+    {
+        if (_max_memory == 0 || needed <= released) return SDSKV_SUCCESS;
+        size_t extra = needed - released;
+        while (memory_used() + extra > _max_memory) {
+            if (!_evict || needed > _max_memory || !evict_one(key)) {
+                _rejections += 1;
+                return SDSKV_ERR_FULL;
+            }
+        }
+        return SDSKV_SUCCESS;
+    }
+
+    // releases _map_lock and passes the keys evicted while it was held to
+    // the eviction handler, if any
+    void unlock_and_report_evictions()
+    {
+        std::vector<ds_bulk_t> evicted;
+        evicted.swap(_evicted);
+        ABT_rwlock_unlock(_map_lock);
+        if (!_on_evicted) return;
+        for (const auto& key : evicted) _on_evicted(key.data(), key.size());
+    }
+
+    // evicts the first entry after the last evicted key, wrapping around,
+    // unless it is key; returns false if there is no entry to evict
+    bool evict_one(const ds_bulk_t& key)
+    {
+        if (_map.empty()) return false;
+        auto it = _map.upper_bound(_evict_hand);
+        if (it == _map.end()) it = _map.begin();
+        if (!_map.key_comp()(it->first, key)
+            && !_map.key_comp()(key, it->first)) {
+            if (_map.size() == 1) return false;
+            if (++it == _map.end()) it = _map.begin();
+        }
+        _evict_hand = it->first;
+        _key_bytes -= it->first.size();
+        _value_bytes -= it->second.size();
+        if (_on_evicted) _evicted.push_back(it->first);
+        _map.erase(it);
+        _evictions += 1;
+        return true;
+    }
+
     AbstractDataStore::comparator_fn       _less;
     std::map<ds_bulk_t, ds_bulk_t, keycmp> _map;
     ABT_rwlock                             _map_lock;
+    // total size of the keys and values in _map, protected by _map_lock
+    size_t _key_bytes   = 0;
+    size_t _value_bytes = 0;
+    // memory limit (0 = none) and what happens when it is reached
+    size_t    _max_memory = 0;
+    bool      _evict      = false;
+    ds_bulk_t _evict_hand; // last evicted key
+    // keys evicted by the write holding _map_lock, to be reported
+    std::vector<ds_bulk_t> _evicted;
+    uint64_t  _evictions  = 0;
+    uint64_t  _rejections = 0;
 };
 
 #endif
@@ -0,0 +1,647 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "rocksdb_datastore.h"
+#include "fs_util.h"
+#include "kv-config.h"
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_batch.h>
+#include <cstring>
+#include <iostream>
+
+std::mutex RocksDBDataStore::_instances_mtx;
+std::map<std::string, std::weak_ptr<RocksDBDataStore::Instance>>
+    RocksDBDataStore::_instances;
+
+RocksDBDataStore::RocksDBDataStore() : AbstractDataStore(false, false)
+{
+    ABT_mutex_create(&_write_mutex);
+}
+
+RocksDBDataStore::RocksDBDataStore(bool eraseOnGet, bool debug)
+    : AbstractDataStore(eraseOnGet, debug)
+{
+    ABT_mutex_create(&_write_mutex);
+}
+
+RocksDBDataStore::~RocksDBDataStore()
+{
+    if (_cf) {
+        std::lock_guard<std::mutex> lock(_instance->mtx);
+        _instance->column_families[_name].attached = false;
+    }
+    /* the instance is closed with the registry locked so that it cannot be
+     * reopened before it is fully closed */
+    std::lock_guard<std::mutex> lock(_instances_mtx);
+    _instance.reset();
+    ABT_mutex_free(&_write_mutex);
+}
+
+RocksDBDataStore::Instance::~Instance()
+{
+    if (!db) return;
+    for (auto& p : column_families) {
+        if (p.second.handle) db->DestroyColumnFamilyHandle(p.second.handle);
+    }
+    db->Close();
+    delete db;
+}
+
+static bool get_size_option(const Json::Value& config,
+                            const char*        field,
+                            size_t*            value)
+{
+    if (!config.isMember(field)) return true;
+    if (!config[field].isUInt64()) {
+        std::cerr << "RocksDBDataStore::configure: \"" << field
+                  << "\" should be a positive integer" << std::endl;
+        return false;
+    }
+    *value = config[field].asUInt64();
+    return true;
+}
+
+bool RocksDBDataStore::configure(const Json::Value& config)
+{
+    /**
+     * The options of the RocksDB instance come from the provider's
+     * configuration, which the provider passes as "__instance_options__":
+     * {
+     *    "block_cache_size" : <bytes>,    (block cache shared by all the
+     *                                      databases of the instance)
+     *    "max_open_files" : <int>,
+     *    "max_background_jobs" : <int>,
+     *    "write_buffer_size" : <bytes>,   (per database)
+     *    "bloom_bits_per_key" : <int>,    (0 disables the bloom filters)
+     *    "prefix_length" : <bytes>,       (length of the key prefixes used
+     *                                      by the bloom filters)
+     *    "compression" : "snappy" | "lz4" | "zstd" | "none"
+     * }
+     * They are taken into account by the first database opened with a given
+     * path, which creates the instance.
+     **/
+    if (!config.isObject() || !config.isMember("__instance_options__"))
+        return true;
+    auto& options = config["__instance_options__"];
+    if (!options.isObject()) return true;
+
+    size_t value;
+    for (auto field : {"block_cache_size", "max_open_files",
+                       "max_background_jobs", "write_buffer_size",
+                       "bloom_bits_per_key", "prefix_length"}) {
+        if (!get_size_option(options, field, &value)) return false;
+    }
+    if (options.isMember("compression")) {
+        std::string compression;
+        if (options["compression"].isString())
+            compression = options["compression"].asString();
+        if (compression != "snappy" && compression != "lz4"
+            && compression != "zstd" && compression != "none") {
+            std::cerr << "RocksDBDataStore::configure: unknown compression \""
+                      << compression << "\"" << std::endl;
+            return false;
+        }
+    }
+    _instance_options = options;
+    return true;
+}
+
+std::shared_ptr<RocksDBDataStore::Instance>
+RocksDBDataStore::get_instance(const std::string& path,
+                               const Json::Value& options,
+                               const std::string& db_name,
+                               const std::string& fn_name,
+                               comparator_fn      less)
+{
+    std::lock_guard<std::mutex> lock(_instances_mtx);
+    auto                        instance = _instances[path].lock();
+    if (instance) return instance;
+    instance = std::make_shared<Instance>();
+
+    rocksdb::DBOptions db_options;
+    db_options.create_if_missing              = true;
+    db_options.create_missing_column_families = true;
+    if (options.isMember("max_open_files"))
+        db_options.max_open_files = options["max_open_files"].asInt();
+    if (options.isMember("max_background_jobs"))
+        db_options.max_background_jobs = options["max_background_jobs"].asInt();
+
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.block_cache = rocksdb::NewLRUCache(
+        options.get("block_cache_size", 8 << 20).asUInt64());
+    size_t bloom_bits_per_key = options.get("bloom_bits_per_key", 0).asUInt64();
+    if (bloom_bits_per_key) {
+        table_options.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(bloom_bits_per_key, false));
+    }
+
+    auto& cf_options = instance->cf_options;
+    cf_options.table_factory.reset(
+        rocksdb::NewBlockBasedTableFactory(table_options));
+    instance->prefix_length = options.get("prefix_length", 0).asUInt64();
+    if (instance->prefix_length) {
+        cf_options.prefix_extractor.reset(
+            rocksdb::NewFixedPrefixTransform(instance->prefix_length));
+    }
+    if (options.isMember("write_buffer_size"))
+        cf_options.write_buffer_size = options["write_buffer_size"].asUInt64();
+    std::string compression = options.get("compression", "snappy").asString();
+    if (compression == "lz4")
+        cf_options.compression = rocksdb::kLZ4Compression;
+    else if (compression == "zstd")
+        cf_options.compression = rocksdb::kZSTD;
+    else if (compression == "none")
+        cf_options.compression = rocksdb::kNoCompression;
+    else
+        cf_options.compression = rocksdb::kSnappyCompression;
+
+    /* all the existing column families have to be opened with the instance,
+     * and with their comparator, which is the default one except for the
+     * database with a custom comparison function */
+    std::vector<std::string> names;
+    mkdirs(path.c_str());
+    rocksdb::DB::ListColumnFamilies(db_options, path, &names);
+    if (names.empty()) names.push_back(rocksdb::kDefaultColumnFamilyName);
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+    for (auto& name : names) {
+        auto& cf = instance->column_families[name];
+        if (name == db_name)
+            cf.comparator.reset(new RocksDBDataStoreComparator(fn_name, less));
+        else
+            cf.comparator.reset(new RocksDBDataStoreComparator("", nullptr));
+        descriptors.emplace_back(name, cf_options);
+        descriptors.back().options.comparator = cf.comparator.get();
+    }
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    rocksdb::Status                           status = rocksdb::DB::Open(
+        db_options, path, descriptors, &handles, &instance->db);
+    if (!status.ok()) {
+        std::cerr << "RocksDBDataStore::get_instance: RocksDB error on Open = "
+                  << status.ToString() << std::endl;
+        return nullptr;
+    }
+    for (size_t i = 0; i < names.size(); i++)
+        instance->column_families[names[i]].handle = handles[i];
+
+    _instances[path] = instance;
+    return instance;
+}
+
+bool RocksDBDataStore::openDatabase(const std::string& db_name,
+                                    const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+
+    std::string path = db_path.empty() ? db_name : db_path;
+    if (_less) path += "/" + db_name;
+    _instance
+        = get_instance(path, _instance_options, db_name, _comp_fun_name, _less);
+    if (!_instance) return false;
+    _dbm = _instance->db;
+
+    std::lock_guard<std::mutex> lock(_instance->mtx);
+    auto&                       cf = _instance->column_families[db_name];
+    if (cf.attached) {
+        std::cerr << "RocksDBDataStore::openDatabase: database \"" << db_name
+                  << "\" is already open" << std::endl;
+        return false;
+    }
+    if (!cf.handle) {
+        cf.comparator.reset(
+            new RocksDBDataStoreComparator(_comp_fun_name, _less));
+        rocksdb::ColumnFamilyOptions options = _instance->cf_options;
+        options.comparator                   = cf.comparator.get();
+        rocksdb::Status status
+            = _dbm->CreateColumnFamily(options, db_name, &cf.handle);
+        if (!status.ok()) {
+            std::cerr << "RocksDBDataStore::openDatabase: RocksDB error on"
+                      << " CreateColumnFamily = " << status.ToString()
+                      << std::endl;
+            _instance->column_families.erase(db_name);
+            return false;
+        }
+    }
+    cf.attached = true;
+    _cf         = cf.handle;
+    _keycmp     = cf.comparator.get();
+    return true;
+}
+
+void RocksDBDataStore::set_comparison_function(const std::string& name,
+                                               comparator_fn      less)
+{
+    if (!_cf) {
+        _comp_fun_name = name;
+        _less          = less;
+    } else if (name != _comp_fun_name) {
+        std::cerr << "RocksDBDataStore::set_comparison_function: the"
+                  << " comparison function of an open database cannot be"
+                  << " changed" << std::endl;
+    }
+}
+
+void RocksDBDataStore::set_in_memory(bool enable) {}
+
+void RocksDBDataStore::sync() { _dbm->SyncWAL(); }
+
+int RocksDBDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    rocksdb::Slice  begin(lower.data(), lower.size());
+    rocksdb::Slice  end(upper.data(), upper.size());
+    rocksdb::Status status = _dbm->CompactRange(
+        rocksdb::CompactRangeOptions(), _cf, lower.empty() ? nullptr : &begin,
+        upper.empty() ? nullptr : &end);
+    if (status.ok()) return SDSKV_SUCCESS;
+    std::cerr << "RocksDBDataStore::compact: RocksDB error on CompactRange = "
+              << status.ToString() << std::endl;
+    return SDSKV_ERR_PUT;
+}
+
+int RocksDBDataStore::write(const rocksdb::Slice* keys,
+                            const rocksdb::Slice* values,
+                            hg_size_t             num_items)
+{
+    int                 ret = SDSKV_SUCCESS;
+    rocksdb::WriteBatch batch;
+    /* the keys are checked and written with the other writes excluded, so
+     * that two no-overwrite puts cannot both find a key missing and that
+     * updates do not overwrite the value */
+    ABT_mutex_lock(_write_mutex);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        if (_no_overwrite && exists(keys[i].data(), keys[i].size())) {
+            ret = SDSKV_ERR_KEYEXISTS;
+            continue;
+        }
+        batch.Put(_cf, keys[i], values[i]);
+    }
+    rocksdb::Status status;
+    if (batch.Count() != 0)
+        status = _dbm->Write(rocksdb::WriteOptions(), &batch);
+    ABT_mutex_unlock(_write_mutex);
+    if (status.ok()) return ret;
+    std::cerr << "RocksDBDataStore::put: RocksDB error on Write = "
+              << status.ToString() << std::endl;
+    return SDSKV_ERR_PUT;
+}
+
+int RocksDBDataStore::put(const void* key,
+                          hg_size_t   ksize,
+                          const void* value,
+                          hg_size_t   vsize)
+{
+    rocksdb::Slice k((const char*)key, ksize);
+    rocksdb::Slice v((const char*)value, vsize);
+    return write(&k, &v, 1);
+}
+
+int RocksDBDataStore::put_multi(hg_size_t          num_items,
+                                const void* const* keys,
+                                const hg_size_t*   ksizes,
+                                const void* const* values,
+                                const hg_size_t*   vsizes)
+{
+    std::vector<rocksdb::Slice> k(num_items);
+    std::vector<rocksdb::Slice> v(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        k[i] = rocksdb::Slice((const char*)keys[i], ksizes[i]);
+        v[i] = rocksdb::Slice((const char*)values[i], vsizes[i]);
+    }
+    return write(k.data(), v.data(), num_items);
+}
+
+int RocksDBDataStore::put_packed(hg_size_t        num_items,
+                                 const char*      keys,
+                                 const hg_size_t* ksizes,
+                                 const char*      values,
+                                 const hg_size_t* vsizes)
+{
+    std::vector<rocksdb::Slice> k(num_items);
+    std::vector<rocksdb::Slice> v(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        k[i] = rocksdb::Slice(keys, ksizes[i]);
+        v[i] = rocksdb::Slice(values, vsizes[i]);
+        keys += ksizes[i];
+        values += vsizes[i];
+    }
+    return write(k.data(), v.data(), num_items);
+}
+
+bool RocksDBDataStore::get_view(const void*    key,
+                                hg_size_t      ksize,
+                                const view_fn& fn)
+{
+    /* the value stays pinned in the block cache or memtable while fn runs */
+    rocksdb::PinnableSlice value;
+    rocksdb::Status        status = _dbm->Get(
+        rocksdb::ReadOptions(), _cf, rocksdb::Slice((const char*)key, ksize),
+        &value);
+    if (status.ok()) {
+        fn(value.data(), value.size());
+        return true;
+    } else if (!status.IsNotFound()) {
+        std::cerr << "RocksDBDataStore::get: RocksDB error on Get = "
+                  << status.ToString() << std::endl;
+    }
+    return false;
+}
+
+void RocksDBDataStore::get_multi_view(hg_size_t            num_keys,
+                                      const void* const*   keys,
+                                      const hg_size_t*     ksizes,
+                                      const multi_view_fn& fn)
+{
+    std::vector<rocksdb::Slice>         k(num_keys);
+    std::vector<rocksdb::PinnableSlice> values(num_keys);
+    std::vector<rocksdb::Status>        statuses(num_keys);
+    for (hg_size_t i = 0; i < num_keys; i++)
+        k[i] = rocksdb::Slice((const char*)keys[i], ksizes[i]);
+    _dbm->MultiGet(rocksdb::ReadOptions(), _cf, num_keys, k.data(),
+                   values.data(), statuses.data());
+    for (hg_size_t i = 0; i < num_keys; i++) {
+        if (statuses[i].ok()) fn(i, values[i].data(), values[i].size());
+    }
+}
+
+bool RocksDBDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    data.clear();
+    return get_view(key.data(), key.size(),
+                    [&data](const void* value, hg_size_t vsize) {
+                        data.assign((const char*)value,
+                                    (const char*)value + vsize);
+                    });
+}
+
+bool RocksDBDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    bool success = false;
+
+    data.clear();
+    ds_bulk_t value;
+    if (get(key, value)) {
+        data.push_back(value);
+        success = true;
+    }
+
+    return success;
+}
+
+bool RocksDBDataStore::length(const void* key, hg_size_t ksize, size_t* vsize)
+{
+    return get_view(key, ksize, [vsize](const void*, hg_size_t size) {
+        *vsize = size;
+    });
+}
+
+bool RocksDBDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    return length(key.data(), key.size(), vsize);
+}
+
+bool RocksDBDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    rocksdb::Slice k((const char*)key, ksize);
+    std::string    value;
+    /* KeyMayExist only looks at memory (memtables, bloom filters) */
+    if (!_dbm->KeyMayExist(rocksdb::ReadOptions(), _cf, k, &value))
+        return false;
+    rocksdb::PinnableSlice pinned;
+    return _dbm->Get(rocksdb::ReadOptions(), _cf, k, &pinned).ok();
+}
+
+bool RocksDBDataStore::erase(const ds_bulk_t& key)
+{
+    ABT_mutex_lock(_write_mutex);
+    rocksdb::Status status
+        = _dbm->Delete(rocksdb::WriteOptions(), _cf,
+                       rocksdb::Slice(key.data(), key.size()));
+    ABT_mutex_unlock(_write_mutex);
+    return status.ok();
+}
+
+/* the value is read and written with the other writes excluded */
+int RocksDBDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    ds_bulk_t value, new_value;
+    int       ret = SDSKV_SUCCESS;
+    ABT_mutex_lock(_write_mutex);
+    bool found = get(key, value);
+    if (fn(found ? &value : nullptr, new_value)) {
+        if (_no_overwrite && found) {
+            ret = SDSKV_ERR_KEYEXISTS;
+        } else {
+            rocksdb::Status status = _dbm->Put(
+                rocksdb::WriteOptions(), _cf,
+                rocksdb::Slice(key.data(), key.size()),
+                rocksdb::Slice(new_value.data(), new_value.size()));
+            if (!status.ok()) {
+                std::cerr << "RocksDBDataStore::update: RocksDB error on Put = "
+                          << status.ToString() << std::endl;
+                ret = SDSKV_ERR_PUT;
+            }
+        }
+    }
+    ABT_mutex_unlock(_write_mutex);
+    return ret;
+}
+
+/* the keys of the range are counted, then deleted with a single range
+ * tombstone */
+int RocksDBDataStore::erase_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  hg_size_t*       num_erased)
+{
+    rocksdb::ReadOptions options;
+    options.fill_cache = false;
+    std::unique_ptr<rocksdb::Iterator> it(_dbm->NewIterator(options, _cf));
+    rocksdb::Slice upper_slice(upper.data(), upper.size());
+    std::string    first, last;
+
+    *num_erased = 0;
+    if (lower.size() > 0)
+        it->Seek(rocksdb::Slice(lower.data(), lower.size()));
+    else
+        it->SeekToFirst();
+    for (; it->Valid(); it->Next()) {
+        if (upper.size() > 0 && _keycmp->Compare(it->key(), upper_slice) >= 0)
+            break;
+        if (*num_erased == 0) first = it->key().ToString();
+        /* without upper bound, the range ends with the last key */
+        if (upper.size() == 0) last = it->key().ToString();
+        *num_erased += 1;
+    }
+    if (*num_erased == 0) return SDSKV_SUCCESS;
+
+    rocksdb::WriteBatch batch;
+    if (upper.size() > 0) {
+        batch.DeleteRange(_cf, first, upper_slice);
+    } else {
+        batch.DeleteRange(_cf, first, last);
+        batch.Delete(_cf, last);
+    }
+    ABT_mutex_lock(_write_mutex);
+    rocksdb::Status status = _dbm->Write(rocksdb::WriteOptions(), &batch);
+    ABT_mutex_unlock(_write_mutex);
+    if (status.ok()) return SDSKV_SUCCESS;
+    std::cerr << "RocksDBDataStore::erase_range: RocksDB error on Write = "
+              << status.ToString() << std::endl;
+    *num_erased = 0;
+    return SDSKV_ERR_ERASE;
+}
+
+int RocksDBDataStore::count_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  bool             with_sizes,
+                                  ds_count_t&      result) const
+{
+    rocksdb::ReadOptions options;
+    options.fill_cache = false;
+    rocksdb::Slice upper_slice(upper.data(), upper.size());
+    if (upper.size() > 0) options.iterate_upper_bound = &upper_slice;
+    std::unique_ptr<rocksdb::Iterator> it(_dbm->NewIterator(options, _cf));
+
+    result = ds_count_t();
+    if (lower.size() > 0)
+        it->Seek(rocksdb::Slice(lower.data(), lower.size()));
+    else
+        it->SeekToFirst();
+    for (; it->Valid(); it->Next()) {
+        result.num_keys += 1;
+        if (with_sizes) {
+            result.key_bytes += it->key().size();
+            result.value_bytes += it->value().size();
+        }
+    }
+    if (!it->status().ok()) {
+        std::cerr << "RocksDBDataStore::count_range: RocksDB error on"
+                  << " iteration = " << it->status().ToString() << std::endl;
+        return SDSKV_ERR_READ;
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* calls f(key, value) on the pairs following start (excluded), in order,
+ * until f returns false; starts at prefix (included) instead when possible */
+template <typename F>
+void RocksDBDataStore::iterate(const ds_bulk_t& start,
+                               const ds_bulk_t& prefix,
+                               F&&              f) const
+{
+    rocksdb::ReadOptions options;
+    bool             at_prefix = seek_to_prefix(start, prefix);
+    const ds_bulk_t& from      = at_prefix ? prefix : start;
+    /* the prefix bloom filters can be used if the iteration cannot leave
+     * the prefix of the key we seek to */
+    size_t prefix_length = _instance->prefix_length;
+    if (prefix_length && prefix.size() >= prefix_length
+        && from.size() >= prefix_length
+        && std::memcmp(from.data(), prefix.data(), prefix_length) == 0)
+        options.prefix_same_as_start = true;
+    /* with the default ordering, the iteration can stop at the successor of
+     * the prefix without reading past it */
+    std::string    upper;
+    rocksdb::Slice upper_slice;
+    if (!prefix.empty() && _comp_fun_name.empty()) {
+        upper.assign(prefix.data(), prefix.size());
+        while (!upper.empty() && (unsigned char)upper.back() == 0xff)
+            upper.pop_back();
+        if (!upper.empty()) {
+            upper.back()++;
+            upper_slice                 = rocksdb::Slice(upper);
+            options.iterate_upper_bound = &upper_slice;
+        }
+    }
+
+    std::unique_ptr<rocksdb::Iterator> it(_dbm->NewIterator(options, _cf));
+    if (at_prefix) {
+        it->Seek(rocksdb::Slice(prefix.data(), prefix.size()));
+    } else if (start.size() > 0) {
+        rocksdb::Slice start_slice(start.data(), start.size());
+        it->Seek(start_slice);
+        /* we treat 'start' the way RADOS treats it: excluding it from
+         * returned keys */
+        if (it->Valid() && _keycmp->Compare(it->key(), start_slice) == 0)
+            it->Next();
+    } else {
+        it->SeekToFirst();
+    }
+    for (; it->Valid(); it->Next())
+        if (!f(it->key(), it->value())) break;
+}
+
+std::vector<ds_bulk_t> RocksDBDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    std::vector<ds_bulk_t> keys;
+    if (count == 0) return keys;
+    iterate(start, prefix,
+            [&](const rocksdb::Slice& k, const rocksdb::Slice&) {
+                int c = compare_prefix(prefix, k.data(), k.size());
+                if (c == 0) keys.emplace_back(k.data(), k.data() + k.size());
+                return c >= 0 && keys.size() < count;
+            });
+    return keys;
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>> RocksDBDataStore::vlist_keyvals(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    if (count == 0) return result;
+    iterate(start, prefix,
+            [&](const rocksdb::Slice& k, const rocksdb::Slice& v) {
+                int c = compare_prefix(prefix, k.data(), k.size());
+                if (c == 0) {
+                    result.emplace_back(ds_bulk_t(k.data(), k.data() + k.size()),
+                                        ds_bulk_t(v.data(), v.data() + v.size()));
+                }
+                return c >= 0 && result.size() < count;
+            });
+    return result;
+}
+
+std::vector<ds_bulk_t>
+RocksDBDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                  const ds_bulk_t& upper_bound,
+                                  hg_size_t        max_keys) const
+{
+    std::vector<ds_bulk_t> result;
+    rocksdb::Slice         upper(upper_bound.data(), upper_bound.size());
+    iterate(lower_bound, ds_bulk_t(),
+            [&](const rocksdb::Slice& k, const rocksdb::Slice&) {
+                if (!upper.empty() && _keycmp->Compare(k, upper) >= 0)
+                    return false;
+                result.emplace_back(k.data(), k.data() + k.size());
+                return max_keys == 0 || result.size() < max_keys;
+            });
+    return result;
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+RocksDBDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                     const ds_bulk_t& upper_bound,
+                                     hg_size_t        max_keys) const
+{
+    std::vector<std::pair<ds_bulk_t, ds_bulk_t>> result;
+    rocksdb::Slice upper(upper_bound.data(), upper_bound.size());
+    iterate(lower_bound, ds_bulk_t(),
+            [&](const rocksdb::Slice& k, const rocksdb::Slice& v) {
+                if (!upper.empty() && _keycmp->Compare(k, upper) >= 0)
+                    return false;
+                result.emplace_back(ds_bulk_t(k.data(), k.data() + k.size()),
+                                    ds_bulk_t(v.data(), v.data() + v.size()));
+                return max_keys == 0 || result.size() < max_keys;
+            });
+    return result;
+}
+
+#ifdef USE_REMI
+remi_fileset_t RocksDBDataStore::create_and_populate_fileset() const
+{
+    /* the files of a RocksDB instance hold all of its column families, so a
+     * single database cannot be migrated as a set of files */
+    return REMI_FILESET_NULL;
+}
+#endif
@@ -0,0 +1,180 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef rocksdb_datastore_h
+#define rocksdb_datastore_h
+
+#include "kv-config.h"
+#include <rocksdb/db.h>
+#include <rocksdb/comparator.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/options.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// each database is a column family of a RocksDB instance shared by all the
+// databases with the same path, so that they share the same block cache, WAL
+// and background threads; since the comparators of all the column families
+// have to be given when the instance is opened, a database with a custom
+// comparison function gets its own instance, in a subdirectory of the path
+class RocksDBDataStore : public AbstractDataStore {
+  private:
+    // the name of the comparison function is part of the name of the
+    // comparator, which RocksDB checks when the instance is reopened
+    class RocksDBDataStoreComparator : public rocksdb::Comparator {
+      public:
+        RocksDBDataStoreComparator(const std::string& fn_name,
+                                   comparator_fn      less)
+            : _less(less), _name("RocksDBDataStoreComparator")
+        {
+            if (less) _name += "." + fn_name;
+        }
+
+        int Compare(const rocksdb::Slice& a, const rocksdb::Slice& b) const
+        {
+            if (_less) {
+                return _less((const void*)a.data(), a.size(),
+                             (const void*)b.data(), b.size());
+            } else {
+                return a.compare(b);
+            }
+        }
+
+        const char* Name() const { return _name.c_str(); }
+        // keys are only shortened with the default (bytewise) ordering
+        void FindShortestSeparator(std::string*          start,
+                                   const rocksdb::Slice& limit) const
+        {
+            if (!_less)
+                rocksdb::BytewiseComparator()->FindShortestSeparator(start,
+                                                                     limit);
+        }
+        void FindShortSuccessor(std::string* key) const
+        {
+            if (!_less) rocksdb::BytewiseComparator()->FindShortSuccessor(key);
+        }
+
+      private:
+        comparator_fn _less;
+        std::string   _name;
+    };
+
+    struct ColumnFamily {
+        rocksdb::ColumnFamilyHandle*                handle   = nullptr;
+        bool                                        attached = false;
+        std::unique_ptr<RocksDBDataStoreComparator> comparator;
+    };
+
+    // a RocksDB instance, released when the last database using it is closed
+    struct Instance {
+        rocksdb::DB*                        db = nullptr;
+        rocksdb::ColumnFamilyOptions        cf_options;
+        size_t                              prefix_length = 0;
+        std::map<std::string, ColumnFamily> column_families;
+        std::mutex                          mtx;
+        ~Instance();
+    };
+
+    static std::shared_ptr<Instance>
+    get_instance(const std::string& path,
+                 const Json::Value& options,
+                 const std::string& db_name,
+                 const std::string& fn_name,
+                 comparator_fn      less);
+    static std::mutex                                       _instances_mtx;
+    static std::map<std::string, std::weak_ptr<Instance>> _instances;
+
+  public:
+    RocksDBDataStore();
+    RocksDBDataStore(bool eraseOnGet, bool debug);
+    virtual ~RocksDBDataStore();
+    virtual bool configure(const Json::Value& config) override;
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool get_view(const void*    key,
+                          hg_size_t      ksize,
+                          const view_fn& fn) override;
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn) override;
+    virtual bool
+    length(const void* key, hg_size_t ksize, size_t* vsize) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual void set_in_memory(bool enable) override; // not supported, a no-op
+    // the comparison function has to be set before the database is opened
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_no_overwrite() override { _no_overwrite = true; }
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+    std::shared_ptr<Instance>    _instance;
+    rocksdb::DB*                 _dbm = nullptr;
+    rocksdb::ColumnFamilyHandle* _cf  = nullptr;
+
+  private:
+    int  write(const rocksdb::Slice* keys,
+               const rocksdb::Slice* values,
+               hg_size_t             num_items);
+    template <typename F>
+    void iterate(const ds_bulk_t& start, const ds_bulk_t& prefix, F&& f) const;
+
+    RocksDBDataStoreComparator* _keycmp = nullptr;
+    comparator_fn               _less   = nullptr;
+    Json::Value                 _instance_options;
+    // serializes the writes, so that updates are atomic with respect to them
+    ABT_mutex _write_mutex = ABT_MUTEX_NULL;
+};
+
+#endif // rocksdb_datastore_h
@@ -0,0 +1,444 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#include "watched_datastore.h"
+#include "kv-config.h"
+#include <algorithm>
+#include <cstring>
+
+/* holds the order lock, if any, during a write and its report: exclusively
+ * if the write is reported, so that the listener sees the changes in the
+ * order they were made, and shared otherwise, so that barrier can wait for
+ * the writes that started before the listener became active */
+class WatchedDataStore::OrderLock {
+
+  public:
+    OrderLock(ABT_rwlock lock, bool report) : _lock(lock)
+    {
+        if (_lock == ABT_RWLOCK_NULL) return;
+        if (report)
+            ABT_rwlock_wrlock(_lock);
+        else
+            ABT_rwlock_rdlock(_lock);
+    }
+    ~OrderLock() { release(); }
+    void release()
+    {
+        if (_lock != ABT_RWLOCK_NULL) ABT_rwlock_unlock(_lock);
+        _lock = ABT_RWLOCK_NULL;
+    }
+
+  private:
+    ABT_rwlock _lock;
+};
+
+WatchedDataStore::WatchedDataStore(AbstractDataStore*              inner,
+                                   std::shared_ptr<ChangeListener> listener,
+                                   bool                            ordered)
+    : AbstractDataStore(false, false), _inner(inner),
+      _listener(std::move(listener))
+{
+    _name          = _inner->get_name();
+    _path          = _inner->get_path();
+    _comp_fun_name = _inner->get_comparison_function_name();
+    if (ordered) ABT_rwlock_create(&_order_lock);
+    /* keys are evicted by writes, which hold the order lock */
+    _inner->set_eviction_handler([this](const void* key, hg_size_t ksize) {
+        if (_listener->active())
+            _listener->changed(SDSKV_WATCH_ERASE, key, ksize, nullptr, 0);
+        if (_on_evicted) _on_evicted(key, ksize);
+    });
+}
+
+WatchedDataStore::~WatchedDataStore()
+{
+    if (_order_lock != ABT_RWLOCK_NULL) ABT_rwlock_free(&_order_lock);
+}
+
+void WatchedDataStore::barrier() { OrderLock lock(_order_lock, true); }
+
+int WatchedDataStore::reported(OrderLock& lock)
+{
+    uint64_t mark = _listener->mark();
+    lock.release();
+    return _listener->wait(mark);
+}
+
+/* the inner datastore is already open */
+bool WatchedDataStore::openDatabase(const std::string& db_name,
+                                    const std::string& db_path)
+{
+    _name = db_name;
+    _path = db_path;
+    return true;
+}
+
+bool WatchedDataStore::below(const ds_bulk_t& key,
+                             const ds_bulk_t& upper) const
+{
+    if (upper.empty()) return true;
+    if (_less)
+        return _less(key.data(), key.size(), upper.data(), upper.size()) < 0;
+    return std::lexicographical_compare(
+        (const unsigned char*)key.data(),
+        (const unsigned char*)key.data() + key.size(),
+        (const unsigned char*)upper.data(),
+        (const unsigned char*)upper.data() + upper.size());
+}
+
+int WatchedDataStore::put(const void* key,
+                          hg_size_t   ksize,
+                          const void* value,
+                          hg_size_t   vsize)
+{
+    bool      report = _listener->active();
+    OrderLock lock(_order_lock, report);
+    int       ret = _inner->put(key, ksize, value, vsize);
+    if (ret != SDSKV_SUCCESS || !report) return ret;
+    put_changed(key, ksize, value, vsize);
+    return reported(lock);
+}
+
+int WatchedDataStore::put(ds_bulk_t&& key, ds_bulk_t&& data)
+{
+    if (_listener->active())
+        return put(key.data(), key.size(), data.data(), data.size());
+    OrderLock lock(_order_lock, false);
+    return _inner->put(std::move(key), std::move(data));
+}
+
+int WatchedDataStore::put_ttl(const void* key,
+                              hg_size_t   ksize,
+                              const void* value,
+                              hg_size_t   vsize,
+                              uint64_t    ttl_ms)
+{
+    bool      report = _listener->active();
+    OrderLock lock(_order_lock, report);
+    int       ret = _inner->put_ttl(key, ksize, value, vsize, ttl_ms);
+    if (ret != SDSKV_SUCCESS || !report) return ret;
+    put_changed(key, ksize, value, vsize);
+    return reported(lock);
+}
+
+/* while the listener is active, the entries are put one by one, since the
+ * backends do not tell which puts of a batch failed, and the ones that
+ * succeeded are reported together */
+int WatchedDataStore::put_multi(hg_size_t          num_items,
+                                const void* const* keys,
+                                const hg_size_t*   ksizes,
+                                const void* const* values,
+                                const hg_size_t*   vsizes)
+{
+    bool      report = _listener->active();
+    OrderLock lock(_order_lock, report);
+    if (!report)
+        return _inner->put_multi(num_items, keys, ksizes, values, vsizes);
+    int  ret     = SDSKV_SUCCESS;
+    bool changed = false;
+    for (hg_size_t i = 0; i < num_items; i++) {
+        int r = _inner->put(keys[i], ksizes[i], values[i], vsizes[i]);
+        if (r == SDSKV_SUCCESS) {
+            put_changed(keys[i], ksizes[i], values[i], vsizes[i]);
+            changed = true;
+        } else if (ret == SDSKV_SUCCESS) {
+            ret = r;
+        }
+    }
+    if (!changed) return ret;
+    int r = reported(lock);
+    return ret != SDSKV_SUCCESS ? ret : r;
+}
+
+int WatchedDataStore::put_packed(hg_size_t        num_items,
+                                 const char*      keys,
+                                 const hg_size_t* ksizes,
+                                 const char*      values,
+                                 const hg_size_t* vsizes)
+{
+    if (!_listener->active()) {
+        OrderLock lock(_order_lock, false);
+        return _inner->put_packed(num_items, keys, ksizes, values, vsizes);
+    }
+    std::vector<const void*> kptrs(num_items);
+    std::vector<const void*> vptrs(num_items);
+    for (hg_size_t i = 0; i < num_items; i++) {
+        kptrs[i] = keys;
+        vptrs[i] = values;
+        keys += ksizes[i];
+        values += vsizes[i];
+    }
+    return put_multi(num_items, kptrs.data(), ksizes, vptrs.data(), vsizes);
+}
+
+bool WatchedDataStore::get(const ds_bulk_t& key, ds_bulk_t& data)
+{
+    return _inner->get(key, data);
+}
+
+bool WatchedDataStore::get(const ds_bulk_t& key, std::vector<ds_bulk_t>& data)
+{
+    return _inner->get(key, data);
+}
+
+bool WatchedDataStore::get_view(const void*    key,
+                                hg_size_t      ksize,
+                                const view_fn& fn)
+{
+    return _inner->get_view(key, ksize, fn);
+}
+
+void WatchedDataStore::get_multi_view(hg_size_t            num_keys,
+                                      const void* const*   keys,
+                                      const hg_size_t*     ksizes,
+                                      const multi_view_fn& fn)
+{
+    _inner->get_multi_view(num_keys, keys, ksizes, fn);
+}
+
+bool WatchedDataStore::get_range_view(const void*    key,
+                                      hg_size_t      ksize,
+                                      hg_size_t      offset,
+                                      hg_size_t      size,
+                                      const view_fn& fn)
+{
+    return _inner->get_range_view(key, ksize, offset, size, fn);
+}
+
+bool WatchedDataStore::get_stream(const void*          key,
+                                  hg_size_t            ksize,
+                                  hg_size_t            chunk_size,
+                                  const chunk_sink_fn& fn)
+{
+    return _inner->get_stream(key, ksize, chunk_size, fn);
+}
+
+bool WatchedDataStore::length(const ds_bulk_t& key, size_t* vsize)
+{
+    return _inner->length(key, vsize);
+}
+
+bool WatchedDataStore::exists(const void* key, hg_size_t ksize) const
+{
+    return _inner->exists(key, ksize);
+}
+
+/* the key is erased even if the listener fails to handle its erasure */
+bool WatchedDataStore::erase(const ds_bulk_t& key)
+{
+    bool      report = _listener->active();
+    OrderLock lock(_order_lock, report);
+    bool      erased = _inner->erase(key);
+    if (erased && report) {
+        _listener->changed(SDSKV_WATCH_ERASE, key.data(), key.size(), nullptr,
+                           0);
+        reported(lock);
+    }
+    return erased;
+}
+
+/* while the listener is active, the keys of the range are listed and erased
+ * one by one so that each erasure can be reported */
+int WatchedDataStore::erase_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  hg_size_t*       num_erased)
+{
+    if (!_listener->active()) {
+        OrderLock lock(_order_lock, false);
+        return _inner->erase_range(lower, upper, num_erased);
+    }
+    *num_erased = 0;
+    /* listings start after their start key */
+    if (!lower.empty() && below(lower, upper) && erase(lower))
+        *num_erased += 1;
+    ds_bulk_t start = lower;
+    while (true) {
+        auto keys = _inner->list_keys(start, erase_batch_size);
+        for (const auto& key : keys) {
+            if (!below(key, upper)) return SDSKV_SUCCESS;
+            if (erase(key)) *num_erased += 1;
+        }
+        if (keys.size() < erase_batch_size) break;
+        start = keys.back();
+    }
+    return SDSKV_SUCCESS;
+}
+
+int WatchedDataStore::erase_prefixed(const ds_bulk_t& prefix,
+                                     hg_size_t*       num_erased)
+{
+    if (!_listener->active()) {
+        OrderLock lock(_order_lock, false);
+        return _inner->erase_prefixed(prefix, num_erased);
+    }
+    *num_erased = 0;
+    ds_bulk_t start;
+    while (true) {
+        auto keys = _inner->list_keys(start, erase_batch_size, prefix);
+        for (const auto& key : keys)
+            if (erase(key)) *num_erased += 1;
+        if (keys.size() < erase_batch_size) break;
+        start = keys.back();
+    }
+    return SDSKV_SUCCESS;
+}
+
+int WatchedDataStore::count_range(const ds_bulk_t& lower,
+                                  const ds_bulk_t& upper,
+                                  bool             with_sizes,
+                                  ds_count_t&      result) const
+{
+    return _inner->count_range(lower, upper, with_sizes, result);
+}
+
+int WatchedDataStore::count_prefixed(const ds_bulk_t& prefix,
+                                     bool             with_sizes,
+                                     ds_count_t&      result) const
+{
+    return _inner->count_prefixed(prefix, with_sizes, result);
+}
+
+/* the new value computed by fn is kept to be reported */
+int WatchedDataStore::update(const ds_bulk_t& key, const update_fn& fn)
+{
+    bool      report = _listener->active();
+    OrderLock lock(_order_lock, report);
+    if (!report) return _inner->update(key, fn);
+    bool      modified = false;
+    ds_bulk_t value;
+    int       ret      = _inner->update(
+        key, [&](const ds_bulk_t* current, ds_bulk_t& new_value) {
+            modified = fn(current, new_value);
+            if (modified) value = new_value;
+            return modified;
+        });
+    if (ret != SDSKV_SUCCESS || !modified) return ret;
+    put_changed(key.data(), key.size(), value.data(), value.size());
+    return reported(lock);
+}
+
+/* while the listener is active, partial and streamed puts go through update
+ * and put, which report the whole new value */
+int WatchedDataStore::put_range(const ds_bulk_t& key,
+                                hg_size_t        offset,
+                                const void*      data,
+                                hg_size_t        size)
+{
+    if (!_listener->active()) {
+        OrderLock lock(_order_lock, false);
+        return _inner->put_range(key, offset, data, size);
+    }
+    return AbstractDataStore::put_range(key, offset, data, size);
+}
+
+int WatchedDataStore::put_stream(const ds_bulk_t&       key,
+                                 hg_size_t              vsize,
+                                 const chunk_source_fn& next)
+{
+    if (!_listener->active()) {
+        OrderLock lock(_order_lock, false);
+        return _inner->put_stream(key, vsize, next);
+    }
+    return AbstractDataStore::put_stream(key, vsize, next);
+}
+
+/* expired entries are erased without being reported */
+int WatchedDataStore::reclaim_expired(ds_bulk_t& cursor,
+                                      hg_size_t  batch_size,
+                                      hg_size_t* num_erased)
+{
+    return _inner->reclaim_expired(cursor, batch_size, num_erased);
+}
+
+int WatchedDataStore::get_changes(uint64_t                  since,
+                                  hg_size_t                 max_changes,
+                                  hg_size_t                 max_bytes,
+                                  std::vector<ds_change_t>& changes,
+                                  uint64_t*                 last_seq) const
+{
+    return _inner->get_changes(since, max_changes, max_bytes, changes,
+                               last_seq);
+}
+
+int WatchedDataStore::truncate_changes(uint64_t upto)
+{
+    return _inner->truncate_changes(upto);
+}
+
+void WatchedDataStore::set_in_memory(bool enable)
+{
+    _inner->set_in_memory(enable);
+}
+
+void WatchedDataStore::set_comparison_function(const std::string& name,
+                                               comparator_fn      less)
+{
+    _comp_fun_name = name;
+    _less          = less;
+    _inner->set_comparison_function(name, less);
+}
+
+void WatchedDataStore::set_key_shortening_functions(separator_fn separator,
+                                                    successor_fn successor)
+{
+    _inner->set_key_shortening_functions(separator, successor);
+}
+
+void WatchedDataStore::set_no_overwrite()
+{
+    _no_overwrite = true;
+    _inner->set_no_overwrite();
+}
+
+void WatchedDataStore::sync() { _inner->sync(); }
+
+int WatchedDataStore::compact(const ds_bulk_t& lower, const ds_bulk_t& upper)
+{
+    return _inner->compact(lower, upper);
+}
+
+bool WatchedDataStore::memory_usage(ds_memory_t& usage) const
+{
+    return _inner->memory_usage(usage);
+}
+
+bool WatchedDataStore::cache_usage(ds_cache_t& usage) const
+{
+    return _inner->cache_usage(usage);
+}
+
+std::vector<ds_bulk_t> WatchedDataStore::vlist_keys(
+    const ds_bulk_t& start, hg_size_t count, const ds_bulk_t& prefix) const
+{
+    return _inner->list_keys(start, count, prefix);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+WatchedDataStore::vlist_keyvals(const ds_bulk_t& start,
+                                hg_size_t        count,
+                                const ds_bulk_t& prefix) const
+{
+    return _inner->list_keyvals(start, count, prefix);
+}
+
+std::vector<ds_bulk_t>
+WatchedDataStore::vlist_key_range(const ds_bulk_t& lower_bound,
+                                  const ds_bulk_t& upper_bound,
+                                  hg_size_t        max_keys) const
+{
+    return _inner->list_key_range(lower_bound, upper_bound, max_keys);
+}
+
+std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+WatchedDataStore::vlist_keyval_range(const ds_bulk_t& lower_bound,
+                                     const ds_bulk_t& upper_bound,
+                                     hg_size_t        max_keys) const
+{
+    return _inner->list_keyval_range(lower_bound, upper_bound, max_keys);
+}
+
+#ifdef USE_REMI
+remi_fileset_t WatchedDataStore::create_and_populate_fileset() const
+{
+    return _inner->create_and_populate_fileset();
+}
+#endif
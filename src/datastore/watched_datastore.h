@@ -0,0 +1,177 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef watched_datastore_h
+#define watched_datastore_h
+
+#include <memory>
+#include "kv-config.h"
+#include "bulk.h"
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+// receives the changes made through a WatchedDataStore
+class ChangeListener {
+
+  public:
+    virtual ~ChangeListener() {}
+    // whether changes should be reported; when it returns false, writes are
+    // forwarded to the inner datastore as they are
+    virtual bool active() const = 0;
+    // type is SDSKV_WATCH_PUT, with the new value, or SDSKV_WATCH_ERASE
+    virtual void changed(sdskv_watch_event_type_t type,
+                         const void*              key,
+                         hg_size_t                ksize,
+                         const void*              value,
+                         hg_size_t                vsize)
+        = 0;
+    // called with the order lock held after the changes of a write were
+    // reported; the value returned is passed to wait once it is released
+    virtual uint64_t mark() { return 0; }
+    // waits until the changes reported up to mark are handled; an error
+    // returned here is returned by the write
+    virtual int wait(uint64_t mark) { return SDSKV_SUCCESS; }
+};
+
+// datastore reporting the keys put and erased in another datastore, which
+// it owns, to a listener. Writes of ranges of keys, which do not tell which
+// keys they modify, are split into writes of single keys while the listener
+// is active. If ordered is true, each write and its report are done under a
+// lock, so that the listener sees the changes in the order they were made.
+class WatchedDataStore : public AbstractDataStore {
+
+  public:
+    WatchedDataStore(AbstractDataStore*              inner,
+                     std::shared_ptr<ChangeListener> listener,
+                     bool                            ordered = false);
+    virtual ~WatchedDataStore();
+    // waits for the writes that started before the listener became active,
+    // which are not reported; only waits if the datastore is ordered
+    void         barrier();
+    virtual bool openDatabase(const std::string& db_name,
+                              const std::string& path) override;
+    virtual int  put(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize) override;
+    virtual int  put(ds_bulk_t&& key, ds_bulk_t&& data) override;
+    virtual int  put_ttl(const void* key,
+                         hg_size_t   ksize,
+                         const void* value,
+                         hg_size_t   vsize,
+                         uint64_t    ttl_ms) override;
+    virtual int  put_multi(hg_size_t          num_items,
+                           const void* const* keys,
+                           const hg_size_t*   ksizes,
+                           const void* const* values,
+                           const hg_size_t*   vsizes) override;
+    virtual int  put_packed(hg_size_t        num_items,
+                            const char*      keys,
+                            const hg_size_t* ksizes,
+                            const char*      values,
+                            const hg_size_t* vsizes) override;
+    virtual bool get(const ds_bulk_t& key, ds_bulk_t& data) override;
+    virtual bool get(const ds_bulk_t&        key,
+                     std::vector<ds_bulk_t>& data) override;
+    virtual bool
+    get_view(const void* key, hg_size_t ksize, const view_fn& fn) override;
+    virtual void get_multi_view(hg_size_t            num_keys,
+                                const void* const*   keys,
+                                const hg_size_t*     ksizes,
+                                const multi_view_fn& fn) override;
+    virtual bool get_range_view(const void*    key,
+                                hg_size_t      ksize,
+                                hg_size_t      offset,
+                                hg_size_t      size,
+                                const view_fn& fn) override;
+    virtual bool get_stream(const void*          key,
+                            hg_size_t            ksize,
+                            hg_size_t            chunk_size,
+                            const chunk_sink_fn& fn) override;
+    virtual bool length(const ds_bulk_t& key, size_t* vsize) override;
+    virtual bool exists(const void* key, hg_size_t ksize) const override;
+    virtual bool erase(const ds_bulk_t& key) override;
+    virtual int  erase_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             hg_size_t*       num_erased) override;
+    virtual int  erase_prefixed(const ds_bulk_t& prefix,
+                                hg_size_t*       num_erased) override;
+    virtual int  count_range(const ds_bulk_t& lower,
+                             const ds_bulk_t& upper,
+                             bool             with_sizes,
+                             ds_count_t&      result) const override;
+    virtual int  count_prefixed(const ds_bulk_t& prefix,
+                                bool             with_sizes,
+                                ds_count_t&      result) const override;
+    virtual int  update(const ds_bulk_t& key, const update_fn& fn) override;
+    virtual int  put_range(const ds_bulk_t& key,
+                           hg_size_t        offset,
+                           const void*      data,
+                           hg_size_t        size) override;
+    virtual int  put_stream(const ds_bulk_t&       key,
+                            hg_size_t              vsize,
+                            const chunk_source_fn& next) override;
+    virtual int  reclaim_expired(ds_bulk_t& cursor,
+                                 hg_size_t  batch_size,
+                                 hg_size_t* num_erased) override;
+    virtual int  get_changes(uint64_t                  since,
+                             hg_size_t                 max_changes,
+                             hg_size_t                 max_bytes,
+                             std::vector<ds_change_t>& changes,
+                             uint64_t*                 last_seq) const override;
+    virtual int  truncate_changes(uint64_t upto) override;
+    virtual void set_in_memory(bool enable) override;
+    virtual void set_comparison_function(const std::string& name,
+                                         comparator_fn      less) override;
+    virtual void set_key_shortening_functions(separator_fn separator,
+                                              successor_fn successor) override;
+    virtual void set_no_overwrite() override;
+    virtual void sync() override;
+    virtual int  compact(const ds_bulk_t& lower,
+                         const ds_bulk_t& upper) override;
+    virtual bool memory_usage(ds_memory_t& usage) const override;
+    virtual bool cache_usage(ds_cache_t& usage) const override;
+#ifdef USE_REMI
+    virtual remi_fileset_t create_and_populate_fileset() const override;
+#endif
+  protected:
+    virtual std::vector<ds_bulk_t>
+    vlist_keys(const ds_bulk_t& start,
+               hg_size_t        count,
+               const ds_bulk_t& prefix) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyvals(const ds_bulk_t& start_key,
+                  hg_size_t        count,
+                  const ds_bulk_t& prefix) const override;
+    virtual std::vector<ds_bulk_t>
+    vlist_key_range(const ds_bulk_t& lower_bound,
+                    const ds_bulk_t& upper_bound,
+                    hg_size_t        max_keys) const override;
+    virtual std::vector<std::pair<ds_bulk_t, ds_bulk_t>>
+    vlist_keyval_range(const ds_bulk_t& lower_bound,
+                       const ds_bulk_t& upper_bound,
+                       hg_size_t        max_keys) const override;
+
+  private:
+    class OrderLock;
+
+    void put_changed(const void* key,
+                     hg_size_t   ksize,
+                     const void* value,
+                     hg_size_t   vsize)
+    {
+        _listener->changed(SDSKV_WATCH_PUT, key, ksize, value, vsize);
+    }
+    // releases the order lock once the changes of a write were reported,
+    // and waits for the listener to handle them
+    int reported(OrderLock& lock);
+    // whether key is below upper, an empty bound meaning the end of the
+    // database
+    bool below(const ds_bulk_t& key, const ds_bulk_t& upper) const;
+
+    std::unique_ptr<AbstractDataStore> _inner;
+    std::shared_ptr<ChangeListener>    _listener;
+    comparator_fn                      _less       = nullptr;
+    ABT_rwlock                         _order_lock = ABT_RWLOCK_NULL;
+};
+
+#endif // watched_datastore_h
@@ -752,6 +752,99 @@ class ListKeyValsBenchmark : public ListKeysBenchmark {
 };
 REGISTER_BENCHMARK("list-keyvals", ListKeyValsBenchmark);
 
+/**
+ * ListKeysWithPrefixBenchmark stores num-entries random keys along with
+ * prefixed-entries keys starting with a given prefix (by default "~", which
+ * places them after all the random keys), then measures the duration of
+ * num-queries LIST KEYS operations retrieving all the prefixed keys. Its
+ * timings should not depend on num-entries.
+ */
+class ListKeysWithPrefixBenchmark : public GetBenchmark {
+
+  protected:
+    std::string              m_prefix;
+    size_t                   m_num_prefixed;
+    size_t                   m_num_queries;
+    size_t                   m_batch_size;
+    std::vector<std::string> m_prefixed_keys;
+    std::vector<std::string> m_keys_buffer;
+    std::vector<hg_size_t>   m_ksizes;
+    std::vector<void*>       m_kptrs;
+
+  public:
+    template <typename... T>
+    ListKeysWithPrefixBenchmark(Json::Value& config, T&&... args)
+        : GetBenchmark(config, std::forward<T>(args)...)
+    {
+        m_prefix       = config.get("prefix", "~").asString();
+        m_num_prefixed = config.get("prefixed-entries", 100).asUInt64();
+        m_num_queries  = config.get("num-queries", 100).asUInt64();
+        m_batch_size   = config.get("batch-size", 8).asUInt();
+        if (m_prefix.empty()) throw std::range_error("invalid empty prefix");
+    }
+
+    virtual void setup() override
+    {
+        GetBenchmark::setup();
+        auto& db = remoteDatabase();
+        m_prefixed_keys.reserve(m_num_prefixed);
+        for (unsigned i = 0; i < m_num_prefixed; i++) {
+            size_t ksize
+                = m_key_size_range.first
+                + (rand() % (m_key_size_range.second - m_key_size_range.first));
+            m_prefixed_keys.push_back(m_prefix + gen_random_string(ksize));
+            db.put(m_prefixed_keys.back(), std::string("x"));
+        }
+        m_keys_buffer.resize(
+            m_batch_size,
+            std::string(m_prefix.size() + m_key_size_range.second - 1, 0));
+        m_ksizes.resize(m_batch_size);
+        m_kptrs.resize(m_batch_size);
+    }
+
+    virtual void execute() override
+    {
+        auto& db = remoteDatabase();
+        for (unsigned q = 0; q < m_num_queries; q++) {
+            std::string start_key = "";
+            hg_size_t   count     = m_batch_size;
+            do {
+                count = m_batch_size;
+                for (unsigned i = 0; i < count; i++) {
+                    m_ksizes[i] = m_keys_buffer[i].size();
+                    m_kptrs[i]  = (void*)m_keys_buffer[i].data();
+                }
+                db.list_keys(start_key.data(), start_key.size(),
+                             m_prefix.data(), m_prefix.size(),
+                             (void**)m_kptrs.data(),
+                             (hg_size_t*)m_ksizes.data(), &count);
+                if (count > 0) {
+                    start_key = std::string((const char*)m_kptrs[count - 1],
+                                            m_ksizes[count - 1]);
+                }
+            } while (count == m_batch_size);
+        }
+    }
+
+    virtual void teardown() override
+    {
+        if (m_erase_on_teardown) {
+            auto& db = remoteDatabase();
+            for (auto& key : m_prefixed_keys) db.erase(key);
+        }
+        GetBenchmark::teardown();
+        m_prefixed_keys.resize(0);
+        m_prefixed_keys.shrink_to_fit();
+        m_keys_buffer.resize(0);
+        m_keys_buffer.shrink_to_fit();
+        m_ksizes.resize(0);
+        m_ksizes.shrink_to_fit();
+        m_kptrs.resize(0);
+        m_kptrs.shrink_to_fit();
+    }
+};
+REGISTER_BENCHMARK("list-keys-with-prefix", ListKeysWithPrefixBenchmark);
+
 static void            run_server(MPI_Comm comm, Json::Value& config);
 static void            run_client(MPI_Comm comm, Json::Value& config);
 static void            run_single_node(Json::Value& config);
@@ -1127,6 +1220,12 @@ static sdskv_db_type_t database_type_from_string(const std::string& type)
         return KVDB_LEVELDB;
     } else if (type == "berkeleydb" || type == "bdb") {
         return KVDB_BERKELEYDB;
+    } else if (type == "forward" || type == "fwd") {
+        return KVDB_FORWARDDB;
+    } else if (type == "lmdb" || type == "mdb") {
+        return KVDB_LMDB;
+    } else if (type == "rocksdb" || type == "rdb") {
+        return KVDB_ROCKSDB;
     }
     throw std::runtime_error(std::string("Unknown database type \"") + type
                              + "\"");
@@ -1,5 +1,7 @@
 #include "sdskv-client.h"
 #include "sdskv-rpc-types.h"
+#include "sdskv-compression.h"
+#include <pthread.h>
 
 #define MAX_RPC_MESSAGE_SIZE 4000 // in bytes
 
@@ -13,6 +15,7 @@ struct sdskv_client {
     hg_id_t sdskv_list_databases_id;
     /* accessing database */
     hg_id_t sdskv_put_id;
+    hg_id_t sdskv_put_ttl_id;
     hg_id_t sdskv_put_multi_id;
     hg_id_t sdskv_put_packed_id;
     hg_id_t sdskv_bulk_put_id;
@@ -23,6 +26,13 @@ struct sdskv_client {
     hg_id_t sdskv_exists_multi_id;
     hg_id_t sdskv_erase_id;
     hg_id_t sdskv_erase_multi_id;
+    hg_id_t sdskv_erase_range_id;
+    hg_id_t sdskv_erase_prefixed_id;
+    hg_id_t sdskv_count_range_id;
+    hg_id_t sdskv_count_prefixed_id;
+    hg_id_t sdskv_compare_and_swap_id;
+    hg_id_t sdskv_fetch_add_id;
+    hg_id_t sdskv_append_id;
     hg_id_t sdskv_length_id;
     hg_id_t sdskv_length_multi_id;
     hg_id_t sdskv_length_packed_id;
@@ -35,6 +45,21 @@ struct sdskv_client {
     hg_id_t sdskv_migrate_keys_prefixed_id;
     hg_id_t sdskv_migrate_all_keys_id;
     hg_id_t sdskv_migrate_database_id;
+    /* compaction */
+    hg_id_t sdskv_compact_id;
+    hg_id_t sdskv_get_statistics_id;
+    hg_id_t sdskv_flush_trace_id;
+    hg_id_t sdskv_get_hot_keys_id;
+    hg_id_t sdskv_get_slow_ops_id;
+    /* watches */
+    hg_id_t sdskv_watch_id;
+    hg_id_t sdskv_unwatch_id;
+    /* change logs */
+    hg_id_t sdskv_get_changes_id;
+    hg_id_t sdskv_truncate_changes_id;
+    /* replication */
+    hg_id_t sdskv_add_backup_id;
+    hg_id_t sdskv_remove_backup_id;
 
     uint64_t num_provider_handles;
 };
@@ -44,8 +69,26 @@ struct sdskv_provider_handle {
     hg_addr_t      addr;
     uint16_t       provider_id;
     uint64_t       refcount;
+    uint32_t       unsupported_codecs; /* codecs the provider cannot decode */
+    uint64_t       request_id;         /* sent with data operations */
 };
 
+/* watches created by the clients of this process, which the notifications
+ * sent by the providers designate by their id */
+struct sdskv_watch {
+    sdskv_watch_id_t    id;
+    uint64_t            server_id; /* id of the watch in the provider */
+    sdskv_watch_fn      fn;
+    void*               uargs;
+    struct sdskv_watch* next;
+};
+
+static struct sdskv_watch* sdskv_watches       = NULL;
+static sdskv_watch_id_t    sdskv_next_watch_id = 1;
+static pthread_mutex_t     sdskv_watches_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+DECLARE_MARGO_RPC_HANDLER(sdskv_watch_notify_ult)
+
 static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
 {
     client->mid      = mid;
@@ -66,6 +109,8 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
                               &client->sdskv_list_databases_id, &flag);
         margo_registered_name(mid, "sdskv_put_rpc", &client->sdskv_put_id,
                               &flag);
+        margo_registered_name(mid, "sdskv_put_ttl_rpc",
+                              &client->sdskv_put_ttl_id, &flag);
         margo_registered_name(mid, "sdskv_put_multi_rpc",
                               &client->sdskv_put_multi_id, &flag);
         margo_registered_name(mid, "sdskv_put_packed_rpc",
@@ -82,6 +127,20 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
                               &flag);
         margo_registered_name(mid, "sdskv_erase_multi_rpc",
                               &client->sdskv_erase_multi_id, &flag);
+        margo_registered_name(mid, "sdskv_erase_range_rpc",
+                              &client->sdskv_erase_range_id, &flag);
+        margo_registered_name(mid, "sdskv_erase_prefixed_rpc",
+                              &client->sdskv_erase_prefixed_id, &flag);
+        margo_registered_name(mid, "sdskv_count_range_rpc",
+                              &client->sdskv_count_range_id, &flag);
+        margo_registered_name(mid, "sdskv_count_prefixed_rpc",
+                              &client->sdskv_count_prefixed_id, &flag);
+        margo_registered_name(mid, "sdskv_compare_and_swap_rpc",
+                              &client->sdskv_compare_and_swap_id, &flag);
+        margo_registered_name(mid, "sdskv_fetch_add_rpc",
+                              &client->sdskv_fetch_add_id, &flag);
+        margo_registered_name(mid, "sdskv_append_rpc", &client->sdskv_append_id,
+                              &flag);
         margo_registered_name(mid, "sdskv_exists_rpc", &client->sdskv_exists_id,
                               &flag);
         margo_registered_name(mid, "sdskv_exists_multi_rpc",
@@ -108,6 +167,28 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
                               &client->sdskv_migrate_all_keys_id, &flag);
         margo_registered_name(mid, "sdskv_migrate_database_rpc",
                               &client->sdskv_migrate_database_id, &flag);
+        margo_registered_name(mid, "sdskv_compact_rpc",
+                              &client->sdskv_compact_id, &flag);
+        margo_registered_name(mid, "sdskv_get_statistics_rpc",
+                              &client->sdskv_get_statistics_id, &flag);
+        margo_registered_name(mid, "sdskv_flush_trace_rpc",
+                              &client->sdskv_flush_trace_id, &flag);
+        margo_registered_name(mid, "sdskv_get_hot_keys_rpc",
+                              &client->sdskv_get_hot_keys_id, &flag);
+        margo_registered_name(mid, "sdskv_get_slow_ops_rpc",
+                              &client->sdskv_get_slow_ops_id, &flag);
+        margo_registered_name(mid, "sdskv_watch_rpc", &client->sdskv_watch_id,
+                              &flag);
+        margo_registered_name(mid, "sdskv_unwatch_rpc",
+                              &client->sdskv_unwatch_id, &flag);
+        margo_registered_name(mid, "sdskv_get_changes_rpc",
+                              &client->sdskv_get_changes_id, &flag);
+        margo_registered_name(mid, "sdskv_truncate_changes_rpc",
+                              &client->sdskv_truncate_changes_id, &flag);
+        margo_registered_name(mid, "sdskv_add_backup_rpc",
+                              &client->sdskv_add_backup_id, &flag);
+        margo_registered_name(mid, "sdskv_remove_backup_rpc",
+                              &client->sdskv_remove_backup_id, &flag);
 
     } else {
 
@@ -119,6 +200,8 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
             mid, "sdskv_list_databases_rpc", list_db_in_t, list_db_out_t, NULL);
         client->sdskv_put_id
             = MARGO_REGISTER(mid, "sdskv_put_rpc", put_in_t, put_out_t, NULL);
+        client->sdskv_put_ttl_id = MARGO_REGISTER(
+            mid, "sdskv_put_ttl_rpc", put_ttl_in_t, put_ttl_out_t, NULL);
         client->sdskv_put_multi_id = MARGO_REGISTER(
             mid, "sdskv_put_multi_rpc", put_multi_in_t, put_multi_out_t, NULL);
         client->sdskv_put_packed_id
@@ -138,6 +221,26 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
         client->sdskv_erase_multi_id
             = MARGO_REGISTER(mid, "sdskv_erase_multi_rpc", erase_multi_in_t,
                              erase_multi_out_t, NULL);
+        client->sdskv_erase_range_id
+            = MARGO_REGISTER(mid, "sdskv_erase_range_rpc", erase_range_in_t,
+                             erase_range_out_t, NULL);
+        client->sdskv_erase_prefixed_id = MARGO_REGISTER(
+            mid, "sdskv_erase_prefixed_rpc", erase_prefixed_in_t,
+            erase_prefixed_out_t, NULL);
+        client->sdskv_count_range_id
+            = MARGO_REGISTER(mid, "sdskv_count_range_rpc", count_range_in_t,
+                             count_range_out_t, NULL);
+        client->sdskv_count_prefixed_id = MARGO_REGISTER(
+            mid, "sdskv_count_prefixed_rpc", count_prefixed_in_t,
+            count_prefixed_out_t, NULL);
+        client->sdskv_compare_and_swap_id = MARGO_REGISTER(
+            mid, "sdskv_compare_and_swap_rpc", compare_and_swap_in_t,
+            compare_and_swap_out_t, NULL);
+        client->sdskv_fetch_add_id
+            = MARGO_REGISTER(mid, "sdskv_fetch_add_rpc", fetch_add_in_t,
+                             fetch_add_out_t, NULL);
+        client->sdskv_append_id = MARGO_REGISTER(
+            mid, "sdskv_append_rpc", append_in_t, append_out_t, NULL);
         client->sdskv_exists_id = MARGO_REGISTER(
             mid, "sdskv_exists_rpc", exists_in_t, exists_out_t, NULL);
         client->sdskv_exists_multi_id
@@ -173,7 +276,43 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
         client->sdskv_migrate_database_id = MARGO_REGISTER(
             mid, "sdskv_migrate_database_rpc", migrate_database_in_t,
             migrate_database_out_t, NULL);
-    }
+        client->sdskv_compact_id = MARGO_REGISTER(
+            mid, "sdskv_compact_rpc", compact_in_t, compact_out_t, NULL);
+        client->sdskv_get_statistics_id
+            = MARGO_REGISTER(mid, "sdskv_get_statistics_rpc", void,
+                             get_statistics_out_t, NULL);
+        client->sdskv_flush_trace_id
+            = MARGO_REGISTER(mid, "sdskv_flush_trace_rpc", flush_trace_in_t,
+                             flush_trace_out_t, NULL);
+        client->sdskv_get_hot_keys_id
+            = MARGO_REGISTER(mid, "sdskv_get_hot_keys_rpc", get_hot_keys_in_t,
+                             get_hot_keys_out_t, NULL);
+        client->sdskv_get_slow_ops_id
+            = MARGO_REGISTER(mid, "sdskv_get_slow_ops_rpc", get_slow_ops_in_t,
+                             get_slow_ops_out_t, NULL);
+        client->sdskv_watch_id = MARGO_REGISTER(mid, "sdskv_watch_rpc",
+                                                watch_in_t, watch_out_t, NULL);
+        client->sdskv_unwatch_id = MARGO_REGISTER(
+            mid, "sdskv_unwatch_rpc", unwatch_in_t, unwatch_out_t, NULL);
+        client->sdskv_get_changes_id
+            = MARGO_REGISTER(mid, "sdskv_get_changes_rpc", get_changes_in_t,
+                             get_changes_out_t, NULL);
+        client->sdskv_truncate_changes_id = MARGO_REGISTER(
+            mid, "sdskv_truncate_changes_rpc", truncate_changes_in_t,
+            truncate_changes_out_t, NULL);
+        client->sdskv_add_backup_id
+            = MARGO_REGISTER(mid, "sdskv_add_backup_rpc", add_backup_in_t,
+                             add_backup_out_t, NULL);
+        client->sdskv_remove_backup_id = MARGO_REGISTER(
+            mid, "sdskv_remove_backup_rpc", remove_backup_in_t,
+            remove_backup_out_t, NULL);
+    }
+
+    /* the providers send the changes of the watches with this RPC */
+    margo_registered_name(mid, "sdskv_watch_notify_rpc", &id, &flag);
+    if (flag == HG_FALSE)
+        MARGO_REGISTER(mid, "sdskv_watch_notify_rpc", watch_notify_in_t,
+                       watch_notify_out_t, sdskv_watch_notify_ult);
 
     return SDSKV_SUCCESS;
 }
@@ -254,6 +393,14 @@ int sdskv_provider_handle_get_info(sdskv_provider_handle_t ph,
     return SDSKV_SUCCESS;
 }
 
+int sdskv_provider_handle_set_request_id(sdskv_provider_handle_t handle,
+                                         uint64_t                request_id)
+{
+    if (handle == SDSKV_PROVIDER_HANDLE_NULL) return SDSKV_ERR_INVALID_ARG;
+    handle->request_id = request_id;
+    return SDSKV_SUCCESS;
+}
+
 int sdskv_provider_handle_ref_incr(sdskv_provider_handle_t handle)
 {
     if (handle == SDSKV_PROVIDER_HANDLE_NULL) return SDSKV_ERR_INVALID_ARG;
@@ -410,6 +557,7 @@ int sdskv_put(sdskv_provider_handle_t provider,
         put_out_t out;
 
         in.db_id      = db_id;
+        in.req_id     = provider->request_id;
         in.key.data   = (kv_ptr_t)key;
         in.key.size   = ksize;
         in.value.data = (kv_ptr_t)value;
@@ -448,9 +596,12 @@ int sdskv_put(sdskv_provider_handle_t provider,
         bulk_put_out_t out;
 
         in.db_id    = db_id;
+        in.req_id   = provider->request_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize    = vsize;
+        in.offset   = 0;
+        in.partial  = 0;
 
         hret = margo_bulk_create(provider->client->mid, 1, (void**)(&value),
                                  &in.vsize, HG_BULK_READ_ONLY, &in.handle);
@@ -495,6 +646,62 @@ int sdskv_put(sdskv_provider_handle_t provider,
     return ret;
 }
 
+int sdskv_put_ttl(sdskv_provider_handle_t provider,
+                  sdskv_database_id_t     db_id,
+                  const void*             key,
+                  hg_size_t               ksize,
+                  const void*             value,
+                  hg_size_t               vsize,
+                  uint64_t                ttl_ms)
+{
+    hg_return_t   hret;
+    int           ret;
+    hg_handle_t   handle;
+    put_ttl_in_t  in;
+    put_ttl_out_t out;
+
+    /* the value is sent within the RPC */
+    hg_size_t msize = ksize + vsize + 2 * sizeof(hg_size_t) + sizeof(uint64_t);
+    if (msize > MAX_RPC_MESSAGE_SIZE) return SDSKV_ERR_INVALID_ARG;
+
+    in.db_id      = db_id;
+    in.req_id     = provider->request_id;
+    in.key.data   = (kv_ptr_t)key;
+    in.key.size   = ksize;
+    in.value.data = (kv_ptr_t)value;
+    in.value.size = vsize;
+    in.ttl_ms     = ttl_ms;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_put_ttl_id, &handle);
+    if (hret != HG_SUCCESS) {
+        fprintf(stderr, "[SDSKV] margo_create() failed in sdskv_put_ttl()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        fprintf(stderr, "[SDSKV] margo_forward() failed in sdskv_put_ttl()\n");
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        fprintf(stderr,
+                "[SDSKV] margo_get_output() failed in sdskv_put_ttl()\n");
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
 int sdskv_put_multi(sdskv_provider_handle_t provider,
                     sdskv_database_id_t     db_id,
                     size_t                  num,
@@ -514,6 +721,7 @@ int sdskv_put_multi(sdskv_provider_handle_t provider,
     hg_size_t*      val_seg_sizes = NULL;
 
     in.db_id            = db_id;
+    in.req_id           = provider->request_id;
     in.num_keys         = num;
     in.keys_bulk_handle = HG_BULK_NULL;
     in.keys_bulk_size   = 0;
@@ -627,54 +835,97 @@ finish:
     return ret;
 }
 
-int sdskv_put_packed(sdskv_provider_handle_t provider,
-                     sdskv_database_id_t     db_id,
-                     size_t                  num,
-                     const void*             packed_keys,
-                     const hg_size_t*        ksizes,
-                     const void*             packed_values,
-                     const hg_size_t*        vsizes)
+/* gathers the segments into a contiguous buffer and compresses it; *out is
+ * left NULL if the codec is not supported or the payload does not shrink */
+static int sdskv_compress_segments(sdskv_compression_t codec,
+                                   int                 num_seg,
+                                   void* const*        seg_ptrs,
+                                   const hg_size_t*    seg_sizes,
+                                   hg_size_t           size,
+                                   void**              out,
+                                   hg_size_t*          out_size)
 {
-    hg_return_t hret;
-    int         ret         = SDSKV_SUCCESS;
-    hg_bulk_t   bulk_handle = HG_BULK_NULL;
-
-    hg_size_t keys_buffer_size = 0;
-    hg_size_t vals_buffer_size = 0;
-    unsigned  i                = 0;
-    for (i = 0; i < num; i++) {
-        keys_buffer_size += ksizes[i];
-        vals_buffer_size += vsizes[i];
-    }
-    hg_size_t bulk_size
-        = keys_buffer_size + vals_buffer_size + 2 * num * sizeof(size_t);
-
-    hg_size_t seg_sizes[4] = {num * sizeof(size_t), num * sizeof(size_t),
-                              keys_buffer_size, vals_buffer_size};
-    void*     seg_ptrs[4]  = {(void*)ksizes, (void*)vsizes, (void*)packed_keys,
-                         (void*)packed_values};
-    int       num_seg      = vals_buffer_size == 0 ? 3 : 4;
+    *out      = NULL;
+    *out_size = 0;
+
+    hg_size_t bound = sdskv_compression_bound(codec, size);
+    if (bound == 0) return SDSKV_SUCCESS;
+
+    char* raw  = (char*)malloc(size);
+    char* cbuf = (char*)malloc(bound);
+    if (!raw || !cbuf) {
+        free(raw);
+        free(cbuf);
+        return SDSKV_ERR_ALLOCATION;
+    }
+    hg_size_t offset = 0;
+    int       i;
+    for (i = 0; i < num_seg; i++) {
+        memcpy(raw + offset, seg_ptrs[i], seg_sizes[i]);
+        offset += seg_sizes[i];
+    }
+
+    *out_size = sdskv_compress(codec, raw, size, cbuf, bound);
+    free(raw);
+    if (*out_size == 0)
+        free(cbuf);
+    else
+        *out = cbuf;
+    return SDSKV_SUCCESS;
+}
 
-    hret = margo_bulk_create(provider->client->mid, num_seg, seg_ptrs,
-                             seg_sizes, HG_BULK_READ_ONLY, &bulk_handle);
-    if (hret != HG_SUCCESS) {
-        fprintf(stderr,
-                "[SDSKV] margo_bulk_create() failed in sdskv_put_packed()\n");
-        return SDSKV_MAKE_HG_ERROR(hret);
+/* decompresses a payload that was pushed, compressed, at the beginning of
+ * the segments, and scatters the result back over them */
+static int sdskv_decompress_segments(sdskv_compression_t codec,
+                                     int                 num_seg,
+                                     void* const*        seg_ptrs,
+                                     const hg_size_t*    seg_sizes,
+                                     hg_size_t           csize,
+                                     hg_size_t           raw_size)
+{
+    hg_size_t capacity = 0;
+    int       i;
+    for (i = 0; i < num_seg; i++) capacity += seg_sizes[i];
+    if (csize > capacity || raw_size > capacity) return SDSKV_ERR_COMPRESSION;
+
+    char* cbuf = (char*)malloc(csize);
+    char* raw  = (char*)malloc(raw_size);
+    if (!cbuf || !raw) {
+        free(cbuf);
+        free(raw);
+        return SDSKV_ERR_ALLOCATION;
+    }
+    hg_size_t offset = 0;
+    for (i = 0; i < num_seg && offset < csize; i++) {
+        hg_size_t n = seg_sizes[i] < csize - offset ? seg_sizes[i]
+                                                     : csize - offset;
+        memcpy(cbuf + offset, seg_ptrs[i], n);
+        offset += n;
+    }
+
+    int ret = sdskv_decompress(codec, cbuf, csize, raw, raw_size);
+    if (ret == SDSKV_SUCCESS) {
+        offset = 0;
+        for (i = 0; i < num_seg && offset < raw_size; i++) {
+            hg_size_t n = seg_sizes[i] < raw_size - offset ? seg_sizes[i]
+                                                            : raw_size - offset;
+            memcpy(seg_ptrs[i], raw + offset, n);
+            offset += n;
+        }
     }
-
-    ret = sdskv_proxy_put_packed(provider, db_id, NULL, num, bulk_handle,
-                                 bulk_size);
-    margo_bulk_free(bulk_handle);
+    free(cbuf);
+    free(raw);
     return ret;
 }
 
-int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
-                           sdskv_database_id_t     db_id,
-                           const char*             origin_addr,
-                           size_t                  num,
-                           hg_bulk_t               packed_data,
-                           hg_size_t               bulk_data_size)
+static int sdskv_put_packed_forward(sdskv_provider_handle_t provider,
+                                    sdskv_database_id_t     db_id,
+                                    const char*             origin_addr,
+                                    size_t                  num,
+                                    hg_bulk_t               packed_data,
+                                    hg_size_t               bulk_data_size,
+                                    sdskv_compression_t     compression,
+                                    hg_size_t               raw_size)
 {
     hg_return_t hret;
     int         ret = SDSKV_SUCCESS;
@@ -684,10 +935,13 @@ int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
     put_packed_out_t out;
 
     in.db_id       = db_id;
+    in.req_id      = provider->request_id;
     in.num_keys    = num;
     in.origin_addr = (char*)origin_addr;
     in.bulk_handle = packed_data;
     in.bulk_size   = bulk_data_size;
+    in.compression = compression;
+    in.raw_size    = raw_size;
 
     /* create handle */
     hret = margo_create(provider->client->mid, provider->addr,
@@ -724,6 +978,107 @@ int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
     return ret;
 }
 
+int sdskv_put_packed(sdskv_provider_handle_t provider,
+                     sdskv_database_id_t     db_id,
+                     size_t                  num,
+                     const void*             packed_keys,
+                     const hg_size_t*        ksizes,
+                     const void*             packed_values,
+                     const hg_size_t*        vsizes)
+{
+    return sdskv_put_packed_compressed(provider, db_id, num, packed_keys,
+                                       ksizes, packed_values, vsizes,
+                                       SDSKV_COMPRESSION_NONE);
+}
+
+int sdskv_put_packed_compressed(sdskv_provider_handle_t provider,
+                                sdskv_database_id_t     db_id,
+                                size_t                  num,
+                                const void*             packed_keys,
+                                const hg_size_t*        ksizes,
+                                const void*             packed_values,
+                                const hg_size_t*        vsizes,
+                                sdskv_compression_t     compression)
+{
+    hg_return_t hret;
+    int         ret         = SDSKV_SUCCESS;
+    hg_bulk_t   bulk_handle = HG_BULK_NULL;
+
+    hg_size_t keys_buffer_size = 0;
+    hg_size_t vals_buffer_size = 0;
+    unsigned  i                = 0;
+    for (i = 0; i < num; i++) {
+        keys_buffer_size += ksizes[i];
+        vals_buffer_size += vsizes[i];
+    }
+    hg_size_t bulk_size
+        = keys_buffer_size + vals_buffer_size + 2 * num * sizeof(size_t);
+
+    hg_size_t seg_sizes[4] = {num * sizeof(size_t), num * sizeof(size_t),
+                              keys_buffer_size, vals_buffer_size};
+    void*     seg_ptrs[4]  = {(void*)ksizes, (void*)vsizes, (void*)packed_keys,
+                         (void*)packed_values};
+    int       num_seg      = vals_buffer_size == 0 ? 3 : 4;
+
+    if (compression != SDSKV_COMPRESSION_NONE
+        && bulk_size >= SDSKV_COMPRESSION_MIN_SIZE
+        && sdskv_compression_supported(compression)
+        && !(provider->unsupported_codecs & (1u << compression))) {
+        void*     cbuf  = NULL;
+        hg_size_t csize = 0;
+        ret = sdskv_compress_segments(compression, num_seg, seg_ptrs,
+                                      seg_sizes, bulk_size, &cbuf, &csize);
+        if (ret != SDSKV_SUCCESS) return ret;
+        if (cbuf) {
+            hret = margo_bulk_create(provider->client->mid, 1, &cbuf, &csize,
+                                     HG_BULK_READ_ONLY, &bulk_handle);
+            if (hret != HG_SUCCESS) {
+                fprintf(stderr,
+                        "[SDSKV] margo_bulk_create() failed in "
+                        "sdskv_put_packed_compressed()\n");
+                free(cbuf);
+                return SDSKV_MAKE_HG_ERROR(hret);
+            }
+            ret = sdskv_put_packed_forward(provider, db_id, NULL, num,
+                                           bulk_handle, csize, compression,
+                                           bulk_size);
+            margo_bulk_free(bulk_handle);
+            free(cbuf);
+            if (ret != SDSKV_ERR_COMPRESSION) return ret;
+            /* the provider was built without this codec, don't try it again
+             * and send the payload as it is */
+            provider->unsupported_codecs |= 1u << compression;
+            bulk_handle = HG_BULK_NULL;
+        }
+        /* incompressible payloads are sent as they are */
+    }
+
+    hret = margo_bulk_create(provider->client->mid, num_seg, seg_ptrs,
+                             seg_sizes, HG_BULK_READ_ONLY, &bulk_handle);
+    if (hret != HG_SUCCESS) {
+        fprintf(stderr,
+                "[SDSKV] margo_bulk_create() failed in sdskv_put_packed()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = sdskv_put_packed_forward(provider, db_id, NULL, num, bulk_handle,
+                                   bulk_size, SDSKV_COMPRESSION_NONE, 0);
+    margo_bulk_free(bulk_handle);
+    return ret;
+}
+
+int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
+                           sdskv_database_id_t     db_id,
+                           const char*             origin_addr,
+                           size_t                  num,
+                           hg_bulk_t               packed_data,
+                           hg_size_t               bulk_data_size)
+{
+    return sdskv_put_packed_forward(provider, db_id, origin_addr, num,
+                                    packed_data, bulk_data_size,
+                                    SDSKV_COMPRESSION_NONE, 0);
+}
+
 int sdskv_get(sdskv_provider_handle_t provider,
               sdskv_database_id_t     db_id,
               const void*             key,
@@ -750,6 +1105,7 @@ int sdskv_get(sdskv_provider_handle_t provider,
         get_out_t out;
 
         in.db_id    = db_id;
+        in.req_id   = provider->request_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize    = size;
@@ -790,9 +1146,12 @@ int sdskv_get(sdskv_provider_handle_t provider,
         bulk_get_out_t out;
 
         in.db_id    = db_id;
+        in.req_id   = provider->request_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize    = size;
+        in.offset   = 0;
+        in.partial  = 0;
 
         hret = margo_bulk_create(provider->client->mid, 1, &value, &in.vsize,
                                  HG_BULK_WRITE_ONLY, &in.handle);
@@ -868,6 +1227,7 @@ int sdskv_get_multi(sdskv_provider_handle_t provider,
     }
 
     in.db_id            = db_id;
+    in.req_id           = provider->request_id;
     in.num_keys         = num;
     in.keys_bulk_handle = HG_BULK_NULL;
     in.keys_bulk_size   = 0;
@@ -978,6 +1338,7 @@ int sdskv_exists(sdskv_provider_handle_t provider,
     exists_out_t out;
 
     in.db_id    = db_id;
+    in.req_id   = provider->request_id;
     in.key.data = (kv_ptr_t)key;
     in.key.size = ksize;
 
@@ -1022,6 +1383,7 @@ int sdskv_exists_multi(sdskv_provider_handle_t provider,
     hg_size_t*         key_seg_sizes = NULL;
 
     in.db_id             = db_id;
+    in.req_id            = provider->request_id;
     in.num_keys          = num;
     in.keys_bulk_handle  = HG_BULK_NULL;
     in.keys_bulk_size    = 0;
@@ -1131,6 +1493,7 @@ int sdskv_length(sdskv_provider_handle_t provider,
     length_out_t out;
 
     in.db_id    = db_id;
+    in.req_id   = provider->request_id;
     in.key.data = (kv_ptr_t)key;
     in.key.size = ksize;
 
@@ -1175,6 +1538,7 @@ int sdskv_length_multi(sdskv_provider_handle_t provider,
     hg_size_t*         key_seg_sizes = NULL;
 
     in.db_id                 = db_id;
+    in.req_id                = provider->request_id;
     in.num_keys              = num;
     in.keys_bulk_handle      = HG_BULK_NULL;
     in.keys_bulk_size        = 0;
@@ -1272,6 +1636,7 @@ int sdskv_length_packed(sdskv_provider_handle_t provider,
     length_packed_out_t out;
 
     in.db_id           = db_id;
+    in.req_id          = provider->request_id;
     in.num_keys        = num;
     in.in_bulk_size    = 0;
     in.in_bulk_handle  = HG_BULK_NULL;
@@ -1358,6 +1723,21 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
                      hg_size_t               vbufsize,
                      void*                   packed_vals,
                      hg_size_t*              vsizes)
+{
+    return sdskv_get_packed_compressed(provider, db_id, num, packed_keys,
+                                       ksizes, vbufsize, packed_vals, vsizes,
+                                       SDSKV_COMPRESSION_NONE);
+}
+
+int sdskv_get_packed_compressed(sdskv_provider_handle_t provider,
+                                sdskv_database_id_t     db_id,
+                                size_t*                 num,
+                                const void*             packed_keys,
+                                const hg_size_t*        ksizes,
+                                hg_size_t               vbufsize,
+                                void*                   packed_vals,
+                                hg_size_t*              vsizes,
+                                sdskv_compression_t     compression)
 {
     hg_return_t hret;
     int         ret;
@@ -1367,11 +1747,13 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
     get_packed_out_t out;
 
     in.db_id            = db_id;
+    in.req_id           = provider->request_id;
     in.num_keys         = *num;
     in.keys_bulk_size   = 0;
     in.keys_bulk_handle = HG_BULK_NULL;
     in.vals_bulk_size   = 0;
     in.vals_bulk_handle = HG_BULK_NULL;
+    in.compression      = compression;
 
     hg_size_t total_ksize = 0;
     unsigned  i           = 0;
@@ -1445,6 +1827,14 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
     ret  = out.ret;
     *num = out.num_keys;
 
+    /* the provider may have compressed the value sizes and values */
+    if (out.compression != SDSKV_COMPRESSION_NONE) {
+        int dret = sdskv_decompress_segments(out.compression, 2, seg_ptrs,
+                                             seg_sizes, out.compressed_size,
+                                             out.raw_size);
+        if (dret != SDSKV_SUCCESS) ret = dret;
+    }
+
     margo_bulk_free(in.keys_bulk_handle);
     margo_bulk_free(in.vals_bulk_handle);
     margo_free_output(handle, &out);
@@ -1465,6 +1855,7 @@ int sdskv_erase(sdskv_provider_handle_t provider,
     erase_out_t out;
 
     in.db_id    = db_id;
+    in.req_id   = provider->request_id;
     in.key.data = (kv_ptr_t)key;
     in.key.size = ksize;
 
@@ -1507,6 +1898,7 @@ int sdskv_erase_multi(sdskv_provider_handle_t provider,
     hg_size_t*        key_seg_sizes = NULL;
 
     in.db_id            = db_id;
+    in.req_id           = provider->request_id;
     in.num_keys         = num;
     in.keys_bulk_handle = HG_BULK_NULL;
     in.keys_bulk_size   = 0;
@@ -1573,121 +1965,568 @@ finish:
     return ret;
 }
 
-int sdskv_list_keys(
-    sdskv_provider_handle_t provider,
-    sdskv_database_id_t     db_id, // db instance
-    const void* start_key,         // we want keys strictly after this start_key
-    hg_size_t   start_ksize,       // size of the start_key
-    void**      keys,              // pointer to an array of void* pointers,
-    //     this array has size *max_keys
-    hg_size_t* ksizes, // pointer to an array of hg_size_t sizes
-    //    representing sizes allocated in
-    //     keys for each key
-    hg_size_t* max_keys) // maximum number of keys requested
-{
-    return sdskv_list_keys_with_prefix(provider, db_id, start_key, start_ksize,
-                                       NULL, 0, keys, ksizes, max_keys);
-}
-
-int sdskv_list_keys_with_prefix(
-    sdskv_provider_handle_t provider,
-    sdskv_database_id_t     db_id, // db instance
-    const void* start_key,         // we want keys strictly after this start_key
-    hg_size_t   start_ksize,       // size of the start_key
-    const void* prefix,
-    hg_size_t   prefix_size,
-    void**      keys, // pointer to an array of void* pointers,
-    //     this array has size *max_keys
-    hg_size_t* ksizes, // pointer to an array of hg_size_t sizes
-    //    representing sizes allocated in
-    //     keys for each key
-    hg_size_t* max_keys) // maximum number of keys requested
+int sdskv_erase_range(sdskv_provider_handle_t provider,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lower_size,
+                      const void*             upper,
+                      hg_size_t               upper_size,
+                      hg_size_t*              num_erased)
 {
-    list_keys_in_t  in;
-    list_keys_out_t out;
-    hg_return_t     hret   = HG_SUCCESS;
-    hg_handle_t     handle = HG_HANDLE_NULL;
-    int             ret    = SDSKV_SUCCESS;
-    int             i;
-
-    if (*max_keys == 0) { return SDSKV_SUCCESS; }
-
-    in.db_id              = db_id;
-    in.start_key.data     = (kv_ptr_t)start_key;
-    in.start_key.size     = start_ksize;
-    in.prefix.data        = (char*)prefix;
-    in.prefix.size        = prefix_size;
-    in.keys_bulk_handle   = HG_BULK_NULL;
-    in.ksizes_bulk_handle = HG_BULK_NULL;
-    in.max_keys           = *max_keys;
-
-    /* create bulk handle to expose the segments with key sizes */
-    hg_size_t ksize_bulk_size = (*max_keys) * sizeof(*ksizes);
-    void*     buf_ptr[1]      = {ksizes};
-    hret
-        = margo_bulk_create(provider->client->mid, 1, buf_ptr, &ksize_bulk_size,
-                            HG_BULK_READWRITE, &in.ksizes_bulk_handle);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-
-    /* make sure none of the buffers is NULL or 0-sized */
-    int requesting_sizes = 0;
-    if (keys == NULL) {
-        requesting_sizes = 1;
-    } else {
-        for (i = 0; i < *max_keys; i++) {
-            if (keys[i] == NULL || ksizes[i] == 0) {
-                requesting_sizes = 1;
-                break;
-            }
-        }
-    }
+    hg_return_t       hret;
+    int               ret;
+    hg_handle_t       handle;
+    erase_range_in_t  in;
+    erase_range_out_t out;
 
-    /* create bulk handle to expose where the keys should be placed */
-    if (!requesting_sizes) {
-        hret = margo_bulk_create(provider->client->mid, *max_keys, keys, ksizes,
-                                 HG_BULK_WRITE_ONLY, &in.keys_bulk_handle);
-        if (hret != HG_SUCCESS) {
-            ret = SDSKV_MAKE_HG_ERROR(hret);
-            goto finish;
-        }
-    }
+    in.db_id      = db_id;
+    in.req_id     = provider->request_id;
+    in.lower.data = (kv_ptr_t)lower;
+    in.lower.size = lower ? lower_size : 0;
+    in.upper.data = (kv_ptr_t)upper;
+    in.upper.size = upper ? upper_size : 0;
 
     /* create handle */
     hret = margo_create(provider->client->mid, provider->addr,
-                        provider->client->sdskv_list_keys_id, &handle);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
+                        provider->client->sdskv_erase_range_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
 
-    /* forward to provider */
     hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    /* get the output from provider */
     hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    /* set return values */
-    *max_keys = out.nkeys;
-    ret       = out.ret;
+    ret = out.ret;
+    if (num_erased) *num_erased = out.num_erased;
 
-finish:
-    /* free everything we created */
-    margo_bulk_free(in.ksizes_bulk_handle);
-    margo_bulk_free(in.keys_bulk_handle);
     margo_free_output(handle, &out);
     margo_destroy(handle);
-
+    return ret;
+}
+
+int sdskv_erase_prefixed(sdskv_provider_handle_t provider,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               prefix_size,
+                         hg_size_t*              num_erased)
+{
+    hg_return_t          hret;
+    int                  ret;
+    hg_handle_t          handle;
+    erase_prefixed_in_t  in;
+    erase_prefixed_out_t out;
+
+    in.db_id       = db_id;
+    in.req_id      = provider->request_id;
+    in.prefix.data = (kv_ptr_t)prefix;
+    in.prefix.size = prefix ? prefix_size : 0;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_erase_prefixed_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (num_erased) *num_erased = out.num_erased;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_count_range(sdskv_provider_handle_t provider,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lower_size,
+                      const void*             upper,
+                      hg_size_t               upper_size,
+                      hg_size_t*              num_keys,
+                      hg_size_t*              key_bytes,
+                      hg_size_t*              value_bytes)
+{
+    hg_return_t       hret;
+    int               ret;
+    hg_handle_t       handle;
+    count_range_in_t  in;
+    count_range_out_t out;
+
+    in.db_id      = db_id;
+    in.req_id     = provider->request_id;
+    in.lower.data = (kv_ptr_t)lower;
+    in.lower.size = lower ? lower_size : 0;
+    in.upper.data = (kv_ptr_t)upper;
+    in.upper.size = upper ? upper_size : 0;
+    in.with_sizes = key_bytes || value_bytes;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_count_range_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (num_keys) *num_keys = out.num_keys;
+    if (key_bytes) *key_bytes = out.key_bytes;
+    if (value_bytes) *value_bytes = out.value_bytes;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_count_prefixed(sdskv_provider_handle_t provider,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               prefix_size,
+                         hg_size_t*              num_keys,
+                         hg_size_t*              key_bytes,
+                         hg_size_t*              value_bytes)
+{
+    hg_return_t          hret;
+    int                  ret;
+    hg_handle_t          handle;
+    count_prefixed_in_t  in;
+    count_prefixed_out_t out;
+
+    in.db_id       = db_id;
+    in.req_id      = provider->request_id;
+    in.prefix.data = (kv_ptr_t)prefix;
+    in.prefix.size = prefix ? prefix_size : 0;
+    in.with_sizes  = key_bytes || value_bytes;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_count_prefixed_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (num_keys) *num_keys = out.num_keys;
+    if (key_bytes) *key_bytes = out.key_bytes;
+    if (value_bytes) *value_bytes = out.value_bytes;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_compare_and_swap(sdskv_provider_handle_t provider,
+                           sdskv_database_id_t     db_id,
+                           const void*             key,
+                           hg_size_t               ksize,
+                           const void*             expected,
+                           hg_size_t               expected_size,
+                           const void*             value,
+                           hg_size_t               vsize,
+                           int*                    swapped)
+{
+    hg_return_t            hret;
+    int                    ret;
+    hg_handle_t            handle;
+    compare_and_swap_in_t  in;
+    compare_and_swap_out_t out;
+
+    in.db_id         = db_id;
+    in.req_id        = provider->request_id;
+    in.key.data      = (kv_ptr_t)key;
+    in.key.size      = ksize;
+    in.has_expected  = expected != NULL;
+    in.expected.data = (kv_ptr_t)expected;
+    in.expected.size = expected ? expected_size : 0;
+    in.value.data    = (kv_ptr_t)value;
+    in.value.size    = vsize;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_compare_and_swap_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (swapped) *swapped = out.swapped;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_fetch_add(sdskv_provider_handle_t provider,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    int64_t                 delta,
+                    int64_t*                previous)
+{
+    hg_return_t     hret;
+    int             ret;
+    hg_handle_t     handle;
+    fetch_add_in_t  in;
+    fetch_add_out_t out;
+
+    in.db_id    = db_id;
+    in.req_id   = provider->request_id;
+    in.key.data = (kv_ptr_t)key;
+    in.key.size = ksize;
+    in.delta    = delta;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_fetch_add_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (previous) *previous = out.previous;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_append(sdskv_provider_handle_t provider,
+                 sdskv_database_id_t     db_id,
+                 const void*             key,
+                 hg_size_t               ksize,
+                 const void*             data,
+                 hg_size_t               size,
+                 hg_size_t*              new_size)
+{
+    hg_return_t  hret;
+    int          ret;
+    hg_handle_t  handle;
+    append_in_t  in;
+    append_out_t out;
+
+    in.db_id    = db_id;
+    in.req_id   = provider->request_id;
+    in.key.data = (kv_ptr_t)key;
+    in.key.size = ksize;
+    in.data.data = (kv_ptr_t)data;
+    in.data.size = size;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_append_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (new_size) *new_size = out.new_size;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_get_range(sdskv_provider_handle_t provider,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    hg_size_t               offset,
+                    void*                   data,
+                    hg_size_t*              size)
+{
+    hg_return_t    hret;
+    int            ret;
+    hg_handle_t    handle;
+    bulk_get_in_t  in;
+    bulk_get_out_t out;
+
+    in.db_id    = db_id;
+    in.req_id   = provider->request_id;
+    in.key.data = (kv_ptr_t)key;
+    in.key.size = ksize;
+    in.vsize    = *size;
+    in.offset   = offset;
+    in.partial  = 1;
+    in.handle   = HG_BULK_NULL;
+
+    if (in.vsize > 0) {
+        hret = margo_bulk_create(provider->client->mid, 1, &data, &in.vsize,
+                                 HG_BULK_WRITE_ONLY, &in.handle);
+        if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_bulk_get_id, &handle);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (ret == SDSKV_SUCCESS) *size = out.vsize;
+
+    margo_free_output(handle, &out);
+    margo_bulk_free(in.handle);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_put_range(sdskv_provider_handle_t provider,
+                    sdskv_database_id_t     db_id,
+                    const void*             key,
+                    hg_size_t               ksize,
+                    hg_size_t               offset,
+                    const void*             data,
+                    hg_size_t               size)
+{
+    hg_return_t    hret;
+    int            ret;
+    hg_handle_t    handle;
+    bulk_put_in_t  in;
+    bulk_put_out_t out;
+
+    in.db_id    = db_id;
+    in.req_id   = provider->request_id;
+    in.key.data = (kv_ptr_t)key;
+    in.key.size = ksize;
+    in.vsize    = size;
+    in.offset   = offset;
+    in.partial  = 1;
+    in.handle   = HG_BULK_NULL;
+
+    if (size > 0) {
+        hret = margo_bulk_create(provider->client->mid, 1, (void**)(&data),
+                                 &in.vsize, HG_BULK_READ_ONLY, &in.handle);
+        if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_bulk_put_id, &handle);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_bulk_free(in.handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+
+    margo_free_output(handle, &out);
+    margo_bulk_free(in.handle);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_list_keys(
+    sdskv_provider_handle_t provider,
+    sdskv_database_id_t     db_id, // db instance
+    const void* start_key,         // we want keys strictly after this start_key
+    hg_size_t   start_ksize,       // size of the start_key
+    void**      keys,              // pointer to an array of void* pointers,
+    //     this array has size *max_keys
+    hg_size_t* ksizes, // pointer to an array of hg_size_t sizes
+    //    representing sizes allocated in
+    //     keys for each key
+    hg_size_t* max_keys) // maximum number of keys requested
+{
+    return sdskv_list_keys_with_prefix(provider, db_id, start_key, start_ksize,
+                                       NULL, 0, keys, ksizes, max_keys);
+}
+
+int sdskv_list_keys_with_prefix(
+    sdskv_provider_handle_t provider,
+    sdskv_database_id_t     db_id, // db instance
+    const void* start_key,         // we want keys strictly after this start_key
+    hg_size_t   start_ksize,       // size of the start_key
+    const void* prefix,
+    hg_size_t   prefix_size,
+    void**      keys, // pointer to an array of void* pointers,
+    //     this array has size *max_keys
+    hg_size_t* ksizes, // pointer to an array of hg_size_t sizes
+    //    representing sizes allocated in
+    //     keys for each key
+    hg_size_t* max_keys) // maximum number of keys requested
+{
+    list_keys_in_t  in;
+    list_keys_out_t out;
+    hg_return_t     hret   = HG_SUCCESS;
+    hg_handle_t     handle = HG_HANDLE_NULL;
+    int             ret    = SDSKV_SUCCESS;
+    int             i;
+
+    if (*max_keys == 0) { return SDSKV_SUCCESS; }
+
+    in.db_id              = db_id;
+    in.req_id             = provider->request_id;
+    in.start_key.data     = (kv_ptr_t)start_key;
+    in.start_key.size     = start_ksize;
+    in.prefix.data        = (char*)prefix;
+    in.prefix.size        = prefix_size;
+    in.keys_bulk_handle   = HG_BULK_NULL;
+    in.ksizes_bulk_handle = HG_BULK_NULL;
+    in.max_keys           = *max_keys;
+
+    /* create bulk handle to expose the segments with key sizes */
+    hg_size_t ksize_bulk_size = (*max_keys) * sizeof(*ksizes);
+    void*     buf_ptr[1]      = {ksizes};
+    hret
+        = margo_bulk_create(provider->client->mid, 1, buf_ptr, &ksize_bulk_size,
+                            HG_BULK_READWRITE, &in.ksizes_bulk_handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* make sure none of the buffers is NULL or 0-sized */
+    int requesting_sizes = 0;
+    if (keys == NULL) {
+        requesting_sizes = 1;
+    } else {
+        for (i = 0; i < *max_keys; i++) {
+            if (keys[i] == NULL || ksizes[i] == 0) {
+                requesting_sizes = 1;
+                break;
+            }
+        }
+    }
+
+    /* create bulk handle to expose where the keys should be placed */
+    if (!requesting_sizes) {
+        hret = margo_bulk_create(provider->client->mid, *max_keys, keys, ksizes,
+                                 HG_BULK_WRITE_ONLY, &in.keys_bulk_handle);
+        if (hret != HG_SUCCESS) {
+            ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
+    }
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_list_keys_id, &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* forward to provider */
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* set return values */
+    *max_keys = out.nkeys;
+    ret       = out.ret;
+
+finish:
+    /* free everything we created */
+    margo_bulk_free(in.ksizes_bulk_handle);
+    margo_bulk_free(in.keys_bulk_handle);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+
     return ret;
 }
 
@@ -1708,367 +2547,1057 @@ int sdskv_list_keyvals(
                                    //    values for each value
     hg_size_t* max_keys)           // maximum number of keys requested
 {
-    return sdskv_list_keyvals_with_prefix(provider, db_id, start_key,
-                                          start_ksize, NULL, 0, keys, ksizes,
-                                          values, vsizes, max_keys);
+    return sdskv_list_keyvals_with_prefix(provider, db_id, start_key,
+                                          start_ksize, NULL, 0, keys, ksizes,
+                                          values, vsizes, max_keys);
+}
+
+int sdskv_list_keyvals_with_prefix(
+    sdskv_provider_handle_t provider,
+    sdskv_database_id_t     db_id, // db instance
+    const void* start_key,         // we want keys strictly after this start_key
+    hg_size_t   start_ksize,       // size of the start_key
+    const void* prefix,            // prefix of returned keys
+    hg_size_t   prefix_size,       // size of prefix
+    void**      keys,              // pointer to an array of void* pointers,
+                                   //     this array has size *max_keys
+    hg_size_t* ksizes,             // pointer to an array of hg_size_t sizes
+                                   //    representing sizes allocated in
+                                   //     keys for each key
+    void** values,                 // pointer to an array of void* pointers,
+                                   //     this array has size *max_keys
+    hg_size_t* vsizes,             // pointer to an array of hg_size_t sizes
+                                   //    representing sizes allocated in
+                                   //    values for each value
+    hg_size_t* max_keys)           // maximum number of keys requested
+{
+    list_keyvals_in_t  in;
+    list_keyvals_out_t out;
+    hg_return_t        hret   = HG_SUCCESS;
+    hg_handle_t        handle = HG_HANDLE_NULL;
+    int                ret    = SDSKV_SUCCESS;
+    int                i;
+
+    in.db_id              = db_id;
+    in.req_id             = provider->request_id;
+    in.start_key.data     = (kv_ptr_t)start_key;
+    in.start_key.size     = start_ksize;
+    in.prefix.data        = (char*)prefix;
+    in.prefix.size        = prefix_size;
+    in.max_keys           = *max_keys;
+    in.keys_bulk_handle   = HG_BULK_NULL;
+    in.ksizes_bulk_handle = HG_BULK_NULL;
+    in.vals_bulk_handle   = HG_BULK_NULL;
+    in.vsizes_bulk_handle = HG_BULK_NULL;
+
+    /* create bulk handle to expose the segments with key sizes */
+    hg_size_t ksize_bulk_size   = (*max_keys) * sizeof(*ksizes);
+    void*     ksizes_buf_ptr[1] = {ksizes};
+    hret = margo_bulk_create(provider->client->mid, 1, ksizes_buf_ptr,
+                             &ksize_bulk_size, HG_BULK_READWRITE,
+                             &in.ksizes_bulk_handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* create bulk handle to expose the segments with value sizes */
+    hg_size_t vsize_bulk_size   = (*max_keys) * sizeof(*vsizes);
+    void*     vsizes_buf_ptr[1] = {vsizes};
+    hret = margo_bulk_create(provider->client->mid, 1, vsizes_buf_ptr,
+                             &ksize_bulk_size, HG_BULK_READWRITE,
+                             &in.vsizes_bulk_handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* create bulk handle to expose where the keys should be placed */
+    if (keys) {
+        hret = margo_bulk_create(provider->client->mid, *max_keys, keys, ksizes,
+                                 HG_BULK_WRITE_ONLY, &in.keys_bulk_handle);
+        if (hret != HG_SUCCESS) {
+            ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
+    }
+
+    /* create bulk handle to expose where the values should be placed */
+    if (values) {
+        hret = margo_bulk_create(provider->client->mid, *max_keys, values,
+                                 vsizes, HG_BULK_WRITE_ONLY,
+                                 &in.vals_bulk_handle);
+        if (hret != HG_SUCCESS) {
+            ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
+    }
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_list_keyvals_id, &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* forward to provider */
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* set return values */
+    *max_keys = out.nkeys;
+    ret       = out.ret;
+
+finish:
+    /* free everything we created */
+    margo_bulk_free(in.ksizes_bulk_handle);
+    margo_bulk_free(in.keys_bulk_handle);
+    margo_bulk_free(in.vsizes_bulk_handle);
+    margo_bulk_free(in.vals_bulk_handle);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+
+    return ret;
+}
+
+int sdskv_migrate_keys(sdskv_provider_handle_t source_provider,
+                       sdskv_database_id_t     source_db_id,
+                       const char*             target_addr,
+                       uint16_t                target_provider_id,
+                       sdskv_database_id_t     target_db_id,
+                       hg_size_t               num_keys,
+                       const void* const*      keys,
+                       const hg_size_t*        key_sizes,
+                       int                     flag)
+{
+    int                ret    = HG_SUCCESS;
+    hg_return_t        hret   = HG_SUCCESS;
+    hg_handle_t        handle = HG_HANDLE_NULL;
+    migrate_keys_in_t  in;
+    migrate_keys_out_t out;
+    in.source_db_id       = source_db_id;
+    in.target_addr        = (hg_string_t)target_addr;
+    in.target_provider_id = target_provider_id;
+    in.target_db_id       = target_db_id;
+    in.keys_bulk          = HG_BULK_NULL;
+    in.num_keys           = num_keys;
+    in.flag               = flag;
+    /* create bulk to expose key sizes and keys */
+    hg_size_t* seg_sizes = (hg_size_t*)calloc(num_keys + 1, sizeof(hg_size_t));
+    seg_sizes[0]         = num_keys * sizeof(hg_size_t);
+    memcpy(seg_sizes + 1, key_sizes, num_keys * sizeof(hg_size_t));
+    void** segs = (void**)calloc(num_keys + 1, sizeof(void*));
+    segs[0]     = (void*)key_sizes;
+    memcpy(segs + 1, keys, num_keys * sizeof(void*));
+    /* compute the total size of the array */
+    int i;
+    in.bulk_size = 0;
+    for (i = 0; i < num_keys + 1; i++) { in.bulk_size += seg_sizes[i]; }
+
+    hret = margo_bulk_create(source_provider->client->mid, num_keys + 1, segs,
+                             seg_sizes, HG_BULK_READ_ONLY, &in.keys_bulk);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* create handle */
+    hret = margo_create(source_provider->client->mid, source_provider->addr,
+                        source_provider->client->sdskv_migrate_key_range_id,
+                        &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* forward to provider */
+    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    ret = out.ret;
+
+finish:
+    free(seg_sizes);
+    free(segs);
+    margo_bulk_free(in.keys_bulk);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_migrate_key_range(sdskv_provider_handle_t source_provider,
+                            sdskv_database_id_t     source_db_id,
+                            const char*             target_addr,
+                            uint16_t                target_provider_id,
+                            sdskv_database_id_t     target_db_id,
+                            const void*             key_range[],
+                            const hg_size_t         key_range_sizes[],
+                            int                     flag)
+{
+    int                    ret    = HG_SUCCESS;
+    hg_return_t            hret   = HG_SUCCESS;
+    hg_handle_t            handle = HG_HANDLE_NULL;
+    migrate_key_range_in_t in;
+    migrate_keys_out_t     out;
+    in.source_db_id       = source_db_id;
+    in.target_addr        = (hg_string_t)target_addr;
+    in.target_provider_id = target_provider_id;
+    in.target_db_id       = target_db_id;
+    in.key_lb.size        = key_range_sizes[0];
+    in.key_lb.data        = (void*)key_range[0];
+    in.key_ub.size        = key_range_sizes[1];
+    in.key_ub.data        = (void*)key_range[1];
+    in.flag               = flag;
+    /* create handle */
+    hret = margo_create(source_provider->client->mid, source_provider->addr,
+                        source_provider->client->sdskv_migrate_key_range_id,
+                        &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* forward to provider */
+    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    ret = out.ret;
+finish:
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_migrate_keys_prefixed(sdskv_provider_handle_t source_provider,
+                                sdskv_database_id_t     source_db_id,
+                                const char*             target_addr,
+                                uint16_t                target_provider_id,
+                                sdskv_database_id_t     target_db_id,
+                                const void*             key_prefix,
+                                hg_size_t               key_prefix_size,
+                                int                     flag)
+{
+    int                        ret    = HG_SUCCESS;
+    hg_return_t                hret   = HG_SUCCESS;
+    hg_handle_t                handle = HG_HANDLE_NULL;
+    migrate_keys_prefixed_in_t in;
+    migrate_keys_out_t         out;
+    in.source_db_id       = source_db_id;
+    in.target_addr        = (hg_string_t)target_addr;
+    in.target_provider_id = target_provider_id;
+    in.target_db_id       = target_db_id;
+    in.key_prefix.size    = key_prefix_size;
+    in.key_prefix.data    = (void*)key_prefix;
+    in.flag               = flag;
+    /* create handle */
+    hret = margo_create(source_provider->client->mid, source_provider->addr,
+                        source_provider->client->sdskv_migrate_keys_prefixed_id,
+                        &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* forward to provider */
+    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    ret = out.ret;
+finish:
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_migrate_all_keys(sdskv_provider_handle_t source_provider,
+                           sdskv_database_id_t     source_db_id,
+                           const char*             target_addr,
+                           uint16_t                target_provider_id,
+                           sdskv_database_id_t     target_db_id,
+                           int                     flag)
+{
+    int                   ret    = HG_SUCCESS;
+    hg_return_t           hret   = HG_SUCCESS;
+    hg_handle_t           handle = HG_HANDLE_NULL;
+    migrate_all_keys_in_t in;
+    migrate_keys_out_t    out;
+    in.source_db_id       = source_db_id;
+    in.target_addr        = (hg_string_t)target_addr;
+    in.target_provider_id = target_provider_id;
+    in.target_db_id       = target_db_id;
+    in.flag               = flag;
+    /* create handle */
+    hret = margo_create(source_provider->client->mid, source_provider->addr,
+                        source_provider->client->sdskv_migrate_all_keys_id,
+                        &handle);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* forward to provider */
+    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+    ret = out.ret;
+finish:
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_migrate_database(sdskv_provider_handle_t source,
+                           sdskv_database_id_t     source_db_id,
+                           const char*             dest_addr,
+                           uint16_t                dest_provider_id,
+                           const char*             dest_root,
+                           int                     flag)
+{
+    hg_return_t            hret;
+    hg_handle_t            handle;
+    migrate_database_in_t  in;
+    migrate_database_out_t out;
+    int                    ret;
+
+    in.source_db_id          = source_db_id;
+    in.remove_src            = flag;
+    in.dest_remi_addr        = dest_addr;
+    in.dest_remi_provider_id = dest_provider_id;
+    in.dest_root             = dest_root;
+
+    hret = margo_create(source->client->mid, source->addr,
+                        source->client->sdskv_migrate_database_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(source->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret              = out.ret;
+    sdskv_remi_errno = out.remi_ret;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_compact(sdskv_provider_handle_t provider, sdskv_database_id_t db_id)
+{
+    return sdskv_compact_range(provider, db_id, NULL, 0, NULL, 0);
+}
+
+int sdskv_compact_range(sdskv_provider_handle_t provider,
+                        sdskv_database_id_t     db_id,
+                        const void*             lower,
+                        hg_size_t               lower_size,
+                        const void*             upper,
+                        hg_size_t               upper_size)
+{
+    hg_return_t   hret;
+    int           ret;
+    hg_handle_t   handle;
+    compact_in_t  in;
+    compact_out_t out;
+
+    in.db_id      = db_id;
+    in.lower.data = (kv_ptr_t)lower;
+    in.lower.size = lower ? lower_size : 0;
+    in.upper.data = (kv_ptr_t)upper;
+    in.upper.size = upper ? upper_size : 0;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_compact_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
 }
 
-int sdskv_list_keyvals_with_prefix(
-    sdskv_provider_handle_t provider,
-    sdskv_database_id_t     db_id, // db instance
-    const void* start_key,         // we want keys strictly after this start_key
-    hg_size_t   start_ksize,       // size of the start_key
-    const void* prefix,            // prefix of returned keys
-    hg_size_t   prefix_size,       // size of prefix
-    void**      keys,              // pointer to an array of void* pointers,
-                                   //     this array has size *max_keys
-    hg_size_t* ksizes,             // pointer to an array of hg_size_t sizes
-                                   //    representing sizes allocated in
-                                   //     keys for each key
-    void** values,                 // pointer to an array of void* pointers,
-                                   //     this array has size *max_keys
-    hg_size_t* vsizes,             // pointer to an array of hg_size_t sizes
-                                   //    representing sizes allocated in
-                                   //    values for each value
-    hg_size_t* max_keys)           // maximum number of keys requested
+int sdskv_get_statistics(sdskv_provider_handle_t provider, char** statistics)
 {
-    list_keyvals_in_t  in;
-    list_keyvals_out_t out;
-    hg_return_t        hret   = HG_SUCCESS;
-    hg_handle_t        handle = HG_HANDLE_NULL;
-    int                ret    = SDSKV_SUCCESS;
-    int                i;
+    hg_return_t          hret;
+    int                  ret;
+    hg_handle_t          handle;
+    get_statistics_out_t out;
 
-    in.db_id              = db_id;
-    in.start_key.data     = (kv_ptr_t)start_key;
-    in.start_key.size     = start_ksize;
-    in.prefix.data        = (char*)prefix;
-    in.prefix.size        = prefix_size;
-    in.max_keys           = *max_keys;
-    in.keys_bulk_handle   = HG_BULK_NULL;
-    in.ksizes_bulk_handle = HG_BULK_NULL;
-    in.vals_bulk_handle   = HG_BULK_NULL;
-    in.vsizes_bulk_handle = HG_BULK_NULL;
+    *statistics = NULL;
 
-    /* create bulk handle to expose the segments with key sizes */
-    hg_size_t ksize_bulk_size   = (*max_keys) * sizeof(*ksizes);
-    void*     ksizes_buf_ptr[1] = {ksizes};
-    hret = margo_bulk_create(provider->client->mid, 1, ksizes_buf_ptr,
-                             &ksize_bulk_size, HG_BULK_READWRITE,
-                             &in.ksizes_bulk_handle);
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_get_statistics_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, NULL);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    /* create bulk handle to expose the segments with value sizes */
-    hg_size_t vsize_bulk_size   = (*max_keys) * sizeof(*vsizes);
-    void*     vsizes_buf_ptr[1] = {vsizes};
-    hret = margo_bulk_create(provider->client->mid, 1, vsizes_buf_ptr,
-                             &ksize_bulk_size, HG_BULK_READWRITE,
-                             &in.vsizes_bulk_handle);
+    hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    /* create bulk handle to expose where the keys should be placed */
-    if (keys) {
-        hret = margo_bulk_create(provider->client->mid, *max_keys, keys, ksizes,
-                                 HG_BULK_WRITE_ONLY, &in.keys_bulk_handle);
-        if (hret != HG_SUCCESS) {
-            ret = SDSKV_MAKE_HG_ERROR(hret);
-            goto finish;
-        }
+    ret = out.ret;
+    if (ret == SDSKV_SUCCESS) {
+        *statistics = strdup(out.statistics ? out.statistics : "");
+        if (!*statistics) ret = SDSKV_ERR_ALLOCATION;
     }
 
-    /* create bulk handle to expose where the values should be placed */
-    if (values) {
-        hret = margo_bulk_create(provider->client->mid, *max_keys, values,
-                                 vsizes, HG_BULK_WRITE_ONLY,
-                                 &in.vals_bulk_handle);
-        if (hret != HG_SUCCESS) {
-            ret = SDSKV_MAKE_HG_ERROR(hret);
-            goto finish;
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_get_slow_ops(sdskv_provider_handle_t provider,
+                       char**                  slow_ops,
+                       int                     clear)
+{
+    hg_return_t        hret;
+    int                ret;
+    hg_handle_t        handle;
+    get_slow_ops_in_t  in;
+    get_slow_ops_out_t out;
+
+    in.clear  = clear;
+    *slow_ops = NULL;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_get_slow_ops_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if (ret == SDSKV_SUCCESS) {
+        *slow_ops = strdup(out.slow_ops ? out.slow_ops : "");
+        if (!*slow_ops) ret = SDSKV_ERR_ALLOCATION;
+    }
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_get_hot_keys(sdskv_provider_handle_t provider,
+                       sdskv_database_id_t     db_id,
+                       hg_size_t*              num_keys,
+                       void**                  keys,
+                       hg_size_t*              ksizes,
+                       uint64_t*               counts,
+                       int                     reset)
+{
+    hg_return_t        hret;
+    int                ret;
+    hg_handle_t        handle;
+    get_hot_keys_in_t  in;
+    get_hot_keys_out_t out;
+
+    in.db_id    = db_id;
+    in.max_keys = *num_keys;
+    in.reset    = reset;
+    *num_keys   = 0;
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_get_hot_keys_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    /* unpack the [count, key size, key] entries */
+    const char* entry = out.entries.data;
+    hg_size_t   i;
+    for (i = 0; ret == SDSKV_SUCCESS && i < out.num_keys && i < in.max_keys;
+         i++) {
+        memcpy(&counts[i], entry, sizeof(uint64_t));
+        entry += sizeof(uint64_t);
+        memcpy(&ksizes[i], entry, sizeof(hg_size_t));
+        entry += sizeof(hg_size_t);
+        keys[i] = malloc(ksizes[i] ? ksizes[i] : 1);
+        if (!keys[i]) {
+            ret = SDSKV_ERR_ALLOCATION;
+            break;
         }
+        memcpy(keys[i], entry, ksizes[i]);
+        entry += ksizes[i];
     }
+    if (ret == SDSKV_SUCCESS) *num_keys = i;
+    else
+        while (i > 0) free(keys[--i]);
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_flush_trace(sdskv_provider_handle_t provider, const char* filename)
+{
+    hg_return_t       hret;
+    int               ret;
+    hg_handle_t       handle;
+    flush_trace_in_t  in;
+    flush_trace_out_t out;
+
+    in.filename = (char*)(filename ? filename : "");
 
     /* create handle */
     hret = margo_create(provider->client->mid, provider->addr,
-                        provider->client->sdskv_list_keyvals_id, &handle);
+                        provider->client->sdskv_flush_trace_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+static int sdskv_watch(sdskv_provider_handle_t provider,
+                       sdskv_database_id_t     db_id,
+                       const void*             lower,
+                       hg_size_t               lsize,
+                       const void*             upper,
+                       hg_size_t               usize,
+                       int                     prefix,
+                       int                     with_values,
+                       sdskv_watch_fn          fn,
+                       void*                   uargs,
+                       sdskv_watch_id_t*       watch_id)
+{
+    hg_return_t          hret;
+    int                  ret;
+    hg_handle_t          handle;
+    watch_in_t           in;
+    watch_out_t          out;
+    struct sdskv_watch*  w;
+    struct sdskv_watch** p;
+
+    if (!fn) return SDSKV_ERR_INVALID_ARG;
+    w = (struct sdskv_watch*)calloc(1, sizeof(*w));
+    if (!w) return SDSKV_ERR_ALLOCATION;
+    w->fn    = fn;
+    w->uargs = uargs;
+
+    /* the watch is registered first, since changes may be sent before the
+     * response */
+    pthread_mutex_lock(&sdskv_watches_mutex);
+    w->id         = sdskv_next_watch_id++;
+    w->next       = sdskv_watches;
+    sdskv_watches = w;
+    pthread_mutex_unlock(&sdskv_watches_mutex);
+
+    in.db_id           = db_id;
+    in.lower.data      = (kv_ptr_t)lower;
+    in.lower.size      = lsize;
+    in.upper.data      = (kv_ptr_t)upper;
+    in.upper.size      = usize;
+    in.prefix          = prefix;
+    in.values          = with_values;
+    in.client_watch_id = w->id;
+
+    ret  = SDSKV_SUCCESS;
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_watch_id, &handle);
     if (hret != HG_SUCCESS) {
+        fprintf(stderr, "[SDSKV] margo_create() failed in sdskv_watch()\n");
         ret = SDSKV_MAKE_HG_ERROR(hret);
         goto finish;
     }
 
-    /* forward to provider */
     hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
+        fprintf(stderr, "[SDSKV] margo_forward() failed in sdskv_watch()\n");
+        margo_destroy(handle);
         ret = SDSKV_MAKE_HG_ERROR(hret);
         goto finish;
     }
 
-    /* get the output from provider */
     hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
+        fprintf(stderr, "[SDSKV] margo_get_output() failed in sdskv_watch()\n");
+        margo_destroy(handle);
         ret = SDSKV_MAKE_HG_ERROR(hret);
         goto finish;
     }
 
-    /* set return values */
-    *max_keys = out.nkeys;
-    ret       = out.ret;
+    ret = out.ret;
+    if (ret == SDSKV_SUCCESS) {
+        pthread_mutex_lock(&sdskv_watches_mutex);
+        w->server_id = out.watch_id;
+        pthread_mutex_unlock(&sdskv_watches_mutex);
+        *watch_id = w->id;
+    }
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
 
 finish:
-    /* free everything we created */
-    margo_bulk_free(in.ksizes_bulk_handle);
-    margo_bulk_free(in.keys_bulk_handle);
-    margo_bulk_free(in.vsizes_bulk_handle);
-    margo_bulk_free(in.vals_bulk_handle);
+    if (ret != SDSKV_SUCCESS) {
+        pthread_mutex_lock(&sdskv_watches_mutex);
+        for (p = &sdskv_watches; *p; p = &(*p)->next) {
+            if (*p == w) {
+                *p = w->next;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&sdskv_watches_mutex);
+        free(w);
+    }
+    return ret;
+}
+
+int sdskv_watch_range(sdskv_provider_handle_t provider,
+                      sdskv_database_id_t     db_id,
+                      const void*             lower,
+                      hg_size_t               lsize,
+                      const void*             upper,
+                      hg_size_t               usize,
+                      int                     with_values,
+                      sdskv_watch_fn          fn,
+                      void*                   uargs,
+                      sdskv_watch_id_t*       watch_id)
+{
+    return sdskv_watch(provider, db_id, lower, lsize, upper, usize, 0,
+                       with_values, fn, uargs, watch_id);
+}
+
+int sdskv_watch_prefixed(sdskv_provider_handle_t provider,
+                         sdskv_database_id_t     db_id,
+                         const void*             prefix,
+                         hg_size_t               psize,
+                         int                     with_values,
+                         sdskv_watch_fn          fn,
+                         void*                   uargs,
+                         sdskv_watch_id_t*       watch_id)
+{
+    return sdskv_watch(provider, db_id, prefix, psize, NULL, 0, 1,
+                       with_values, fn, uargs, watch_id);
+}
+
+int sdskv_unwatch(sdskv_provider_handle_t provider, sdskv_watch_id_t watch_id)
+{
+    hg_return_t          hret;
+    int                  ret;
+    hg_handle_t          handle;
+    unwatch_in_t         in;
+    unwatch_out_t        out;
+    struct sdskv_watch*  w = NULL;
+    struct sdskv_watch** p;
+
+    pthread_mutex_lock(&sdskv_watches_mutex);
+    for (p = &sdskv_watches; *p; p = &(*p)->next) {
+        if ((*p)->id == watch_id) {
+            w  = *p;
+            *p = w->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sdskv_watches_mutex);
+    if (!w) return SDSKV_ERR_UNKNOWN_WATCH;
+
+    in.watch_id = w->server_id;
+    free(w);
+
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_unwatch_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if (hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+
     margo_free_output(handle, &out);
     margo_destroy(handle);
-
     return ret;
 }
 
-int sdskv_migrate_keys(sdskv_provider_handle_t source_provider,
-                       sdskv_database_id_t     source_db_id,
-                       const char*             target_addr,
-                       uint16_t                target_provider_id,
-                       sdskv_database_id_t     target_db_id,
-                       hg_size_t               num_keys,
-                       const void* const*      keys,
-                       const hg_size_t*        key_sizes,
-                       int                     flag)
+/* decodes a batch of changes and passes it to the function of its watch;
+ * the provider sends the next batch once this one is acknowledged */
+static void sdskv_watch_notify_ult(hg_handle_t handle)
 {
-    int                ret    = HG_SUCCESS;
-    hg_return_t        hret   = HG_SUCCESS;
-    hg_handle_t        handle = HG_HANDLE_NULL;
-    migrate_keys_in_t  in;
-    migrate_keys_out_t out;
-    in.source_db_id       = source_db_id;
-    in.target_addr        = (hg_string_t)target_addr;
-    in.target_provider_id = target_provider_id;
-    in.target_db_id       = target_db_id;
-    in.keys_bulk          = HG_BULK_NULL;
-    in.num_keys           = num_keys;
-    in.flag               = flag;
-    /* create bulk to expose key sizes and keys */
-    hg_size_t* seg_sizes = (hg_size_t*)calloc(num_keys + 1, sizeof(hg_size_t));
-    seg_sizes[0]         = num_keys * sizeof(hg_size_t);
-    memcpy(seg_sizes + 1, key_sizes, num_keys * sizeof(hg_size_t));
-    void** segs = (void**)calloc(num_keys + 1, sizeof(void*));
-    segs[0]     = (void*)key_sizes;
-    memcpy(segs + 1, keys, num_keys * sizeof(void*));
-    /* compute the total size of the array */
-    int i;
-    in.bulk_size = 0;
-    for (i = 0; i < num_keys + 1; i++) { in.bulk_size += seg_sizes[i]; }
-
-    hret = margo_bulk_create(source_provider->client->mid, num_keys + 1, segs,
-                             seg_sizes, HG_BULK_READ_ONLY, &in.keys_bulk);
+    hg_return_t          hret;
+    watch_notify_in_t    in;
+    watch_notify_out_t   out;
+    sdskv_watch_fn       fn     = NULL;
+    void*                uargs  = NULL;
+    sdskv_watch_event_t* events = NULL;
+    struct sdskv_watch*  w;
+    const char*          entry;
+    const char*          end;
+    hg_size_t            i;
+
+    hret = margo_get_input(handle, &in);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
     }
 
-    /* create handle */
-    hret = margo_create(source_provider->client->mid, source_provider->addr,
-                        source_provider->client->sdskv_migrate_key_range_id,
-                        &handle);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
+    pthread_mutex_lock(&sdskv_watches_mutex);
+    for (w = sdskv_watches; w; w = w->next) {
+        if (w->id == in.watch_id) {
+            fn    = w->fn;
+            uargs = w->uargs;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sdskv_watches_mutex);
+
+    out.ret = SDSKV_SUCCESS;
+    if (!fn) {
+        /* the watch was cancelled, the provider will remove it */
+        out.ret = SDSKV_ERR_UNKNOWN_WATCH;
         goto finish;
     }
-    /* forward to provider */
-    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
+
+    events = (sdskv_watch_event_t*)calloc(in.num_events ? in.num_events : 1,
+                                          sizeof(*events));
+    if (!events) {
+        out.ret = SDSKV_ERR_ALLOCATION;
         goto finish;
     }
-    /* get the output from provider */
-    hret = margo_get_output(handle, &out);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
+    entry = in.events.data;
+    end   = in.events.data + in.events.size;
+    for (i = 0; i < in.num_events; i++) {
+        int has_value;
+        if ((size_t)(end - entry) < 2 + 2 * sizeof(hg_size_t)) break;
+        events[i].type = (sdskv_watch_event_type_t)entry[0];
+        has_value      = entry[1];
+        entry += 2;
+        memcpy(&events[i].ksize, entry, sizeof(hg_size_t));
+        entry += sizeof(hg_size_t);
+        memcpy(&events[i].vsize, entry, sizeof(hg_size_t));
+        entry += sizeof(hg_size_t);
+        if ((hg_size_t)(end - entry) < events[i].ksize
+            || (hg_size_t)(end - entry) - events[i].ksize < events[i].vsize)
+            break;
+        events[i].key = entry;
+        entry += events[i].ksize;
+        events[i].value = has_value ? entry : NULL;
+        entry += events[i].vsize;
+    }
+    if (i != in.num_events) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         goto finish;
     }
-    ret = out.ret;
+
+    fn(uargs, in.num_events, events, in.flags);
 
 finish:
-    free(seg_sizes);
-    free(segs);
-    margo_bulk_free(in.keys_bulk);
-    margo_free_output(handle, &out);
+    free(events);
+    margo_free_input(handle, &in);
+    margo_respond(handle, &out);
     margo_destroy(handle);
-    return ret;
 }
+DEFINE_MARGO_RPC_HANDLER(sdskv_watch_notify_ult)
 
-int sdskv_migrate_key_range(sdskv_provider_handle_t source_provider,
-                            sdskv_database_id_t     source_db_id,
-                            const char*             target_addr,
-                            uint16_t                target_provider_id,
-                            sdskv_database_id_t     target_db_id,
-                            const void*             key_range[],
-                            const hg_size_t         key_range_sizes[],
-                            int                     flag)
+int sdskv_get_changes(sdskv_provider_handle_t provider,
+                      sdskv_database_id_t     db_id,
+                      uint64_t                since,
+                      hg_size_t*              num_changes,
+                      sdskv_change_t*         changes,
+                      void*                   buffer,
+                      hg_size_t               bufsize,
+                      uint64_t*               last_seq)
 {
-    int                    ret    = HG_SUCCESS;
-    hg_return_t            hret   = HG_SUCCESS;
-    hg_handle_t            handle = HG_HANDLE_NULL;
-    migrate_key_range_in_t in;
-    migrate_keys_out_t     out;
-    in.source_db_id       = source_db_id;
-    in.target_addr        = (hg_string_t)target_addr;
-    in.target_provider_id = target_provider_id;
-    in.target_db_id       = target_db_id;
-    in.key_lb.size        = key_range_sizes[0];
-    in.key_lb.data        = (void*)key_range[0];
-    in.key_ub.size        = key_range_sizes[1];
-    in.key_ub.data        = (void*)key_range[1];
-    in.flag               = flag;
+    hg_return_t       hret;
+    int               ret;
+    hg_handle_t       handle;
+    get_changes_in_t  in;
+    get_changes_out_t out;
+    const char*       entry;
+    const char*       end;
+    hg_size_t         i;
+    /* sequence number, type, key size and value size of each change */
+    const hg_size_t header = sizeof(uint64_t) + 1 + 2 * sizeof(hg_size_t);
+
+    in.db_id       = db_id;
+    in.since       = since;
+    in.max_changes = *num_changes;
+    in.bulk_size   = bufsize;
+    *num_changes   = 0;
+
+    if (in.max_changes == 0 || bufsize == 0) return SDSKV_ERR_INVALID_ARG;
+
+    /* create bulk handle to receive the changes */
+    hret = margo_bulk_create(provider->client->mid, 1, &buffer, &in.bulk_size,
+                             HG_BULK_WRITE_ONLY, &in.bulk_handle);
+    if (hret != HG_SUCCESS) {
+        fprintf(stderr,
+                "[SDSKV] margo_bulk_create() failed in sdskv_get_changes()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
     /* create handle */
-    hret = margo_create(source_provider->client->mid, source_provider->addr,
-                        source_provider->client->sdskv_migrate_key_range_id,
-                        &handle);
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_get_changes_id, &handle);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_bulk_free(in.bulk_handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
-    /* forward to provider */
-    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_bulk_free(in.bulk_handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
-    /* get the output from provider */
+
     hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_bulk_free(in.bulk_handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+
     ret = out.ret;
-finish:
+    if (last_seq) *last_seq = out.last_seq;
+
+    /* the changes point into the buffer */
+    entry = (const char*)buffer;
+    end   = entry + out.size;
+    for (i = 0; ret == SDSKV_SUCCESS && i < out.num_changes; i++) {
+        sdskv_change_t* c = &changes[i];
+        if ((hg_size_t)(end - entry) < header) {
+            ret = SDSKV_ERR_SIZE;
+            break;
+        }
+        memcpy(&c->seq, entry, sizeof(uint64_t));
+        c->type = (sdskv_watch_event_type_t)entry[sizeof(uint64_t)];
+        memcpy(&c->ksize, entry + sizeof(uint64_t) + 1, sizeof(hg_size_t));
+        memcpy(&c->vsize, entry + sizeof(uint64_t) + 1 + sizeof(hg_size_t),
+               sizeof(hg_size_t));
+        entry += header;
+        if ((hg_size_t)(end - entry) < c->ksize + c->vsize) {
+            ret = SDSKV_ERR_SIZE;
+            break;
+        }
+        c->key   = entry;
+        c->value = c->vsize ? entry + c->ksize : NULL;
+        entry += c->ksize + c->vsize;
+        *num_changes += 1;
+    }
+
     margo_free_output(handle, &out);
+    margo_bulk_free(in.bulk_handle);
     margo_destroy(handle);
     return ret;
 }
 
-int sdskv_migrate_keys_prefixed(sdskv_provider_handle_t source_provider,
-                                sdskv_database_id_t     source_db_id,
-                                const char*             target_addr,
-                                uint16_t                target_provider_id,
-                                sdskv_database_id_t     target_db_id,
-                                const void*             key_prefix,
-                                hg_size_t               key_prefix_size,
-                                int                     flag)
+int sdskv_truncate_changes(sdskv_provider_handle_t provider,
+                           sdskv_database_id_t     db_id,
+                           uint64_t                upto)
 {
-    int                        ret    = HG_SUCCESS;
-    hg_return_t                hret   = HG_SUCCESS;
-    hg_handle_t                handle = HG_HANDLE_NULL;
-    migrate_keys_prefixed_in_t in;
-    migrate_keys_out_t         out;
-    in.source_db_id       = source_db_id;
-    in.target_addr        = (hg_string_t)target_addr;
-    in.target_provider_id = target_provider_id;
-    in.target_db_id       = target_db_id;
-    in.key_prefix.size    = key_prefix_size;
-    in.key_prefix.data    = (void*)key_prefix;
-    in.flag               = flag;
+    hg_return_t            hret;
+    int                    ret;
+    hg_handle_t            handle;
+    truncate_changes_in_t  in;
+    truncate_changes_out_t out;
+
+    in.db_id = db_id;
+    in.upto  = upto;
+
     /* create handle */
-    hret = margo_create(source_provider->client->mid, source_provider->addr,
-                        source_provider->client->sdskv_migrate_keys_prefixed_id,
-                        &handle);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-    /* forward to provider */
-    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_truncate_changes_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
-    /* get the output from provider */
+
     hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+
     ret = out.ret;
-finish:
+
     margo_free_output(handle, &out);
     margo_destroy(handle);
     return ret;
 }
 
-int sdskv_migrate_all_keys(sdskv_provider_handle_t source_provider,
-                           sdskv_database_id_t     source_db_id,
-                           const char*             target_addr,
-                           uint16_t                target_provider_id,
-                           sdskv_database_id_t     target_db_id,
-                           int                     flag)
+int sdskv_add_backup(sdskv_provider_handle_t provider,
+                     sdskv_database_id_t     db_id,
+                     const char*             backup_addr,
+                     uint16_t                backup_provider_id,
+                     sdskv_database_id_t     backup_db_id,
+                     int                     sync)
 {
-    int                   ret    = HG_SUCCESS;
-    hg_return_t           hret   = HG_SUCCESS;
-    hg_handle_t           handle = HG_HANDLE_NULL;
-    migrate_all_keys_in_t in;
-    migrate_keys_out_t    out;
-    in.source_db_id       = source_db_id;
-    in.target_addr        = (hg_string_t)target_addr;
-    in.target_provider_id = target_provider_id;
-    in.target_db_id       = target_db_id;
-    in.flag               = flag;
+    hg_return_t      hret;
+    int              ret;
+    hg_handle_t      handle;
+    add_backup_in_t  in;
+    add_backup_out_t out;
+
+    in.db_id              = db_id;
+    in.backup_addr        = backup_addr;
+    in.backup_provider_id = backup_provider_id;
+    in.backup_db_id       = backup_db_id;
+    in.sync               = sync;
+
     /* create handle */
-    hret = margo_create(source_provider->client->mid, source_provider->addr,
-                        source_provider->client->sdskv_migrate_all_keys_id,
-                        &handle);
-    if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-    /* forward to provider */
-    hret = margo_provider_forward(source_provider->provider_id, handle, &in);
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_add_backup_id, &handle);
+    if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
-    /* get the output from provider */
+
     hret = margo_get_output(handle, &out);
     if (hret != HG_SUCCESS) {
-        ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+
     ret = out.ret;
-finish:
+
     margo_free_output(handle, &out);
     margo_destroy(handle);
     return ret;
 }
 
-int sdskv_migrate_database(sdskv_provider_handle_t source,
-                           sdskv_database_id_t     source_db_id,
-                           const char*             dest_addr,
-                           uint16_t                dest_provider_id,
-                           const char*             dest_root,
-                           int                     flag)
+int sdskv_remove_backup(sdskv_provider_handle_t provider,
+                        sdskv_database_id_t     db_id,
+                        const char*             backup_addr,
+                        uint16_t                backup_provider_id,
+                        sdskv_database_id_t     backup_db_id)
 {
-    hg_return_t            hret;
-    hg_handle_t            handle;
-    migrate_database_in_t  in;
-    migrate_database_out_t out;
-    int                    ret;
+    hg_return_t         hret;
+    int                 ret;
+    hg_handle_t         handle;
+    remove_backup_in_t  in;
+    remove_backup_out_t out;
 
-    in.source_db_id          = source_db_id;
-    in.remove_src            = flag;
-    in.dest_remi_addr        = dest_addr;
-    in.dest_remi_provider_id = dest_provider_id;
-    in.dest_root             = dest_root;
+    in.db_id              = db_id;
+    in.backup_addr        = backup_addr;
+    in.backup_provider_id = backup_provider_id;
+    in.backup_db_id       = backup_db_id;
 
-    hret = margo_create(source->client->mid, source->addr,
-                        source->client->sdskv_migrate_database_id, &handle);
+    /* create handle */
+    hret = margo_create(provider->client->mid, provider->addr,
+                        provider->client->sdskv_remove_backup_id, &handle);
     if (hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
 
-    hret = margo_provider_forward(source->provider_id, handle, &in);
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
     if (hret != HG_SUCCESS) {
         margo_destroy(handle);
         return SDSKV_MAKE_HG_ERROR(hret);
@@ -2080,8 +3609,7 @@ int sdskv_migrate_database(sdskv_provider_handle_t source,
         return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    ret              = out.ret;
-    sdskv_remi_errno = out.remi_ret;
+    ret = out.ret;
 
     margo_free_output(handle, &out);
     margo_destroy(handle);
@@ -0,0 +1,111 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "kv-config.h"
+#include "sdskv-compression.h"
+#include <limits.h>
+#ifdef USE_LZ4
+    #include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+    #include <zstd.h>
+#endif
+
+/* level used by Zstd for wire payloads, favoring speed over ratio */
+#define SDSKV_ZSTD_WIRE_LEVEL 1
+
+int sdskv_compression_supported(sdskv_compression_t codec)
+{
+    switch (codec) {
+#ifdef USE_LZ4
+    case SDSKV_COMPRESSION_LZ4:
+        return 1;
+#endif
+#ifdef USE_ZSTD
+    case SDSKV_COMPRESSION_ZSTD:
+        return 1;
+#endif
+    default:
+        return 0;
+    }
+}
+
+hg_size_t sdskv_compression_bound(sdskv_compression_t codec, hg_size_t size)
+{
+    switch (codec) {
+#ifdef USE_LZ4
+    case SDSKV_COMPRESSION_LZ4:
+        if (size > LZ4_MAX_INPUT_SIZE) return 0;
+        return LZ4_compressBound((int)size);
+#endif
+#ifdef USE_ZSTD
+    case SDSKV_COMPRESSION_ZSTD:
+        return ZSTD_compressBound(size);
+#endif
+    default:
+        return 0;
+    }
+}
+
+hg_size_t sdskv_compress(sdskv_compression_t codec,
+                         const void*         src,
+                         hg_size_t           size,
+                         void*               dst,
+                         hg_size_t           dst_size)
+{
+    hg_size_t csize = 0;
+    switch (codec) {
+#ifdef USE_LZ4
+    case SDSKV_COMPRESSION_LZ4: {
+        if (size > LZ4_MAX_INPUT_SIZE) return 0;
+        int capacity = dst_size > INT_MAX ? INT_MAX : (int)dst_size;
+        int n = LZ4_compress_default((const char*)src, (char*)dst, (int)size,
+                                     capacity);
+        csize = n > 0 ? (hg_size_t)n : 0;
+        break;
+    }
+#endif
+#ifdef USE_ZSTD
+    case SDSKV_COMPRESSION_ZSTD: {
+        size_t n
+            = ZSTD_compress(dst, dst_size, src, size, SDSKV_ZSTD_WIRE_LEVEL);
+        csize = ZSTD_isError(n) ? 0 : n;
+        break;
+    }
+#endif
+    default:
+        return 0;
+    }
+    return csize < size ? csize : 0;
+}
+
+int sdskv_decompress(sdskv_compression_t codec,
+                     const void*         src,
+                     hg_size_t           csize,
+                     void*               dst,
+                     hg_size_t           size)
+{
+    switch (codec) {
+#ifdef USE_LZ4
+    case SDSKV_COMPRESSION_LZ4: {
+        if (size > LZ4_MAX_INPUT_SIZE || csize > LZ4_MAX_INPUT_SIZE)
+            return SDSKV_ERR_COMPRESSION;
+        int n = LZ4_decompress_safe((const char*)src, (char*)dst, (int)csize,
+                                    (int)size);
+        return n >= 0 && (hg_size_t)n == size ? SDSKV_SUCCESS
+                                              : SDSKV_ERR_COMPRESSION;
+    }
+#endif
+#ifdef USE_ZSTD
+    case SDSKV_COMPRESSION_ZSTD: {
+        size_t n = ZSTD_decompress(dst, size, src, csize);
+        return !ZSTD_isError(n) && n == size ? SDSKV_SUCCESS
+                                             : SDSKV_ERR_COMPRESSION;
+    }
+#endif
+    default:
+        return SDSKV_ERR_COMPRESSION;
+    }
+}
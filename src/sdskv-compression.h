@@ -0,0 +1,58 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_COMPRESSION_H
+#define SDSKV_COMPRESSION_H
+
+#include <stdint.h>
+#include <mercury.h>
+#include "sdskv-common.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Payloads smaller than this are never compressed on the wire. */
+#define SDSKV_COMPRESSION_MIN_SIZE 4096
+
+/**
+ * @brief Checks whether the codec was enabled when building SDSKV.
+ */
+int sdskv_compression_supported(sdskv_compression_t codec);
+
+/**
+ * @brief Returns the size of the buffer needed to compress size bytes
+ * with the given codec, or 0 if the codec is not supported.
+ */
+hg_size_t sdskv_compression_bound(sdskv_compression_t codec, hg_size_t size);
+
+/**
+ * @brief Compresses the size bytes of src into the dst_size bytes of dst.
+ * Returns the compressed size, or 0 if the codec is not supported or the
+ * compressed payload would not be smaller than the original one, in which
+ * case the payload should be sent as it is.
+ */
+hg_size_t sdskv_compress(sdskv_compression_t codec,
+                         const void*         src,
+                         hg_size_t           size,
+                         void*               dst,
+                         hg_size_t           dst_size);
+
+/**
+ * @brief Decompresses the csize bytes of src into the size bytes of dst.
+ * Returns SDSKV_SUCCESS, or SDSKV_ERR_COMPRESSION if the codec is not
+ * supported or the payload does not decompress to exactly size bytes.
+ */
+int sdskv_decompress(sdskv_compression_t codec,
+                     const void*         src,
+                     hg_size_t           csize,
+                     void*               dst,
+                     hg_size_t           size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
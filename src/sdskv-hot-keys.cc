@@ -0,0 +1,88 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-hot-keys.h"
+#include <algorithm>
+#include "bulk.h"
+
+HotKeyTracker::HotKeyTracker(const HotKeyConfig& config)
+    : _sample_rate(std::max<uint32_t>(config.sample_rate, 1)),
+      _width(std::max<uint32_t>(config.width, 1)),
+      _depth(std::max<uint32_t>(config.depth, 1)), _top_k(config.top_k),
+      _sketch(_width * _depth)
+{
+    for (auto& c : _sketch) c.store(0, std::memory_order_relaxed);
+    ABT_mutex_create(&_mutex);
+}
+
+HotKeyTracker::~HotKeyTracker() { ABT_mutex_free(&_mutex); }
+
+bool HotKeyTracker::sampled() const
+{
+    if (_sample_rate == 1) return true;
+    /* xorshift64, one generator per execution stream */
+    static thread_local uint64_t state
+        = 0x9e3779b97f4a7c15ULL ^ (uint64_t)(uintptr_t)&state;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state % _sample_rate == 0;
+}
+
+void HotKeyTracker::record_sampled(const void* key, size_t ksize)
+{
+    /* the rows' hash functions are derived from two halves of one hash */
+    uint64_t h  = ds_hash_key(key, ksize);
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+    uint64_t estimate = UINT64_MAX;
+    for (uint32_t row = 0; row < _depth; row++) {
+        uint32_t col   = (h1 + row * h2) % _width;
+        uint64_t count = _sketch[row * _width + col].fetch_add(
+                             1, std::memory_order_relaxed)
+                       + 1;
+        estimate = std::min(estimate, count);
+    }
+    if (_top_k == 0) return;
+
+    ABT_mutex_lock(_mutex);
+    auto min = _top.end();
+    for (auto it = _top.begin(); it != _top.end(); it++) {
+        if (it->first.size() == ksize
+            && std::equal(it->first.begin(), it->first.end(),
+                          (const char*)key)) {
+            it->second = std::max(it->second, estimate);
+            ABT_mutex_unlock(_mutex);
+            return;
+        }
+        if (min == _top.end() || it->second < min->second) min = it;
+    }
+    if (_top.size() < _top_k)
+        _top.emplace_back(std::string((const char*)key, ksize), estimate);
+    else if (estimate > min->second)
+        *min = std::make_pair(std::string((const char*)key, ksize), estimate);
+    ABT_mutex_unlock(_mutex);
+}
+
+std::vector<std::pair<std::string, uint64_t>>
+HotKeyTracker::top(size_t max_keys, bool reset)
+{
+    ABT_mutex_lock(_mutex);
+    auto result = _top;
+    if (reset) {
+        _top.clear();
+        for (auto& c : _sketch) c.store(0, std::memory_order_relaxed);
+    }
+    ABT_mutex_unlock(_mutex);
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<std::string, uint64_t>& a,
+                 const std::pair<std::string, uint64_t>& b) {
+                  return a.second > b.second;
+              });
+    if (result.size() > max_keys) result.resize(max_keys);
+    /* scale the sampled counts to estimates of the number of accesses */
+    for (auto& entry : result) entry.second *= _sample_rate;
+    return result;
+}
@@ -0,0 +1,58 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_HOT_KEYS_H
+#define SDSKV_HOT_KEYS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <margo.h>
+
+struct HotKeyConfig {
+    bool     enabled     = true;
+    uint32_t sample_rate = 16; // one access in sample_rate is recorded
+    uint32_t width       = 1024;
+    uint32_t depth       = 4;
+    uint32_t top_k       = 32;
+};
+
+// estimates how often the keys of a database are accessed, to find its hot
+// keys. A sample of the accesses is counted in a count-min sketch (depth
+// rows of width relaxed atomic counters, so its estimates can only be too
+// high), and the top_k keys with the highest estimates are kept aside.
+class HotKeyTracker {
+
+  public:
+    HotKeyTracker(const HotKeyConfig& config);
+    ~HotKeyTracker();
+
+    // records an access to a key, if it is part of the sample
+    void record(const void* key, size_t ksize)
+    {
+        if (sampled()) record_sampled(key, ksize);
+    }
+
+    // returns the max_keys hottest keys with their estimated number of
+    // accesses, hottest first, and optionally resets the tracker
+    std::vector<std::pair<std::string, uint64_t>> top(size_t max_keys,
+                                                      bool   reset);
+
+  private:
+    bool sampled() const;
+    void record_sampled(const void* key, size_t ksize);
+
+    uint32_t                                      _sample_rate;
+    uint32_t                                      _width;
+    uint32_t                                      _depth;
+    uint32_t                                      _top_k;
+    std::vector<std::atomic<uint32_t>>            _sketch;
+    std::vector<std::pair<std::string, uint64_t>> _top; // sampled counts
+    ABT_mutex                                     _mutex = ABT_MUTEX_NULL;
+};
+
+#endif
@@ -0,0 +1,450 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-replication.h"
+#include "sdskv-rpc-types.h"
+
+// encoded size of a change besides its key and value
+static constexpr size_t change_header_size = 1 + 2 * sizeof(hg_size_t);
+
+struct ReplicaChange {
+    uint64_t                 seq;
+    sdskv_watch_event_type_t type;
+    ds_bulk_t                key;
+    ds_bulk_t                value;
+};
+
+struct Backup {
+    std::string         addr_str;
+    margo_instance_id   mid;
+    hg_addr_t           addr = HG_ADDR_NULL;
+    uint16_t            provider_id;
+    sdskv_database_id_t db_id;
+    bool                sync;
+    // the following are protected by the mutex of the database's replicas
+    uint64_t acked     = 0; // last change acknowledged
+    uint64_t failed_at = 0; // last change reported when it failed
+    bool     failed    = false;
+    bool     closed    = false;
+
+    ~Backup()
+    {
+        if (addr != HG_ADDR_NULL) margo_addr_free(mid, addr);
+    }
+};
+
+struct SendArgs {
+    std::shared_ptr<DatabaseReplicas> replicas;
+    std::shared_ptr<Backup>           backup;
+};
+
+static void encode(std::vector<char>&       batch,
+                   sdskv_watch_event_type_t type,
+                   const ds_bulk_t&         key,
+                   const ds_bulk_t&         value)
+{
+    hg_size_t ksize = key.size();
+    hg_size_t vsize = value.size();
+    batch.push_back((char)type);
+    batch.insert(batch.end(), (const char*)&ksize,
+                 (const char*)&ksize + sizeof(ksize));
+    batch.insert(batch.end(), (const char*)&vsize,
+                 (const char*)&vsize + sizeof(vsize));
+    batch.insert(batch.end(), key.begin(), key.end());
+    batch.insert(batch.end(), value.begin(), value.end());
+}
+
+DatabaseReplicas::DatabaseReplicas(ReplicationHub& hub) : _hub(hub)
+{
+    ABT_mutex_create(&_mutex);
+    ABT_cond_create(&_changed);
+    ABT_cond_create(&_acked);
+}
+
+DatabaseReplicas::~DatabaseReplicas()
+{
+    ABT_cond_free(&_acked);
+    ABT_cond_free(&_changed);
+    ABT_mutex_free(&_mutex);
+}
+
+void DatabaseReplicas::changed(sdskv_watch_event_type_t type,
+                               const void*              key,
+                               hg_size_t                ksize,
+                               const void*              value,
+                               hg_size_t                vsize)
+{
+    ReplicaChange c;
+    c.type = type;
+    c.key.assign((const char*)key, (const char*)key + ksize);
+    if (type == SDSKV_WATCH_PUT)
+        c.value.assign((const char*)value, (const char*)value + vsize);
+    ABT_mutex_lock(_mutex);
+    c.seq = ++_last;
+    /* changes made while no backup receives them are not kept */
+    if (_count.load() > 0) {
+        _queue.push_back(std::move(c));
+        ABT_cond_broadcast(_changed);
+    }
+    ABT_mutex_unlock(_mutex);
+}
+
+int DatabaseReplicas::wait(uint64_t mark)
+{
+    uint64_t max_lag = _hub._config.max_lag;
+    int      ret     = SDSKV_SUCCESS;
+    ABT_mutex_lock(_mutex);
+    while (true) {
+        bool done = true;
+        for (auto& b : _backups) {
+            if (b->acked >= mark) continue;
+            if (b->failed) {
+                if (b->sync && mark <= b->failed_at)
+                    ret = SDSKV_ERR_REPLICATION;
+                continue;
+            }
+            if (b->sync || mark - b->acked > max_lag) done = false;
+        }
+        if (done) break;
+        if (_closed) {
+            ret = SDSKV_ERR_REPLICATION;
+            break;
+        }
+        ABT_cond_wait(_acked, _mutex);
+    }
+    ABT_mutex_unlock(_mutex);
+    return ret;
+}
+
+int DatabaseReplicas::add_backup(const std::shared_ptr<Backup>& b)
+{
+    ABT_mutex_lock(_mutex);
+    if (_closed) {
+        ABT_mutex_unlock(_mutex);
+        return SDSKV_ERR_UNKNOWN_DB;
+    }
+    /* a failed backup can be added again, and is then copied again */
+    for (auto it = _backups.begin(); it != _backups.end(); it++) {
+        const Backup& o = **it;
+        if (o.addr_str != b->addr_str || o.provider_id != b->provider_id
+            || o.db_id != b->db_id)
+            continue;
+        if (!o.failed) {
+            ABT_mutex_unlock(_mutex);
+            return SDSKV_ERR_INVALID_ARG;
+        }
+        _backups.erase(it);
+        break;
+    }
+    b->acked = _last;
+    _backups.push_back(b);
+    _count += 1;
+    _senders += 1;
+    ABT_mutex_unlock(_mutex);
+
+    /* the writes that started before the backup was added are not reported
+     * to it, but are done when the database is copied */
+    _db->barrier();
+    auto args = new SendArgs{shared_from_this(), b};
+    if (ABT_thread_create(_hub._pool, send_ult, args, ABT_THREAD_ATTR_NULL,
+                          NULL)
+        != ABT_SUCCESS) {
+        delete args;
+        ABT_mutex_lock(_mutex);
+        _backups.erase(std::find(_backups.begin(), _backups.end(), b));
+        _count -= 1;
+        _senders -= 1;
+        trim();
+        ABT_cond_broadcast(_acked);
+        ABT_mutex_unlock(_mutex);
+        return SDSKV_ERR_ALLOCATION;
+    }
+    return SDSKV_SUCCESS;
+}
+
+int DatabaseReplicas::remove_backup(const std::string&  addr,
+                                    uint16_t            provider_id,
+                                    sdskv_database_id_t db_id)
+{
+    ABT_mutex_lock(_mutex);
+    for (auto it = _backups.begin(); it != _backups.end(); it++) {
+        Backup& b = **it;
+        if (b.addr_str != addr || b.provider_id != provider_id
+            || b.db_id != db_id)
+            continue;
+        b.closed = true;
+        if (!b.failed) _count -= 1;
+        _backups.erase(it);
+        trim();
+        ABT_cond_broadcast(_changed);
+        ABT_cond_broadcast(_acked);
+        ABT_mutex_unlock(_mutex);
+        return SDSKV_SUCCESS;
+    }
+    ABT_mutex_unlock(_mutex);
+    return SDSKV_ERR_UNKNOWN_BACKUP;
+}
+
+void DatabaseReplicas::close()
+{
+    ABT_mutex_lock(_mutex);
+    _closed = true;
+    for (auto& b : _backups) b->closed = true;
+    _backups.clear();
+    _queue.clear();
+    _count = 0;
+    ABT_cond_broadcast(_changed);
+    ABT_cond_broadcast(_acked);
+    while (_senders > 0) ABT_cond_wait(_acked, _mutex);
+    ABT_mutex_unlock(_mutex);
+}
+
+/* must be called with the mutex locked */
+void DatabaseReplicas::trim()
+{
+    bool     any   = false;
+    uint64_t acked = _last;
+    for (auto& b : _backups) {
+        if (b->failed) continue;
+        any   = true;
+        acked = std::min(acked, b->acked);
+    }
+    if (!any) {
+        _queue.clear();
+        return;
+    }
+    while (!_queue.empty() && _queue.front().seq <= acked) _queue.pop_front();
+}
+
+/* must be called with the mutex locked */
+void DatabaseReplicas::fail(Backup& b, const char* what, int ret)
+{
+    if (b.closed) return;
+    margo_error(_hub._mid,
+                "replication to database %lu of provider %u at %s failed"
+                " while %s (ret = %d)",
+                b.db_id, b.provider_id, b.addr_str.c_str(), what, ret);
+    b.failed    = true;
+    b.failed_at = _last;
+    _count -= 1;
+    trim();
+    ABT_cond_broadcast(_acked);
+}
+
+void DatabaseReplicas::send_ult(void* a)
+{
+    auto args = static_cast<SendArgs*>(a);
+    args->replicas->send(args->backup);
+    delete args;
+}
+
+void DatabaseReplicas::send(const std::shared_ptr<Backup>& b)
+{
+    const ReplicationConfig& config = _hub._config;
+    std::vector<char>        batch;
+    bool                     copied = copy(b);
+    while (copied) {
+        ABT_mutex_lock(_mutex);
+        while (!b->closed && _last <= b->acked) ABT_cond_wait(_changed, _mutex);
+        if (b->closed) {
+            ABT_mutex_unlock(_mutex);
+            break;
+        }
+        /* the queue holds the changes following the last one acknowledged
+         * by all the backups */
+        auto      it    = _queue.begin() + (b->acked + 1 - _queue.front().seq);
+        uint64_t  upto  = b->acked;
+        hg_size_t count = 0;
+        batch.clear();
+        for (; it != _queue.end() && count < config.max_batch_changes; it++) {
+            size_t size
+                = change_header_size + it->key.size() + it->value.size();
+            if (count > 0 && batch.size() + size > config.max_batch_bytes)
+                break;
+            encode(batch, it->type, it->key, it->value);
+            upto = it->seq;
+            count += 1;
+        }
+        ABT_mutex_unlock(_mutex);
+
+        int ret = forward(*b, batch, count);
+
+        ABT_mutex_lock(_mutex);
+        if (ret != SDSKV_SUCCESS) {
+            fail(*b, "sending changes", ret);
+            ABT_mutex_unlock(_mutex);
+            break;
+        }
+        if (!b->closed) {
+            b->acked = upto;
+            trim();
+            ABT_cond_broadcast(_acked);
+        }
+        ABT_mutex_unlock(_mutex);
+    }
+    ABT_mutex_lock(_mutex);
+    _senders -= 1;
+    ABT_cond_broadcast(_acked);
+    ABT_mutex_unlock(_mutex);
+}
+
+/* sends the content of the database to a new backup as puts; the changes
+ * made meanwhile are queued and sent afterwards, so that the keys copied
+ * after being modified end up with their last value */
+bool DatabaseReplicas::copy(const std::shared_ptr<Backup>& b)
+{
+    const ReplicationConfig& config = _hub._config;
+    std::vector<char>        batch;
+    hg_size_t                count = 0;
+    ds_bulk_t                start;
+    int                      ret = SDSKV_SUCCESS;
+    while (ret == SDSKV_SUCCESS) {
+        ABT_mutex_lock(_mutex);
+        bool closed = b->closed;
+        ABT_mutex_unlock(_mutex);
+        if (closed) return false;
+        auto keyvals = _db->list_keyvals(start, config.max_batch_changes);
+        for (const auto& kv : keyvals) {
+            size_t size
+                = change_header_size + kv.first.size() + kv.second.size();
+            if (count > 0
+                && (count == config.max_batch_changes
+                    || batch.size() + size > config.max_batch_bytes)) {
+                ret = forward(*b, batch, count);
+                if (ret != SDSKV_SUCCESS) break;
+                batch.clear();
+                count = 0;
+            }
+            encode(batch, SDSKV_WATCH_PUT, kv.first, kv.second);
+            count += 1;
+        }
+        if (keyvals.size() < config.max_batch_changes) break;
+        start = keyvals.back().first;
+    }
+    if (ret == SDSKV_SUCCESS && count > 0) ret = forward(*b, batch, count);
+    if (ret != SDSKV_SUCCESS) {
+        ABT_mutex_lock(_mutex);
+        fail(*b, "copying the database", ret);
+        ABT_mutex_unlock(_mutex);
+        return false;
+    }
+    return true;
+}
+
+int DatabaseReplicas::forward(Backup&            b,
+                              std::vector<char>& batch,
+                              hg_size_t          count)
+{
+    replicate_in_t in;
+    in.db_id        = b.db_id;
+    in.num_changes  = count;
+    in.changes.size = batch.size();
+    in.changes.data = batch.data();
+    int         ret    = SDSKV_SUCCESS;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_return_t hret
+        = margo_create(_hub._mid, b.addr, _hub._replicate_id, &handle);
+    if (hret == HG_SUCCESS)
+        hret = margo_provider_forward_timed(b.provider_id, handle, &in,
+                                            _hub._config.timeout_ms);
+    if (hret == HG_SUCCESS) {
+        replicate_out_t out;
+        hret = margo_get_output(handle, &out);
+        if (hret == HG_SUCCESS) {
+            ret = out.ret;
+            margo_free_output(handle, &out);
+        }
+    }
+    if (handle != HG_HANDLE_NULL) margo_destroy(handle);
+    return hret == HG_SUCCESS ? ret : SDSKV_MAKE_HG_ERROR(hret);
+}
+
+ReplicationHub::ReplicationHub() { ABT_mutex_create(&_mutex); }
+
+ReplicationHub::~ReplicationHub() { ABT_mutex_free(&_mutex); }
+
+void ReplicationHub::configure(margo_instance_id        mid,
+                               ABT_pool                 pool,
+                               hg_id_t                  replicate_id,
+                               const ReplicationConfig& config)
+{
+    _mid          = mid;
+    _pool         = pool;
+    _replicate_id = replicate_id;
+    _config       = config;
+}
+
+void ReplicationHub::add_database(sdskv_database_id_t               db_id,
+                                  std::shared_ptr<DatabaseReplicas> replicas)
+{
+    ABT_mutex_lock(_mutex);
+    _databases[db_id] = std::move(replicas);
+    ABT_mutex_unlock(_mutex);
+}
+
+void ReplicationHub::remove_database(sdskv_database_id_t db_id)
+{
+    std::shared_ptr<DatabaseReplicas> replicas;
+    ABT_mutex_lock(_mutex);
+    auto it = _databases.find(db_id);
+    if (it != _databases.end()) {
+        replicas = std::move(it->second);
+        _databases.erase(it);
+    }
+    ABT_mutex_unlock(_mutex);
+    if (replicas) replicas->close();
+}
+
+void ReplicationHub::remove_all_databases()
+{
+    std::map<sdskv_database_id_t, std::shared_ptr<DatabaseReplicas>> databases;
+    ABT_mutex_lock(_mutex);
+    databases.swap(_databases);
+    ABT_mutex_unlock(_mutex);
+    for (auto& db : databases) db.second->close();
+}
+
+std::shared_ptr<DatabaseReplicas>
+ReplicationHub::find(sdskv_database_id_t db_id)
+{
+    std::shared_ptr<DatabaseReplicas> replicas;
+    ABT_mutex_lock(_mutex);
+    auto it = _databases.find(db_id);
+    if (it != _databases.end()) replicas = it->second;
+    ABT_mutex_unlock(_mutex);
+    return replicas;
+}
+
+int ReplicationHub::add_backup(sdskv_database_id_t db_id,
+                               const std::string&  addr,
+                               uint16_t            provider_id,
+                               sdskv_database_id_t backup_db_id,
+                               bool                sync)
+{
+    auto replicas = find(db_id);
+    if (!replicas) return SDSKV_ERR_UNKNOWN_DB;
+    auto b         = std::make_shared<Backup>();
+    b->addr_str    = addr;
+    b->mid         = _mid;
+    b->provider_id = provider_id;
+    b->db_id       = backup_db_id;
+    b->sync        = sync;
+    hg_return_t hret = margo_addr_lookup(_mid, addr.c_str(), &b->addr);
+    if (hret != HG_SUCCESS) {
+        b->addr = HG_ADDR_NULL;
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+    return replicas->add_backup(b);
+}
+
+int ReplicationHub::remove_backup(sdskv_database_id_t db_id,
+                                  const std::string&  addr,
+                                  uint16_t            provider_id,
+                                  sdskv_database_id_t backup_db_id)
+{
+    auto replicas = find(db_id);
+    if (!replicas) return SDSKV_ERR_UNKNOWN_DB;
+    return replicas->remove_backup(addr, provider_id, backup_db_id);
+}
@@ -0,0 +1,139 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_REPLICATION_H
+#define SDSKV_REPLICATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <margo.h>
+#include "sdskv-common.h"
+#include "datastore/watched_datastore.h"
+
+struct ReplicationConfig {
+    bool     enabled           = true;
+    uint32_t max_batch_changes = 256;      // changes per batch
+    size_t   max_batch_bytes   = 64 << 10; // encoded bytes per batch
+    uint64_t max_lag           = 1024;     // changes an async backup may lag
+    double   timeout_ms        = 10000.0;  // of each batch
+};
+
+class ReplicationHub;
+struct Backup;
+struct ReplicaChange;
+
+// backups of a database, to which its WatchedDataStore, which must be
+// ordered, reports changes. The changes are queued until all the backups
+// have acknowledged them.
+class DatabaseReplicas : public ChangeListener,
+                         public std::enable_shared_from_this<DatabaseReplicas> {
+
+  public:
+    DatabaseReplicas(ReplicationHub& hub);
+    ~DatabaseReplicas();
+
+    // sets the datastore whose content is copied to new backups
+    void set_database(WatchedDataStore* db) { _db = db; }
+
+    bool     active() const override { return _count.load() > 0; }
+    void     changed(sdskv_watch_event_type_t type,
+                     const void*              key,
+                     hg_size_t                ksize,
+                     const void*              value,
+                     hg_size_t                vsize) override;
+    uint64_t mark() override { return _last; }
+    int      wait(uint64_t mark) override;
+
+  private:
+    friend class ReplicationHub;
+
+    int  add_backup(const std::shared_ptr<Backup>& b);
+    int  remove_backup(const std::string&  addr,
+                       uint16_t            provider_id,
+                       sdskv_database_id_t db_id);
+    void close();
+    /* must be called with the mutex locked */
+    void trim();
+    void fail(Backup& b, const char* what, int ret);
+
+    static void send_ult(void* args);
+    void        send(const std::shared_ptr<Backup>& b);
+    bool        copy(const std::shared_ptr<Backup>& b);
+    int         forward(Backup&            b,
+                        std::vector<char>& batch,
+                        hg_size_t          count);
+
+    ReplicationHub&     _hub;
+    WatchedDataStore*   _db = nullptr;
+    std::atomic<size_t> _count{0}; // backups receiving changes
+    // the following are protected by the mutex
+    ABT_mutex                            _mutex   = ABT_MUTEX_NULL;
+    ABT_cond                             _changed = ABT_COND_NULL;
+    ABT_cond                             _acked   = ABT_COND_NULL;
+    uint64_t                             _last    = 0; // last change reported
+    std::deque<ReplicaChange>            _queue;
+    std::vector<std::shared_ptr<Backup>> _backups;
+    size_t                               _senders = 0; // running send ULTs
+    bool                                 _closed  = false;
+};
+
+// backups of the databases of a provider. Each backup is a database of
+// another provider, populated with a copy of the database when it is added,
+// then sent the changes of the database in batches, in order, by a ULT that
+// has at most one batch in flight; the changes made meanwhile are sent in
+// the next batch. The writes to a database wait for its sync backups to
+// acknowledge them, and for its async backups to lag by at most max_lag
+// changes. A backup failing to acknowledge a batch stops receiving changes,
+// and the writes waiting for it return SDSKV_ERR_REPLICATION.
+class ReplicationHub {
+
+  public:
+    ReplicationHub();
+    ~ReplicationHub();
+
+    // replicate_id is the id of the RPC sent to the backups, which is sent
+    // from ULTs created in pool
+    void configure(margo_instance_id        mid,
+                   ABT_pool                 pool,
+                   hg_id_t                  replicate_id,
+                   const ReplicationConfig& config);
+    bool enabled() const { return _config.enabled; }
+
+    void add_database(sdskv_database_id_t               db_id,
+                      std::shared_ptr<DatabaseReplicas> replicas);
+    // stops replicating the database and waits for the ULTs of its backups
+    void remove_database(sdskv_database_id_t db_id);
+    void remove_all_databases();
+
+    int add_backup(sdskv_database_id_t db_id,
+                   const std::string&  addr,
+                   uint16_t            provider_id,
+                   sdskv_database_id_t backup_db_id,
+                   bool                sync);
+    int remove_backup(sdskv_database_id_t db_id,
+                      const std::string&  addr,
+                      uint16_t            provider_id,
+                      sdskv_database_id_t backup_db_id);
+
+  private:
+    friend class DatabaseReplicas;
+
+    std::shared_ptr<DatabaseReplicas> find(sdskv_database_id_t db_id);
+
+    margo_instance_id _mid          = MARGO_INSTANCE_NULL;
+    ABT_pool          _pool         = ABT_POOL_NULL;
+    hg_id_t           _replicate_id = 0;
+    ReplicationConfig _config;
+    ABT_mutex         _mutex = ABT_MUTEX_NULL;
+    std::map<sdskv_database_id_t, std::shared_ptr<DatabaseReplicas>> _databases;
+};
+
+#endif
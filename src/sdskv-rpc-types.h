@@ -120,113 +120,196 @@ static hg_return_t hg_proc_list_db_out_t(hg_proc_t proc, void* arg)
     return HG_SUCCESS;
 }
 
+// req_id, in the inputs of data operations, is the request id set on the
+// client's provider handle; providers use it to tag traced requests
+
 // ------------- PUT ------------- //
 MERCURY_GEN_PROC(put_in_t,
-                 ((uint64_t)(db_id))((kv_data_t)(key))((kv_data_t)(value)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (kv_data_t)(value)))
 MERCURY_GEN_PROC(put_out_t, ((int32_t)(ret)))
 
+// ------------- PUT TTL ------------- //
+MERCURY_GEN_PROC(put_ttl_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (kv_data_t)(value))((uint64_t)(ttl_ms)))
+MERCURY_GEN_PROC(put_ttl_out_t, ((int32_t)(ret)))
+
 // ------------- GET ------------- //
 MERCURY_GEN_PROC(get_in_t,
-                 ((uint64_t)(db_id))((kv_data_t)(key))((hg_size_t)(vsize)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (hg_size_t)(vsize)))
 
 MERCURY_GEN_PROC(get_out_t,
                  ((int32_t)(ret))((kv_data_t)(value))((hg_size_t)(vsize)))
 
 // ------------- LENGTH ------------- //
-MERCURY_GEN_PROC(length_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(length_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key)))
 MERCURY_GEN_PROC(length_out_t, ((hg_size_t)(size))((int32_t)(ret)))
 
 // ------------- EXISTS ------------- //
-MERCURY_GEN_PROC(exists_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(exists_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key)))
 MERCURY_GEN_PROC(exists_out_t, ((int32_t)(flag))((int32_t)(ret)))
 
 // ------------- ERASE ------------- //
 MERCURY_GEN_PROC(erase_out_t, ((int32_t)(ret)))
-MERCURY_GEN_PROC(erase_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(erase_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key)))
 
 // ------------- LIST KEYS ------------- //
 MERCURY_GEN_PROC(list_keys_in_t,
-                 ((uint64_t)(db_id))((kv_data_t)(start_key))(
-                     (kv_data_t)(prefix))((hg_size_t)(max_keys))((hg_bulk_t)(
-                     ksizes_bulk_handle))((hg_bulk_t)(keys_bulk_handle)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))(
+                     (kv_data_t)(start_key))((kv_data_t)(prefix))(
+                     (hg_size_t)(max_keys))((hg_bulk_t)(ksizes_bulk_handle))(
+                     (hg_bulk_t)(keys_bulk_handle)))
 MERCURY_GEN_PROC(list_keys_out_t, ((hg_size_t)(nkeys))((int32_t)(ret)))
 
 // ------------- LIST KEYVALS ------------- //
-MERCURY_GEN_PROC(
-    list_keyvals_in_t,
-    ((uint64_t)(db_id))((kv_data_t)(start_key))((kv_data_t)(prefix))(
-        (hg_size_t)(max_keys))((hg_bulk_t)(ksizes_bulk_handle))(
-        (hg_bulk_t)(keys_bulk_handle))((hg_bulk_t)(vsizes_bulk_handle))(
-        (hg_bulk_t)(vals_bulk_handle)))
+MERCURY_GEN_PROC(list_keyvals_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))(
+                     (kv_data_t)(start_key))((kv_data_t)(prefix))(
+                     (hg_size_t)(max_keys))((hg_bulk_t)(ksizes_bulk_handle))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_bulk_t)(vsizes_bulk_handle))(
+                     (hg_bulk_t)(vals_bulk_handle)))
 MERCURY_GEN_PROC(list_keyvals_out_t, ((hg_size_t)(nkeys))((int32_t)(ret)))
 
 // ------------- BULK PUT ------------- //
 MERCURY_GEN_PROC(bulk_put_in_t,
-                 ((uint64_t)(db_id))((kv_data_t)(key))((hg_size_t)(vsize))(
-                     (hg_bulk_t)(handle)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (hg_size_t)(vsize))((hg_bulk_t)(handle))(
+                     (hg_size_t)(offset))((int32_t)(partial)))
 MERCURY_GEN_PROC(bulk_put_out_t, ((int32_t)(ret)))
 
 // ------------- BULK GET ------------- //
 MERCURY_GEN_PROC(bulk_get_in_t,
-                 ((uint64_t)(db_id))((kv_data_t)(key))((hg_size_t)(vsize))(
-                     (hg_bulk_t)(handle)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (hg_size_t)(vsize))((hg_bulk_t)(handle))(
+                     (hg_size_t)(offset))((int32_t)(partial)))
 MERCURY_GEN_PROC(bulk_get_out_t, ((hg_size_t)(vsize))((int32_t)(ret)))
 
 // ------------- PUT MULTI ------------- //
 MERCURY_GEN_PROC(put_multi_in_t,
-                 ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_bulk_t)(
-                     keys_bulk_handle))((hg_size_t)(keys_bulk_size))((
-                     hg_bulk_t)(vals_bulk_handle))((hg_size_t)(vals_bulk_size)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(keys_bulk_size))(
+                     (hg_bulk_t)(vals_bulk_handle))(
+                     (hg_size_t)(vals_bulk_size)))
 MERCURY_GEN_PROC(put_multi_out_t, ((int32_t)(ret)))
 
 // ------------- PUT PACKED ------------- //
-MERCURY_GEN_PROC(
-    put_packed_in_t,
-    ((uint64_t)(db_id))((hg_string_t)(origin_addr))((hg_size_t)(num_keys))(
-        (hg_size_t)(bulk_size))((hg_bulk_t)(bulk_handle)))
+// when compression is not SDSKV_COMPRESSION_NONE, the bulk_size bytes of
+// the bulk handle decompress into the raw_size bytes of the packed layout
+MERCURY_GEN_PROC(put_packed_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))(
+                     (hg_string_t)(origin_addr))((hg_size_t)(num_keys))(
+                     (hg_size_t)(bulk_size))((hg_bulk_t)(bulk_handle))(
+                     (int32_t)(compression))((hg_size_t)(raw_size)))
 MERCURY_GEN_PROC(put_packed_out_t, ((int32_t)(ret)))
 
 // ------------- GET MULTI ------------- //
 MERCURY_GEN_PROC(get_multi_in_t,
-                 ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_bulk_t)(
-                     keys_bulk_handle))((hg_size_t)(keys_bulk_size))((
-                     hg_bulk_t)(vals_bulk_handle))((hg_size_t)(vals_bulk_size)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(keys_bulk_size))(
+                     (hg_bulk_t)(vals_bulk_handle))(
+                     (hg_size_t)(vals_bulk_size)))
 MERCURY_GEN_PROC(get_multi_out_t, ((int32_t)(ret)))
 
 // ------------- GET PACKED ------------- //
+// compression is the codec requested by the client; the one the server
+// actually used is sent back, in which case the first compressed_size bytes
+// pushed decompress into the raw_size first bytes of the values buffer
 MERCURY_GEN_PROC(get_packed_in_t,
-                 ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_size_t)(
-                     keys_bulk_size))((hg_bulk_t)(keys_bulk_handle))((
-                     hg_size_t)(vals_bulk_size))((hg_bulk_t)(vals_bulk_handle)))
-MERCURY_GEN_PROC(get_packed_out_t, ((int32_t)(ret))((hg_size_t)(num_keys)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_size_t)(keys_bulk_size))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(vals_bulk_size))(
+                     (hg_bulk_t)(vals_bulk_handle))((int32_t)(compression)))
+MERCURY_GEN_PROC(get_packed_out_t,
+                 ((int32_t)(ret))((hg_size_t)(num_keys))((int32_t)(
+                     compression))((hg_size_t)(compressed_size))((hg_size_t)(
+                     raw_size)))
 
 // ------------- LENGTH MULTI ------------- //
-MERCURY_GEN_PROC(
-    length_multi_in_t,
-    ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_bulk_t)(keys_bulk_handle))(
-        (hg_size_t)(keys_bulk_size))((hg_bulk_t)(vals_size_bulk_handle)))
+MERCURY_GEN_PROC(length_multi_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(keys_bulk_size))(
+                     (hg_bulk_t)(vals_size_bulk_handle)))
 MERCURY_GEN_PROC(length_multi_out_t, ((int32_t)(ret)))
 
 // ------------- LENGTH PACKED ------------- //
-MERCURY_GEN_PROC(
-    length_packed_in_t,
-    ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_size_t)(in_bulk_size))(
-        (hg_bulk_t)(in_bulk_handle))((hg_bulk_t)(out_bulk_handle)))
+MERCURY_GEN_PROC(length_packed_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_size_t)(in_bulk_size))((hg_bulk_t)(in_bulk_handle))(
+                     (hg_bulk_t)(out_bulk_handle)))
 MERCURY_GEN_PROC(length_packed_out_t, ((int32_t)(ret)))
 
 // ------------- EXIST MULTI ------------- //
-MERCURY_GEN_PROC(
-    exists_multi_in_t,
-    ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_bulk_t)(keys_bulk_handle))(
-        (hg_size_t)(keys_bulk_size))((hg_bulk_t)(flags_bulk_handle)))
+MERCURY_GEN_PROC(exists_multi_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(keys_bulk_size))(
+                     (hg_bulk_t)(flags_bulk_handle)))
 MERCURY_GEN_PROC(exists_multi_out_t, ((int32_t)(ret)))
 
 // ------------- ERASE MULTI ------------- //
 MERCURY_GEN_PROC(erase_multi_in_t,
-                 ((uint64_t)(db_id))((hg_size_t)(num_keys))((hg_bulk_t)(
-                     keys_bulk_handle))((hg_size_t)(keys_bulk_size)))
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((hg_size_t)(num_keys))(
+                     (hg_bulk_t)(keys_bulk_handle))(
+                     (hg_size_t)(keys_bulk_size)))
 MERCURY_GEN_PROC(erase_multi_out_t, ((int32_t)(ret)))
 
+// ------------- ERASE RANGE ------------- //
+MERCURY_GEN_PROC(erase_range_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(lower))(
+                     (kv_data_t)(upper)))
+MERCURY_GEN_PROC(erase_range_out_t, ((int32_t)(ret))((uint64_t)(num_erased)))
+
+// ------------- ERASE PREFIXED ------------- //
+MERCURY_GEN_PROC(erase_prefixed_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(prefix)))
+MERCURY_GEN_PROC(erase_prefixed_out_t,
+                 ((int32_t)(ret))((uint64_t)(num_erased)))
+
+// ------------- COUNT RANGE ------------- //
+MERCURY_GEN_PROC(count_range_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(lower))(
+                     (kv_data_t)(upper))((int32_t)(with_sizes)))
+MERCURY_GEN_PROC(count_range_out_t,
+                 ((int32_t)(ret))((uint64_t)(num_keys))((uint64_t)(key_bytes))(
+                     (uint64_t)(value_bytes)))
+
+// ------------- COUNT PREFIXED ------------- //
+MERCURY_GEN_PROC(count_prefixed_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(prefix))(
+                     (int32_t)(with_sizes)))
+MERCURY_GEN_PROC(count_prefixed_out_t,
+                 ((int32_t)(ret))((uint64_t)(num_keys))((uint64_t)(key_bytes))(
+                     (uint64_t)(value_bytes)))
+
+// ------------- COMPARE AND SWAP ------------- //
+MERCURY_GEN_PROC(compare_and_swap_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (int32_t)(has_expected))((kv_data_t)(expected))(
+                     (kv_data_t)(value)))
+MERCURY_GEN_PROC(compare_and_swap_out_t, ((int32_t)(ret))((int32_t)(swapped)))
+
+// ------------- FETCH AND ADD ------------- //
+MERCURY_GEN_PROC(fetch_add_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (int64_t)(delta)))
+MERCURY_GEN_PROC(fetch_add_out_t, ((int32_t)(ret))((int64_t)(previous)))
+
+// ------------- APPEND ------------- //
+MERCURY_GEN_PROC(append_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(req_id))((kv_data_t)(key))(
+                     (kv_data_t)(data)))
+MERCURY_GEN_PROC(append_out_t, ((int32_t)(ret))((uint64_t)(new_size)))
+
 // ------------- MIGRATE KEYS ----------- //
 MERCURY_GEN_PROC(migrate_keys_in_t,
                  ((uint64_t)(source_db_id))((hg_string_t)(target_addr))(
@@ -262,4 +345,92 @@ MERCURY_GEN_PROC(migrate_database_in_t,
 
 MERCURY_GEN_PROC(migrate_database_out_t, ((int32_t)(ret))((int32_t)(remi_ret)))
 
+// ------------- COMPACT ------------- //
+MERCURY_GEN_PROC(compact_in_t,
+                 ((uint64_t)(db_id))((kv_data_t)(lower))((kv_data_t)(upper)))
+MERCURY_GEN_PROC(compact_out_t, ((int32_t)(ret)))
+
+// ------------- GET STATISTICS ------------- //
+MERCURY_GEN_PROC(get_statistics_out_t,
+                 ((int32_t)(ret))((hg_string_t)(statistics)))
+
+// ------------- GET SLOW OPS ------------- //
+MERCURY_GEN_PROC(get_slow_ops_in_t, ((int32_t)(clear)))
+MERCURY_GEN_PROC(get_slow_ops_out_t,
+                 ((int32_t)(ret))((hg_string_t)(slow_ops)))
+
+// ------------- FLUSH TRACE ------------- //
+MERCURY_GEN_PROC(flush_trace_in_t, ((hg_string_t)(filename)))
+MERCURY_GEN_PROC(flush_trace_out_t, ((int32_t)(ret)))
+
+// ------------- GET HOT KEYS ------------- //
+// entries holds num_keys entries, each made of the estimated number of
+// accesses (uint64_t), the key size (hg_size_t), and the key
+MERCURY_GEN_PROC(get_hot_keys_in_t,
+                 ((uint64_t)(db_id))((hg_size_t)(max_keys))((int32_t)(reset)))
+MERCURY_GEN_PROC(get_hot_keys_out_t,
+                 ((int32_t)(ret))((hg_size_t)(num_keys))((kv_data_t)(entries)))
+
+// ------------- WATCH ------------- //
+// prefix tells whether lower is a prefix, in which case upper is ignored;
+// client_watch_id is sent back with the notifications
+MERCURY_GEN_PROC(watch_in_t,
+                 ((uint64_t)(db_id))((kv_data_t)(lower))((kv_data_t)(upper))(
+                     (int32_t)(prefix))((int32_t)(values))(
+                     (uint64_t)(client_watch_id)))
+MERCURY_GEN_PROC(watch_out_t, ((int32_t)(ret))((uint64_t)(watch_id)))
+
+// ------------- UNWATCH ------------- //
+MERCURY_GEN_PROC(unwatch_in_t, ((uint64_t)(watch_id)))
+MERCURY_GEN_PROC(unwatch_out_t, ((int32_t)(ret)))
+
+// ------------- WATCH NOTIFY ------------- //
+// sent by the provider to the watching client; events holds num_events
+// events, each made of its type (uint8_t), whether it carries a value
+// (uint8_t), the key size and value size (hg_size_t), the key and the value
+MERCURY_GEN_PROC(watch_notify_in_t,
+                 ((uint64_t)(watch_id))((int32_t)(flags))(
+                     (hg_size_t)(num_events))((kv_data_t)(events)))
+MERCURY_GEN_PROC(watch_notify_out_t, ((int32_t)(ret)))
+
+// ------------- GET CHANGES ------------- //
+// the provider pushes to the client's buffer of bulk_size bytes the
+// num_changes changes following since, each made of its sequence number
+// (uint64_t), its type (uint8_t), the key size and value size (hg_size_t),
+// the key and the value, size being the number of bytes pushed
+MERCURY_GEN_PROC(get_changes_in_t,
+                 ((uint64_t)(db_id))((uint64_t)(since))(
+                     (hg_size_t)(max_changes))((hg_size_t)(bulk_size))(
+                     (hg_bulk_t)(bulk_handle)))
+MERCURY_GEN_PROC(get_changes_out_t,
+                 ((int32_t)(ret))((hg_size_t)(num_changes))(
+                     (uint64_t)(last_seq))((hg_size_t)(size)))
+
+// ------------- TRUNCATE CHANGES ------------- //
+MERCURY_GEN_PROC(truncate_changes_in_t, ((uint64_t)(db_id))((uint64_t)(upto)))
+MERCURY_GEN_PROC(truncate_changes_out_t, ((int32_t)(ret)))
+
+// ------------- REPLICATE ------------- //
+// sent by a provider to the backups of a database; changes holds
+// num_changes changes, each made of its type (uint8_t), the key size and
+// value size (hg_size_t), the key and the value
+MERCURY_GEN_PROC(replicate_in_t,
+                 ((uint64_t)(db_id))((hg_size_t)(num_changes))(
+                     (kv_data_t)(changes)))
+MERCURY_GEN_PROC(replicate_out_t, ((int32_t)(ret)))
+
+// ------------- ADD BACKUP ------------- //
+MERCURY_GEN_PROC(add_backup_in_t,
+                 ((uint64_t)(db_id))((hg_const_string_t)(backup_addr))(
+                     (uint16_t)(backup_provider_id))(
+                     (uint64_t)(backup_db_id))((int32_t)(sync)))
+MERCURY_GEN_PROC(add_backup_out_t, ((int32_t)(ret)))
+
+// ------------- REMOVE BACKUP ------------- //
+MERCURY_GEN_PROC(remove_backup_in_t,
+                 ((uint64_t)(db_id))((hg_const_string_t)(backup_addr))(
+                     (uint16_t)(backup_provider_id))(
+                     (uint64_t)(backup_db_id)))
+MERCURY_GEN_PROC(remove_backup_out_t, ((int32_t)(ret)))
+
 #endif
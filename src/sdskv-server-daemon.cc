@@ -8,6 +8,8 @@
 #include <assert.h>
 #include <unistd.h>
 #include <margo.h>
+#include <fstream>
+#include <sstream>
 #include <sdskv-server.hpp>
 
 typedef enum
@@ -22,6 +24,7 @@ struct options {
     char**           db_names;
     sdskv_db_type_t* db_types;
     char*            host_file;
+    char*            config_file;
     kv_mplex_mode_t  mplex_mode;
 };
 
@@ -29,7 +32,8 @@ static void usage(int argc, char** argv)
 {
     fprintf(stderr,
             "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name "
-            "1>[:map|:bwt|:bdb|:ldb] <db name 2>[:map|:bwt|:bdb|:ldb] ...\n");
+            "1>[:map|:bwt|:bdb|:ldb|:mdb|:rdb|:fwd] <db name "
+            "2>[:map|:bwt|:bdb|:ldb|:mdb|:rdb|:fwd] ...\n");
     fprintf(stderr, "       listen_addr is the Mercury address to listen on\n");
     fprintf(stderr, "       db name X are the names of the databases\n");
     fprintf(stderr,
@@ -37,6 +41,10 @@ static void usage(int argc, char** argv)
     fprintf(stderr,
             "       [-m mode] multiplexing mode (providers or databases) for "
             "managing multiple databases (default is databases)\n");
+    fprintf(stderr,
+            "       [-c filename] JSON configuration of the provider at "
+            "multiplex id 1, whose databases are attached in addition to "
+            "the ones given on the command line (which are then optional)\n");
     fprintf(
         stderr,
         "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:bdb bar\n");
@@ -57,6 +65,12 @@ static sdskv_db_type_t parse_db_type(char* db_fullname)
         return KVDB_BERKELEYDB;
     } else if (strcmp(db_type, "ldb") == 0) {
         return KVDB_LEVELDB;
+    } else if (strcmp(db_type, "mdb") == 0) {
+        return KVDB_LMDB;
+    } else if (strcmp(db_type, "rdb") == 0) {
+        return KVDB_ROCKSDB;
+    } else if (strcmp(db_type, "fwd") == 0) {
+        return KVDB_FORWARDDB;
     }
     fprintf(stderr, "Unknown database type \"%s\"\n", db_type);
     exit(-1);
@@ -69,11 +83,14 @@ static void parse_args(int argc, char** argv, struct options* opts)
     memset(opts, 0, sizeof(*opts));
 
     /* get options */
-    while ((opt = getopt(argc, argv, "f:m:")) != -1) {
+    while ((opt = getopt(argc, argv, "f:m:c:")) != -1) {
         switch (opt) {
         case 'f':
             opts->host_file = optarg;
             break;
+        case 'c':
+            opts->config_file = optarg;
+            break;
         case 'm':
             if (0 == strcmp(optarg, "databases"))
                 opts->mplex_mode = MODE_DATABASES;
@@ -91,8 +108,9 @@ static void parse_args(int argc, char** argv, struct options* opts)
         }
     }
 
-    /* get required arguments after options */
-    if ((argc - optind) < 2) {
+    /* get required arguments after options; the databases may all come from
+     * the configuration file */
+    if ((argc - optind) < (opts->config_file ? 1 : 2)) {
         usage(argc, argv);
         exit(EXIT_FAILURE);
     }
@@ -117,6 +135,18 @@ int main(int argc, char** argv)
 
     parse_args(argc, argv, &opts);
 
+    std::string config;
+    if (opts.config_file) {
+        std::ifstream     file(opts.config_file);
+        std::stringstream content;
+        content << file.rdbuf();
+        if (!file) {
+            fprintf(stderr, "Error: could not read %s\n", opts.config_file);
+            return (-1);
+        }
+        config = content.str();
+    }
+
     /* start margo */
     /* use the main xstream for driving progress and executing rpc handlers */
     mid = margo_init(opts.listen_addr_str, MARGO_SERVER_MODE, 0, -1);
@@ -166,9 +196,11 @@ int main(int argc, char** argv)
     /* initialize the SDSKV server */
     if (opts.mplex_mode == MODE_PROVIDERS) {
         int i;
+        if (opts.num_db == 0)
+            sdskv::provider::create(mid, 1, SDSKV_ABT_POOL_DEFAULT, config);
         for (i = 0; i < opts.num_db; i++) {
-            sdskv::provider* provider
-                = sdskv::provider::create(mid, i + 1, SDSKV_ABT_POOL_DEFAULT);
+            sdskv::provider* provider = sdskv::provider::create(
+                mid, i + 1, SDSKV_ABT_POOL_DEFAULT, i == 0 ? config : "");
 
             sdskv_database_id_t db_id;
             sdskv_config_t      db_config
@@ -187,7 +219,7 @@ int main(int argc, char** argv)
 
         int              i;
         sdskv::provider* provider
-            = sdskv::provider::create(mid, 1, SDSKV_ABT_POOL_DEFAULT);
+            = sdskv::provider::create(mid, 1, SDSKV_ABT_POOL_DEFAULT, config);
 
         for (i = 0; i < opts.num_db; i++) {
             sdskv_database_id_t db_id;
@@ -4,11 +4,13 @@
  * See COPYRIGHT in top-level directory.
  */
 #include "kv-config.h"
+#include <atomic>
 #include <map>
 #include <iostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
+#include <fstream>
 #ifdef USE_REMI
     #include <remi/remi-client.h>
     #include <remi/remi-server.h>
@@ -16,9 +18,16 @@
 #define SDSKV
 #include "datastore/datastore_factory.h"
 #include "sdskv-rpc-types.h"
+#include "sdskv-compression.h"
+#include "sdskv-statistics.h"
+#include "sdskv-tracing.h"
+#include "sdskv-hot-keys.h"
+#include "sdskv-watch.h"
+#include "sdskv-replication.h"
 #include "sdskv-server.h"
 
 #include <dlfcn.h>
+#include <time.h>
 
 #include <json/json.h>
 
@@ -43,7 +52,12 @@ template <typename F> inline scoped_call<F> at_exit(F&& f)
 
 #define ENSURE_MARGO_DESTROY DEFER(margo_destroy, margo_destroy(handle))
 
-#define ENSURE_MARGO_RESPOND DEFER(margo_respond, margo_respond(handle, &out))
+/* the trace of the request is declared first, so that the response is part
+ * of it */
+#define ENSURE_MARGO_RESPOND \
+    RequestTrace trace;      \
+    DEFER(margo_respond,     \
+          trace.timed("respond", [&] { return margo_respond(handle, &out); }))
 
 #define ENSURE_MARGO_FREE_INPUT \
     DEFER(margo_free_input, margo_free_input(handle, &in))
@@ -75,7 +89,9 @@ template <typename F> inline scoped_call<F> at_exit(F&& f)
 
 #define GET_INPUT                                                            \
     do {                                                                     \
-        hret = margo_get_input(handle, &in);                                 \
+        trace.attach(provider->tracer);                                      \
+        hret = trace.timed("decode",                                         \
+                           [&] { return margo_get_input(handle, &in); });    \
         if (hret != HG_SUCCESS) {                                            \
             SDSKV_LOG_ERROR(mid, "margo_get_input failed (ret = %d)", hret); \
             out.ret = SDSKV_MAKE_HG_ERROR(hret);                             \
@@ -84,7 +100,7 @@ template <typename F> inline scoped_call<F> at_exit(F&& f)
     } while (0)
 
 #define FIND_DATABASE                                                          \
-    ABT_rwlock_rdlock(provider->lock);                                         \
+    trace.lock([&] { return ABT_rwlock_rdlock(provider->lock); });             \
     auto it = provider->databases.find(in.db_id);                              \
     if (it == provider->databases.end()) {                                     \
         ABT_rwlock_unlock(provider->lock);                                     \
@@ -92,8 +108,20 @@ template <typename F> inline scoped_call<F> at_exit(F&& f)
         SDSKV_LOG_ERROR(mid, "could not find database with id %lu", in.db_id); \
         return;                                                                \
     }                                                                          \
-    auto db = it->second;                                                      \
-    ABT_rwlock_unlock(provider->lock)
+    auto db       = it->second;                                                \
+    auto hot_keys = find_hot_keys(provider, in.db_id);                         \
+    ABT_rwlock_unlock(provider->lock);                                         \
+    if (provider->compaction_idle_interval > 0)                                \
+        provider->last_activity.store(ABT_get_wtime(),                         \
+                                      std::memory_order_relaxed)
+
+/* times the rest of the handler and records it under __op__ */
+#define TRACK_RPC(__op__)                                                \
+    RpcTimer timer(provider->stats, provider->slow_ops, trace, __op__,   \
+                   in.db_id, in.req_id, &out.ret)
+
+/* evaluates a database call, accounting its duration as backend time */
+#define TIMED_BACKEND(__call__) timer.backend([&] { return __call__; })
 
 struct sdskv_server_context_t {
     margo_instance_id mid;
@@ -102,6 +130,9 @@ struct sdskv_server_context_t {
     std::map<std::string, sdskv_database_id_t>                  name2id;
     std::map<sdskv_database_id_t, std::string>                  id2name;
     std::map<std::string, sdskv_compare_fn>                     compfunctions;
+    std::map<std::string,
+             std::pair<sdskv_shortest_separator_fn, sdskv_short_successor_fn>>
+        shorteningfunctions;
 
 #ifdef USE_REMI
     remi_client_t                    remi_client;
@@ -119,6 +150,7 @@ struct sdskv_server_context_t {
     hg_id_t sdskv_count_databases_id;
     hg_id_t sdskv_list_databases_id;
     hg_id_t sdskv_put_id;
+    hg_id_t sdskv_put_ttl_id;
     hg_id_t sdskv_put_multi_id;
     hg_id_t sdskv_put_packed_id;
     hg_id_t sdskv_bulk_put_id;
@@ -129,6 +161,13 @@ struct sdskv_server_context_t {
     hg_id_t sdskv_exists_multi_id;
     hg_id_t sdskv_erase_id;
     hg_id_t sdskv_erase_multi_id;
+    hg_id_t sdskv_erase_range_id;
+    hg_id_t sdskv_erase_prefixed_id;
+    hg_id_t sdskv_count_range_id;
+    hg_id_t sdskv_count_prefixed_id;
+    hg_id_t sdskv_compare_and_swap_id;
+    hg_id_t sdskv_fetch_add_id;
+    hg_id_t sdskv_append_id;
     hg_id_t sdskv_length_id;
     hg_id_t sdskv_length_multi_id;
     hg_id_t sdskv_length_packed_id;
@@ -141,14 +180,92 @@ struct sdskv_server_context_t {
     hg_id_t sdskv_migrate_keys_prefixed_id;
     hg_id_t sdskv_migrate_all_keys_id;
     hg_id_t sdskv_migrate_database_id;
+    /* compaction */
+    hg_id_t sdskv_compact_id;
+    /* statistics and tracing */
+    hg_id_t sdskv_get_statistics_id;
+    hg_id_t sdskv_flush_trace_id;
+    hg_id_t sdskv_get_hot_keys_id;
+    hg_id_t sdskv_get_slow_ops_id;
+    /* watches */
+    hg_id_t sdskv_watch_id;
+    hg_id_t sdskv_unwatch_id;
+    /* change logs */
+    hg_id_t sdskv_get_changes_id;
+    hg_id_t sdskv_truncate_changes_id;
+    /* replication */
+    hg_id_t sdskv_replicate_id;
+    hg_id_t sdskv_add_backup_id;
+    hg_id_t sdskv_remove_backup_id;
+
+    /* compactions run in a dedicated execution stream, created on demand,
+     * so that they don't block the RPC handlers */
+    ABT_mutex           compaction_mutex;
+    ABT_cond            compaction_cond;
+    ABT_xstream         compaction_xstream;
+    ABT_pool            compaction_pool;
+    ABT_thread          compaction_scheduler;
+    bool                compaction_stop;
+    double              compaction_idle_interval; // in seconds, 0 = disabled
+    double              last_compaction;
+    std::atomic<double> last_activity;
+
+    /* expired entries are reclaimed in the same execution stream, by a
+     * ULT started when the first database with a "ttl" option is attached */
+    ABT_thread expiration_reclaimer;
+    double     expiration_interval; // in seconds
+    hg_size_t  expiration_batch_size;
+
+    /* values larger than bulk_chunk_size are transferred in chunks, with
+     * up to bulk_pipeline_depth transfers in flight */
+    hg_size_t bulk_chunk_size; // 0 = disabled
+    unsigned  bulk_pipeline_depth;
+    /* largest value a bulk or partial put may write at once */
+    hg_size_t bulk_max_value_size;
+    /* largest decompressed payload of a packed put */
+    hg_size_t bulk_max_packed_size;
+
+    /* latencies and volumes of the RPCs, per provider and per database */
+    ProviderStatistics stats;
+    std::string        stats_dump_file; // empty = no dump
+
+    /* spans of the recent requests, when tracing is enabled */
+    Tracer      tracer;
+    std::string trace_file; // default file the trace is flushed to
+
+    /* RPCs that exceeded the threshold of their type, whose file is
+     * written by a ULT of the compaction execution stream */
+    SlowOpLog  slow_ops;
+    ABT_thread slow_ops_flusher;
+
+    /* access frequencies of the keys of each database, guarded by lock */
+    HotKeyConfig hot_keys_config;
+    std::unordered_map<sdskv_database_id_t, std::shared_ptr<HotKeyTracker>>
+        hot_keys;
+
+    /* clients notified of the changes made to ranges of keys */
+    WatchHub watches;
+
+    /* backups to which the writes to the databases are sent */
+    ReplicationHub replication;
 
     Json::Value json_cfg;
 };
 
+/* hot-key tracker of a database, if any; the caller holds provider->lock */
+static inline std::shared_ptr<HotKeyTracker>
+find_hot_keys(sdskv_provider_t provider, sdskv_database_id_t db_id)
+{
+    if (provider->hot_keys.empty()) return nullptr;
+    auto it = provider->hot_keys.find(db_id);
+    return it == provider->hot_keys.end() ? nullptr : it->second;
+}
+
 DECLARE_MARGO_RPC_HANDLER(sdskv_open_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_count_db_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_list_db_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_put_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_put_ttl_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_put_multi_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_put_packed_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_length_ult)
@@ -163,6 +280,13 @@ DECLARE_MARGO_RPC_HANDLER(sdskv_list_keys_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_list_keyvals_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_erase_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_erase_multi_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_erase_range_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_erase_prefixed_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_count_range_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_count_prefixed_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_compare_and_swap_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_fetch_add_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_append_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_exists_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_exists_multi_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_keys_ult)
@@ -170,6 +294,18 @@ DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_key_range_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_keys_prefixed_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_all_keys_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_database_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_compact_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_statistics_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_flush_trace_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_hot_keys_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_slow_ops_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_watch_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_unwatch_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_changes_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_truncate_changes_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_replicate_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_add_backup_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_remove_backup_ult)
 
 static void sdskv_server_finalize_cb(void* data);
 
@@ -183,6 +319,19 @@ static int sdskv_post_migration_callback(remi_fileset_t fileset, void* uargs);
 
 static int populate_provider_from_config(sdskv_provider_t provider);
 
+static int start_compaction_scheduler(sdskv_provider_t provider);
+
+static void stop_compaction(sdskv_provider_t provider);
+
+static int start_expiration_reclaimer(sdskv_provider_t provider);
+
+static int start_slow_ops_flusher(sdskv_provider_t provider);
+
+static int attach_database(sdskv_provider_t      provider,
+                           const sdskv_config_t* config,
+                           const Json::Value&    db_json,
+                           sdskv_database_id_t*  db_id);
+
 static int validate_and_complete_config(margo_instance_id mid,
                                         Json::Value&      config)
 {
@@ -199,9 +348,113 @@ static int validate_and_complete_config(margo_instance_id mid,
      *         "path" : "<database-path>",         (required for some backends)
      *         "comparator" : "<comparator-name>", (optional, default to "")
      *         "no_overwrite" : true/false         (optional, default to false)
+     *         ...                                 (backend-specific options)
      *       },
      *       ...
-     *    ]
+     *    ],
+     *    "leveldb" : {                            (optional)
+     *       "shared_block_cache_size" : <bytes>   (block cache shared by the
+     *    },                                        leveldb databases that set
+     *                                              "shared_block_cache")
+     *    "rocksdb" : { ... },                     (optional, options of the
+     *                                              rocksdb instances)
+     *    "compaction" : {                         (optional)
+     *       "idle_interval" : <seconds>           (compact all the databases
+     *    },                                        after this much time without
+     *                                              activity, 0 to disable)
+     *    "expiration" : {                         (optional)
+     *       "interval" : <seconds>,               (default 1, period at which
+     *                                              expired entries of the
+     *                                              databases with a "ttl" are
+     *                                              reclaimed)
+     *       "batch_size" : <int>                  (default 1024, keys examined
+     *    },                                        per database and period)
+     *    "bulk" : {                               (optional)
+     *       "chunk_size" : <bytes>,               (default 1 MiB, values larger
+     *                                              than this are transferred in
+     *                                              chunks, 0 to disable)
+     *       "pipeline_depth" : <int>,             (default 4, number of chunk
+     *                                              transfers in flight)
+     *       "max_value_size" : <bytes>,           (default 1 GiB, largest
+     *                                              value a bulk put or a
+     *                                              partial put may write at
+     *                                              once)
+     *       "max_packed_size" : <bytes>           (default 1 GiB, largest
+     *    },                                        payload of a compressed
+     *                                              packed put, once
+     *                                              decompressed)
+     *    "statistics" : {                         (optional)
+     *       "enabled" : true/false,               (default true, per-RPC and
+     *                                              per-database latencies)
+     *       "dump_file" : "<path>"                (default "", file to which
+     *    }                                         statistics are written as
+     *                                              JSON when the provider is
+     *                                              destroyed)
+     *    "tracing" : {                            (optional)
+     *       "enabled" : true/false,               (default false, spans of
+     *                                              each request's decoding,
+     *                                              lock wait, backend calls,
+     *                                              bulk transfers and response)
+     *       "capacity" : <int>,                   (default 65536, number of
+     *                                              spans kept in memory)
+     *       "file" : "<path>"                     (default "", Chrome trace
+     *    }                                         file the spans are flushed
+     *                                              to when the provider is
+     *                                              destroyed)
+     *    "hot_keys" : {                           (optional)
+     *       "enabled" : true/false,               (default true, track the
+     *                                              most accessed keys of each
+     *                                              database)
+     *       "sample_rate" : <int>,                (default 16, one put or get
+     *                                              in sample_rate is counted)
+     *       "width" : <int>,                      (default 1024, counters per
+     *                                              row of the count-min sketch)
+     *       "depth" : <int>,                      (default 4, rows of the
+     *                                              count-min sketch)
+     *       "top_k" : <int>                       (default 32, number of hot
+     *    }                                         keys tracked)
+     *    "slow_ops" : {                           (optional)
+     *       "enabled" : true/false,               (default true, log the RPCs
+     *                                              slower than their threshold)
+     *       "capacity" : <int>,                   (default 1024, number of
+     *                                              slow RPCs kept in memory)
+     *       "threshold_ms" : <number>,            (default 100, threshold of
+     *                                              all the types of RPC)
+     *       "thresholds_ms" : {                   (default {}, thresholds of
+     *          "<rpc>" : <number>, ...             specific types of RPC, e.g.
+     *       },                                     "get_packed")
+     *       "file" : "<path>"                     (default "", file to which
+     *    }                                         slow RPCs are appended as
+     *                                              JSON lines)
+     *    "watch" : {                              (optional)
+     *       "enabled" : true/false,               (default false, let clients
+     *                                              watch ranges of keys)
+     *       "max_batch_events" : <int>,           (default 256, changes per
+     *                                              notification)
+     *       "max_batch_bytes" : <bytes>,          (default 64 KiB, size of a
+     *                                              notification)
+     *       "max_pending_bytes" : <bytes>,        (default 16 MiB, changes
+     *                                              queued per watch before
+     *                                              they are dropped)
+     *       "coalesce_ms" : <number>,             (default 10, delay before
+     *                                              each notification)
+     *       "timeout_ms" : <number>               (default 10000, after which
+     *    }                                         an unacknowledged
+     *                                              notification cancels its
+     *                                              watch)
+     *    "replication" : {                        (optional)
+     *       "enabled" : true/false,               (default false, let
+     *                                              databases have backups)
+     *       "max_batch_changes" : <int>,          (default 256, changes sent
+     *                                              to a backup at once)
+     *       "max_batch_bytes" : <bytes>,          (default 64 KiB, size of a
+     *                                              batch of changes)
+     *       "max_lag" : <int>,                    (default 1024, changes not
+     *                                              acknowledged by an async
+     *                                              backup before writes wait)
+     *       "timeout_ms" : <number>               (default 10000, after which
+     *    }                                         an unacknowledged batch
+     *                                              fails its backup)
      * }
      **/
     if (config.isNull()) { config = Json::Value(Json::objectValue); }
@@ -250,6 +503,301 @@ static int validate_and_complete_config(margo_instance_id mid,
             comparator_names.insert(name.asString());
         }
     }
+    // validate leveldb options
+    if (config.isMember("leveldb")) {
+        auto& leveldb = config["leveldb"];
+        if (!leveldb.isObject()) {
+            SDSKV_LOG_ERROR(mid, "\"leveldb\" field should be an object");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (leveldb.isMember("shared_block_cache_size")
+            && !leveldb["shared_block_cache_size"].isUInt64()) {
+            SDSKV_LOG_ERROR(
+                mid, "\"shared_block_cache_size\" should be a positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate rocksdb options
+    if (config.isMember("rocksdb") && !config["rocksdb"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"rocksdb\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    // validate compaction options
+    if (config.isMember("compaction")) {
+        auto& compaction = config["compaction"];
+        if (!compaction.isObject()) {
+            SDSKV_LOG_ERROR(mid, "\"compaction\" field should be an object");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!compaction.isMember("idle_interval"))
+            compaction["idle_interval"] = 0;
+        if (!compaction["idle_interval"].isNumeric()
+            || compaction["idle_interval"].asDouble() < 0) {
+            SDSKV_LOG_ERROR(mid,
+                            "\"idle_interval\" should be a positive number");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate expiration options
+    if (config.isMember("expiration") && !config["expiration"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"expiration\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& expiration = config["expiration"];
+        if (!expiration.isMember("interval")) expiration["interval"] = 1.0;
+        if (!expiration.isMember("batch_size")) expiration["batch_size"] = 1024;
+        if (!expiration["interval"].isNumeric()
+            || expiration["interval"].asDouble() <= 0) {
+            SDSKV_LOG_ERROR(mid, "\"interval\" should be a strictly positive"
+                                 " number");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!expiration["batch_size"].isUInt()
+            || expiration["batch_size"].asUInt() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"batch_size\" should be a strictly"
+                                 " positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate bulk transfer options
+    if (config.isMember("bulk") && !config["bulk"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"bulk\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& bulk = config["bulk"];
+        if (!bulk.isMember("chunk_size")) bulk["chunk_size"] = 1 << 20;
+        if (!bulk.isMember("pipeline_depth")) bulk["pipeline_depth"] = 4;
+        if (!bulk.isMember("max_value_size")) bulk["max_value_size"] = 1 << 30;
+        if (!bulk.isMember("max_packed_size"))
+            bulk["max_packed_size"] = 1 << 30;
+        if (!bulk["chunk_size"].isUInt64()) {
+            SDSKV_LOG_ERROR(mid, "\"chunk_size\" should be a positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!bulk["pipeline_depth"].isUInt()
+            || bulk["pipeline_depth"].asUInt() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"pipeline_depth\" should be a strictly"
+                                 " positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!bulk["max_value_size"].isUInt64()
+            || bulk["max_value_size"].asUInt64() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"max_value_size\" should be a strictly"
+                                 " positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!bulk["max_packed_size"].isUInt64()
+            || bulk["max_packed_size"].asUInt64() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"max_packed_size\" should be a strictly"
+                                 " positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate statistics options
+    if (config.isMember("statistics") && !config["statistics"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"statistics\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& statistics = config["statistics"];
+        if (!statistics.isMember("enabled")) statistics["enabled"] = true;
+        if (!statistics.isMember("dump_file")) statistics["dump_file"] = "";
+        if (!statistics["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!statistics["dump_file"].isString()) {
+            SDSKV_LOG_ERROR(mid, "\"dump_file\" should be a string");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate tracing options
+    if (config.isMember("tracing") && !config["tracing"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"tracing\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& tracing = config["tracing"];
+        if (!tracing.isMember("enabled")) tracing["enabled"] = false;
+        if (!tracing.isMember("capacity")) tracing["capacity"] = 65536;
+        if (!tracing.isMember("file")) tracing["file"] = "";
+        if (!tracing["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!tracing["capacity"].isUInt()
+            || tracing["capacity"].asUInt() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"capacity\" should be a positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!tracing["file"].isString()) {
+            SDSKV_LOG_ERROR(mid, "\"file\" should be a string");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate hot-key tracking options
+    if (config.isMember("hot_keys") && !config["hot_keys"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"hot_keys\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto&        hot_keys = config["hot_keys"];
+        HotKeyConfig defaults;
+        if (!hot_keys.isMember("enabled")) hot_keys["enabled"] = true;
+        if (!hot_keys.isMember("sample_rate"))
+            hot_keys["sample_rate"] = defaults.sample_rate;
+        if (!hot_keys.isMember("width")) hot_keys["width"] = defaults.width;
+        if (!hot_keys.isMember("depth")) hot_keys["depth"] = defaults.depth;
+        if (!hot_keys.isMember("top_k")) hot_keys["top_k"] = defaults.top_k;
+        if (!hot_keys["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        for (auto field : {"sample_rate", "width", "depth", "top_k"}) {
+            if (!hot_keys[field].isUInt() || hot_keys[field].asUInt() == 0) {
+                SDSKV_LOG_ERROR(mid, "\"%s\" should be a positive integer",
+                                field);
+                return SDSKV_ERR_CONFIG;
+            }
+        }
+    }
+    // validate slow-operation log options
+    if (config.isMember("slow_ops") && !config["slow_ops"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"slow_ops\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& slow_ops = config["slow_ops"];
+        if (!slow_ops.isMember("enabled")) slow_ops["enabled"] = true;
+        if (!slow_ops.isMember("capacity")) slow_ops["capacity"] = 1024;
+        if (!slow_ops.isMember("threshold_ms")) slow_ops["threshold_ms"] = 100;
+        if (!slow_ops.isMember("thresholds_ms"))
+            slow_ops["thresholds_ms"] = Json::Value(Json::objectValue);
+        if (!slow_ops.isMember("file")) slow_ops["file"] = "";
+        if (!slow_ops["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!slow_ops["capacity"].isUInt()
+            || slow_ops["capacity"].asUInt() == 0) {
+            SDSKV_LOG_ERROR(mid, "\"capacity\" should be a positive integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!slow_ops["threshold_ms"].isNumeric()
+            || slow_ops["threshold_ms"].asDouble() < 0) {
+            SDSKV_LOG_ERROR(mid,
+                            "\"threshold_ms\" should be a non-negative number");
+            return SDSKV_ERR_CONFIG;
+        }
+        auto& thresholds = slow_ops["thresholds_ms"];
+        if (!thresholds.isObject()) {
+            SDSKV_LOG_ERROR(mid, "\"thresholds_ms\" should be an object");
+            return SDSKV_ERR_CONFIG;
+        }
+        for (const auto& name : thresholds.getMemberNames()) {
+            unsigned op = 0;
+            while (op < SDSKV_STAT_NUM_OPS
+                   && name != sdskv_stat_op_name((sdskv_stat_op_t)op))
+                op++;
+            if (op == SDSKV_STAT_NUM_OPS) {
+                SDSKV_LOG_ERROR(mid, "unknown RPC \"%s\" in \"thresholds_ms\"",
+                                name.c_str());
+                return SDSKV_ERR_CONFIG;
+            }
+            if (!thresholds[name].isNumeric()
+                || thresholds[name].asDouble() < 0) {
+                SDSKV_LOG_ERROR(mid,
+                                "threshold of \"%s\" should be a non-negative"
+                                " number",
+                                name.c_str());
+                return SDSKV_ERR_CONFIG;
+            }
+        }
+        if (!slow_ops["file"].isString()) {
+            SDSKV_LOG_ERROR(mid, "\"file\" should be a string");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate watch options
+    if (config.isMember("watch") && !config["watch"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"watch\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& watch = config["watch"];
+        if (!watch.isMember("enabled")) watch["enabled"] = false;
+        if (!watch.isMember("max_batch_events"))
+            watch["max_batch_events"] = 256;
+        if (!watch.isMember("max_batch_bytes"))
+            watch["max_batch_bytes"] = 64 * 1024;
+        if (!watch.isMember("max_pending_bytes"))
+            watch["max_pending_bytes"] = 16 * 1024 * 1024;
+        if (!watch.isMember("coalesce_ms")) watch["coalesce_ms"] = 10;
+        if (!watch.isMember("timeout_ms")) watch["timeout_ms"] = 10000;
+        if (!watch["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        for (auto field :
+             {"max_batch_events", "max_batch_bytes", "max_pending_bytes"}) {
+            if (!watch[field].isUInt() || watch[field].asUInt() == 0) {
+                SDSKV_LOG_ERROR(mid, "\"%s\" should be a positive integer",
+                                field);
+                return SDSKV_ERR_CONFIG;
+            }
+        }
+        if (!watch["coalesce_ms"].isNumeric()
+            || watch["coalesce_ms"].asDouble() < 0) {
+            SDSKV_LOG_ERROR(mid,
+                            "\"coalesce_ms\" should be a non-negative number");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!watch["timeout_ms"].isNumeric()
+            || watch["timeout_ms"].asDouble() <= 0) {
+            SDSKV_LOG_ERROR(mid, "\"timeout_ms\" should be a positive number");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
+    // validate replication options
+    if (config.isMember("replication") && !config["replication"].isObject()) {
+        SDSKV_LOG_ERROR(mid, "\"replication\" field should be an object");
+        return SDSKV_ERR_CONFIG;
+    }
+    {
+        auto& replication = config["replication"];
+        if (!replication.isMember("enabled")) replication["enabled"] = false;
+        if (!replication.isMember("max_batch_changes"))
+            replication["max_batch_changes"] = 256;
+        if (!replication.isMember("max_batch_bytes"))
+            replication["max_batch_bytes"] = 64 * 1024;
+        if (!replication.isMember("max_lag")) replication["max_lag"] = 1024;
+        if (!replication.isMember("timeout_ms"))
+            replication["timeout_ms"] = 10000;
+        if (!replication["enabled"].isBool()) {
+            SDSKV_LOG_ERROR(mid, "\"enabled\" should be a boolean");
+            return SDSKV_ERR_CONFIG;
+        }
+        for (auto field : {"max_batch_changes", "max_batch_bytes"}) {
+            if (!replication[field].isUInt()
+                || replication[field].asUInt() == 0) {
+                SDSKV_LOG_ERROR(mid, "\"%s\" should be a positive integer",
+                                field);
+                return SDSKV_ERR_CONFIG;
+            }
+        }
+        if (!replication["max_lag"].isUInt64()) {
+            SDSKV_LOG_ERROR(mid,
+                            "\"max_lag\" should be a non-negative integer");
+            return SDSKV_ERR_CONFIG;
+        }
+        if (!replication["timeout_ms"].isNumeric()
+            || replication["timeout_ms"].asDouble() <= 0) {
+            SDSKV_LOG_ERROR(mid, "\"timeout_ms\" should be a positive number");
+            return SDSKV_ERR_CONFIG;
+        }
+    }
     // validate databases
     if (config.isMember("databases")) {
         if (!config["databases"].isArray()) {
@@ -384,6 +932,63 @@ sdskv_provider_register(margo_instance_id                      mid,
         return SDSKV_MAKE_ABT_ERROR(ret);
     }
 
+    tmp_provider->compaction_xstream   = ABT_XSTREAM_NULL;
+    tmp_provider->compaction_pool      = ABT_POOL_NULL;
+    tmp_provider->compaction_scheduler = ABT_THREAD_NULL;
+    tmp_provider->compaction_stop      = false;
+    tmp_provider->compaction_idle_interval
+        = config.get("compaction", Json::Value())
+              .get("idle_interval", 0)
+              .asDouble();
+    tmp_provider->last_compaction = 0.0;
+    tmp_provider->last_activity   = 0.0;
+    tmp_provider->expiration_reclaimer = ABT_THREAD_NULL;
+    tmp_provider->slow_ops_flusher     = ABT_THREAD_NULL;
+    tmp_provider->expiration_interval
+        = config["expiration"]["interval"].asDouble();
+    tmp_provider->expiration_batch_size
+        = config["expiration"]["batch_size"].asUInt();
+    tmp_provider->bulk_chunk_size = config["bulk"]["chunk_size"].asUInt64();
+    tmp_provider->bulk_pipeline_depth
+        = config["bulk"]["pipeline_depth"].asUInt();
+    tmp_provider->bulk_max_value_size
+        = config["bulk"]["max_value_size"].asUInt64();
+    tmp_provider->bulk_max_packed_size
+        = config["bulk"]["max_packed_size"].asUInt64();
+    tmp_provider->stats.set_enabled(
+        config["statistics"]["enabled"].asBool());
+    tmp_provider->stats_dump_file
+        = config["statistics"]["dump_file"].asString();
+    tmp_provider->tracer.configure(config["tracing"]["enabled"].asBool(),
+                                   config["tracing"]["capacity"].asUInt(),
+                                   provider_id);
+    tmp_provider->trace_file = config["tracing"]["file"].asString();
+
+    auto& hot_keys       = tmp_provider->hot_keys_config;
+    hot_keys.enabled     = config["hot_keys"]["enabled"].asBool();
+    hot_keys.sample_rate = config["hot_keys"]["sample_rate"].asUInt();
+    hot_keys.width       = config["hot_keys"]["width"].asUInt();
+    hot_keys.depth       = config["hot_keys"]["depth"].asUInt();
+    hot_keys.top_k       = config["hot_keys"]["top_k"].asUInt();
+
+    auto&               slow_ops = config["slow_ops"];
+    std::vector<double> thresholds(SDSKV_STAT_NUM_OPS);
+    for (unsigned op = 0; op < SDSKV_STAT_NUM_OPS; op++) {
+        const char* name = sdskv_stat_op_name((sdskv_stat_op_t)op);
+        thresholds[op]
+            = slow_ops["thresholds_ms"].get(name, slow_ops["threshold_ms"])
+                  .asDouble()
+            / 1000.0;
+    }
+    if (!tmp_provider->slow_ops.configure(
+            slow_ops["enabled"].asBool(), slow_ops["capacity"].asUInt(),
+            thresholds, slow_ops["file"].asString()))
+        SDSKV_LOG_ERROR(mid, "could not open %s to log slow operations",
+                        slow_ops["file"].asCString());
+
+    ABT_mutex_create(&(tmp_provider->compaction_mutex));
+    ABT_cond_create(&(tmp_provider->compaction_cond));
+
     /* register RPCs */
     hg_id_t rpc_id;
     rpc_id
@@ -410,6 +1015,12 @@ sdskv_provider_register(margo_instance_id                      mid,
     tmp_provider->sdskv_put_id = rpc_id;
     margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
 
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_put_ttl_rpc", put_ttl_in_t,
+                                     put_ttl_out_t, sdskv_put_ttl_ult,
+                                     provider_id, args->rpc_pool);
+    tmp_provider->sdskv_put_ttl_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
     rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_put_multi_rpc", put_multi_in_t,
                                      put_multi_out_t, sdskv_put_multi_ult,
                                      provider_id, args->rpc_pool);
@@ -506,6 +1117,51 @@ sdskv_provider_register(margo_instance_id                      mid,
     tmp_provider->sdskv_erase_multi_id = rpc_id;
     margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
 
+    rpc_id = MARGO_REGISTER_PROVIDER(
+        mid, "sdskv_erase_range_rpc", erase_range_in_t, erase_range_out_t,
+        sdskv_erase_range_ult, provider_id, args->rpc_pool);
+    tmp_provider->sdskv_erase_range_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(
+        mid, "sdskv_erase_prefixed_rpc", erase_prefixed_in_t,
+        erase_prefixed_out_t, sdskv_erase_prefixed_ult, provider_id,
+        args->rpc_pool);
+    tmp_provider->sdskv_erase_prefixed_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(
+        mid, "sdskv_count_range_rpc", count_range_in_t, count_range_out_t,
+        sdskv_count_range_ult, provider_id, args->rpc_pool);
+    tmp_provider->sdskv_count_range_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(
+        mid, "sdskv_count_prefixed_rpc", count_prefixed_in_t,
+        count_prefixed_out_t, sdskv_count_prefixed_ult, provider_id,
+        args->rpc_pool);
+    tmp_provider->sdskv_count_prefixed_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(
+        mid, "sdskv_compare_and_swap_rpc", compare_and_swap_in_t,
+        compare_and_swap_out_t, sdskv_compare_and_swap_ult, provider_id,
+        args->rpc_pool);
+    tmp_provider->sdskv_compare_and_swap_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_fetch_add_rpc", fetch_add_in_t,
+                                     fetch_add_out_t, sdskv_fetch_add_ult,
+                                     provider_id, args->rpc_pool);
+    tmp_provider->sdskv_fetch_add_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_append_rpc", append_in_t,
+                                     append_out_t, sdskv_append_ult,
+                                     provider_id, args->rpc_pool);
+    tmp_provider->sdskv_append_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
     /* migration RPC */
     rpc_id = MARGO_REGISTER_PROVIDER(
         mid, "sdskv_migrate_keys_rpc", migrate_keys_in_t, migrate_keys_out_t,
@@ -541,6 +1197,120 @@ sdskv_provider_register(margo_instance_id                      mid,
     tmp_provider->sdskv_migrate_database_id = rpc_id;
     margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
 
+    /* compaction RPC */
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_compact_rpc", compact_in_t,
+                                     compact_out_t, sdskv_compact_ult,
+                                     provider_id, args->rpc_pool);
+    tmp_provider->sdskv_compact_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    /* statistics RPC */
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_statistics_rpc", void,
+                                     get_statistics_out_t,
+                                     sdskv_get_statistics_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_get_statistics_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_flush_trace_rpc",
+                                     flush_trace_in_t, flush_trace_out_t,
+                                     sdskv_flush_trace_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_flush_trace_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_hot_keys_rpc",
+                                     get_hot_keys_in_t, get_hot_keys_out_t,
+                                     sdskv_get_hot_keys_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_get_hot_keys_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_slow_ops_rpc",
+                                     get_slow_ops_in_t, get_slow_ops_out_t,
+                                     sdskv_get_slow_ops_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_get_slow_ops_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    /* watch RPCs; the changes are sent back with an RPC that the clients
+     * register with their own margo instance */
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_watch_rpc", watch_in_t,
+                                     watch_out_t, sdskv_watch_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_watch_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_unwatch_rpc", unwatch_in_t,
+                                     unwatch_out_t, sdskv_unwatch_ult,
+                                     provider_id, args->rpc_pool);
+    tmp_provider->sdskv_unwatch_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_changes_rpc",
+                                     get_changes_in_t, get_changes_out_t,
+                                     sdskv_get_changes_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_get_changes_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_truncate_changes_rpc",
+                                     truncate_changes_in_t,
+                                     truncate_changes_out_t,
+                                     sdskv_truncate_changes_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_truncate_changes_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+
+    /* replication RPCs; the changes are sent to the backups with the
+     * replicate RPC, handled by the providers they belong to */
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_replicate_rpc",
+                                     replicate_in_t, replicate_out_t,
+                                     sdskv_replicate_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_replicate_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_add_backup_rpc",
+                                     add_backup_in_t, add_backup_out_t,
+                                     sdskv_add_backup_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_add_backup_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_remove_backup_rpc",
+                                     remove_backup_in_t, remove_backup_out_t,
+                                     sdskv_remove_backup_ult, provider_id,
+                                     args->rpc_pool);
+    tmp_provider->sdskv_remove_backup_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_provider, NULL);
+    {
+        hg_id_t   notify_id;
+        hg_bool_t flag;
+        margo_registered_name(mid, "sdskv_watch_notify_rpc", &notify_id,
+                              &flag);
+        if (flag == HG_FALSE)
+            notify_id = MARGO_REGISTER(mid, "sdskv_watch_notify_rpc",
+                                       watch_notify_in_t, watch_notify_out_t,
+                                       NULL);
+        ABT_pool pool = args->rpc_pool;
+        if (pool == ABT_POOL_NULL) margo_get_handler_pool(mid, &pool);
+        auto&       watch = config["watch"];
+        WatchConfig watch_config;
+        watch_config.enabled           = watch["enabled"].asBool();
+        watch_config.max_batch_events  = watch["max_batch_events"].asUInt();
+        watch_config.max_batch_bytes   = watch["max_batch_bytes"].asUInt();
+        watch_config.max_pending_bytes = watch["max_pending_bytes"].asUInt();
+        watch_config.coalesce_ms       = watch["coalesce_ms"].asDouble();
+        watch_config.timeout_ms        = watch["timeout_ms"].asDouble();
+        tmp_provider->watches.configure(mid, pool, notify_id, watch_config);
+
+        auto&             replication = config["replication"];
+        ReplicationConfig replication_config;
+        replication_config.enabled = replication["enabled"].asBool();
+        replication_config.max_batch_changes
+            = replication["max_batch_changes"].asUInt();
+        replication_config.max_batch_bytes
+            = replication["max_batch_bytes"].asUInt();
+        replication_config.max_lag    = replication["max_lag"].asUInt64();
+        replication_config.timeout_ms = replication["timeout_ms"].asDouble();
+        tmp_provider->replication.configure(mid, pool,
+                                            tmp_provider->sdskv_replicate_id,
+                                            replication_config);
+    }
+
 #ifdef USE_REMI
     tmp_provider->remi_client   = (remi_client_t)(args->remi_client);
     tmp_provider->remi_provider = (remi_provider_t)(args->remi_provider);
@@ -569,6 +1339,18 @@ sdskv_provider_register(margo_instance_id                      mid,
         return ret;
     }
 
+    ret = start_compaction_scheduler(tmp_provider);
+    if (ret != SDSKV_SUCCESS) {
+        sdskv_provider_destroy(tmp_provider);
+        return ret;
+    }
+
+    ret = start_slow_ops_flusher(tmp_provider);
+    if (ret != SDSKV_SUCCESS) {
+        sdskv_provider_destroy(tmp_provider);
+        return ret;
+    }
+
     if (provider != SDSKV_PROVIDER_IGNORE) *provider = tmp_provider;
 
     return SDSKV_SUCCESS;
@@ -582,6 +1364,76 @@ extern "C" char* sdskv_provider_get_config(sdskv_provider_t provider)
     return strdup(config.c_str());
 }
 
+static std::string statistics_to_string(sdskv_provider_t provider)
+{
+    ABT_rwlock_rdlock(provider->lock);
+    Json::Value stats = provider->stats.to_json(provider->id2name);
+    /* memory used by the databases that keep their data in memory */
+    for (const auto& db : provider->databases) {
+        ds_memory_t usage;
+        ds_cache_t  cached;
+        auto        name = provider->id2name.find(db.first);
+        if (name == provider->id2name.end()) continue;
+        if (db.second->memory_usage(usage)) {
+            auto& memory         = stats["databases"][name->second]["memory"];
+            memory["used_bytes"] = (Json::UInt64)usage.used_bytes;
+            memory["max_bytes"]  = (Json::UInt64)usage.max_bytes;
+            memory["evictions"]  = (Json::UInt64)usage.evictions;
+            memory["rejections"] = (Json::UInt64)usage.rejections;
+        }
+        /* value cache of the databases opened with a "cache" option */
+        if (db.second->cache_usage(cached)) {
+            auto& cache            = stats["databases"][name->second]["cache"];
+            cache["used_bytes"]    = (Json::UInt64)cached.used_bytes;
+            cache["max_bytes"]     = (Json::UInt64)cached.max_bytes;
+            cache["hits"]          = (Json::UInt64)cached.hits;
+            cache["misses"]        = (Json::UInt64)cached.misses;
+            cache["evictions"]     = (Json::UInt64)cached.evictions;
+            cache["invalidations"] = (Json::UInt64)cached.invalidations;
+        }
+    }
+    ABT_rwlock_unlock(provider->lock);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, stats);
+}
+
+extern "C" char* sdskv_provider_get_statistics(sdskv_provider_t provider)
+{
+    return strdup(statistics_to_string(provider).c_str());
+}
+
+static std::string slow_ops_to_string(sdskv_provider_t provider, bool clear)
+{
+    ABT_rwlock_rdlock(provider->lock);
+    Json::Value slow_ops = provider->slow_ops.to_json(provider->id2name, clear);
+    ABT_rwlock_unlock(provider->lock);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, slow_ops);
+}
+
+extern "C" char* sdskv_provider_get_slow_ops(sdskv_provider_t provider,
+                                             int              clear)
+{
+    return strdup(slow_ops_to_string(provider, clear).c_str());
+}
+
+extern "C" int sdskv_provider_flush_trace(sdskv_provider_t provider,
+                                          const char*      filename)
+{
+    std::string file = provider->trace_file;
+    if (filename && *filename) file = filename;
+    if (!provider->tracer.enabled() || file.empty())
+        return SDSKV_ERR_INVALID_ARG;
+    if (!provider->tracer.flush(file)) {
+        SDSKV_LOG_ERROR(provider->mid, "could not write trace to %s",
+                        file.c_str());
+        return SDSKV_ERR_INVALID_ARG;
+    }
+    return SDSKV_SUCCESS;
+}
+
 extern "C" margo_instance_id sdskv_provider_get_mid(sdskv_provider_t provider)
 {
     return (provider->mid);
@@ -638,9 +1490,36 @@ extern "C" int sdskv_provider_find_comparison_function(
 
     return SDSKV_SUCCESS;
 }
+extern "C" int sdskv_provider_add_key_shortening_functions(
+    sdskv_provider_t            provider,
+    const char*                 function_name,
+    sdskv_shortest_separator_fn separator_fn,
+    sdskv_short_successor_fn    successor_fn)
+{
+    if (provider->compfunctions.find(std::string(function_name))
+        == provider->compfunctions.end()) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "could not find comparison function \"%s\"",
+                        function_name);
+        return SDSKV_ERR_COMP_FUNC;
+    }
+    provider->shorteningfunctions[std::string(function_name)]
+        = std::make_pair(separator_fn, successor_fn);
+    return SDSKV_SUCCESS;
+}
+
 extern "C" int sdskv_provider_attach_database(sdskv_provider_t      provider,
                                               const sdskv_config_t* config,
                                               sdskv_database_id_t*  db_id)
+{
+    return attach_database(provider, config, Json::Value(Json::objectValue),
+                           db_id);
+}
+
+static int attach_database(sdskv_provider_t      provider,
+                           const sdskv_config_t* config,
+                           const Json::Value&    db_json,
+                           sdskv_database_id_t*  db_id)
 {
     sdskv_compare_fn comp_fn = NULL;
     if (config->db_comp_fn_name && config->db_comp_fn_name[0]) {
@@ -655,17 +1534,66 @@ extern "C" int sdskv_provider_attach_database(sdskv_provider_t      provider,
         comp_fn = it->second;
     }
 
-    auto db = datastore_factory::open_datastore(config->db_type,
-                                                std::string(config->db_name),
-                                                std::string(config->db_path));
+    /* databases asking for the provider's shared block cache are all given
+     * the same cache name, and the size from the provider's configuration */
+    Json::Value ds_config = db_json;
+    if (config->db_type == KVDB_LEVELDB
+        && ds_config.get("shared_block_cache", false).asBool()) {
+        auto              leveldb_cfg = provider->json_cfg.get("leveldb", {});
+        std::stringstream cache_name;
+        cache_name << "sdskv-provider-" << (void*)provider;
+        ds_config["__shared_block_cache_name__"] = cache_name.str();
+        if (leveldb_cfg.isMember("shared_block_cache_size"))
+            ds_config["__shared_block_cache_size__"]
+                = leveldb_cfg["shared_block_cache_size"];
+    }
+    /* rocksdb databases, including the back tier of forward databases, are
+     * column families of instances configured at the provider level */
+    if (config->db_type == KVDB_ROCKSDB
+        && provider->json_cfg.isMember("rocksdb"))
+        ds_config["__instance_options__"] = provider->json_cfg["rocksdb"];
+    if (config->db_type == KVDB_FORWARDDB
+        && provider->json_cfg.isMember("rocksdb")
+        && (ds_config["backend"] == "rocksdb"
+            || ds_config["backend"] == "rdb"))
+        ds_config["backend_config"]["__instance_options__"]
+            = provider->json_cfg["rocksdb"];
+
+    /* backends whose files depend on the comparison function get it
+     * before they are opened */
+    auto db = datastore_factory::open_datastore(
+        config->db_type, std::string(config->db_name),
+        std::string(config->db_path), ds_config,
+        comp_fn ? std::string(config->db_comp_fn_name) : std::string(),
+        comp_fn);
     if (db == nullptr) {
         SDSKV_LOG_ERROR(provider->mid,
                         "factory failed to create datastore \"%s\"",
                         config->db_name);
         return SDSKV_ERR_DB_CREATE;
     }
+    /* writes are sent to the backups of the database, if any, in the order
+     * they are made */
+    std::shared_ptr<DatabaseReplicas> replicas;
+    if (provider->replication.enabled()) {
+        replicas = std::make_shared<DatabaseReplicas>(provider->replication);
+        auto replicated = new WatchedDataStore(db, replicas, true);
+        replicas->set_database(replicated);
+        db = replicated;
+    }
+    /* writes are reported to the watches of the database, if any */
+    std::shared_ptr<DatabaseWatches> watches;
+    if (provider->watches.enabled()) {
+        watches = std::make_shared<DatabaseWatches>(provider->watches, comp_fn);
+        db      = new WatchedDataStore(db, watches);
+    }
     if (comp_fn) {
         db->set_comparison_function(config->db_comp_fn_name, comp_fn);
+        auto it = provider->shorteningfunctions.find(config->db_comp_fn_name);
+        if (it != provider->shorteningfunctions.end()) {
+            db->set_key_shortening_functions(it->second.first,
+                                             it->second.second);
+        }
     }
     sdskv_database_id_t id = (sdskv_database_id_t)(db);
     if (config->db_no_overwrite) { db->set_no_overwrite(); }
@@ -674,6 +1602,12 @@ extern "C" int sdskv_provider_attach_database(sdskv_provider_t      provider,
     provider->name2id[std::string(config->db_name)] = id;
     provider->id2name[id]   = std::string(config->db_name);
     provider->databases[id] = db;
+    provider->stats.add_database(id);
+    if (provider->hot_keys_config.enabled)
+        provider->hot_keys[id]
+            = std::make_shared<HotKeyTracker>(provider->hot_keys_config);
+    if (watches) provider->watches.add_database(id, watches);
+    if (replicas) provider->replication.add_database(id, replicas);
     ABT_rwlock_unlock(provider->lock);
 
     *db_id = id;
@@ -682,12 +1616,16 @@ extern "C" int sdskv_provider_attach_database(sdskv_provider_t      provider,
                 "Successfully opened database \"%s\" with id %lu",
                 config->db_name, id);
 
+    if (ds_config.isMember("ttl")) return start_expiration_reclaimer(provider);
     return SDSKV_SUCCESS;
 }
 
 extern "C" int sdskv_provider_remove_database(sdskv_provider_t    provider,
                                               sdskv_database_id_t db_id)
 {
+    /* the ULTs sending the changes to the backups are waited for without
+     * the lock, which a backup managed by this provider needs */
+    provider->replication.remove_database(db_id);
     ABT_rwlock_wrlock(provider->lock);
     auto r = at_exit([provider]() { ABT_rwlock_unlock(provider->lock); });
     if (provider->databases.count(db_id)) {
@@ -697,6 +1635,9 @@ extern "C" int sdskv_provider_remove_database(sdskv_provider_t    provider,
         auto db = provider->databases[db_id];
         delete db;
         provider->databases.erase(db_id);
+        provider->stats.remove_database(db_id);
+        provider->hot_keys.erase(db_id);
+        provider->watches.remove_database(db_id);
         margo_trace(provider->mid,
                     "Successfully removed database %lu from provider", db_id);
         return SDSKV_SUCCESS;
@@ -709,9 +1650,15 @@ extern "C" int sdskv_provider_remove_database(sdskv_provider_t    provider,
 
 extern "C" int sdskv_provider_remove_all_databases(sdskv_provider_t provider)
 {
+    provider->replication.remove_all_databases();
     ABT_rwlock_wrlock(provider->lock);
-    for (auto db : provider->databases) { delete db.second; }
+    for (auto db : provider->databases) {
+        provider->watches.remove_database(db.first);
+        delete db.second;
+        provider->stats.remove_database(db.first);
+    }
     provider->databases.clear();
+    provider->hot_keys.clear();
     provider->name2id.clear();
     provider->id2name.clear();
     ABT_rwlock_unlock(provider->lock);
@@ -719,6 +1666,33 @@ extern "C" int sdskv_provider_remove_all_databases(sdskv_provider_t provider)
     return SDSKV_SUCCESS;
 }
 
+extern "C" int sdskv_provider_add_backup(sdskv_provider_t    provider,
+                                         sdskv_database_id_t db_id,
+                                         const char*         backup_addr,
+                                         uint16_t            backup_provider_id,
+                                         sdskv_database_id_t backup_db_id,
+                                         int                 sync)
+{
+    if (!provider->replication.enabled()) return SDSKV_OP_NOT_IMPL;
+    int ret = provider->replication.add_backup(
+        db_id, backup_addr, backup_provider_id, backup_db_id, sync);
+    if (ret == SDSKV_ERR_UNKNOWN_DB)
+        SDSKV_LOG_ERROR(provider->mid, "could not find database with id %lu",
+                        db_id);
+    return ret;
+}
+
+extern "C" int sdskv_provider_remove_backup(sdskv_provider_t    provider,
+                                            sdskv_database_id_t db_id,
+                                            const char*         backup_addr,
+                                            uint16_t backup_provider_id,
+                                            sdskv_database_id_t backup_db_id)
+{
+    if (!provider->replication.enabled()) return SDSKV_OP_NOT_IMPL;
+    return provider->replication.remove_backup(
+        db_id, backup_addr, backup_provider_id, backup_db_id);
+}
+
 extern "C" int sdskv_provider_count_databases(sdskv_provider_t provider,
                                               uint64_t*        num_db)
 {
@@ -890,14 +1864,44 @@ static void sdskv_put_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_PUT);
+
+    if (hot_keys) hot_keys->record(in.key.data, in.key.size);
+    timer.key(in.key.data, in.key.size);
 
     ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
     ds_bulk_t vdata(in.value.data, in.value.data + in.value.size);
 
-    out.ret = db->put(kdata, vdata);
+    timer.add_bytes_in(in.key.size + in.value.size);
+    out.ret = TIMED_BACKEND(db->put(kdata, vdata));
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_put_ult)
 
+/* accounted for as a put in the statistics */
+static void sdskv_put_ttl_ult(hg_handle_t handle)
+{
+    hg_return_t   hret;
+    put_ttl_in_t  in;
+    put_ttl_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_PUT);
+
+    if (hot_keys) hot_keys->record(in.key.data, in.key.size);
+    timer.key(in.key.data, in.key.size);
+
+    timer.add_bytes_in(in.key.size + in.value.size);
+    out.ret = TIMED_BACKEND(db->put_ttl(in.key.data, in.key.size,
+                                        in.value.data, in.value.size,
+                                        in.ttl_ms));
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_put_ttl_ult)
+
 static void sdskv_put_multi_ult(hg_handle_t handle)
 {
     hg_return_t     hret;
@@ -915,6 +1919,7 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_PUT_MULTI);
 
     // allocate a buffer to receive the keys and a buffer to receive the values
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -945,7 +1950,7 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
     DEFER(margo_bulk_free_local_vals, margo_bulk_free(local_vals_bulk_handle));
 
     /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -955,7 +1960,7 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
     }
 
     /* transfer values */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.vals_bulk_handle, 0, local_vals_bulk_handle,
                                0, in.vals_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -978,11 +1983,13 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
         kptrs[i] = local_keys_buffer.data() + keys_offset;
         vptrs[i] = val_sizes[i] == 0 ? nullptr
                                      : local_vals_buffer.data() + vals_offset;
+        if (hot_keys) hot_keys->record(kptrs[i], key_sizes[i]);
+        timer.key(kptrs[i], key_sizes[i]);
         keys_offset += key_sizes[i];
         vals_offset += val_sizes[i];
     }
-    out.ret = db->put_multi(in.num_keys, kptrs.data(), key_sizes, vptrs.data(),
-                            val_sizes);
+    out.ret = TIMED_BACKEND(db->put_multi(in.num_keys, kptrs.data(), key_sizes,
+                                          vptrs.data(), val_sizes));
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_put_multi_ult)
 
@@ -1002,6 +2009,7 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_PUT_PACKED);
 
     // find out the address of the origin
     if (in.origin_addr != NULL) {
@@ -1039,7 +2047,7 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     DEFER(margo_bulk_free, margo_bulk_free(local_bulk_handle));
 
     /* transfer data */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr, in.bulk_handle,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, origin_addr, in.bulk_handle,
                                0, local_bulk_handle, 0, in.bulk_size);
     if (hret != HG_SUCCESS) {
         SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)", hret);
@@ -1047,7 +2055,28 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
         return;
     }
 
-    /* interpret buffer as a list of key sizes */
+    /* decompress the payload if the client compressed it, the size it
+     * claims being bounded before it is allocated */
+    if (in.compression != SDSKV_COMPRESSION_NONE) {
+        if (in.raw_size > provider->bulk_max_packed_size) {
+            SDSKV_LOG_ERROR(mid, "decompressed payload too large (%lu bytes)",
+                            in.raw_size);
+            out.ret = SDSKV_ERR_SIZE;
+            return;
+        }
+        std::vector<char> raw_buffer(in.raw_size);
+        out.ret = sdskv_decompress((sdskv_compression_t)in.compression,
+                                   local_buffer.data(), in.bulk_size,
+                                   raw_buffer.data(), in.raw_size);
+        if (out.ret != SDSKV_SUCCESS) {
+            SDSKV_LOG_ERROR(mid, "failed to decompress payload (codec %d)",
+                            in.compression);
+            return;
+        }
+        local_buffer.swap(raw_buffer);
+    }
+
+    /* interpret buffer as a list of key sizes */
     hg_size_t* key_sizes = (hg_size_t*)local_buffer.data();
     /* interpret buffer as a list of value sizes */
     hg_size_t* val_sizes = key_sizes + in.num_keys;
@@ -1055,13 +2084,17 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     char* packed_keys = (char*)(val_sizes + in.num_keys);
     /* compute the size of part of the buffer that contain keys */
     size_t k = 0;
-    for (unsigned i = 0; i < in.num_keys; i++) k += key_sizes[i];
+    for (unsigned i = 0; i < in.num_keys; i++) {
+        if (hot_keys) hot_keys->record(packed_keys + k, key_sizes[i]);
+        timer.key(packed_keys + k, key_sizes[i]);
+        k += key_sizes[i];
+    }
     /* interpret the rest of the buffer as list of values */
     char* packed_vals = packed_keys + k;
 
     /* insert key/vals into the DB */
-    out.ret = db->put_packed(in.num_keys, packed_keys, key_sizes, packed_vals,
-                             val_sizes);
+    out.ret = TIMED_BACKEND(db->put_packed(in.num_keys, packed_keys, key_sizes,
+                                           packed_vals, val_sizes));
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_put_packed_ult)
 
@@ -1077,11 +2110,13 @@ static void sdskv_length_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_LENGTH);
+    timer.key(in.key.data, in.key.size);
 
     ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
 
     size_t vsize;
-    if (db->length(kdata, &vsize)) {
+    if (TIMED_BACKEND(db->length(kdata, &vsize))) {
         out.size = vsize;
         out.ret  = SDSKV_SUCCESS;
     } else {
@@ -1096,8 +2131,9 @@ static void sdskv_get_ult(hg_handle_t handle)
     hg_return_t hret;
     get_in_t    in;
     get_out_t   out;
-    ds_bulk_t   kdata;
-    ds_bulk_t   vdata;
+    /* the value is copied out of the backend, so that the response is sent
+     * once the backend has released it (e.g. LMDB's read transaction) */
+    ds_bulk_t value;
 
     memset(&out, 0, sizeof(out));
 
@@ -1107,27 +2143,28 @@ static void sdskv_get_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
-
-    kdata = ds_bulk_t(in.key.data, in.key.data + in.key.size);
-
-    if (db->get(kdata, vdata)) {
-        if (vdata.size() <= in.vsize) {
-            out.vsize      = vdata.size();
-            out.value.size = vdata.size();
-            out.value.data = vdata.data();
-            out.ret        = SDSKV_SUCCESS;
-        } else {
-            out.vsize      = vdata.size();
-            out.value.size = 0;
-            out.value.data = nullptr;
-            out.ret        = SDSKV_ERR_SIZE;
-        }
+    TRACK_RPC(SDSKV_STAT_GET);
+
+    if (hot_keys) hot_keys->record(in.key.data, in.key.size);
+    timer.key(in.key.data, in.key.size);
+
+    auto found = TIMED_BACKEND(db->get_view(
+        in.key.data, in.key.size, [&](const void* data, hg_size_t vsize) {
+            out.vsize = vsize;
+            if (vsize <= in.vsize)
+                value.assign((const char*)data, (const char*)data + vsize);
+        }));
+    if (!found) {
+        out.vsize = 0;
+        out.ret   = SDSKV_ERR_UNKNOWN_KEY;
+    } else if (out.vsize > in.vsize) {
+        out.ret = SDSKV_ERR_SIZE;
     } else {
-        out.vsize      = 0;
-        out.value.size = 0;
-        out.value.data = nullptr;
-        out.ret        = SDSKV_ERR_UNKNOWN_KEY;
+        out.value.size = value.size();
+        out.value.data = value.data();
+        out.ret        = SDSKV_SUCCESS;
     }
+    timer.add_bytes_out(out.value.size);
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_get_ult)
 
@@ -1149,6 +2186,7 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_GET_MULTI);
 
     /* allocate buffers to receive the keys */
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -1181,7 +2219,7 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
     DEFER(margo_bulk_free_local_valss, margo_bulk_free(local_vals_bulk_handle));
 
     /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1192,7 +2230,7 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
 
     /* transfer sizes allocated by user for the values (beginning of value
      * segment) */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.vals_bulk_handle, 0, local_vals_bulk_handle,
                                0, in.num_keys * sizeof(hg_size_t));
     if (hret != HG_SUCCESS) {
@@ -1212,28 +2250,34 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
     char* packed_values
         = local_vals_buffer.data() + in.num_keys * sizeof(hg_size_t);
 
-    /* go through the key/value pairs and get the values from the database */
+    /* get the values from the database; they are copied straight from the
+     * backend into the buffer sent back to the client when the backend
+     * allows it */
+    std::vector<const void*> keys(in.num_keys);
     for (unsigned i = 0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys + key_sizes[i]);
-        ds_bulk_t vdata;
-        size_t    client_allocated_value_size = val_sizes[i];
-        if (db->get(kdata, vdata)) {
-            size_t old_vsize = val_sizes[i];
-            if (vdata.size() > val_sizes[i]) {
+        keys[i] = packed_keys;
+        if (hot_keys) hot_keys->record(keys[i], key_sizes[i]);
+        timer.key(keys[i], key_sizes[i]);
+        packed_keys += key_sizes[i];
+    }
+    hg_size_t next = 0; /* keys before next have been handled */
+    TIMED_BACKEND(db->get_multi_view(
+        in.num_keys, keys.data(), key_sizes,
+        [&](hg_size_t i, const void* value, hg_size_t vsize) {
+            for (; next < i; next++) val_sizes[next] = 0; /* not found */
+            if (vsize > val_sizes[i]) {
                 val_sizes[i] = 0;
             } else {
-                val_sizes[i] = vdata.size();
-                memcpy(packed_values, vdata.data(), val_sizes[i]);
+                val_sizes[i] = vsize;
+                memcpy(packed_values, value, vsize);
             }
-        } else {
-            val_sizes[i] = 0;
-        }
-        packed_keys += key_sizes[i];
-        packed_values += val_sizes[i];
-    }
+            packed_values += val_sizes[i];
+            next = i + 1;
+        }));
+    for (; next < in.num_keys; next++) val_sizes[next] = 0;
 
     /* do a PUSH operation to push back the values to the client */
-    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PUSH, info->addr,
                                in.vals_bulk_handle, 0, local_vals_bulk_handle,
                                0, in.vals_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1250,8 +2294,11 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     hg_return_t      hret;
     get_packed_in_t  in;
     get_packed_out_t out;
-    out.ret      = SDSKV_SUCCESS;
-    out.num_keys = 0;
+    out.ret             = SDSKV_SUCCESS;
+    out.num_keys        = 0;
+    out.compression     = SDSKV_COMPRESSION_NONE;
+    out.compressed_size = 0;
+    out.raw_size        = 0;
     std::vector<char> local_keys_buffer;
     std::vector<char> local_vals_buffer;
     hg_bulk_t         local_keys_bulk_handle;
@@ -1263,6 +2310,7 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_GET_PACKED);
 
     /* allocate buffers to receive the keys */
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -1295,7 +2343,7 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     DEFER(margo_bulk_free_local_vals, margo_bulk_free(local_vals_bulk_handle));
 
     /* transfer keys and key sizes */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1322,12 +2370,14 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     for (unsigned i = 0; i < in.num_keys; i++) {
         ds_bulk_t kdata(packed_keys, packed_keys + key_sizes[i]);
         ds_bulk_t vdata;
+        if (hot_keys) hot_keys->record(kdata.data(), kdata.size());
+        timer.key(kdata.data(), kdata.size());
         if (available_client_memory == 0) {
             val_sizes[i] = 0;
             out.ret      = SDSKV_ERR_SIZE;
             continue;
         }
-        if (db->get(kdata, vdata)) {
+        if (TIMED_BACKEND(db->get(kdata, vdata))) {
             if (vdata.size() > available_client_memory) {
                 available_client_memory = 0;
                 out.ret                 = SDSKV_ERR_SIZE;
@@ -1344,13 +2394,35 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
         packed_keys += key_sizes[i];
     }
 
+    /* compress the value sizes and values if the client asked for it, and
+     * send only the compressed bytes if they are fewer */
+    hg_size_t           push_size = in.vals_bulk_size;
+    hg_size_t           raw_size  = packed_values - local_vals_buffer.data();
+    sdskv_compression_t codec     = (sdskv_compression_t)in.compression;
+    if (codec != SDSKV_COMPRESSION_NONE
+        && raw_size >= SDSKV_COMPRESSION_MIN_SIZE
+        && sdskv_compression_supported(codec)) {
+        std::vector<char> compressed(sdskv_compression_bound(codec, raw_size));
+        hg_size_t csize = sdskv_compress(codec, local_vals_buffer.data(),
+                                         raw_size, compressed.data(),
+                                         compressed.size());
+        if (csize) {
+            memcpy(local_vals_buffer.data(), compressed.data(), csize);
+            push_size           = csize;
+            out.compression     = codec;
+            out.compressed_size = csize;
+            out.raw_size        = raw_size;
+        }
+    }
+
     /* do a PUSH operation to push back the values to the client */
-    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PUSH, info->addr,
                                in.vals_bulk_handle, 0, local_vals_bulk_handle,
-                               0, in.vals_bulk_size);
+                               0, push_size);
     if (hret != HG_SUCCESS) {
         SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)", hret);
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        out.ret         = SDSKV_MAKE_HG_ERROR(hret);
+        out.compression = SDSKV_COMPRESSION_NONE;
         return;
     }
 }
@@ -1374,6 +2446,7 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_LENGTH_MULTI);
 
     /* allocate buffers to receive the keys */
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -1409,7 +2482,7 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
           margo_bulk_free(local_vals_size_bulk_handle));
 
     /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1428,7 +2501,7 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     for (unsigned i = 0; i < in.num_keys; i++) {
         ds_bulk_t kdata(packed_keys, packed_keys + key_sizes[i]);
         size_t    vsize;
-        if (db->length(kdata, &vsize)) {
+        if (TIMED_BACKEND(db->length(kdata, &vsize))) {
             local_vals_size_buffer[i] = vsize;
         } else {
             local_vals_size_buffer[i] = 0;
@@ -1437,7 +2510,7 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     }
 
     /* do a PUSH operation to push back the value sizes to the client */
-    hret = margo_bulk_transfer(
+    hret = timer.bulk_transfer(
         mid, HG_BULK_PUSH, info->addr, in.vals_size_bulk_handle, 0,
         local_vals_size_bulk_handle, 0, local_vals_size_buffer_size);
     if (hret != HG_SUCCESS) {
@@ -1466,6 +2539,7 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_EXISTS_MULTI);
 
     /* allocate buffers to receive the keys */
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -1502,7 +2576,7 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
           margo_bulk_free(local_flags_bulk_handle));
 
     /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1522,7 +2596,7 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     for (unsigned i = 0; i < in.num_keys; i++) {
         auto current_key   = packed_keys;
         auto current_ksize = key_sizes[i];
-        if (db->exists(current_key, current_ksize)) {
+        if (TIMED_BACKEND(db->exists(current_key, current_ksize))) {
             local_flags_buffer[i / 8] |= mask;
         }
         mask = mask << 1;
@@ -1531,7 +2605,7 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     }
 
     /* do a PUSH operation to push back the value sizes to the client */
-    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PUSH, info->addr,
                                in.flags_bulk_handle, 0, local_flags_bulk_handle,
                                0, local_flags_buffer_size);
     if (hret != HG_SUCCESS) {
@@ -1560,6 +2634,7 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_LENGTH_PACKED);
 
     /* allocate buffers to receive the keys and key sizes*/
     local_keys_buffer.resize(in.in_bulk_size);
@@ -1595,7 +2670,7 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
           margo_bulk_free(local_vals_size_bulk_handle));
 
     /* transfer keys and ksizes */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.in_bulk_handle,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr, in.in_bulk_handle,
                                0, local_keys_bulk_handle, 0, in.in_bulk_size);
     if (hret != HG_SUCCESS) {
         SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)", hret);
@@ -1613,7 +2688,7 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     for (unsigned i = 0; i < in.num_keys; i++) {
         ds_bulk_t kdata(packed_keys, packed_keys + key_sizes[i]);
         size_t    vsize;
-        if (db->length(kdata, &vsize)) {
+        if (TIMED_BACKEND(db->length(kdata, &vsize))) {
             local_vals_size_buffer[i] = vsize;
         } else {
             local_vals_size_buffer[i] = 0;
@@ -1622,7 +2697,7 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     }
 
     /* do a PUSH operation to push back the value sizes to the client */
-    hret = margo_bulk_transfer(
+    hret = timer.bulk_transfer(
         mid, HG_BULK_PUSH, info->addr, in.out_bulk_handle, 0,
         local_vals_size_bulk_handle, 0, local_vals_size_buffer_size);
     if (hret != HG_SUCCESS) {
@@ -1633,6 +2708,173 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_length_packed_ult)
 
+/* Ring of local chunk buffers used to transfer a large value to or from a
+ * remote bulk handle, chunk_size bytes at a time. Each buffer has at most
+ * one transfer in flight, so up to depth transfers overlap each other and
+ * the processing of the chunks by the backend. */
+struct bulk_pipeline {
+    margo_instance_id          mid;
+    hg_bulk_op_t               op;
+    hg_addr_t                  addr;
+    hg_bulk_t                  remote;
+    hg_size_t                  chunk_size;
+    std::vector<ds_bulk_t>     buffers;
+    std::vector<hg_bulk_t>     handles;
+    std::vector<margo_request> requests;
+    RpcTimer&                  timer;
+    hg_return_t                hret = HG_SUCCESS;
+
+    bulk_pipeline(margo_instance_id m,
+                  hg_bulk_op_t      o,
+                  hg_addr_t         a,
+                  hg_bulk_t         r,
+                  hg_size_t         csize,
+                  unsigned          depth,
+                  RpcTimer&         t)
+        : mid(m), op(o), addr(a), remote(r), chunk_size(csize),
+          buffers(depth), handles(depth, HG_BULK_NULL),
+          requests(depth, MARGO_REQUEST_NULL), timer(t)
+    {
+        for (unsigned i = 0; i < depth && hret == HG_SUCCESS; i++) {
+            buffers[i].resize(chunk_size);
+            void*     ptr  = buffers[i].data();
+            hg_size_t size = chunk_size;
+            hret = margo_bulk_create(mid, 1, &ptr, &size, HG_BULK_READWRITE,
+                                     &handles[i]);
+        }
+    }
+
+    ~bulk_pipeline()
+    {
+        for (unsigned i = 0; i < handles.size(); i++) {
+            wait(i);
+            if (handles[i] != HG_BULK_NULL) margo_bulk_free(handles[i]);
+        }
+    }
+
+    /* transfers size bytes at offset in the remote buffer using the buffer
+     * of the given slot, which must not have a transfer in flight */
+    void start(unsigned slot, hg_size_t offset, hg_size_t size)
+    {
+        if (hret != HG_SUCCESS) return;
+        hret = margo_bulk_itransfer(mid, op, addr, remote, offset,
+                                    handles[slot], 0, size, &requests[slot]);
+        if (hret != HG_SUCCESS) return;
+        if (op == HG_BULK_PULL)
+            timer.add_bytes_in(size);
+        else
+            timer.add_bytes_out(size);
+    }
+
+    /* waits for the transfer of the given slot, if any */
+    bool wait(unsigned slot)
+    {
+        if (requests[slot] != MARGO_REQUEST_NULL) {
+            hg_return_t r  = timer.bulk_wait(requests[slot]);
+            requests[slot] = MARGO_REQUEST_NULL;
+            if (hret == HG_SUCCESS) hret = r;
+        }
+        return hret == HG_SUCCESS;
+    }
+};
+
+/* pulls the value chunk by chunk, the next chunks being pulled while the
+ * backend stores the current one */
+static int pipelined_bulk_put(sdskv_provider_t     provider,
+                              AbstractDataStore*   db,
+                              const ds_bulk_t&     key,
+                              const bulk_put_in_t& in,
+                              hg_addr_t            addr,
+                              RpcTimer&            timer)
+{
+    hg_size_t     chunk_size = provider->bulk_chunk_size;
+    unsigned      depth      = provider->bulk_pipeline_depth;
+    bulk_pipeline pipeline(provider->mid, HG_BULK_PULL, addr, in.handle,
+                           chunk_size, depth, timer);
+    hg_size_t     num_chunks = (in.vsize + chunk_size - 1) / chunk_size;
+    auto          chunk_len  = [&](hg_size_t i) {
+        return std::min(chunk_size, in.vsize - i * chunk_size);
+    };
+
+    for (hg_size_t i = 0; i < std::min<hg_size_t>(depth, num_chunks); i++)
+        pipeline.start(i, i * chunk_size, chunk_len(i));
+
+    hg_size_t next_chunk = 0;
+    auto      next       = [&](hg_size_t& size) -> const void* {
+        hg_size_t i = next_chunk++;
+        /* the previous chunk has been consumed, its buffer can be reused */
+        if (i > 0 && i - 1 + depth < num_chunks)
+            pipeline.start((i - 1) % depth, (i - 1 + depth) * chunk_size,
+                           chunk_len(i - 1 + depth));
+        if (i >= num_chunks || !pipeline.wait(i % depth)) return nullptr;
+        size = chunk_len(i);
+        return pipeline.buffers[i % depth].data();
+    };
+
+    int ret = db->put_stream(key, in.vsize, next);
+    for (unsigned i = 0; i < depth; i++) pipeline.wait(i);
+    if (pipeline.hret != HG_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "failed to issue bulk transfer (hret = %d)",
+                        pipeline.hret);
+        return SDSKV_MAKE_HG_ERROR(pipeline.hret);
+    }
+    return ret;
+}
+
+/* pushes the value chunk by chunk as the backend reads it; vsize is set to
+ * the size of the value */
+static int pipelined_bulk_get(sdskv_provider_t     provider,
+                              AbstractDataStore*   db,
+                              const bulk_get_in_t& in,
+                              hg_addr_t            addr,
+                              hg_size_t*           vsize,
+                              RpcTimer&            timer)
+{
+    hg_size_t     chunk_size = provider->bulk_chunk_size;
+    unsigned      depth      = provider->bulk_pipeline_depth;
+    bulk_pipeline pipeline(provider->mid, HG_BULK_PUSH, addr, in.handle,
+                           chunk_size, depth, timer);
+    if (pipeline.hret != HG_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "failed to create bulk handle (hret = %d)",
+                        pipeline.hret);
+        return SDSKV_MAKE_HG_ERROR(pipeline.hret);
+    }
+
+    int       ret    = SDSKV_SUCCESS;
+    hg_size_t offset = 0;
+    hg_size_t chunk  = 0;
+    auto sink = [&](hg_size_t total, const void* data, hg_size_t size) {
+        *vsize = total;
+        if (total > in.vsize) {
+            ret = SDSKV_ERR_SIZE;
+            return false;
+        }
+        /* the chunk is copied once the buffer's previous push is done */
+        unsigned slot = chunk++ % depth;
+        if (!pipeline.wait(slot)) return false;
+        if (size) {
+            std::memcpy(pipeline.buffers[slot].data(), data, size);
+            pipeline.start(slot, offset, size);
+        }
+        offset += size;
+        return true;
+    };
+
+    bool found = db->get_stream(in.key.data, in.key.size, chunk_size, sink);
+    for (unsigned i = 0; i < depth; i++) pipeline.wait(i);
+    if (!found) return SDSKV_ERR_UNKNOWN_KEY;
+    if (pipeline.hret != HG_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "failed to issue bulk transfer (hret = %d)",
+                        pipeline.hret);
+        return SDSKV_MAKE_HG_ERROR(pipeline.hret);
+    }
+    if (ret == SDSKV_SUCCESS && offset != *vsize) return SDSKV_ERR_READ;
+    return ret;
+}
+
 static void sdskv_bulk_put_ult(hg_handle_t handle)
 {
 
@@ -1647,6 +2889,31 @@ static void sdskv_bulk_put_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_BULK_PUT);
+
+    if (hot_keys) hot_keys->record(in.key.data, in.key.size);
+    timer.key(in.key.data, in.key.size);
+
+    ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
+
+    /* the size and offset come from the client: the value, chunked or not,
+     * and the end of a partial put must neither wrap around nor exceed the
+     * largest value allowed, since backends allocate the value up front */
+    hg_size_t max_size = provider->bulk_max_value_size;
+    if (in.vsize > max_size
+        || (in.partial
+            && (in.offset > SIZE_MAX - in.vsize
+                || in.offset + in.vsize > max_size))) {
+        out.ret = SDSKV_ERR_SIZE;
+        return;
+    }
+
+    if (!in.partial && provider->bulk_chunk_size
+        && in.vsize > provider->bulk_chunk_size) {
+        out.ret
+            = pipelined_bulk_put(provider, db, kdata, in, info->addr, timer);
+        return;
+    }
 
     ds_bulk_t vdata(in.vsize);
 
@@ -1664,7 +2931,7 @@ static void sdskv_bulk_put_ult(hg_handle_t handle)
         }
         DEFER(margo_bulk_free, margo_bulk_free(bulk_handle));
 
-        hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.handle, 0,
+        hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr, in.handle, 0,
                                    bulk_handle, 0, vdata.size());
         if (hret != HG_SUCCESS) {
             SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)",
@@ -1674,9 +2941,12 @@ static void sdskv_bulk_put_ult(hg_handle_t handle)
         }
     }
 
-    ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
-
-    out.ret = db->put(kdata, vdata);
+    /* partial puts write the value at in.offset in the stored value */
+    if (in.partial)
+        out.ret = TIMED_BACKEND(
+            db->put_range(kdata, in.offset, vdata.data(), vdata.size()));
+    else
+        out.ret = TIMED_BACKEND(db->put(kdata, vdata));
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_bulk_put_ult)
 
@@ -1696,11 +2966,55 @@ static void sdskv_bulk_get_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_BULK_GET);
+
+    if (hot_keys) hot_keys->record(in.key.data, in.key.size);
+    timer.key(in.key.data, in.key.size);
+
+    /* partial gets only transfer (and read, if the backend allows it) the
+     * in.vsize bytes starting at in.offset */
+    if (in.partial) {
+        out.ret = SDSKV_ERR_UNKNOWN_KEY;
+        db->get_range_view(
+            in.key.data, in.key.size, in.offset, in.vsize,
+            [&](const void* value, hg_size_t vsize) {
+                out.ret = SDSKV_SUCCESS;
+                if (vsize == 0) return;
+                void* buffer = (void*)value;
+                hret = margo_bulk_create(mid, 1, (void**)&buffer, &vsize,
+                                         HG_BULK_READ_ONLY, &bulk_handle);
+                if (hret != HG_SUCCESS) {
+                    SDSKV_LOG_ERROR(mid,
+                                    "failed to create bulk handle (hret = %d)",
+                                    hret);
+                    out.ret = SDSKV_MAKE_HG_ERROR(hret);
+                    return;
+                }
+                hret = timer.bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+                                           in.handle, 0, bulk_handle, 0, vsize);
+                margo_bulk_free(bulk_handle);
+                if (hret != HG_SUCCESS) {
+                    SDSKV_LOG_ERROR(mid,
+                                    "failed to issue bulk transfer (hret = %d)",
+                                    hret);
+                    out.ret = SDSKV_MAKE_HG_ERROR(hret);
+                    return;
+                }
+                out.vsize = vsize;
+            });
+        return;
+    }
+
+    if (provider->bulk_chunk_size && in.vsize > provider->bulk_chunk_size) {
+        out.ret = pipelined_bulk_get(provider, db, in, info->addr, &out.vsize,
+                                     timer);
+        return;
+    }
 
     ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
 
     ds_bulk_t vdata;
-    auto      b = db->get(kdata, vdata);
+    auto      b = TIMED_BACKEND(db->get(kdata, vdata));
 
     if (!b) {
         out.vsize = 0;
@@ -1728,7 +3042,7 @@ static void sdskv_bulk_get_ult(hg_handle_t handle)
         }
         DEFER(margo_bulk_free, margo_bulk_free(bulk_handle));
 
-        hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.handle, 0,
+        hret = timer.bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.handle, 0,
                                    bulk_handle, 0, vdata.size());
         if (hret != HG_SUCCESS) {
             SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)",
@@ -1757,10 +3071,12 @@ static void sdskv_erase_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_ERASE);
+    timer.key(in.key.data, in.key.size);
 
     ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
 
-    if (db->erase(kdata)) {
+    if (TIMED_BACKEND(db->erase(kdata))) {
         out.ret = SDSKV_SUCCESS;
     } else {
         out.ret = SDSKV_ERR_ERASE;
@@ -1784,6 +3100,7 @@ static void sdskv_erase_multi_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_ERASE_MULTI);
 
     /* allocate buffers to receive the keys */
     local_keys_buffer.resize(in.keys_bulk_size);
@@ -1801,7 +3118,7 @@ static void sdskv_erase_multi_ult(hg_handle_t handle)
     DEFER(margo_bulk_free_local_keys, margo_bulk_free(local_keys_bulk_handle));
 
     /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, info->addr,
                                in.keys_bulk_handle, 0, local_keys_bulk_handle,
                                0, in.keys_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1819,12 +3136,208 @@ static void sdskv_erase_multi_ult(hg_handle_t handle)
     /* go through the key/value pairs and erase them */
     for (unsigned i = 0; i < in.num_keys; i++) {
         ds_bulk_t kdata(packed_keys, packed_keys + key_sizes[i]);
-        db->erase(kdata);
+        TIMED_BACKEND(db->erase(kdata));
         packed_keys += key_sizes[i];
     }
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_erase_multi_ult)
 
+static void sdskv_erase_range_ult(hg_handle_t handle)
+{
+
+    hg_return_t       hret;
+    erase_range_in_t  in;
+    erase_range_out_t out;
+    out.ret        = SDSKV_SUCCESS;
+    out.num_erased = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_ERASE_RANGE);
+
+    ds_bulk_t lower(in.lower.data, in.lower.data + in.lower.size);
+    ds_bulk_t upper(in.upper.data, in.upper.data + in.upper.size);
+
+    hg_size_t num_erased = 0;
+    out.ret        = TIMED_BACKEND(db->erase_range(lower, upper, &num_erased));
+    out.num_erased = num_erased;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_erase_range_ult)
+
+static void sdskv_erase_prefixed_ult(hg_handle_t handle)
+{
+
+    hg_return_t          hret;
+    erase_prefixed_in_t  in;
+    erase_prefixed_out_t out;
+    out.ret        = SDSKV_SUCCESS;
+    out.num_erased = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_ERASE_PREFIXED);
+
+    ds_bulk_t prefix(in.prefix.data, in.prefix.data + in.prefix.size);
+
+    hg_size_t num_erased = 0;
+    out.ret        = TIMED_BACKEND(db->erase_prefixed(prefix, &num_erased));
+    out.num_erased = num_erased;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_erase_prefixed_ult)
+
+static void sdskv_count_range_ult(hg_handle_t handle)
+{
+
+    hg_return_t       hret;
+    count_range_in_t  in;
+    count_range_out_t out;
+    out.ret         = SDSKV_SUCCESS;
+    out.num_keys    = 0;
+    out.key_bytes   = 0;
+    out.value_bytes = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_COUNT_RANGE);
+
+    ds_bulk_t lower(in.lower.data, in.lower.data + in.lower.size);
+    ds_bulk_t upper(in.upper.data, in.upper.data + in.upper.size);
+
+    ds_count_t count;
+    out.ret
+        = TIMED_BACKEND(db->count_range(lower, upper, in.with_sizes, count));
+    out.num_keys    = count.num_keys;
+    out.key_bytes   = count.key_bytes;
+    out.value_bytes = count.value_bytes;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_count_range_ult)
+
+static void sdskv_count_prefixed_ult(hg_handle_t handle)
+{
+
+    hg_return_t          hret;
+    count_prefixed_in_t  in;
+    count_prefixed_out_t out;
+    out.ret         = SDSKV_SUCCESS;
+    out.num_keys    = 0;
+    out.key_bytes   = 0;
+    out.value_bytes = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_COUNT_PREFIXED);
+
+    ds_bulk_t prefix(in.prefix.data, in.prefix.data + in.prefix.size);
+
+    ds_count_t count;
+    out.ret
+        = TIMED_BACKEND(db->count_prefixed(prefix, in.with_sizes, count));
+    out.num_keys    = count.num_keys;
+    out.key_bytes   = count.key_bytes;
+    out.value_bytes = count.value_bytes;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_count_prefixed_ult)
+
+static void sdskv_compare_and_swap_ult(hg_handle_t handle)
+{
+
+    hg_return_t            hret;
+    compare_and_swap_in_t  in;
+    compare_and_swap_out_t out;
+    out.ret     = SDSKV_SUCCESS;
+    out.swapped = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_COMPARE_AND_SWAP);
+    timer.key(in.key.data, in.key.size);
+
+    ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
+    ds_bulk_t expected(in.expected.data, in.expected.data + in.expected.size);
+    ds_bulk_t vdata(in.value.data, in.value.data + in.value.size);
+
+    bool swapped = false;
+    timer.add_bytes_in(in.key.size + in.expected.size + in.value.size);
+    out.ret = TIMED_BACKEND(db->compare_and_swap(
+        kdata, in.has_expected ? &expected : nullptr, vdata, &swapped));
+    out.swapped = swapped;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_compare_and_swap_ult)
+
+static void sdskv_fetch_add_ult(hg_handle_t handle)
+{
+
+    hg_return_t     hret;
+    fetch_add_in_t  in;
+    fetch_add_out_t out;
+    out.ret      = SDSKV_SUCCESS;
+    out.previous = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_FETCH_ADD);
+    timer.key(in.key.data, in.key.size);
+
+    ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
+
+    int64_t previous = 0;
+    out.ret      = TIMED_BACKEND(db->fetch_add(kdata, in.delta, &previous));
+    out.previous = previous;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_fetch_add_ult)
+
+static void sdskv_append_ult(hg_handle_t handle)
+{
+
+    hg_return_t  hret;
+    append_in_t  in;
+    append_out_t out;
+    out.ret      = SDSKV_SUCCESS;
+    out.new_size = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_APPEND);
+    timer.key(in.key.data, in.key.size);
+
+    ds_bulk_t kdata(in.key.data, in.key.data + in.key.size);
+
+    hg_size_t new_size = 0;
+    timer.add_bytes_in(in.key.size + in.data.size);
+    out.ret = TIMED_BACKEND(
+        db->append(kdata, in.data.data, in.data.size, &new_size));
+    out.new_size = new_size;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_append_ult)
+
 static void sdskv_exists_ult(hg_handle_t handle)
 {
 
@@ -1838,8 +3351,10 @@ static void sdskv_exists_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_EXISTS);
+    timer.key(in.key.data, in.key.size);
 
-    out.flag = db->exists(in.key.data, in.key.size) ? 1 : 0;
+    out.flag = TIMED_BACKEND(db->exists(in.key.data, in.key.size)) ? 1 : 0;
     out.ret  = SDSKV_SUCCESS;
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_exists_ult)
@@ -1862,6 +3377,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_LIST_KEYS);
 
     /* create a bulk handle to receive and send key sizes from client */
     std::vector<hg_size_t> ksizes(in.max_keys);
@@ -1879,7 +3395,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
 
     /* receive the key sizes from the client */
     hg_addr_t origin_addr = info->addr;
-    hret                  = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
+    hret                  = timer.bulk_transfer(mid, HG_BULK_PULL, origin_addr,
                                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0,
                                ksizes_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1895,7 +3411,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     ds_bulk_t start_kdata(in.start_key.data,
                           in.start_key.data + in.start_key.size);
     ds_bulk_t prefix(in.prefix.data, in.prefix.data + in.prefix.size);
-    auto      keys     = db->list_keys(start_kdata, in.max_keys, prefix);
+    auto keys = TIMED_BACKEND(db->list_keys(start_kdata, in.max_keys, prefix));
     hg_size_t num_keys = std::min((size_t)keys.size(), (size_t)in.max_keys);
 
     if (num_keys == 0) {
@@ -1920,7 +3436,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     out.nkeys = num_keys;
 
     /* transfer the ksizes back to the client */
-    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
                                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0,
                                ksizes_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -1959,7 +3475,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     for (unsigned i = 0; i < num_keys; i++) {
 
         if (true_ksizes[i] > 0) {
-            hret = margo_bulk_transfer(
+            hret = timer.bulk_transfer(
                 mid, HG_BULK_PUSH, origin_addr, in.keys_bulk_handle,
                 remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
             if (hret != HG_SUCCESS) {
@@ -1998,6 +3514,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     GET_INPUT;
     ENSURE_MARGO_FREE_INPUT;
     FIND_DATABASE;
+    TRACK_RPC(SDSKV_STAT_LIST_KEYVALS);
 
     /* create a bulk handle to receive and send key sizes from client */
     std::vector<hg_size_t> ksizes(in.max_keys);
@@ -2029,7 +3546,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
 
     /* receive the key sizes from the client */
     hg_addr_t origin_addr = info->addr;
-    hret                  = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
+    hret                  = timer.bulk_transfer(mid, HG_BULK_PULL, origin_addr,
                                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0,
                                ksizes_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -2039,7 +3556,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     }
 
     /* receive the values sizes from the client */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
+    hret = timer.bulk_transfer(mid, HG_BULK_PULL, origin_addr,
                                in.vsizes_bulk_handle, 0, vsizes_local_bulk, 0,
                                vsizes_bulk_size);
     if (hret != HG_SUCCESS) {
@@ -2056,7 +3573,8 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     ds_bulk_t start_kdata(in.start_key.data,
                           in.start_key.data + in.start_key.size);
     ds_bulk_t prefix(in.prefix.data, in.prefix.data + in.prefix.size);
-    auto      keyvals  = db->list_keyvals(start_kdata, in.max_keys, prefix);
+    auto keyvals
+        = TIMED_BACKEND(db->list_keyvals(start_kdata, in.max_keys, prefix));
     hg_size_t num_keys = std::min((size_t)keyvals.size(), (size_t)in.max_keys);
 
     out.nkeys = num_keys;
@@ -2099,7 +3617,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
 
     /* transfer the ksizes back to the client */
     if (ksizes_bulk_size) {
-        hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
+        hret = timer.bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
                                    in.ksizes_bulk_handle, 0, ksizes_local_bulk,
                                    0, ksizes_bulk_size);
         if (hret != HG_SUCCESS) {
@@ -2112,7 +3630,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
 
     /* transfer the vsizes back to the client */
     if (vsizes_bulk_size) {
-        hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
+        hret = timer.bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
                                    in.vsizes_bulk_handle, 0, vsizes_local_bulk,
                                    0, vsizes_bulk_size);
         if (hret != HG_SUCCESS) {
@@ -2165,7 +3683,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     /* transfer the keys to the client */
     for (unsigned i = 0; i < num_keys; i++) {
         if (true_ksizes[i] > 0) {
-            hret = margo_bulk_transfer(
+            hret = timer.bulk_transfer(
                 mid, HG_BULK_PUSH, origin_addr, in.keys_bulk_handle,
                 remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
             if (hret != HG_SUCCESS) {
@@ -2185,7 +3703,7 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     /* transfer the values to the client */
     for (unsigned i = 0; i < num_keys; i++) {
         if (true_vsizes[i] > 0) {
-            hret = margo_bulk_transfer(
+            hret = timer.bulk_transfer(
                 mid, HG_BULK_PUSH, origin_addr, in.vals_bulk_handle,
                 remote_offset, vals_local_bulk, local_offset, true_vsizes[i]);
             if (hret != HG_SUCCESS) {
@@ -2656,18 +4174,652 @@ static void sdskv_migrate_database_ult(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_migrate_database_ult)
 
+struct compaction_args {
+    AbstractDataStore* db;
+    ds_bulk_t          lower;
+    ds_bulk_t          upper;
+    int                ret;
+};
+
+static void compact_database_ult(void* arg)
+{
+    auto args = static_cast<compaction_args*>(arg);
+    args->ret = args->db->compact(args->lower, args->upper);
+}
+
+/* returns the pool of the provider's compaction execution stream,
+ * creating the execution stream if needed */
+static int get_compaction_pool(sdskv_provider_t provider, ABT_pool* pool)
+{
+    int ret = ABT_SUCCESS;
+    ABT_mutex_lock(provider->compaction_mutex);
+    if (provider->compaction_xstream == ABT_XSTREAM_NULL) {
+        ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC,
+                                    ABT_TRUE, &provider->compaction_pool);
+        if (ret == ABT_SUCCESS) {
+            ret = ABT_xstream_create_basic(
+                ABT_SCHED_DEFAULT, 1, &provider->compaction_pool,
+                ABT_SCHED_CONFIG_NULL, &provider->compaction_xstream);
+        }
+    }
+    *pool = provider->compaction_pool;
+    ABT_mutex_unlock(provider->compaction_mutex);
+    if (ret != ABT_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "could not create compaction execution stream");
+        return SDSKV_MAKE_ABT_ERROR(ret);
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* runs the compaction in the compaction execution stream and waits for it */
+static int run_compaction(sdskv_provider_t provider, compaction_args* args)
+{
+    ABT_pool pool;
+    int      ret = get_compaction_pool(provider, &pool);
+    if (ret != SDSKV_SUCCESS) return ret;
+
+    ABT_thread thread;
+    ret = ABT_thread_create(pool, compact_database_ult, args,
+                            ABT_THREAD_ATTR_NULL, &thread);
+    if (ret != ABT_SUCCESS) return SDSKV_MAKE_ABT_ERROR(ret);
+    ABT_thread_join(thread);
+    ABT_thread_free(&thread);
+    return args->ret;
+}
+
+/* waits until the provider is stopped or interval seconds have passed;
+ * the caller holds provider->compaction_mutex */
+static void wait_for_stop(sdskv_provider_t provider, double interval)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)interval;
+    deadline.tv_nsec += (long)((interval - (time_t)interval) * 1e9);
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+    }
+    ABT_cond_timedwait(provider->compaction_cond, provider->compaction_mutex,
+                       &deadline);
+}
+
+static void compaction_scheduler_ult(void* arg)
+{
+    sdskv_provider_t provider = (sdskv_provider_t)arg;
+    double           interval = provider->compaction_idle_interval;
+
+    ABT_mutex_lock(provider->compaction_mutex);
+    while (!provider->compaction_stop) {
+        wait_for_stop(provider, interval);
+        if (provider->compaction_stop) break;
+
+        double now  = ABT_get_wtime();
+        double last = provider->last_activity.load();
+        if (last <= provider->last_compaction || now - last < interval)
+            continue;
+        provider->last_compaction = now;
+        ABT_mutex_unlock(provider->compaction_mutex);
+
+        std::vector<sdskv_database_id_t> ids;
+        ABT_rwlock_rdlock(provider->lock);
+        for (const auto& p : provider->databases) ids.push_back(p.first);
+        ABT_rwlock_unlock(provider->lock);
+
+        /* like the compaction RPC, the provider's lock is only held to look
+         * up each database, so that RPCs that write-lock it are not held up
+         * for the duration of the compaction */
+        for (auto id : ids) {
+            AbstractDataStore* db = nullptr;
+            ABT_rwlock_rdlock(provider->lock);
+            auto it = provider->databases.find(id);
+            if (it != provider->databases.end()) db = it->second;
+            ABT_rwlock_unlock(provider->lock);
+            if (!db) continue;
+            int ret = db->compact(ds_bulk_t(), ds_bulk_t());
+            if (ret != SDSKV_SUCCESS && ret != SDSKV_OP_NOT_IMPL) {
+                SDSKV_LOG_ERROR(provider->mid,
+                                "idle compaction of database %lu failed", id);
+            }
+        }
+
+        ABT_mutex_lock(provider->compaction_mutex);
+    }
+    ABT_mutex_unlock(provider->compaction_mutex);
+}
+
+static int start_compaction_scheduler(sdskv_provider_t provider)
+{
+    if (provider->compaction_idle_interval <= 0) return SDSKV_SUCCESS;
+    ABT_pool pool;
+    int      ret = get_compaction_pool(provider, &pool);
+    if (ret != SDSKV_SUCCESS) return ret;
+    ret = ABT_thread_create(pool, compaction_scheduler_ult, provider,
+                            ABT_THREAD_ATTR_NULL,
+                            &provider->compaction_scheduler);
+    if (ret != ABT_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid, "could not start compaction scheduler");
+        return SDSKV_MAKE_ABT_ERROR(ret);
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* reclaims a batch of expired entries in each database, taking the
+ * provider's lock for one database at a time so that the RPCs that need
+ * to write-lock it are not held up; cursors maps the databases to the key
+ * their next batch starts after */
+static void
+reclaim_expired_entries(sdskv_provider_t                          provider,
+                        std::map<sdskv_database_id_t, ds_bulk_t>& cursors)
+{
+    std::map<sdskv_database_id_t, ds_bulk_t> active;
+    ABT_rwlock_rdlock(provider->lock);
+    for (const auto& p : provider->databases) active[p.first] = ds_bulk_t();
+    ABT_rwlock_unlock(provider->lock);
+
+    for (auto& p : active) {
+        auto c = cursors.find(p.first);
+        if (c != cursors.end()) p.second.swap(c->second);
+        hg_size_t num_erased = 0;
+        int       ret        = SDSKV_OP_NOT_IMPL;
+        ABT_rwlock_rdlock(provider->lock);
+        auto it = provider->databases.find(p.first);
+        if (it != provider->databases.end())
+            ret = it->second->reclaim_expired(
+                p.second, provider->expiration_batch_size, &num_erased);
+        ABT_rwlock_unlock(provider->lock);
+        if (ret != SDSKV_SUCCESS && ret != SDSKV_OP_NOT_IMPL) {
+            SDSKV_LOG_ERROR(provider->mid,
+                            "reclaiming expired entries of database %lu"
+                            " failed",
+                            p.first);
+        } else if (num_erased) {
+            margo_trace(provider->mid,
+                        "reclaimed %lu expired entries of database %lu",
+                        num_erased, p.first);
+        }
+        ABT_thread_yield();
+    }
+    /* drops the cursors of the databases that were removed */
+    cursors.swap(active);
+}
+
+static void expiration_reclaimer_ult(void* arg)
+{
+    sdskv_provider_t                         provider = (sdskv_provider_t)arg;
+    std::map<sdskv_database_id_t, ds_bulk_t> cursors;
+
+    ABT_mutex_lock(provider->compaction_mutex);
+    while (!provider->compaction_stop) {
+        wait_for_stop(provider, provider->expiration_interval);
+        if (provider->compaction_stop) break;
+        ABT_mutex_unlock(provider->compaction_mutex);
+        reclaim_expired_entries(provider, cursors);
+        ABT_mutex_lock(provider->compaction_mutex);
+    }
+    ABT_mutex_unlock(provider->compaction_mutex);
+}
+
+/* starts the expiration reclaimer unless it is already running */
+static int start_expiration_reclaimer(sdskv_provider_t provider)
+{
+    ABT_pool pool;
+    int      ret = get_compaction_pool(provider, &pool);
+    if (ret != SDSKV_SUCCESS) return ret;
+    ABT_mutex_lock(provider->compaction_mutex);
+    if (provider->expiration_reclaimer == ABT_THREAD_NULL
+        && !provider->compaction_stop)
+        ret = ABT_thread_create(pool, expiration_reclaimer_ult, provider,
+                                ABT_THREAD_ATTR_NULL,
+                                &provider->expiration_reclaimer);
+    ABT_mutex_unlock(provider->compaction_mutex);
+    if (ret != ABT_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid, "could not start expiration reclaimer");
+        return SDSKV_MAKE_ABT_ERROR(ret);
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* slow operations are written to their file at most this often, in
+ * seconds, and when the provider is finalized */
+static const double slow_ops_flush_interval = 1.0;
+
+static void slow_ops_flusher_ult(void* arg)
+{
+    sdskv_provider_t provider = (sdskv_provider_t)arg;
+
+    ABT_mutex_lock(provider->compaction_mutex);
+    while (!provider->compaction_stop) {
+        wait_for_stop(provider, slow_ops_flush_interval);
+        ABT_mutex_unlock(provider->compaction_mutex);
+        provider->slow_ops.flush();
+        ABT_mutex_lock(provider->compaction_mutex);
+    }
+    ABT_mutex_unlock(provider->compaction_mutex);
+}
+
+static int start_slow_ops_flusher(sdskv_provider_t provider)
+{
+    if (!provider->slow_ops.has_file()) return SDSKV_SUCCESS;
+    ABT_pool pool;
+    int      ret = get_compaction_pool(provider, &pool);
+    if (ret != SDSKV_SUCCESS) return ret;
+    ret = ABT_thread_create(pool, slow_ops_flusher_ult, provider,
+                            ABT_THREAD_ATTR_NULL, &provider->slow_ops_flusher);
+    if (ret != ABT_SUCCESS) {
+        SDSKV_LOG_ERROR(provider->mid,
+                        "could not start slow operation flusher");
+        return SDSKV_MAKE_ABT_ERROR(ret);
+    }
+    return SDSKV_SUCCESS;
+}
+
+static void stop_compaction(sdskv_provider_t provider)
+{
+    ABT_mutex_lock(provider->compaction_mutex);
+    provider->compaction_stop = true;
+    ABT_cond_broadcast(provider->compaction_cond);
+    ABT_mutex_unlock(provider->compaction_mutex);
+    if (provider->compaction_scheduler != ABT_THREAD_NULL) {
+        ABT_thread_join(provider->compaction_scheduler);
+        ABT_thread_free(&provider->compaction_scheduler);
+    }
+    if (provider->expiration_reclaimer != ABT_THREAD_NULL) {
+        ABT_thread_join(provider->expiration_reclaimer);
+        ABT_thread_free(&provider->expiration_reclaimer);
+    }
+    if (provider->slow_ops_flusher != ABT_THREAD_NULL) {
+        ABT_thread_join(provider->slow_ops_flusher);
+        ABT_thread_free(&provider->slow_ops_flusher);
+    }
+    if (provider->compaction_xstream != ABT_XSTREAM_NULL) {
+        ABT_xstream_join(provider->compaction_xstream);
+        ABT_xstream_free(&provider->compaction_xstream);
+    }
+}
+
+static void sdskv_compact_ult(hg_handle_t handle)
+{
+
+    hg_return_t   hret;
+    compact_in_t  in;
+    compact_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+
+    compaction_args args;
+    args.db    = db;
+    args.lower = ds_bulk_t(in.lower.data, in.lower.data + in.lower.size);
+    args.upper = ds_bulk_t(in.upper.data, in.upper.data + in.upper.size);
+    args.ret   = SDSKV_SUCCESS;
+
+    out.ret = run_compaction(provider, &args);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_compact_ult)
+
+static void sdskv_get_statistics_ult(hg_handle_t handle)
+{
+    get_statistics_out_t out;
+    std::string          statistics;
+    out.statistics = (char*)"";
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+
+    statistics     = statistics_to_string(provider);
+    out.statistics = (char*)statistics.c_str();
+    out.ret        = SDSKV_SUCCESS;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_statistics_ult)
+
+static void sdskv_flush_trace_ult(hg_handle_t handle)
+{
+
+    hg_return_t       hret;
+    flush_trace_in_t  in;
+    flush_trace_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    out.ret = sdskv_provider_flush_trace(provider, in.filename);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_flush_trace_ult)
+
+static void sdskv_get_hot_keys_ult(hg_handle_t handle)
+{
+
+    hg_return_t        hret;
+    get_hot_keys_in_t  in;
+    get_hot_keys_out_t out;
+    std::vector<char>  entries;
+    out.num_keys     = 0;
+    out.entries.size = 0;
+    out.entries.data = nullptr;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    ABT_rwlock_rdlock(provider->lock);
+    bool found    = provider->databases.count(in.db_id) != 0;
+    auto hot_keys = find_hot_keys(provider, in.db_id);
+    ABT_rwlock_unlock(provider->lock);
+    if (!found) {
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        SDSKV_LOG_ERROR(mid, "could not find database with id %lu", in.db_id);
+        return;
+    }
+    out.ret = SDSKV_SUCCESS;
+    /* hot-key tracking is disabled */
+    if (!hot_keys) return;
+
+    for (const auto& entry : hot_keys->top(in.max_keys, in.reset)) {
+        uint64_t  count  = entry.second;
+        hg_size_t ksize  = entry.first.size();
+        size_t    offset = entries.size();
+        entries.resize(offset + sizeof(count) + sizeof(ksize) + ksize);
+        memcpy(entries.data() + offset, &count, sizeof(count));
+        offset += sizeof(count);
+        memcpy(entries.data() + offset, &ksize, sizeof(ksize));
+        offset += sizeof(ksize);
+        memcpy(entries.data() + offset, entry.first.data(), ksize);
+        out.num_keys += 1;
+    }
+    out.entries.size = entries.size();
+    out.entries.data = entries.data();
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_hot_keys_ult)
+
+static void sdskv_get_slow_ops_ult(hg_handle_t handle)
+{
+
+    hg_return_t        hret;
+    get_slow_ops_in_t  in;
+    get_slow_ops_out_t out;
+    std::string        slow_ops;
+    out.slow_ops = (char*)"";
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    slow_ops     = slow_ops_to_string(provider, in.clear);
+    out.slow_ops = (char*)slow_ops.c_str();
+    out.ret      = SDSKV_SUCCESS;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_slow_ops_ult)
+
+static void sdskv_watch_ult(hg_handle_t handle)
+{
+
+    hg_return_t hret;
+    watch_in_t  in;
+    watch_out_t out;
+    out.watch_id = 0;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    if (!provider->watches.enabled()) {
+        out.ret = SDSKV_OP_NOT_IMPL;
+        return;
+    }
+    ds_bulk_t lower(in.lower.data, in.lower.data + in.lower.size);
+    ds_bulk_t upper(in.upper.data, in.upper.data + in.upper.size);
+    /* the changes are sent to the address the request came from */
+    out.ret = provider->watches.watch(in.db_id, info->addr, in.client_watch_id,
+                                      lower, upper, in.prefix, in.values,
+                                      &out.watch_id);
+    if (out.ret == SDSKV_ERR_UNKNOWN_DB)
+        SDSKV_LOG_ERROR(mid, "could not find database with id %lu", in.db_id);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_watch_ult)
+
+static void sdskv_unwatch_ult(hg_handle_t handle)
+{
+
+    hg_return_t   hret;
+    unwatch_in_t  in;
+    unwatch_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    out.ret = provider->watches.unwatch(in.watch_id);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_unwatch_ult)
+
+static void sdskv_get_changes_ult(hg_handle_t handle)
+{
+
+    hg_return_t       hret;
+    get_changes_in_t  in;
+    get_changes_out_t out;
+    out.num_changes = 0;
+    out.last_seq    = 0;
+    out.size        = 0;
+    std::vector<char> local_buffer;
+    hg_bulk_t         local_bulk_handle;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+
+    /* the keys and values of the changes fit in the client's buffer, but
+     * their headers may not */
+    std::vector<ds_change_t> changes;
+    out.ret = db->get_changes(in.since, in.max_changes, in.bulk_size, changes,
+                              &out.last_seq);
+    if (out.ret != SDSKV_SUCCESS) return;
+
+    const size_t header_size = sizeof(uint64_t) + 1 + 2 * sizeof(hg_size_t);
+    for (auto& c : changes) {
+        size_t size = header_size + c.key.size() + c.value.size();
+        if (local_buffer.size() + size > in.bulk_size) break;
+        hg_size_t ksize = c.key.size();
+        hg_size_t vsize = c.value.size();
+        local_buffer.insert(local_buffer.end(), (const char*)&c.seq,
+                            (const char*)&c.seq + sizeof(c.seq));
+        local_buffer.push_back((char)c.type);
+        local_buffer.insert(local_buffer.end(), (const char*)&ksize,
+                            (const char*)&ksize + sizeof(ksize));
+        local_buffer.insert(local_buffer.end(), (const char*)&vsize,
+                            (const char*)&vsize + sizeof(vsize));
+        local_buffer.insert(local_buffer.end(), c.key.begin(), c.key.end());
+        local_buffer.insert(local_buffer.end(), c.value.begin(),
+                            c.value.end());
+        out.num_changes += 1;
+    }
+    if (out.num_changes == 0) {
+        if (!changes.empty()) out.ret = SDSKV_ERR_SIZE;
+        return;
+    }
+    out.size = local_buffer.size();
+
+    /* create bulk handle to send the changes */
+    std::vector<void*> buf_addr(1);
+    buf_addr[0] = (void*)local_buffer.data();
+    hret = margo_bulk_create(mid, 1, buf_addr.data(), &out.size,
+                             HG_BULK_READ_ONLY, &local_bulk_handle);
+    if (hret != HG_SUCCESS) {
+        SDSKV_LOG_ERROR(mid, "failed to create bulk handle (hret = %d)", hret);
+        out.ret         = SDSKV_MAKE_HG_ERROR(hret);
+        out.num_changes = 0;
+        return;
+    }
+    DEFER(margo_bulk_free_local, margo_bulk_free(local_bulk_handle));
+
+    /* do a PUSH operation to send the changes to the client */
+    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.bulk_handle,
+                               0, local_bulk_handle, 0, out.size);
+    if (hret != HG_SUCCESS) {
+        SDSKV_LOG_ERROR(mid, "failed to issue bulk transfer (hret = %d)", hret);
+        out.ret         = SDSKV_MAKE_HG_ERROR(hret);
+        out.num_changes = 0;
+        return;
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_changes_ult)
+
+static void sdskv_truncate_changes_ult(hg_handle_t handle)
+{
+
+    hg_return_t            hret;
+    truncate_changes_in_t  in;
+    truncate_changes_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+
+    out.ret = db->truncate_changes(in.upto);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_truncate_changes_ult)
+
+/* applies in order the changes sent by the provider of a database of which
+ * this one is a backup; the changes that were copied with the database may
+ * be sent again */
+static void sdskv_replicate_ult(hg_handle_t handle)
+{
+
+    hg_return_t     hret;
+    replicate_in_t  in;
+    replicate_out_t out;
+    out.ret = SDSKV_SUCCESS;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+    FIND_DATABASE;
+
+    const size_t header_size = 1 + 2 * sizeof(hg_size_t);
+    const char*  entry       = in.changes.data;
+    const char*  end         = entry + in.changes.size;
+    for (hg_size_t i = 0; i < in.num_changes; i++) {
+        hg_size_t ksize, vsize;
+        if ((size_t)(end - entry) < header_size) {
+            out.ret = SDSKV_ERR_INVALID_ARG;
+            return;
+        }
+        auto type = (sdskv_watch_event_type_t)entry[0];
+        memcpy(&ksize, entry + 1, sizeof(ksize));
+        memcpy(&vsize, entry + 1 + sizeof(ksize), sizeof(vsize));
+        entry += header_size;
+        if ((size_t)(end - entry) < ksize + vsize) {
+            out.ret = SDSKV_ERR_INVALID_ARG;
+            return;
+        }
+        if (type == SDSKV_WATCH_PUT) {
+            int ret = db->put(entry, ksize, entry + ksize, vsize);
+            /* a key put again in a database that does not allow overwrites
+             * already has its value */
+            if (ret != SDSKV_SUCCESS && ret != SDSKV_ERR_KEYEXISTS) {
+                out.ret = ret;
+                return;
+            }
+        } else {
+            db->erase(ds_bulk_t(entry, entry + ksize));
+        }
+        entry += ksize + vsize;
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_replicate_ult)
+
+static void sdskv_add_backup_ult(hg_handle_t handle)
+{
+
+    hg_return_t      hret;
+    add_backup_in_t  in;
+    add_backup_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    out.ret = sdskv_provider_add_backup(provider, in.db_id, in.backup_addr,
+                                        in.backup_provider_id,
+                                        in.backup_db_id, in.sync);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_add_backup_ult)
+
+static void sdskv_remove_backup_ult(hg_handle_t handle)
+{
+
+    hg_return_t         hret;
+    remove_backup_in_t  in;
+    remove_backup_out_t out;
+
+    ENSURE_MARGO_DESTROY;
+    ENSURE_MARGO_RESPOND;
+    FIND_MID_AND_PROVIDER;
+    GET_INPUT;
+    ENSURE_MARGO_FREE_INPUT;
+
+    out.ret = sdskv_provider_remove_backup(provider, in.db_id, in.backup_addr,
+                                           in.backup_provider_id,
+                                           in.backup_db_id);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_remove_backup_ult)
+
 static void sdskv_server_finalize_cb(void* data)
 {
     sdskv_provider_t provider = (sdskv_provider_t)data;
     assert(provider);
     margo_instance_id mid = provider->mid;
 
+    stop_compaction(provider);
+    provider->watches.stop();
+
+    if (!provider->stats_dump_file.empty()) {
+        std::ofstream dump(provider->stats_dump_file);
+        dump << statistics_to_string(provider) << std::endl;
+        if (!dump)
+            SDSKV_LOG_ERROR(mid, "could not write statistics to %s",
+                            provider->stats_dump_file.c_str());
+    }
+
+    if (provider->tracer.enabled() && !provider->trace_file.empty())
+        sdskv_provider_flush_trace(provider, nullptr);
+
+    provider->slow_ops.flush();
+
     sdskv_provider_remove_all_databases(provider);
 
     margo_deregister(mid, provider->sdskv_open_id);
     margo_deregister(mid, provider->sdskv_count_databases_id);
     margo_deregister(mid, provider->sdskv_list_databases_id);
     margo_deregister(mid, provider->sdskv_put_id);
+    margo_deregister(mid, provider->sdskv_put_ttl_id);
     margo_deregister(mid, provider->sdskv_put_multi_id);
     margo_deregister(mid, provider->sdskv_bulk_put_id);
     margo_deregister(mid, provider->sdskv_get_id);
@@ -2675,6 +4827,13 @@ static void sdskv_server_finalize_cb(void* data)
     margo_deregister(mid, provider->sdskv_exists_id);
     margo_deregister(mid, provider->sdskv_erase_id);
     margo_deregister(mid, provider->sdskv_erase_multi_id);
+    margo_deregister(mid, provider->sdskv_erase_range_id);
+    margo_deregister(mid, provider->sdskv_erase_prefixed_id);
+    margo_deregister(mid, provider->sdskv_count_range_id);
+    margo_deregister(mid, provider->sdskv_count_prefixed_id);
+    margo_deregister(mid, provider->sdskv_compare_and_swap_id);
+    margo_deregister(mid, provider->sdskv_fetch_add_id);
+    margo_deregister(mid, provider->sdskv_append_id);
     margo_deregister(mid, provider->sdskv_length_id);
     margo_deregister(mid, provider->sdskv_length_multi_id);
     margo_deregister(mid, provider->sdskv_bulk_get_id);
@@ -2685,8 +4844,22 @@ static void sdskv_server_finalize_cb(void* data)
     margo_deregister(mid, provider->sdskv_migrate_keys_prefixed_id);
     margo_deregister(mid, provider->sdskv_migrate_all_keys_id);
     margo_deregister(mid, provider->sdskv_migrate_database_id);
+    margo_deregister(mid, provider->sdskv_compact_id);
+    margo_deregister(mid, provider->sdskv_get_statistics_id);
+    margo_deregister(mid, provider->sdskv_flush_trace_id);
+    margo_deregister(mid, provider->sdskv_get_hot_keys_id);
+    margo_deregister(mid, provider->sdskv_get_slow_ops_id);
+    margo_deregister(mid, provider->sdskv_watch_id);
+    margo_deregister(mid, provider->sdskv_unwatch_id);
+    margo_deregister(mid, provider->sdskv_get_changes_id);
+    margo_deregister(mid, provider->sdskv_truncate_changes_id);
+    margo_deregister(mid, provider->sdskv_replicate_id);
+    margo_deregister(mid, provider->sdskv_add_backup_id);
+    margo_deregister(mid, provider->sdskv_remove_backup_id);
 
     ABT_rwlock_free(&(provider->lock));
+    ABT_mutex_free(&(provider->compaction_mutex));
+    ABT_cond_free(&(provider->compaction_cond));
 
     delete provider;
 
@@ -2736,7 +4909,9 @@ static int sdskv_pre_migration_callback(remi_fileset_t fileset, void* uargs)
         }
     }
     // (3) check that the type of database is ok to migrate
-    if (db_type != "berkeleydb" && db_type != "leveldb") { return -103; }
+    if (db_type != "berkeleydb" && db_type != "leveldb" && db_type != "lmdb") {
+        return -103;
+    }
     // (4) check that the comparison function exists
     if (comp_fn.size() != 0) {
         if (provider->compfunctions.find(comp_fn)
@@ -2754,6 +4929,8 @@ static int sdskv_pre_migration_callback(remi_fileset_t fileset, void* uargs)
             config.db_type = KVDB_BERKELEYDB;
         else if (db_type == "leveldb")
             config.db_type = KVDB_LEVELDB;
+        else if (db_type == "lmdb")
+            config.db_type = KVDB_LMDB;
         if (comp_fn.size() != 0)
             config.db_comp_fn_name = comp_fn.c_str();
         else
@@ -2793,6 +4970,8 @@ static int sdskv_post_migration_callback(remi_fileset_t fileset, void* uargs)
         config.db_type = KVDB_BERKELEYDB;
     else if (db_type == "leveldb")
         config.db_type = KVDB_LEVELDB;
+    else if (db_type == "lmdb")
+        config.db_type = KVDB_LMDB;
     if (comp_fn.size() != 0)
         config.db_comp_fn_name = comp_fn.c_str();
     else
@@ -2963,13 +5142,17 @@ static int populate_provider_from_config(sdskv_provider_t provider)
             db_cfg.db_type = KVDB_BERKELEYDB;
         else if (type == "forward" || type == "fwd")
             db_cfg.db_type = KVDB_FORWARDDB;
+        else if (type == "lmdb" || type == "mdb")
+            db_cfg.db_type = KVDB_LMDB;
+        else if (type == "rocksdb" || type == "rdb")
+            db_cfg.db_type = KVDB_ROCKSDB;
         else {
             SDSKV_LOG_ERROR(provider->mid, "unknown database type \"%s\"",
                             type.c_str());
             ret = SDSKV_ERR_CONFIG;
             break;
         }
-        ret = sdskv_provider_attach_database(provider, &db_cfg, &id);
+        ret = attach_database(provider, &db_cfg, *it, &id);
         if (ret == SDSKV_SUCCESS) { (*it)["__database_id__"] = id; }
     }
     if (ret != SDSKV_SUCCESS) sdskv_provider_remove_all_databases(provider);
@@ -0,0 +1,130 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-slow-ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+static inline Json::UInt64 to_ns(double seconds)
+{
+    return seconds > 0.0 ? (Json::UInt64)(seconds * 1e9) : 0;
+}
+
+static Json::Value to_json(const SlowOperation& op)
+{
+    char hash[19];
+    snprintf(hash, sizeof(hash), "0x%016llx", (unsigned long long)op.key_hash);
+    Json::Value result(Json::objectValue);
+    result["time"]         = op.time;
+    result["op"]           = op.op;
+    result["db_id"]        = (Json::UInt64)op.db_id;
+    result["request_id"]   = (Json::UInt64)op.request_id;
+    result["ret"]          = op.ret;
+    result["key_hash"]     = hash;
+    result["key_size"]     = (Json::UInt64)op.key_size;
+    result["bytes_in"]     = (Json::UInt64)op.bytes_in;
+    result["bytes_out"]    = (Json::UInt64)op.bytes_out;
+    result["latency_ns"]   = to_ns(op.latency);
+    result["lock_wait_ns"] = to_ns(op.lock_wait);
+    result["backend_ns"]   = to_ns(op.backend);
+    result["bulk_ns"]      = to_ns(op.bulk);
+    return result;
+}
+
+SlowOpLog::SlowOpLog()
+{
+    ABT_mutex_create(&_mutex);
+    ABT_mutex_create(&_file_mutex);
+}
+
+SlowOpLog::~SlowOpLog()
+{
+    flush();
+    ABT_mutex_free(&_file_mutex);
+    ABT_mutex_free(&_mutex);
+}
+
+bool SlowOpLog::configure(bool                       enabled,
+                          size_t                     capacity,
+                          const std::vector<double>& thresholds,
+                          const std::string&         filename)
+{
+    /* the records buffered so far go to the previous file */
+    flush();
+    ABT_mutex_lock(_file_mutex);
+    ABT_mutex_lock(_mutex);
+    _enabled    = enabled && capacity > 0;
+    _recorded   = 0;
+    _total      = 0;
+    _thresholds = thresholds;
+    _ring.assign(_enabled ? capacity : 0, SlowOperation());
+    if (_file.is_open()) _file.close();
+    bool ok = true;
+    if (_enabled && !filename.empty()) {
+        _file.open(filename, std::ios::app);
+        ok = _file.is_open();
+    }
+    _has_file = _file.is_open();
+    ABT_mutex_unlock(_mutex);
+    ABT_mutex_unlock(_file_mutex);
+    return ok;
+}
+
+void SlowOpLog::record(const SlowOperation& op)
+{
+    if (!_enabled) return;
+    auto          now = std::chrono::system_clock::now().time_since_epoch();
+    SlowOperation r   = op;
+    r.time            = std::chrono::duration<double>(now).count();
+    std::string line;
+    if (_has_file) {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        line                   = Json::writeString(builder, ::to_json(r));
+        line += '\n';
+    }
+    ABT_mutex_lock(_mutex);
+    _ring[_recorded % _ring.size()] = r;
+    _recorded += 1;
+    _total += 1;
+    _pending += line;
+    ABT_mutex_unlock(_mutex);
+}
+
+void SlowOpLog::flush()
+{
+    std::string lines;
+    ABT_mutex_lock(_file_mutex);
+    ABT_mutex_lock(_mutex);
+    lines.swap(_pending);
+    ABT_mutex_unlock(_mutex);
+    if (!lines.empty() && _file.is_open()) _file << lines << std::flush;
+    ABT_mutex_unlock(_file_mutex);
+}
+
+Json::Value
+SlowOpLog::to_json(const std::map<sdskv_database_id_t, std::string>& names,
+                   bool                                              clear)
+{
+    Json::Value result(Json::objectValue);
+    Json::Value operations(Json::arrayValue);
+    ABT_mutex_lock(_mutex);
+    result["enabled"] = _enabled;
+    result["total"]   = (Json::UInt64)_total;
+    size_t n          = std::min<uint64_t>(_recorded, _ring.size());
+    result["dropped"] = (Json::UInt64)(_recorded - n);
+    for (uint64_t i = _recorded - n; i < _recorded; i++) {
+        const auto& op    = _ring[i % _ring.size()];
+        Json::Value entry = ::to_json(op);
+        auto        it    = names.find(op.db_id);
+        if (it != names.end()) entry["database"] = it->second;
+        operations.append(entry);
+    }
+    if (clear) _recorded = 0;
+    ABT_mutex_unlock(_mutex);
+    result["operations"] = operations;
+    return result;
+}
@@ -0,0 +1,94 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_SLOW_OPS_H
+#define SDSKV_SLOW_OPS_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <margo.h>
+#include <json/json.h>
+#include "sdskv-common.h"
+#include "bulk.h"
+
+// an RPC that took longer than the threshold of its type; op points to a
+// string literal and durations are in seconds
+struct SlowOperation {
+    double              time; // seconds since the epoch, at completion
+    const char*         op;
+    sdskv_database_id_t db_id;
+    uint64_t            request_id;
+    int32_t             ret;
+    uint64_t            key_hash; // hash of the key's first bytes, 0 if none
+    uint64_t            key_size;
+    uint64_t            bytes_in;
+    uint64_t            bytes_out;
+    double              latency;
+    double              lock_wait;
+    double              backend;
+    double              bulk;
+};
+
+// bounded log of the slow RPCs of a provider. Once it is full, the oldest
+// records are overwritten. Records are also appended to a file, one JSON
+// object per line, if one is configured; they are buffered in memory until
+// flush is called, so that RPCs do not wait for the file.
+class SlowOpLog {
+
+  public:
+    // number of leading key bytes hashed into SlowOperation::key_hash
+    static constexpr size_t key_prefix_size = 16;
+
+    SlowOpLog();
+    ~SlowOpLog();
+
+    // thresholds are in seconds, indexed by type of RPC; returns false if
+    // the file could not be opened
+    bool configure(bool                       enabled,
+                   size_t                     capacity,
+                   const std::vector<double>& thresholds,
+                   const std::string&         filename);
+    bool enabled() const { return _enabled; }
+
+    bool is_slow(unsigned op, double latency) const
+    {
+        return _enabled && op < _thresholds.size()
+            && latency >= _thresholds[op];
+    }
+
+    void record(const SlowOperation& op);
+
+    // writes the buffered records to the file, if any
+    void flush();
+    bool has_file() const { return _has_file; }
+
+    // names maps database ids to database names; clear empties the log
+    Json::Value to_json(const std::map<sdskv_database_id_t, std::string>& names,
+                        bool clear);
+
+    // hash of the first key_prefix_size bytes of the key
+    static uint64_t hash_key(const void* key, size_t ksize)
+    {
+        return ds_hash_key(key, ksize < key_prefix_size ? ksize
+                                                        : key_prefix_size);
+    }
+
+  private:
+    bool                       _enabled  = false;
+    uint64_t                   _recorded = 0; // since the log was cleared
+    uint64_t                   _total    = 0; // since the log was configured
+    std::vector<double>        _thresholds;
+    std::vector<SlowOperation> _ring;
+    bool                       _has_file = false;
+    std::string                _pending; // records not yet written to _file
+    std::ofstream              _file;    // protected by _file_mutex
+    ABT_mutex                  _mutex      = ABT_MUTEX_NULL;
+    ABT_mutex                  _file_mutex = ABT_MUTEX_NULL;
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-statistics.h"
+#include <cmath>
+
+/* names of the operations in the statistics, indexed by sdskv_stat_op_t */
+static const char* const op_names[SDSKV_STAT_NUM_OPS] = {
+    "put",
+    "put_multi",
+    "put_packed",
+    "bulk_put",
+    "get",
+    "get_multi",
+    "get_packed",
+    "bulk_get",
+    "length",
+    "length_multi",
+    "length_packed",
+    "exists",
+    "exists_multi",
+    "erase",
+    "erase_multi",
+    "erase_range",
+    "erase_prefixed",
+    "count_range",
+    "count_prefixed",
+    "compare_and_swap",
+    "fetch_add",
+    "append",
+    "list_keys",
+    "list_keyvals"
+};
+
+const char* sdskv_stat_op_name(sdskv_stat_op_t op) { return op_names[op]; }
+
+static inline uint64_t to_ns(double seconds)
+{
+    return seconds > 0.0 ? (uint64_t)(seconds * 1e9) : 0;
+}
+
+unsigned LatencyHistogram::bucket_of(uint64_t ns)
+{
+    if (ns < 8) return (unsigned)ns;
+    unsigned e = 63 - __builtin_clzll(ns);
+    unsigned b = (e - 1) * 4 + ((ns >> (e - 2)) & 3);
+    return b < num_buckets ? b : num_buckets - 1;
+}
+
+uint64_t LatencyHistogram::lower_bound(unsigned bucket)
+{
+    if (bucket < 8) return bucket;
+    unsigned e = bucket / 4 + 1;
+    return (uint64_t)(4 + bucket % 4) << (e - 2);
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    _buckets[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t m = _min.load(std::memory_order_relaxed);
+    while (ns < m
+           && !_min.compare_exchange_weak(m, ns, std::memory_order_relaxed))
+        ;
+    m = _max.load(std::memory_order_relaxed);
+    while (ns > m
+           && !_max.compare_exchange_weak(m, ns, std::memory_order_relaxed))
+        ;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const
+{
+    uint64_t count = _count.load(std::memory_order_relaxed);
+    if (count == 0) return 0;
+    uint64_t target = (uint64_t)std::ceil(q * count);
+    uint64_t seen   = 0;
+    uint64_t max    = _max.load(std::memory_order_relaxed);
+    for (unsigned b = 0; b < num_buckets; b++) {
+        seen += _buckets[b].load(std::memory_order_relaxed);
+        if (seen >= target && seen > 0) {
+            if (b + 1 == num_buckets) return max;
+            return std::min(lower_bound(b + 1) - 1, max);
+        }
+    }
+    return max;
+}
+
+Json::Value LatencyHistogram::to_json() const
+{
+    Json::Value result(Json::objectValue);
+    uint64_t    count = _count.load(std::memory_order_relaxed);
+    uint64_t    sum   = _sum.load(std::memory_order_relaxed);
+    result["count"]   = (Json::UInt64)count;
+    result["sum_ns"]  = (Json::UInt64)sum;
+    if (count == 0) return result;
+    result["min_ns"]  = (Json::UInt64)_min.load(std::memory_order_relaxed);
+    result["max_ns"]  = (Json::UInt64)_max.load(std::memory_order_relaxed);
+    result["mean_ns"] = (Json::UInt64)(sum / count);
+    result["p50_ns"]  = (Json::UInt64)percentile(0.50);
+    result["p90_ns"]  = (Json::UInt64)percentile(0.90);
+    result["p99_ns"]  = (Json::UInt64)percentile(0.99);
+    result["p999_ns"] = (Json::UInt64)percentile(0.999);
+    /* non-empty buckets, as [lower bound in ns, count] pairs */
+    Json::Value buckets(Json::arrayValue);
+    for (unsigned b = 0; b < num_buckets; b++) {
+        uint64_t n = _buckets[b].load(std::memory_order_relaxed);
+        if (n == 0) continue;
+        Json::Value bucket(Json::arrayValue);
+        bucket.append((Json::UInt64)lower_bound(b));
+        bucket.append((Json::UInt64)n);
+        buckets.append(bucket);
+    }
+    result["buckets"] = buckets;
+    return result;
+}
+
+Json::Value OperationStatistics::to_json() const
+{
+    Json::Value result(Json::objectValue);
+    auto        relaxed = std::memory_order_relaxed;
+    result["count"]     = (Json::UInt64)count.load(relaxed);
+    result["errors"]    = (Json::UInt64)errors.load(relaxed);
+    result["bytes_in"]  = (Json::UInt64)bytes_in.load(relaxed);
+    result["bytes_out"] = (Json::UInt64)bytes_out.load(relaxed);
+    result["latency"]   = latency.to_json();
+    result["backend"]   = backend.to_json();
+    result["bulk"]      = bulk.to_json();
+    return result;
+}
+
+static Json::Value table_to_json(const OperationTable& table)
+{
+    Json::Value result(Json::objectValue);
+    for (unsigned op = 0; op < SDSKV_STAT_NUM_OPS; op++) {
+        if (table[op].count.load(std::memory_order_relaxed) == 0) continue;
+        result[op_names[op]] = table[op].to_json();
+    }
+    return result;
+}
+
+ProviderStatistics::ProviderStatistics() { ABT_rwlock_create(&_lock); }
+
+ProviderStatistics::~ProviderStatistics() { ABT_rwlock_free(&_lock); }
+
+void ProviderStatistics::add_database(sdskv_database_id_t db_id)
+{
+    ABT_rwlock_wrlock(_lock);
+    _databases[db_id] = std::make_shared<OperationTable>();
+    ABT_rwlock_unlock(_lock);
+}
+
+void ProviderStatistics::remove_database(sdskv_database_id_t db_id)
+{
+    ABT_rwlock_wrlock(_lock);
+    _databases.erase(db_id);
+    ABT_rwlock_unlock(_lock);
+}
+
+std::shared_ptr<OperationTable>
+ProviderStatistics::find_database(sdskv_database_id_t db_id) const
+{
+    std::shared_ptr<OperationTable> result;
+    ABT_rwlock_rdlock(_lock);
+    auto it = _databases.find(db_id);
+    if (it != _databases.end()) result = it->second;
+    ABT_rwlock_unlock(_lock);
+    return result;
+}
+
+Json::Value ProviderStatistics::to_json(
+    const std::map<sdskv_database_id_t, std::string>& names) const
+{
+    Json::Value result(Json::objectValue);
+    result["enabled"] = _enabled;
+    result["rpcs"]    = table_to_json(_rpcs);
+    Json::Value databases(Json::objectValue);
+    ABT_rwlock_rdlock(_lock);
+    for (const auto& db : _databases) {
+        auto it = names.find(db.first);
+        if (it == names.end()) continue;
+        databases[it->second]["rpcs"] = table_to_json(*db.second);
+    }
+    ABT_rwlock_unlock(_lock);
+    result["databases"] = databases;
+    return result;
+}
+
+RpcTimer::RpcTimer(ProviderStatistics& stats,
+                   SlowOpLog&          slow_ops,
+                   RequestTrace&       trace,
+                   sdskv_stat_op_t     op,
+                   sdskv_database_id_t db_id,
+                   uint64_t            request_id,
+                   const int32_t*      ret)
+    : _stats(stats), _slow_ops(slow_ops), _trace(trace), _op(op),
+      _db_id(db_id), _request_id(request_id), _ret(ret),
+      _slow(slow_ops.enabled()), _enabled(stats.enabled() || _slow)
+{
+    trace.begin(op_names[op], request_id, db_id);
+    if (!_enabled) return;
+    if (stats.enabled()) _db = stats.find_database(db_id);
+    _start = ABT_get_wtime();
+}
+
+static void record(OperationStatistics& s,
+                   bool                 error,
+                   uint64_t             latency,
+                   const uint64_t*      backend,
+                   const uint64_t*      bulk,
+                   uint64_t             bytes_in,
+                   uint64_t             bytes_out)
+{
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    if (error) s.errors.fetch_add(1, std::memory_order_relaxed);
+    if (bytes_in) s.bytes_in.fetch_add(bytes_in, std::memory_order_relaxed);
+    if (bytes_out)
+        s.bytes_out.fetch_add(bytes_out, std::memory_order_relaxed);
+    s.latency.record(latency);
+    if (backend) s.backend.record(*backend);
+    if (bulk) s.bulk.record(*bulk);
+}
+
+RpcTimer::~RpcTimer()
+{
+    if (!_enabled) return;
+    double   now     = ABT_get_wtime();
+    uint64_t latency = to_ns(now - _start);
+    uint64_t backend = to_ns(_backend_time);
+    uint64_t bulk    = to_ns(_bulk_time);
+    bool     error   = _ret && *_ret != SDSKV_SUCCESS;
+    if (_stats.enabled()) {
+        record(_stats.rpc(_op), error, latency,
+               _in_backend ? &backend : nullptr, _in_bulk ? &bulk : nullptr,
+               _bytes_in, _bytes_out);
+        if (_db)
+            record((*_db)[_op], error, latency,
+                   _in_backend ? &backend : nullptr,
+                   _in_bulk ? &bulk : nullptr, _bytes_in, _bytes_out);
+    }
+    /* the slow-operation log uses the time since the request was received,
+     * which includes decoding its input and waiting for the lock */
+    double total = now - _trace.received();
+    if (!_slow || !_slow_ops.is_slow(_op, total)) return;
+    SlowOperation op;
+    op.time       = 0.0;
+    op.op         = op_names[_op];
+    op.db_id      = _db_id;
+    op.request_id = _request_id;
+    op.ret        = _ret ? *_ret : SDSKV_SUCCESS;
+    op.key_hash   = _key_hash;
+    op.key_size   = _key_size;
+    op.bytes_in   = _bytes_in;
+    op.bytes_out  = _bytes_out;
+    op.latency    = total;
+    op.lock_wait  = _trace.lock_wait();
+    op.backend    = _backend_time;
+    op.bulk       = _bulk_time;
+    _slow_ops.record(op);
+}
+
+hg_return_t RpcTimer::bulk_transfer(margo_instance_id mid,
+                                    hg_bulk_op_t      op,
+                                    hg_addr_t         origin_addr,
+                                    hg_bulk_t         origin_handle,
+                                    size_t            origin_offset,
+                                    hg_bulk_t         local_handle,
+                                    size_t            local_offset,
+                                    size_t            size)
+{
+    RequestTrace::scope ts(_trace, "bulk_transfer");
+    span                s(_enabled ? &_bulk_time : nullptr);
+    _in_bulk         = true;
+    hg_return_t hret = margo_bulk_transfer(mid, op, origin_addr, origin_handle,
+                                           origin_offset, local_handle,
+                                           local_offset, size);
+    if (hret == HG_SUCCESS) {
+        if (op == HG_BULK_PULL)
+            _bytes_in += size;
+        else
+            _bytes_out += size;
+    }
+    return hret;
+}
+
+hg_return_t RpcTimer::bulk_wait(margo_request req)
+{
+    RequestTrace::scope ts(_trace, "bulk_wait");
+    span                s(_enabled ? &_bulk_time : nullptr);
+    _in_bulk = true;
+    return margo_wait(req);
+}
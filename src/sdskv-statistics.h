@@ -0,0 +1,214 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_STATISTICS_H
+#define SDSKV_STATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <margo.h>
+#include <json/json.h>
+#include "sdskv-common.h"
+#include "sdskv-slow-ops.h"
+#include "sdskv-tracing.h"
+
+/* operations for which a provider keeps statistics */
+enum sdskv_stat_op_t
+{
+    SDSKV_STAT_PUT = 0,
+    SDSKV_STAT_PUT_MULTI,
+    SDSKV_STAT_PUT_PACKED,
+    SDSKV_STAT_BULK_PUT,
+    SDSKV_STAT_GET,
+    SDSKV_STAT_GET_MULTI,
+    SDSKV_STAT_GET_PACKED,
+    SDSKV_STAT_BULK_GET,
+    SDSKV_STAT_LENGTH,
+    SDSKV_STAT_LENGTH_MULTI,
+    SDSKV_STAT_LENGTH_PACKED,
+    SDSKV_STAT_EXISTS,
+    SDSKV_STAT_EXISTS_MULTI,
+    SDSKV_STAT_ERASE,
+    SDSKV_STAT_ERASE_MULTI,
+    SDSKV_STAT_ERASE_RANGE,
+    SDSKV_STAT_ERASE_PREFIXED,
+    SDSKV_STAT_COUNT_RANGE,
+    SDSKV_STAT_COUNT_PREFIXED,
+    SDSKV_STAT_COMPARE_AND_SWAP,
+    SDSKV_STAT_FETCH_ADD,
+    SDSKV_STAT_APPEND,
+    SDSKV_STAT_LIST_KEYS,
+    SDSKV_STAT_LIST_KEYVALS,
+    SDSKV_STAT_NUM_OPS
+};
+
+const char* sdskv_stat_op_name(sdskv_stat_op_t op);
+
+// log-linear histogram of durations in nanoseconds: each power of two is
+// split into 4 linear sub-buckets, so a recorded duration is at most 25%
+// away from the bounds of its bucket. Counters are relaxed atomics, so
+// recording never blocks.
+class LatencyHistogram {
+
+  public:
+    static constexpr unsigned num_buckets = 160; // up to 2^40 ns (~18 min)
+
+    void record(uint64_t ns);
+    // smallest upper bucket bound below which a fraction q of the
+    // durations fall
+    uint64_t    percentile(double q) const;
+    Json::Value to_json() const;
+
+    static unsigned bucket_of(uint64_t ns);
+    static uint64_t lower_bound(unsigned bucket);
+
+  private:
+    std::array<std::atomic<uint64_t>, num_buckets> _buckets{};
+    std::atomic<uint64_t>                          _count{0};
+    std::atomic<uint64_t>                          _sum{0};
+    std::atomic<uint64_t>                          _min{UINT64_MAX};
+    std::atomic<uint64_t>                          _max{0};
+};
+
+// statistics of one type of RPC. latency covers the whole handler, backend
+// the time spent in the database, and bulk the time spent in bulk
+// transfers; the latter two only record RPCs that did either.
+struct OperationStatistics {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> bytes_in{0};
+    std::atomic<uint64_t> bytes_out{0};
+    LatencyHistogram      latency;
+    LatencyHistogram      backend;
+    LatencyHistogram      bulk;
+
+    Json::Value to_json() const;
+};
+
+typedef std::array<OperationStatistics, SDSKV_STAT_NUM_OPS> OperationTable;
+
+// statistics of a provider, for all its databases and for each of them
+class ProviderStatistics {
+
+  public:
+    ProviderStatistics();
+    ~ProviderStatistics();
+
+    bool enabled() const { return _enabled; }
+    void set_enabled(bool enable) { _enabled = enable; }
+
+    void add_database(sdskv_database_id_t db_id);
+    void remove_database(sdskv_database_id_t db_id);
+    std::shared_ptr<OperationTable>
+    find_database(sdskv_database_id_t db_id) const;
+
+    OperationStatistics& rpc(sdskv_stat_op_t op) { return _rpcs[op]; }
+
+    // names maps the database ids to the names under which their
+    // statistics are listed
+    Json::Value
+    to_json(const std::map<sdskv_database_id_t, std::string>& names) const;
+
+  private:
+    bool           _enabled = true;
+    OperationTable _rpcs;
+    std::unordered_map<sdskv_database_id_t, std::shared_ptr<OperationTable>>
+               _databases;
+    ABT_rwlock _lock = ABT_RWLOCK_NULL;
+};
+
+// times an RPC handler from its construction to its destruction and records
+// the result in the provider's and the database's statistics. ret points to
+// the return code of the RPC, read when the handler completes. The backend
+// calls and bulk transfers it times are also recorded in the request's trace,
+// and the handler is added to the slow-operation log if it took longer than
+// the threshold of its type since the request was received.
+class RpcTimer {
+
+    struct span {
+        double* total;
+        double  start;
+        span(double* t) : total(t), start(t ? ABT_get_wtime() : 0.0) {}
+        ~span()
+        {
+            if (total) *total += ABT_get_wtime() - start;
+        }
+    };
+
+  public:
+    RpcTimer(ProviderStatistics& stats,
+             SlowOpLog&          slow_ops,
+             RequestTrace&       trace,
+             sdskv_stat_op_t     op,
+             sdskv_database_id_t db_id,
+             uint64_t            request_id,
+             const int32_t*      ret);
+    ~RpcTimer();
+
+    // calls f, accounting its duration as time spent in the database
+    template <typename F> auto backend(F&& f) -> decltype(f())
+    {
+        RequestTrace::scope ts(_trace, "backend");
+        span                s(_enabled ? &_backend_time : nullptr);
+        _in_backend = true;
+        return f();
+    }
+
+    // margo_bulk_transfer, accounting its duration and the bytes it moves
+    hg_return_t bulk_transfer(margo_instance_id mid,
+                              hg_bulk_op_t      op,
+                              hg_addr_t         origin_addr,
+                              hg_bulk_t         origin_handle,
+                              size_t            origin_offset,
+                              hg_bulk_t         local_handle,
+                              size_t            local_offset,
+                              size_t            size);
+
+    // margo_wait on a bulk transfer, accounting the time spent waiting
+    hg_return_t bulk_wait(margo_request req);
+
+    // sets the key the slow-operation log identifies the RPC by; only the
+    // first key of RPCs accessing several keys is kept
+    void key(const void* key, size_t ksize)
+    {
+        if (!_slow || _has_key) return;
+        _has_key  = true;
+        _key_hash = SlowOpLog::hash_key(key, ksize);
+        _key_size = ksize;
+    }
+
+    void add_bytes_in(uint64_t n) { _bytes_in += n; }
+    void add_bytes_out(uint64_t n) { _bytes_out += n; }
+    bool enabled() const { return _enabled; }
+
+  private:
+    ProviderStatistics&             _stats;
+    SlowOpLog&                      _slow_ops;
+    RequestTrace&                   _trace;
+    sdskv_stat_op_t                 _op;
+    sdskv_database_id_t             _db_id;
+    uint64_t                        _request_id;
+    std::shared_ptr<OperationTable> _db;
+    const int32_t*                  _ret;
+    bool                            _slow;    // slow-operation log enabled
+    bool                            _enabled; // statistics or slow log
+    double                          _start        = 0.0;
+    double                          _backend_time = 0.0;
+    double                          _bulk_time    = 0.0;
+    bool                            _in_backend   = false;
+    bool                            _in_bulk      = false;
+    uint64_t                        _bytes_in     = 0;
+    uint64_t                        _bytes_out    = 0;
+    bool                            _has_key      = false;
+    uint64_t                        _key_hash     = 0;
+    uint64_t                        _key_size     = 0;
+};
+
+#endif
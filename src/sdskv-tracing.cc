@@ -0,0 +1,123 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-tracing.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+
+Tracer::Tracer() { ABT_mutex_create(&_mutex); }
+
+Tracer::~Tracer() { ABT_mutex_free(&_mutex); }
+
+void Tracer::configure(bool enabled, size_t capacity, uint16_t provider_id)
+{
+    ABT_mutex_lock(_mutex);
+    _enabled  = enabled && capacity > 0;
+    _pid      = provider_id;
+    _origin   = ABT_get_wtime();
+    _recorded = 0;
+    _ring.assign(_enabled ? capacity : 0, TraceEvent());
+    ABT_mutex_unlock(_mutex);
+}
+
+void Tracer::record(const std::vector<TraceEvent>& events)
+{
+    if (!_enabled) return;
+    ABT_mutex_lock(_mutex);
+    for (const auto& e : events) {
+        _ring[_recorded % _ring.size()] = e;
+        _recorded += 1;
+    }
+    ABT_mutex_unlock(_mutex);
+}
+
+bool Tracer::flush(const std::string& filename)
+{
+    std::vector<TraceEvent> events;
+    ABT_mutex_lock(_mutex);
+    size_t n = std::min<uint64_t>(_recorded, _ring.size());
+    events.reserve(n);
+    for (uint64_t i = _recorded - n; i < _recorded; i++)
+        events.push_back(_ring[i % _ring.size()]);
+    _recorded = 0;
+    ABT_mutex_unlock(_mutex);
+
+    std::ofstream out(filename);
+    if (!out) return false;
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+             "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,"
+             "\"args\":{\"name\":\"sdskv provider %u\"}}",
+             _pid, _pid);
+    out << buffer;
+    /* timestamps are in microseconds since the tracer was configured */
+    for (const auto& e : events) {
+        snprintf(buffer, sizeof(buffer),
+                 ",\n{\"name\":\"%s\",\"cat\":\"sdskv\",\"ph\":\"X\","
+                 "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%" PRIu64 ","
+                 "\"args\":{\"request_id\":%" PRIu64 ",\"db_id\":%" PRIu64
+                 "}}",
+                 e.name, (e.start - _origin) * 1e6, e.duration * 1e6, _pid,
+                 e.thread, e.request_id, e.db_id);
+        out << buffer;
+    }
+    out << "\n]}" << std::endl;
+    return (bool)out;
+}
+
+RequestTrace::RequestTrace() : _start(ABT_get_wtime()) {}
+
+RequestTrace::scope::scope(RequestTrace& trace, const char* name)
+    : _trace(trace.active() ? &trace : nullptr), _name(name),
+      _start(_trace ? ABT_get_wtime() : 0.0)
+{
+}
+
+RequestTrace::scope::~scope()
+{
+    if (!_trace) return;
+    TraceEvent e;
+    e.name     = _name;
+    e.start    = _start;
+    e.duration = ABT_get_wtime() - _start;
+    _trace->_spans.push_back(e);
+}
+
+void RequestTrace::attach(Tracer& tracer)
+{
+    if (!tracer.enabled()) return;
+    _tracer = &tracer;
+    _spans.reserve(8);
+}
+
+void RequestTrace::begin(const char*         op,
+                         uint64_t            request_id,
+                         sdskv_database_id_t db_id)
+{
+    _op         = op;
+    _request_id = request_id;
+    _db_id      = db_id;
+}
+
+RequestTrace::~RequestTrace()
+{
+    if (!_tracer || !_op) return;
+    ABT_thread_id thread = 0;
+    ABT_thread_self_id(&thread);
+    TraceEvent request;
+    request.name     = _op;
+    request.start    = _start;
+    request.duration = ABT_get_wtime() - _start;
+    _spans.insert(_spans.begin(), request);
+    for (auto& e : _spans) {
+        e.request_id = _request_id;
+        e.db_id      = _db_id;
+        e.thread     = thread;
+    }
+    _tracer->record(_spans);
+}
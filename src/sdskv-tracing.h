@@ -0,0 +1,109 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_TRACING_H
+#define SDSKV_TRACING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <margo.h>
+#include "sdskv-common.h"
+
+// span of a traced request; name points to a string literal
+struct TraceEvent {
+    const char*         name;
+    uint64_t            request_id;
+    sdskv_database_id_t db_id;
+    uint64_t            thread;
+    double              start;
+    double              duration;
+};
+
+// ring buffer of the spans of the requests traced by a provider. Once it
+// is full, the oldest spans are overwritten.
+class Tracer {
+
+  public:
+    Tracer();
+    ~Tracer();
+
+    void configure(bool enabled, size_t capacity, uint16_t provider_id);
+    bool enabled() const { return _enabled; }
+
+    void record(const std::vector<TraceEvent>& events);
+
+    // writes the buffered spans to filename in the Chrome trace event
+    // format (readable by chrome://tracing and Perfetto) and empties the
+    // buffer; returns false if the file could not be written
+    bool flush(const std::string& filename);
+
+  private:
+    bool                    _enabled  = false;
+    uint16_t                _pid      = 0;
+    double                  _origin   = 0.0;
+    uint64_t                _recorded = 0;
+    std::vector<TraceEvent> _ring;
+    ABT_mutex               _mutex = ABT_MUTEX_NULL;
+};
+
+// spans of one request handler, handed to the tracer when the handler
+// completes. Nothing is recorded unless the tracer it is attached to is
+// enabled, and the spans are dropped unless begin() is called. The time
+// the request was received and the time spent waiting for the provider's
+// lock are kept regardless, for the slow-operation log.
+class RequestTrace {
+
+  public:
+    // times a part of the handler, from its construction to its destruction
+    class scope {
+      public:
+        scope(RequestTrace& trace, const char* name);
+        ~scope();
+
+      private:
+        RequestTrace* _trace;
+        const char*   _name;
+        double        _start;
+    };
+
+    RequestTrace();
+    ~RequestTrace();
+
+    void attach(Tracer& tracer);
+    void begin(const char* op, uint64_t request_id, sdskv_database_id_t db_id);
+    bool active() const { return _tracer != nullptr; }
+
+    double received() const { return _start; }
+    double lock_wait() const { return _lock_wait; }
+
+    // calls f, recording its duration under the given name
+    template <typename F> auto timed(const char* name, F&& f) -> decltype(f())
+    {
+        scope s(*this, name);
+        return f();
+    }
+
+    // calls f, which acquires a lock, recording the time spent waiting
+    template <typename F> auto lock(F&& f) -> decltype(f())
+    {
+        scope  s(*this, "lock_wait");
+        double start = ABT_get_wtime();
+        auto   r     = f();
+        _lock_wait += ABT_get_wtime() - start;
+        return r;
+    }
+
+  private:
+    Tracer*                 _tracer     = nullptr;
+    const char*             _op         = nullptr;
+    uint64_t                _request_id = 0;
+    sdskv_database_id_t     _db_id      = 0;
+    double                  _start      = 0.0;
+    double                  _lock_wait  = 0.0;
+    std::vector<TraceEvent> _spans;
+};
+
+#endif
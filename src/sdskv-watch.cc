@@ -0,0 +1,337 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "sdskv-watch.h"
+#include <algorithm>
+#include <cstring>
+#include "sdskv-rpc-types.h"
+
+// encoded size of an event besides its key and value
+static constexpr size_t event_header_size = 2 + 2 * sizeof(hg_size_t);
+
+struct WatchEvent {
+    sdskv_watch_event_type_t type;
+    ds_bulk_t                value;
+};
+
+struct Watcher {
+    uint64_t            id;
+    uint64_t            client_id;
+    sdskv_database_id_t db_id;
+    margo_instance_id   mid;
+    hg_addr_t           addr = HG_ADDR_NULL;
+    ds_bulk_t           lower;
+    ds_bulk_t           upper;
+    bool                prefix;
+    bool                values;
+    // the following are protected by the mutex of the hub; only the last
+    // change of each key is kept
+    std::map<ds_bulk_t, WatchEvent> pending;
+    size_t                          pending_bytes = 0;
+    bool                            overflow      = false;
+    bool                            draining      = false;
+    bool                            closed        = false;
+
+    ~Watcher()
+    {
+        if (addr != HG_ADDR_NULL) margo_addr_free(mid, addr);
+    }
+};
+
+struct WatchHub::DrainArgs {
+    WatchHub*                hub;
+    std::shared_ptr<Watcher> watcher;
+};
+
+static int compare_bytes(const void* a, size_t asize, const void* b,
+                         size_t bsize)
+{
+    int c = memcmp(a, b, std::min(asize, bsize));
+    if (c != 0) return c;
+    return asize < bsize ? -1 : (asize > bsize ? 1 : 0);
+}
+
+static bool matches(const Watcher&                   w,
+                    AbstractDataStore::comparator_fn less,
+                    const void*                      key,
+                    hg_size_t                        ksize)
+{
+    if (w.prefix)
+        return ksize >= w.lower.size()
+            && memcmp(key, w.lower.data(), w.lower.size()) == 0;
+    auto cmp = [less](const void* a, size_t as, const void* b, size_t bs) {
+        return less ? less(a, as, b, bs) : compare_bytes(a, as, b, bs);
+    };
+    if (!w.lower.empty()
+        && cmp(key, ksize, w.lower.data(), w.lower.size()) < 0)
+        return false;
+    if (!w.upper.empty()
+        && cmp(key, ksize, w.upper.data(), w.upper.size()) >= 0)
+        return false;
+    return true;
+}
+
+static inline size_t event_size(const ds_bulk_t& key, const WatchEvent& e)
+{
+    return event_header_size + key.size() + e.value.size();
+}
+
+void DatabaseWatches::changed(sdskv_watch_event_type_t type,
+                              const void*              key,
+                              hg_size_t                ksize,
+                              const void*              value,
+                              hg_size_t                vsize)
+{
+    _hub.changed(*this, type, key, ksize, value, vsize);
+}
+
+WatchHub::WatchHub()
+{
+    ABT_mutex_create(&_mutex);
+    ABT_cond_create(&_cond);
+}
+
+WatchHub::~WatchHub()
+{
+    ABT_cond_free(&_cond);
+    ABT_mutex_free(&_mutex);
+}
+
+void WatchHub::configure(margo_instance_id  mid,
+                         ABT_pool           pool,
+                         hg_id_t            notify_id,
+                         const WatchConfig& config)
+{
+    _mid       = mid;
+    _pool      = pool;
+    _notify_id = notify_id;
+    _config    = config;
+}
+
+void WatchHub::add_database(sdskv_database_id_t              db_id,
+                            std::shared_ptr<DatabaseWatches> watches)
+{
+    ABT_mutex_lock(_mutex);
+    _databases[db_id] = std::move(watches);
+    ABT_mutex_unlock(_mutex);
+}
+
+void WatchHub::remove_database(sdskv_database_id_t db_id)
+{
+    ABT_mutex_lock(_mutex);
+    auto it = _databases.find(db_id);
+    if (it != _databases.end()) {
+        for (auto& w : it->second->_watchers) {
+            close(*w);
+            _watchers.erase(w->id);
+        }
+        it->second->_watchers.clear();
+        it->second->_count = 0;
+        _databases.erase(it);
+    }
+    ABT_mutex_unlock(_mutex);
+}
+
+int WatchHub::watch(sdskv_database_id_t db_id,
+                    hg_addr_t           addr,
+                    uint64_t            client_watch_id,
+                    const ds_bulk_t&    lower,
+                    const ds_bulk_t&    upper,
+                    bool                prefix,
+                    bool                values,
+                    uint64_t*           watch_id)
+{
+    auto w       = std::make_shared<Watcher>();
+    w->client_id = client_watch_id;
+    w->db_id     = db_id;
+    w->mid       = _mid;
+    w->lower     = lower;
+    w->upper     = prefix ? ds_bulk_t() : upper;
+    w->prefix    = prefix;
+    w->values    = values;
+    if (margo_addr_dup(_mid, addr, &w->addr) != HG_SUCCESS) {
+        w->addr = HG_ADDR_NULL;
+        return SDSKV_ERR_INVALID_ARG;
+    }
+    int ret = SDSKV_SUCCESS;
+    ABT_mutex_lock(_mutex);
+    auto it = _databases.find(db_id);
+    if (_stopping || it == _databases.end()) {
+        ret = SDSKV_ERR_UNKNOWN_DB;
+    } else {
+        w->id = *watch_id = _next_id++;
+        _watchers[w->id]  = w;
+        it->second->_watchers.push_back(w);
+        it->second->_count += 1;
+    }
+    ABT_mutex_unlock(_mutex);
+    return ret;
+}
+
+int WatchHub::unwatch(uint64_t watch_id)
+{
+    ABT_mutex_lock(_mutex);
+    auto it = _watchers.find(watch_id);
+    if (it == _watchers.end()) {
+        ABT_mutex_unlock(_mutex);
+        return SDSKV_ERR_UNKNOWN_WATCH;
+    }
+    auto w = it->second;
+    _watchers.erase(it);
+    close(*w);
+    auto db = _databases.find(w->db_id);
+    if (db != _databases.end()) {
+        auto& v = db->second->_watchers;
+        v.erase(std::remove(v.begin(), v.end(), w), v.end());
+        db->second->_count -= 1;
+    }
+    ABT_mutex_unlock(_mutex);
+    return SDSKV_SUCCESS;
+}
+
+void WatchHub::stop()
+{
+    ABT_mutex_lock(_mutex);
+    _stopping = true;
+    for (auto& db : _databases) {
+        for (auto& w : db.second->_watchers) close(*w);
+        db.second->_watchers.clear();
+        db.second->_count = 0;
+    }
+    _watchers.clear();
+    while (_draining > 0) ABT_cond_wait(_cond, _mutex);
+    ABT_mutex_unlock(_mutex);
+}
+
+/* must be called with the mutex locked */
+void WatchHub::close(Watcher& w)
+{
+    w.closed = true;
+    w.pending.clear();
+    w.pending_bytes = 0;
+}
+
+void WatchHub::changed(DatabaseWatches&         db,
+                       sdskv_watch_event_type_t type,
+                       const void*              key,
+                       hg_size_t                ksize,
+                       const void*              value,
+                       hg_size_t                vsize)
+{
+    ABT_mutex_lock(_mutex);
+    for (auto& w : db._watchers) {
+        if (w->closed || !matches(*w, db._less, key, ksize)) continue;
+        ds_bulk_t k((const char*)key, (const char*)key + ksize);
+        auto      it = w->pending.find(k);
+        if (it != w->pending.end()) {
+            w->pending_bytes -= event_size(it->first, it->second);
+            w->pending.erase(it);
+        }
+        WatchEvent e;
+        e.type = type;
+        if (w->values && type == SDSKV_WATCH_PUT)
+            e.value.assign((const char*)value, (const char*)value + vsize);
+        size_t size = event_size(k, e);
+        if (w->pending_bytes + size > _config.max_pending_bytes) {
+            w->pending.clear();
+            w->pending_bytes = 0;
+            w->overflow      = true;
+        }
+        w->pending_bytes += size;
+        w->pending.emplace(std::move(k), std::move(e));
+        if (!w->draining && !_stopping) {
+            auto args = new DrainArgs{this, w};
+            if (ABT_thread_create(_pool, drain_ult, args,
+                                  ABT_THREAD_ATTR_NULL, NULL)
+                == ABT_SUCCESS) {
+                w->draining = true;
+                _draining += 1;
+            } else {
+                delete args;
+            }
+        }
+    }
+    ABT_mutex_unlock(_mutex);
+}
+
+void WatchHub::drain_ult(void* a)
+{
+    auto args = static_cast<DrainArgs*>(a);
+    args->hub->drain(args->watcher);
+    delete args;
+}
+
+void WatchHub::drain(const std::shared_ptr<Watcher>& w)
+{
+    std::vector<char> buffer;
+    while (true) {
+        /* let the changes accumulate */
+        margo_thread_sleep(_mid, _config.coalesce_ms);
+
+        ABT_mutex_lock(_mutex);
+        if (w->closed || w->pending.empty()) {
+            w->draining = false;
+            _draining -= 1;
+            ABT_cond_broadcast(_cond);
+            ABT_mutex_unlock(_mutex);
+            return;
+        }
+        watch_notify_in_t in;
+        in.watch_id   = w->client_id;
+        in.flags      = w->overflow ? SDSKV_WATCH_OVERFLOW : 0;
+        in.num_events = 0;
+        w->overflow   = false;
+        buffer.clear();
+        auto it = w->pending.begin();
+        while (it != w->pending.end()
+               && in.num_events < _config.max_batch_events) {
+            const ds_bulk_t&  key  = it->first;
+            const WatchEvent& e    = it->second;
+            size_t            size = event_size(key, e);
+            /* a value that does not fit in a notification is left out */
+            bool with_value = w->values && e.type == SDSKV_WATCH_PUT
+                           && size <= _config.max_batch_bytes;
+            if (!with_value) size -= e.value.size();
+            if (in.num_events > 0
+                && buffer.size() + size > _config.max_batch_bytes)
+                break;
+            hg_size_t ksize = key.size();
+            hg_size_t vsize = with_value ? e.value.size() : 0;
+            buffer.push_back((char)e.type);
+            buffer.push_back((char)with_value);
+            buffer.insert(buffer.end(), (const char*)&ksize,
+                          (const char*)&ksize + sizeof(ksize));
+            buffer.insert(buffer.end(), (const char*)&vsize,
+                          (const char*)&vsize + sizeof(vsize));
+            buffer.insert(buffer.end(), key.begin(), key.end());
+            if (with_value)
+                buffer.insert(buffer.end(), e.value.begin(), e.value.end());
+            w->pending_bytes -= event_size(key, e);
+            it = w->pending.erase(it);
+            in.num_events += 1;
+        }
+        ABT_mutex_unlock(_mutex);
+
+        in.events.size = buffer.size();
+        in.events.data = buffer.data();
+        /* the next notification is only sent once this one is acknowledged,
+         * the changes made meanwhile being queued */
+        int         ret    = SDSKV_SUCCESS;
+        hg_handle_t handle = HG_HANDLE_NULL;
+        hg_return_t hret   = margo_create(_mid, w->addr, _notify_id, &handle);
+        if (hret == HG_SUCCESS)
+            hret = margo_forward_timed(handle, &in, _config.timeout_ms);
+        if (hret == HG_SUCCESS) {
+            watch_notify_out_t out;
+            hret = margo_get_output(handle, &out);
+            if (hret == HG_SUCCESS) {
+                ret = out.ret;
+                margo_free_output(handle, &out);
+            }
+        }
+        if (handle != HG_HANDLE_NULL) margo_destroy(handle);
+        if (hret != HG_SUCCESS || ret != SDSKV_SUCCESS) unwatch(w->id);
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef SDSKV_WATCH_H
+#define SDSKV_WATCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include <margo.h>
+#include "sdskv-common.h"
+#include "datastore/watched_datastore.h"
+
+struct WatchConfig {
+    bool     enabled           = true;
+    uint32_t max_batch_events  = 256;      // events per notification
+    size_t   max_batch_bytes   = 64 << 10; // encoded bytes per notification
+    size_t   max_pending_bytes = 16 << 20; // queued bytes per watcher
+    double   coalesce_ms       = 10.0;     // delay before each notification
+    double   timeout_ms        = 10000.0;  // of each notification
+};
+
+class WatchHub;
+struct Watcher;
+
+// watchers of a database, to which its WatchedDataStore reports changes
+class DatabaseWatches : public ChangeListener {
+
+  public:
+    DatabaseWatches(WatchHub& hub, AbstractDataStore::comparator_fn less)
+    : _hub(hub), _less(less)
+    {
+    }
+
+    bool active() const override { return _count.load() > 0; }
+    void changed(sdskv_watch_event_type_t type,
+                 const void*              key,
+                 hg_size_t                ksize,
+                 const void*              value,
+                 hg_size_t                vsize) override;
+
+  private:
+    friend class WatchHub;
+
+    WatchHub&                        _hub;
+    AbstractDataStore::comparator_fn _less;
+    std::atomic<size_t>              _count{0};
+    // protected by the mutex of the hub
+    std::vector<std::shared_ptr<Watcher>> _watchers;
+};
+
+// watches of the databases of a provider. Changes matching a watch are
+// queued, coalesced by key, and sent to the watching client by a ULT that
+// has at most one notification in flight per watch. A watch whose queue
+// grows past max_pending_bytes loses its queued changes and is told so by
+// the SDSKV_WATCH_OVERFLOW flag; a watch whose client fails to acknowledge
+// a notification is removed.
+class WatchHub {
+
+  public:
+    WatchHub();
+    ~WatchHub();
+
+    // notify_id is the id of the RPC sent to the watching clients, whose
+    // notifications are sent from ULTs created in pool
+    void configure(margo_instance_id  mid,
+                   ABT_pool           pool,
+                   hg_id_t            notify_id,
+                   const WatchConfig& config);
+    bool enabled() const { return _config.enabled; }
+
+    void add_database(sdskv_database_id_t              db_id,
+                      std::shared_ptr<DatabaseWatches> watches);
+    void remove_database(sdskv_database_id_t db_id);
+
+    // watches the keys starting with lower if prefix is true, or the keys
+    // in [lower, upper) otherwise, an empty bound being open
+    int watch(sdskv_database_id_t db_id,
+              hg_addr_t           addr,
+              uint64_t            client_watch_id,
+              const ds_bulk_t&    lower,
+              const ds_bulk_t&    upper,
+              bool                prefix,
+              bool                values,
+              uint64_t*           watch_id);
+    int unwatch(uint64_t watch_id);
+
+    // removes all the watches and waits for their ULTs to complete
+    void stop();
+
+  private:
+    friend class DatabaseWatches;
+    struct DrainArgs;
+
+    void        changed(DatabaseWatches&         db,
+                        sdskv_watch_event_type_t type,
+                        const void*              key,
+                        hg_size_t                ksize,
+                        const void*              value,
+                        hg_size_t                vsize);
+    void        close(Watcher& w);
+    static void drain_ult(void* args);
+    void        drain(const std::shared_ptr<Watcher>& w);
+
+    margo_instance_id _mid       = MARGO_INSTANCE_NULL;
+    ABT_pool          _pool      = ABT_POOL_NULL;
+    hg_id_t           _notify_id = 0;
+    WatchConfig       _config;
+    ABT_mutex         _mutex = ABT_MUTEX_NULL;
+    ABT_cond          _cond  = ABT_COND_NULL;
+    bool              _stopping = false;
+    size_t            _draining = 0; // number of running drain ULTs
+    uint64_t          _next_id  = 1;
+    std::map<sdskv_database_id_t, std::shared_ptr<DatabaseWatches>> _databases;
+    std::map<uint64_t, std::shared_ptr<Watcher>>                    _watchers;
+};
+
+#endif
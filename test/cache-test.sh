@@ -0,0 +1,42 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+find_db_name
+
+# the database is declared with its options in the provider's configuration
+cat > $TMPBASE/config.json <<EOF
+{
+    "databases" : [ {
+        "name" : "$test_db_name",
+        "type" : "$test_db_type",
+        "path" : "$TMPBASE",
+        "cache" : { "size" : 65536, "shards" : 4 }
+    } ]
+}
+EOF
+
+# start a server with 2 second wait,
+# 20s timeout, and the above configuration
+test_start_server 2 20 -c $TMPBASE/config.json
+
+sleep 1
+
+#####################
+
+run_to 20 test/sdskv-cache-test $svr_addr 1 $test_db_name 64
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
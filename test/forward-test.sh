@@ -0,0 +1,45 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+find_db_name
+
+# the database is declared with its options in the provider's configuration,
+# with a front tier small enough for entries to be evicted to its LevelDB
+# back tier
+cat > $TMPBASE/config.json <<EOF
+{
+    "databases" : [ {
+        "name" : "$test_db_name",
+        "type" : "forward",
+        "path" : "$TMPBASE",
+        "cache_size" : 4096,
+        "flush_interval" : 0.02
+    } ]
+}
+EOF
+
+# start a server with 2 second wait,
+# 20s timeout, and the above configuration
+test_start_server 2 20 -c $TMPBASE/config.json
+
+sleep 1
+
+#####################
+
+run_to 20 test/sdskv-forward-test $svr_addr 1 $test_db_name 100
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
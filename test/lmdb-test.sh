@@ -0,0 +1,48 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+# runs a client test against a fresh LMDB database, which covers gets
+# served from the map, listings, read-modify-write operations, and custom
+# comparison functions
+SDSKV_TEST_DB_TYPE=mdb
+
+function run_lmdb_test ()
+{
+    start_server=$1
+    client=$2
+    num_keys=$3
+
+    SDSKV_TEST_DB_NAME="lmdb-$client"
+    find_db_name
+
+    # start a server with 2 second wait,
+    # 20s timeout, and the test's database
+    $start_server 2 20 $test_db_full
+
+    sleep 1
+
+    run_to 20 test/$client $svr_addr 1 $test_db_name $num_keys
+    if [ $? -ne 0 ]; then
+        wait
+        exit 1
+    fi
+
+    wait
+}
+
+#####################
+
+run_lmdb_test test_start_server sdskv-get-test 10
+run_lmdb_test test_start_server sdskv-list-keys-test 10
+run_lmdb_test test_start_server sdskv-rmw-test 100
+run_lmdb_test test_start_custom_server sdskv-custom-cmp-test 10
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
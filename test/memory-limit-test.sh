@@ -0,0 +1,50 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+find_db_name
+
+# memory limits only apply to in-memory databases; the evicting one has a
+# change log, in which its evictions are recorded as erasures
+cat > $TMPBASE/config.json <<EOF
+{
+    "databases" : [ {
+        "name" : "$test_db_name-reject",
+        "type" : "map",
+        "path" : "$TMPBASE",
+        "max_memory" : 16384
+    }, {
+        "name" : "$test_db_name-evict",
+        "type" : "map",
+        "path" : "$TMPBASE",
+        "max_memory" : 16384,
+        "memory_policy" : "evict",
+        "change_log" : { "reserve" : 64 }
+    } ]
+}
+EOF
+
+# start a server with 2 second wait,
+# 20s timeout, and the above configuration
+test_start_server 2 20 -c $TMPBASE/config.json
+
+sleep 1
+
+#####################
+
+run_to 20 test/sdskv-memory-limit-test $svr_addr 1 $test_db_name 64
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
@@ -0,0 +1,210 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+
+#include "sdskv-client.h"
+
+static int check_values(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        uint32_t num_keys, bool overwritten, bool erased);
+static uint64_t cache_counter(const char* stats, const char* name);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database, whose values are cached by the provider */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret != 0)
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+
+    /* **** put the keys, then read them twice, filling the cache and
+     * reading them from it **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+    for(unsigned j=0; ret == 0 && j < 2; j++)
+        ret = check_values(kvph, db_id, num_keys, false, false);
+
+    /* **** overwrites invalidate the cached values **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i += 2) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "new" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+    if(ret == 0)
+        ret = check_values(kvph, db_id, num_keys, true, false);
+
+    /* **** so do erasures, of single keys and of prefixes **** */
+    if(ret == 0) {
+        std::string k = "key0";
+        ret = sdskv_erase(kvph, db_id, k.data(), k.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_erase() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0) {
+        std::string prefix = "key1";
+        hg_size_t num_erased = 0;
+        ret = sdskv_erase_prefixed(kvph, db_id, prefix.data(), prefix.size(), &num_erased);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_erase_prefixed() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0)
+        ret = check_values(kvph, db_id, num_keys, true, true);
+
+    /* **** the cache reports its hits and invalidations **** */
+    if(ret == 0) {
+        char* stats = NULL;
+        ret = sdskv_get_statistics(kvph, &stats);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_statistics() failed\n");
+        } else {
+            uint64_t hits = cache_counter(stats, "hits");
+            uint64_t invalidations = cache_counter(stats, "invalidations");
+            if(hits < num_keys || invalidations == 0) {
+                fprintf(stderr, "Error: %lu hits and %lu invalidations in statistics %s\n",
+                        hits, invalidations, stats);
+                ret = -1;
+            }
+            free(stats);
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly read %u cached values\n", num_keys);
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* checks the values, and lengths, of the keys, of which the even ones may
+ * have been overwritten and key0 and the ones starting with key1 erased */
+static int check_values(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        uint32_t num_keys, bool overwritten, bool erased)
+{
+    for(unsigned i=0; i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string expected = (overwritten && i % 2 == 0 ? "new" : "value")
+                             + std::to_string(i);
+        bool gone = erased && (i == 0 || k.compare(0, 4, "key1") == 0);
+        char value[64];
+        hg_size_t vsize = sizeof(value);
+        int ret = sdskv_get(kvph, db_id, k.data(), k.size(), value, &vsize);
+        if(gone) {
+            if(ret == SDSKV_ERR_UNKNOWN_KEY) continue;
+            fprintf(stderr, "Error: erased key %s could be read (ret = %d)\n",
+                    k.c_str(), ret);
+            return -1;
+        }
+        if(ret != 0 || std::string(value, vsize) != expected) {
+            fprintf(stderr, "Error: sdskv_get() of key %s returned a wrong value (ret = %d)\n",
+                    k.c_str(), ret);
+            return -1;
+        }
+        ret = sdskv_length(kvph, db_id, k.data(), k.size(), &vsize);
+        if(ret != 0 || vsize != expected.size()) {
+            fprintf(stderr, "Error: sdskv_length() of key %s returned %lu (ret = %d)\n",
+                    k.c_str(), vsize, ret);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* returns the value of a counter of the "cache" entry of the statistics */
+static uint64_t cache_counter(const char* stats, const char* name)
+{
+    const char* cache = strstr(stats, "\"cache\"");
+    if(cache == NULL) return 0;
+    std::string field = std::string("\"") + name + "\":";
+    const char* counter = strstr(cache, field.c_str());
+    if(counter == NULL) return 0;
+    return strtoull(counter + field.size(), NULL, 10);
+}
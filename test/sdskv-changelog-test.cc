@@ -0,0 +1,207 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "sdskv-client.h"
+
+struct op {
+    sdskv_watch_event_type_t type;
+    std::string              key;
+    std::string              value;
+};
+
+static int read_changes(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        uint64_t since, std::vector<op>& ops, std::vector<uint64_t>& seqs);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database, which has a change log */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret != 0)
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+
+    /* **** put keys and erase one in three, remembering the changes **** */
+    std::vector<op> expected;
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+        expected.push_back({SDSKV_WATCH_PUT, k, v});
+        if(ret == 0 && i % 3 == 0) {
+            ret = sdskv_erase(kvph, db_id, k.data(), k.size());
+            if(ret != 0)
+                fprintf(stderr, "Error: sdskv_erase() failed for key %s\n", k.c_str());
+            expected.push_back({SDSKV_WATCH_ERASE, k, ""});
+        }
+    }
+
+    /* **** the log has all of them, in order **** */
+    std::vector<op> changes;
+    std::vector<uint64_t> seqs;
+    if(ret == 0) {
+        ret = read_changes(kvph, db_id, 0, changes, seqs);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_get_changes() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0) {
+        bool ok = changes.size() == expected.size()
+               && std::is_sorted(seqs.begin(), seqs.end())
+               && std::adjacent_find(seqs.begin(), seqs.end()) == seqs.end();
+        for(size_t i=0; ok && i < changes.size(); i++)
+            ok = changes[i].type == expected[i].type
+              && changes[i].key == expected[i].key
+              && changes[i].value == expected[i].value;
+        if(!ok) {
+            fprintf(stderr, "Error: read %lu changes instead of the %lu made\n",
+                    changes.size(), expected.size());
+            ret = -1;
+        }
+    }
+
+    /* **** truncate the first half of the log **** */
+    uint64_t upto = ret == 0 ? seqs[seqs.size() / 2 - 1] : 0;
+    if(ret == 0) {
+        ret = sdskv_truncate_changes(kvph, db_id, upto);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_truncate_changes() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0) {
+        changes.clear();
+        seqs.clear();
+        ret = read_changes(kvph, db_id, 0, changes, seqs);
+        if(ret != SDSKV_ERR_LOG_TRUNCATED) {
+            fprintf(stderr, "Error: truncated changes could be read (ret = %d)\n", ret);
+            ret = -1;
+        } else {
+            ret = 0;
+        }
+    }
+    if(ret == 0) {
+        changes.clear();
+        seqs.clear();
+        ret = read_changes(kvph, db_id, upto, changes, seqs);
+        size_t rest = expected.size() - expected.size() / 2;
+        if(ret != 0 || changes.size() != rest
+        || changes.front().key != expected[expected.size() / 2].key) {
+            fprintf(stderr, "Error: read %lu changes after truncation instead of %lu (ret = %d)\n",
+                    changes.size(), rest, ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly read and truncated %lu changes\n", expected.size());
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* reads the changes after since in small batches */
+static int read_changes(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        uint64_t since, std::vector<op>& ops, std::vector<uint64_t>& seqs)
+{
+    std::vector<sdskv_change_t> batch(32);
+    std::vector<char> buffer(1024);
+    uint64_t last_seq = 0;
+    do {
+        hg_size_t num_changes = batch.size();
+        int ret = sdskv_get_changes(kvph, db_id, since, &num_changes,
+                batch.data(), buffer.data(), buffer.size(), &last_seq);
+        if(ret != SDSKV_SUCCESS) return ret;
+        if(num_changes == 0) break;
+        for(hg_size_t i=0; i < num_changes; i++) {
+            const sdskv_change_t& c = batch[i];
+            std::string value;
+            if(c.value) value.assign((const char*)c.value, c.vsize);
+            ops.push_back({c.type, std::string((const char*)c.key, c.ksize), value});
+            seqs.push_back(c.seq);
+        }
+        since = batch[num_changes - 1].seq;
+    } while(since < last_seq);
+    return SDSKV_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+
+#include "sdskv-client.h"
+
+static std::string make_value(unsigned i);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database, whose values are compressed by the provider */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret != 0)
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+
+    /* **** put values, some too small to be compressed, some that do not
+     * compress **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = make_value(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+
+    /* **** get them back, with their uncompressed length **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string expected = make_value(i);
+        hg_size_t vsize = 0;
+        ret = sdskv_length(kvph, db_id, k.data(), k.size(), &vsize);
+        if(ret != 0 || vsize != expected.size()) {
+            fprintf(stderr, "Error: sdskv_length() of key %s returned %lu (ret = %d)\n",
+                    k.c_str(), vsize, ret);
+            ret = -1;
+            break;
+        }
+        std::vector<char> v(vsize);
+        ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(ret != 0 || std::string(v.data(), vsize) != expected) {
+            fprintf(stderr, "Error: sdskv_get() of key %s returned a wrong value (ret = %d)\n",
+                    k.c_str(), ret);
+            ret = -1;
+        }
+    }
+
+    /* **** appends decompress the value and compress it again **** */
+    std::string k = "key0";
+    std::string expected = make_value(0);
+    for(unsigned i=0; ret == 0 && i < 4; i++) {
+        std::string v = make_value(i + 1);
+        hg_size_t new_size;
+        ret = sdskv_append(kvph, db_id, k.data(), k.size(), v.data(), v.size(), &new_size);
+        expected += v;
+        if(ret != 0 || new_size != expected.size()) {
+            fprintf(stderr, "Error: sdskv_append() failed (ret = %d)\n", ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0) {
+        std::vector<char> v(expected.size());
+        hg_size_t vsize = v.size();
+        ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(ret != 0 || std::string(v.data(), vsize) != expected) {
+            fprintf(stderr, "Error: value after sdskv_append() is incorrect (ret = %d)\n", ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly read %d compressed values\n", num_keys);
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* values of even keys are repetitive and compress well, odd ones are
+ * pseudo-random; one in four is shorter than the compression threshold */
+static std::string make_value(unsigned i)
+{
+    size_t size = (i % 4 == 0) ? 16 + i % 64 : 512 + 37 * i;
+    std::string v(size, 'a');
+    uint32_t x = 2463534242u + i;
+    for(size_t j = 0; j < size; j++) {
+        if(i % 2) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            v[j] = (char)x;
+        } else {
+            v[j] = 'a' + (j % 7);
+        }
+    }
+    return v;
+}
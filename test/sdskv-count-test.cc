@@ -0,0 +1,228 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string make_key(char group, unsigned i);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys in three groups, "a/...", "b/..." and "c/..." **** */
+    /* the value of the i-th key of a group has i+1 bytes */
+    std::vector<char> value(num_keys, 'x');
+    const char groups[] = { 'a', 'b', 'c' };
+
+    for(char g : groups) {
+        for(unsigned i=0; i < num_keys; i++) {
+            auto k = make_key(g, i);
+            ret = sdskv_put(kvph, db_id,
+                    (const void *)k.data(), k.size(),
+                    (const void *)value.data(), i+1);
+            if(ret != 0) {
+                fprintf(stderr, "Error: sdskv_put() failed (key was %s)\n", k.c_str());
+                sdskv_shutdown_service(kvcl, svr_addr);
+                sdskv_provider_handle_release(kvph);
+                margo_addr_free(mid, svr_addr);
+                sdskv_client_finalize(kvcl);
+                margo_finalize(mid);
+                return -1;
+            }
+        }
+    }
+    printf("Successfuly inserted %d keys\n", 3*num_keys);
+
+    hg_size_t ksize = make_key('a', 0).size();
+    hg_size_t num_keys_out = 0, key_bytes = 0, value_bytes = 0;
+
+    /* **** count the keys starting with "b/" **** */
+    std::string prefix = "b/";
+    ret = sdskv_count_prefixed(kvph, db_id,
+            (const void*)prefix.data(), prefix.size(),
+            &num_keys_out, &key_bytes, &value_bytes);
+    if(ret != 0 || num_keys_out != num_keys
+    || key_bytes != num_keys*ksize
+    || value_bytes != (hg_size_t)num_keys*(num_keys+1)/2) {
+        fprintf(stderr, "Error: sdskv_count_prefixed() failed (ret = %d, %ld keys, %ld key bytes, %ld value bytes)\n",
+                ret, num_keys_out, key_bytes, value_bytes);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly counted %ld keys with prefix %s\n", num_keys_out, prefix.c_str());
+
+    /* **** count the first half of the "a/" keys **** */
+    std::string lower = make_key('a', 0);
+    std::string upper = make_key('a', num_keys/2);
+    ret = sdskv_count_range(kvph, db_id,
+            (const void*)lower.data(), lower.size(),
+            (const void*)upper.data(), upper.size(),
+            &num_keys_out, NULL, &value_bytes);
+    if(ret != 0 || num_keys_out != num_keys/2
+    || value_bytes != (hg_size_t)(num_keys/2)*(num_keys/2+1)/2) {
+        fprintf(stderr, "Error: sdskv_count_range() failed (ret = %d, %ld keys, %ld value bytes)\n",
+                ret, num_keys_out, value_bytes);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly counted %ld keys in range [%s, %s)\n", num_keys_out,
+            lower.c_str(), upper.c_str());
+
+    /* **** count the whole database, without and with sizes **** */
+    ret = sdskv_count_range(kvph, db_id, NULL, 0, NULL, 0,
+            &num_keys_out, NULL, NULL);
+    if(ret == 0 && num_keys_out == 3*num_keys) {
+        ret = sdskv_count_range(kvph, db_id, NULL, 0, NULL, 0,
+                &num_keys_out, &key_bytes, &value_bytes);
+    }
+    if(ret != 0 || num_keys_out != 3*num_keys
+    || key_bytes != 3*num_keys*ksize
+    || value_bytes != (hg_size_t)3*num_keys*(num_keys+1)/2) {
+        fprintf(stderr, "Error: sdskv_count_range() failed on the whole database (ret = %d, %ld keys)\n",
+                ret, num_keys_out);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly counted the %ld keys of the database\n", num_keys_out);
+
+    /* **** count a prefix whose successor has a byte above 0x7f **** */
+    std::string high_prefix = "d\x7f";
+    std::vector<std::string> high_keys = { "d\x7f" "0", "d\x7f" "1", "d\x80" };
+    for(unsigned i=0; ret == 0 && i < high_keys.size(); i++)
+        ret = sdskv_put(kvph, db_id,
+                (const void*)high_keys[i].data(), high_keys[i].size(),
+                (const void*)value.data(), 1);
+    if(ret == 0)
+        ret = sdskv_count_prefixed(kvph, db_id,
+                (const void*)high_prefix.data(), high_prefix.size(),
+                &num_keys_out, NULL, NULL);
+    if(ret != 0 || num_keys_out != 2) {
+        fprintf(stderr, "Error: sdskv_count_prefixed() failed with a prefix ending in 0x7f (ret = %d, %ld keys)\n",
+                ret, num_keys_out);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly counted %ld keys with a prefix ending in 0x7f\n", num_keys_out);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string make_key(char group, unsigned i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%c/%08u", group, i);
+    return std::string(buf);
+}
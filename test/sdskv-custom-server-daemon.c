@@ -34,7 +34,7 @@ int custom_key_cmp(const void* x, size_t sx, const void* y, size_t sy) {
 
 static void usage(int argc, char **argv)
 {
-    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:bwt|:bdb|:ldb] <db name 2>[:map|:bwt|:bdb|:ldb] ...\n");
+    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:bwt|:bdb|:ldb|:mdb|:rdb] <db name 2>[:map|:bwt|:bdb|:ldb|:mdb|:rdb] ...\n");
     fprintf(stderr, "       listen_addr is the Mercury address to listen on\n");
     fprintf(stderr, "       db name X are the names of the databases\n");
     fprintf(stderr, "       [-f filename] to write the server address to a file\n");
@@ -58,6 +58,10 @@ static sdskv_db_type_t parse_db_type(char* db_fullname) {
         return KVDB_BERKELEYDB;
     } else if(strcmp(db_type, "ldb") == 0) {
         return KVDB_LEVELDB;
+    } else if(strcmp(db_type, "mdb") == 0) {
+        return KVDB_LMDB;
+    } else if(strcmp(db_type, "rdb") == 0) {
+        return KVDB_ROCKSDB;
     }
     fprintf(stderr, "Unknown database type \"%s\"\n", db_type);
     exit(-1);
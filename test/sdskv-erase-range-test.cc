@@ -0,0 +1,217 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "sdskv-client.h"
+
+static std::string make_key(char group, unsigned i);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys in three groups, "a/...", "b/..." and "c/..." **** */
+    std::set<std::string> reference;
+    const char groups[] = { 'a', 'b', 'c' };
+
+    for(char g : groups) {
+        for(unsigned i=0; i < num_keys; i++) {
+            auto k = make_key(g, i);
+            ret = sdskv_put(kvph, db_id,
+                    (const void *)k.data(), k.size(),
+                    (const void *)k.data(), k.size());
+            if(ret != 0) {
+                fprintf(stderr, "Error: sdskv_put() failed (key was %s)\n", k.c_str());
+                sdskv_shutdown_service(kvcl, svr_addr);
+                sdskv_provider_handle_release(kvph);
+                margo_addr_free(mid, svr_addr);
+                sdskv_client_finalize(kvcl);
+                margo_finalize(mid);
+                return -1;
+            }
+            reference.insert(k);
+        }
+    }
+    printf("Successfuly inserted %d keys\n", 3*num_keys);
+
+    /* **** erase all the keys starting with "b/" **** */
+    hg_size_t num_erased = 0;
+    std::string prefix = "b/";
+    ret = sdskv_erase_prefixed(kvph, db_id,
+            (const void*)prefix.data(), prefix.size(), &num_erased);
+    if(ret != 0 || num_erased != num_keys) {
+        fprintf(stderr, "Error: sdskv_erase_prefixed() failed (ret = %d, %ld keys erased instead of %d)\n",
+                ret, num_erased, num_keys);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    for(unsigned i=0; i < num_keys; i++)
+        reference.erase(make_key('b', i));
+    printf("Successfuly erased %ld keys with prefix %s\n", num_erased, prefix.c_str());
+
+    /* **** erase the first half of the "a/" keys **** */
+    std::string lower = make_key('a', 0);
+    std::string upper = make_key('a', num_keys/2);
+    ret = sdskv_erase_range(kvph, db_id,
+            (const void*)lower.data(), lower.size(),
+            (const void*)upper.data(), upper.size(), &num_erased);
+    if(ret != 0 || num_erased != num_keys/2) {
+        fprintf(stderr, "Error: sdskv_erase_range() failed (ret = %d, %ld keys erased instead of %d)\n",
+                ret, num_erased, num_keys/2);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    for(unsigned i=0; i < num_keys/2; i++)
+        reference.erase(make_key('a', i));
+    printf("Successfuly erased %ld keys in range [%s, %s)\n", num_erased,
+            lower.c_str(), upper.c_str());
+
+    /* **** check that exactly the remaining keys exist **** */
+    for(char g : groups) {
+        for(unsigned i=0; i < num_keys; i++) {
+            auto k = make_key(g, i);
+            int flag = 0;
+            ret = sdskv_exists(kvph, db_id,
+                    (const void *)k.data(), k.size(), &flag);
+            bool expected = reference.count(k) != 0;
+            if(ret != 0 || (flag != 0) != expected) {
+                fprintf(stderr, "Error: key %s should %s\n", k.c_str(),
+                        expected ? "exist" : "have been erased");
+                sdskv_shutdown_service(kvcl, svr_addr);
+                sdskv_provider_handle_release(kvph);
+                margo_addr_free(mid, svr_addr);
+                sdskv_client_finalize(kvcl);
+                margo_finalize(mid);
+                return -1;
+            }
+        }
+    }
+
+    /* **** erase the rest of the database **** */
+    ret = sdskv_erase_range(kvph, db_id, NULL, 0, NULL, 0, &num_erased);
+    if(ret != 0 || num_erased != reference.size()) {
+        fprintf(stderr, "Error: sdskv_erase_range() failed (ret = %d, %ld keys erased instead of %ld)\n",
+                ret, num_erased, reference.size());
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly erased the remaining %ld keys\n", num_erased);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string make_key(char group, unsigned i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%c/%08u", group, i);
+    return std::string(buf);
+}
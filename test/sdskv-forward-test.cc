@@ -0,0 +1,199 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+
+#include "sdskv-client.h"
+
+static bool check_key(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        const std::string& key, bool present);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database, a forward database with a small front tier */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret != 0)
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+
+    /* **** put more keys than the front tier holds, around the 0x80 byte,
+     * and read them back so that they are cached clean **** */
+    std::vector<std::string> keys;
+    for(unsigned i=0; i < num_keys; i++) {
+        keys.push_back(std::string("p\x7f") + std::to_string(i));
+        keys.push_back(std::string("p\x80") + std::to_string(i));
+        keys.push_back(std::string("q") + std::to_string(i));
+    }
+    for(unsigned i=0; ret == 0 && i < keys.size(); i++) {
+        ret = sdskv_put(kvph, db_id, keys[i].data(), keys[i].size(),
+                keys[i].data(), keys[i].size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed (ret = %d)\n", ret);
+    }
+    for(unsigned i=0; ret == 0 && i < keys.size(); i++) {
+        if(!check_key(kvph, db_id, keys[i], true)) {
+            fprintf(stderr, "Error: key %u has a wrong value\n", i);
+            ret = -1;
+        }
+    }
+
+    /* **** erase the keys with a prefix whose successor starts with a byte
+     * above 0x7f: the cached ones must go too **** */
+    std::string prefix = "p\x7f";
+    hg_size_t num_erased = 0;
+    if(ret == 0) {
+        ret = sdskv_erase_prefixed(kvph, db_id, prefix.data(), prefix.size(),
+                &num_erased);
+        if(ret != 0 || num_erased != num_keys) {
+            fprintf(stderr, "Error: sdskv_erase_prefixed() erased %lu keys (ret = %d)\n",
+                    num_erased, ret);
+            ret = -1;
+        }
+    }
+    for(unsigned i=0; ret == 0 && i < keys.size(); i++) {
+        bool present = keys[i].compare(0, prefix.size(), prefix) != 0;
+        if(!check_key(kvph, db_id, keys[i], present)) {
+            fprintf(stderr, "Error: key %u is %s after sdskv_erase_prefixed()\n",
+                    i, present ? "missing" : "still present");
+            ret = -1;
+        }
+    }
+
+    /* **** same with a range spanning 0x80 **** */
+    std::string lower = "p\x7f", upper = "p\x81";
+    if(ret == 0) {
+        ret = sdskv_erase_range(kvph, db_id, lower.data(), lower.size(),
+                upper.data(), upper.size(), &num_erased);
+        if(ret != 0 || num_erased != num_keys) {
+            fprintf(stderr, "Error: sdskv_erase_range() erased %lu keys (ret = %d)\n",
+                    num_erased, ret);
+            ret = -1;
+        }
+    }
+    for(unsigned i=0; ret == 0 && i < keys.size(); i++) {
+        bool present = keys[i][0] == 'q';
+        if(!check_key(kvph, db_id, keys[i], present)) {
+            fprintf(stderr, "Error: key %u is %s after sdskv_erase_range()\n",
+                    i, present ? "missing" : "still present");
+            ret = -1;
+        }
+    }
+
+    /* **** modify keys while the background flusher runs **** */
+    for(unsigned j=0; ret == 0 && j < 5; j++) {
+        for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+            std::string k = "q" + std::to_string(i);
+            std::string v = k + "/" + std::to_string(j);
+            ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        }
+        margo_thread_sleep(mid, 50);
+    }
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "q" + std::to_string(i);
+        std::string expected = k + "/4";
+        std::vector<char> v(expected.size() + 16);
+        hg_size_t vsize = v.size();
+        ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(ret != 0 || std::string(v.data(), vsize) != expected) {
+            fprintf(stderr, "Error: key %s has a stale value (ret = %d)\n", k.c_str(), ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly checked %lu keys\n", keys.size());
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* checks that a key is absent, or present with itself as value */
+static bool check_key(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        const std::string& key, bool present)
+{
+    std::vector<char> v(key.size() + 16);
+    hg_size_t vsize = v.size();
+    int ret = sdskv_get(kvph, db_id, key.data(), key.size(), v.data(), &vsize);
+    if(!present) return ret == SDSKV_ERR_UNKNOWN_KEY;
+    return ret == SDSKV_SUCCESS && std::string(v.data(), vsize) == key;
+}
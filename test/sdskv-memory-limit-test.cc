@@ -0,0 +1,233 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "sdskv-client.h"
+
+/* the databases are limited to 16 KiB and the values take 1 KiB each */
+#define VALUE_SIZE 1024
+#define MAX_MEMORY (16 * 1024)
+
+static int count_erasures(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        std::vector<std::string>& erased);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the databases, <db_name>-reject and <db_name>-evict, which have
+     * the "reject" and "evict" memory policies */
+    std::string reject_name = std::string(db_name) + "-reject";
+    std::string evict_name  = std::string(db_name) + "-evict";
+    sdskv_database_id_t reject_id, evict_id;
+    ret = sdskv_open(kvph, reject_name.c_str(), &reject_id);
+    if(ret != 0) {
+        fprintf(stderr, "Error: could not open database %s\n", reject_name.c_str());
+    } else {
+        ret = sdskv_open(kvph, evict_name.c_str(), &evict_id);
+        if(ret != 0)
+            fprintf(stderr, "Error: could not open database %s\n", evict_name.c_str());
+    }
+
+    std::string value(VALUE_SIZE, 'v');
+    std::string too_large(2 * MAX_MEMORY, 'v');
+
+    /* **** puts are rejected once the limit is reached **** */
+    unsigned num_stored = 0;
+    for(; ret == 0 && num_stored < num_keys; num_stored++) {
+        std::string k = "key" + std::to_string(num_stored);
+        ret = sdskv_put(kvph, reject_id, k.data(), k.size(), value.data(), value.size());
+    }
+    if(ret != SDSKV_ERR_FULL || num_stored < 2) {
+        fprintf(stderr, "Error: sdskv_put() returned %d after %u keys instead of SDSKV_ERR_FULL\n",
+                ret, num_stored);
+        ret = -1;
+    } else {
+        num_stored -= 1;
+        ret = 0;
+    }
+    /* the keys put before are kept */
+    for(unsigned i=0; ret == 0 && i < num_stored; i++) {
+        std::string k = "key" + std::to_string(i);
+        int flag = 0;
+        ret = sdskv_exists(kvph, reject_id, k.data(), k.size(), &flag);
+        if(ret != 0 || !flag) {
+            fprintf(stderr, "Error: key %s was lost by a rejected put\n", k.c_str());
+            ret = -1;
+        }
+    }
+    /* erasing a key makes room for another */
+    if(ret == 0) {
+        std::string k = "key0";
+        ret = sdskv_erase(kvph, reject_id, k.data(), k.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_erase() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0) {
+        std::string k = "key" + std::to_string(num_stored);
+        ret = sdskv_put(kvph, reject_id, k.data(), k.size(), value.data(), value.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed after an erase (ret = %d)\n", ret);
+    }
+
+    /* **** puts evict other keys once the limit is reached **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        ret = sdskv_put(kvph, evict_id, k.data(), k.size(), value.data(), value.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s (ret = %d)\n", k.c_str(), ret);
+    }
+    std::vector<std::string> evicted;
+    unsigned num_kept = 0;
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        int flag = 0;
+        ret = sdskv_exists(kvph, evict_id, k.data(), k.size(), &flag);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_exists() failed for key %s\n", k.c_str());
+        num_kept += flag;
+        if(!flag) evicted.push_back(k);
+    }
+    std::sort(evicted.begin(), evicted.end());
+    if(ret == 0 && (num_kept == 0 || num_kept == num_keys)) {
+        fprintf(stderr, "Error: %u keys out of %u were kept\n", num_kept, num_keys);
+        ret = -1;
+    }
+    /* the evicted keys are recorded in the change log as erasures */
+    if(ret == 0) {
+        std::vector<std::string> erased;
+        ret = count_erasures(kvph, evict_id, erased);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_changes() failed (ret = %d)\n", ret);
+        } else if(erased != evicted) {
+            fprintf(stderr, "Error: %lu erasures recorded for %lu evictions\n",
+                    erased.size(), evicted.size());
+            ret = -1;
+        }
+    }
+
+    /* **** a value larger than the limit is rejected by both policies **** */
+    if(ret == 0) {
+        std::string k = "large";
+        sdskv_database_id_t ids[] = { reject_id, evict_id };
+        for(auto id : ids) {
+            ret = sdskv_put(kvph, id, k.data(), k.size(), too_large.data(), too_large.size());
+            if(ret != SDSKV_ERR_FULL) {
+                fprintf(stderr, "Error: a value larger than the limit was not rejected (ret = %d)\n", ret);
+                ret = -1;
+                break;
+            }
+            ret = 0;
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly stored %u keys and kept %u out of %u\n", num_stored, num_kept, num_keys);
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* reads the change log and returns the keys of its erasures, sorted */
+static int count_erasures(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        std::vector<std::string>& erased)
+{
+    std::vector<sdskv_change_t> batch(32);
+    std::vector<char> buffer(64 * VALUE_SIZE);
+    uint64_t since = 0, last_seq = 0;
+    do {
+        hg_size_t num_changes = batch.size();
+        int ret = sdskv_get_changes(kvph, db_id, since, &num_changes,
+                batch.data(), buffer.data(), buffer.size(), &last_seq);
+        if(ret != SDSKV_SUCCESS) return ret;
+        if(num_changes == 0) break;
+        for(hg_size_t i=0; i < num_changes; i++) {
+            const sdskv_change_t& c = batch[i];
+            if(c.type == SDSKV_WATCH_ERASE)
+                erased.push_back(std::string((const char*)c.key, c.ksize));
+        }
+        since = batch[num_changes - 1].seq;
+    } while(since < last_seq);
+    std::sort(erased.begin(), erased.end());
+    return SDSKV_SUCCESS;
+}
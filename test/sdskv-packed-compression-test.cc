@@ -0,0 +1,202 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+#include "sdskv-client.h"
+
+static int put_and_get_packed(sdskv_provider_handle_t kvph,
+        sdskv_database_id_t db_id, uint32_t num_keys,
+        sdskv_compression_t compression, bool compressible);
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** round trips with each codec; codecs that were not built in
+     * and values that do not compress fall back to plain transfers **** */
+    sdskv_compression_t codecs[] = { SDSKV_COMPRESSION_NONE,
+        SDSKV_COMPRESSION_LZ4, SDSKV_COMPRESSION_ZSTD };
+    for(auto codec : codecs) {
+        for(bool compressible : { true, false }) {
+            ret = put_and_get_packed(kvph, db_id, num_keys, codec, compressible);
+            if(ret != 0) {
+                fprintf(stderr, "Error: packed round trip failed with codec %d (%s values)\n",
+                        codec, compressible ? "compressible" : "random");
+                sdskv_shutdown_service(kvcl, svr_addr);
+                sdskv_provider_handle_release(kvph);
+                margo_addr_free(mid, svr_addr);
+                sdskv_client_finalize(kvcl);
+                margo_finalize(mid);
+                return -1;
+            }
+        }
+    }
+    printf("Packed round trips succeeded with all codecs\n");
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static int put_and_get_packed(sdskv_provider_handle_t kvph,
+        sdskv_database_id_t db_id, uint32_t num_keys,
+        sdskv_compression_t compression, bool compressible)
+{
+    std::string packed_keys;
+    std::vector<hg_size_t> packed_key_sizes;
+    std::string packed_vals;
+    std::vector<hg_size_t> packed_val_sizes;
+    std::string prefix = std::to_string(compression)
+                       + (compressible ? "c" : "r");
+
+    for(unsigned i=0; i < num_keys; i++) {
+        auto k = prefix + gen_random_string(16);
+        std::string v;
+        if(compressible) {
+            std::string pattern = "value-" + std::to_string(i) + "-";
+            while(v.size() < 512) v += pattern;
+        } else {
+            v = gen_random_string(512);
+        }
+        packed_keys += k;
+        packed_vals += v;
+        packed_key_sizes.push_back(k.size());
+        packed_val_sizes.push_back(v.size());
+    }
+
+    int ret = sdskv_put_packed_compressed(kvph, db_id, num_keys,
+            packed_keys.data(), packed_key_sizes.data(),
+            packed_vals.data(), packed_val_sizes.data(), compression);
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put_packed_compressed() failed (%d)\n", ret);
+        return -1;
+    }
+
+    size_t count = num_keys;
+    std::string rvals(packed_vals.size(), '\0');
+    std::vector<hg_size_t> rval_sizes(num_keys);
+    ret = sdskv_get_packed_compressed(kvph, db_id, &count,
+            packed_keys.data(), packed_key_sizes.data(),
+            rvals.size(), &rvals[0], rval_sizes.data(), compression);
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_get_packed_compressed() failed (%d)\n", ret);
+        return -1;
+    }
+    if(count != num_keys) {
+        fprintf(stderr, "Error: got %ld values, expected %d\n", count, num_keys);
+        return -1;
+    }
+    if(rval_sizes != packed_val_sizes || rvals != packed_vals) {
+        fprintf(stderr, "Error: values retrieved differ from values put\n");
+        return -1;
+    }
+    return 0;
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
@@ -0,0 +1,285 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+#include "sdskv-client.h"
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put a large value **** */
+    std::string key = "large";
+    std::vector<char> value(num_keys*1000);
+    for(unsigned i=0; i < value.size(); i++) value[i] = 'a' + (i % 26);
+    ret = sdskv_put(kvph, db_id,
+            (const void*)key.data(), key.size(),
+            (const void*)value.data(), value.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put() failed\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* **** overwrite a slice in the middle of the value **** */
+    hg_size_t offset = value.size()/3;
+    std::string slice = "0123456789";
+    ret = sdskv_put_range(kvph, db_id,
+            (const void*)key.data(), key.size(), offset,
+            (const void*)slice.data(), slice.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put_range() failed (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    std::copy(slice.begin(), slice.end(), value.begin() + offset);
+
+    /* **** read slices around it **** */
+    std::vector<char> buffer(100);
+    hg_size_t vsize = buffer.size();
+    ret = sdskv_get_range(kvph, db_id,
+            (const void*)key.data(), key.size(), offset - 45,
+            buffer.data(), &vsize);
+    if(ret != 0 || vsize != buffer.size()
+    || !std::equal(buffer.begin(), buffer.end(), value.begin() + offset - 45)) {
+        fprintf(stderr, "Error: sdskv_get_range() returned incorrect data (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* the value ends before offset + size */
+    vsize = buffer.size();
+    ret = sdskv_get_range(kvph, db_id,
+            (const void*)key.data(), key.size(), value.size() - 10,
+            buffer.data(), &vsize);
+    if(ret != 0 || vsize != 10
+    || !std::equal(buffer.begin(), buffer.begin() + 10, value.end() - 10)) {
+        fprintf(stderr, "Error: sdskv_get_range() at the end of the value failed (ret = %d, size = %ld)\n",
+                ret, vsize);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* the offset is past the end of the value */
+    vsize = buffer.size();
+    ret = sdskv_get_range(kvph, db_id,
+            (const void*)key.data(), key.size(), value.size() + 10,
+            buffer.data(), &vsize);
+    if(ret != 0 || vsize != 0) {
+        fprintf(stderr, "Error: sdskv_get_range() past the end of the value failed (ret = %d, size = %ld)\n",
+                ret, vsize);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* the key does not exist */
+    std::string missing = "missing";
+    vsize = buffer.size();
+    ret = sdskv_get_range(kvph, db_id,
+            (const void*)missing.data(), missing.size(), 0,
+            buffer.data(), &vsize);
+    if(ret != SDSKV_ERR_UNKNOWN_KEY) {
+        fprintf(stderr, "Error: sdskv_get_range() on a missing key returned %d\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly read slices of a %ld-byte value\n", value.size());
+
+    /* **** extend the value past its end **** */
+    hg_size_t old_size = value.size();
+    ret = sdskv_put_range(kvph, db_id,
+            (const void*)key.data(), key.size(), old_size + 5,
+            (const void*)slice.data(), slice.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put_range() past the end failed (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    value.resize(old_size + 5, 0);
+    value.insert(value.end(), slice.begin(), slice.end());
+    buffer.resize(value.size());
+    vsize = buffer.size();
+    ret = sdskv_get(kvph, db_id,
+            (const void*)key.data(), key.size(), buffer.data(), &vsize);
+    if(ret != 0 || buffer != value) {
+        fprintf(stderr, "Error: value after extending sdskv_put_range() is incorrect\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* **** write at an offset in a new key **** */
+    std::string new_key = "new";
+    ret = sdskv_put_range(kvph, db_id,
+            (const void*)new_key.data(), new_key.size(), 3,
+            (const void*)slice.data(), slice.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put_range() on a new key failed (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    std::string expected = std::string(3, '\0') + slice;
+    buffer.resize(64);
+    vsize = buffer.size();
+    ret = sdskv_get(kvph, db_id,
+            (const void*)new_key.data(), new_key.size(), buffer.data(), &vsize);
+    if(ret != 0 || std::string(buffer.data(), vsize) != expected) {
+        fprintf(stderr, "Error: value after sdskv_put_range() on a new key is incorrect\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* **** offsets whose end wraps around or is too large are refused **** */
+    hg_size_t bad_offsets[] = { (hg_size_t)-1, ((hg_size_t)1) << 40 };
+    for(hg_size_t bad_offset : bad_offsets) {
+        ret = sdskv_put_range(kvph, db_id,
+                (const void*)new_key.data(), new_key.size(), bad_offset,
+                (const void*)slice.data(), slice.size());
+        if(ret != SDSKV_ERR_SIZE) {
+            fprintf(stderr, "Error: sdskv_put_range() at offset %llu returned %d instead of SDSKV_ERR_SIZE\n",
+                    (unsigned long long)bad_offset, ret);
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+    }
+    printf("Successfuly wrote slices of values\n");
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
@@ -0,0 +1,241 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+
+#include "sdskv-client.h"
+
+static bool check_backup(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        const std::string& prefix, uint32_t num_keys, bool with_erased);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_strA;
+    char *sdskv_svr_addr_strB;
+    char *db_nameA;
+    char *db_nameB;
+    margo_instance_id mid;
+    hg_addr_t svr_addrA;
+    hg_addr_t svr_addrB;
+    uint8_t mplex_idA, mplex_idB;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvphA, kvphB;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 8)
+    {
+        fprintf(stderr, "Usage: %s <server_addrA> <mplex_idA> <db_nameA> <server_addrB> <mplex_idB> <db_nameB> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo tcp://localhost:1235 1 bar 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_strA = argv[1];
+    mplex_idA           = atoi(argv[2]);
+    db_nameA            = argv[3];
+    sdskv_svr_addr_strB = argv[4];
+    mplex_idB           = atoi(argv[5]);
+    db_nameB            = argv[6];
+    num_keys            = atoi(argv[7]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_strA[i] != '\0' && sdskv_svr_addr_strA[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_strA[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address A */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_strA, &svr_addrA);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+    /* look up the SDSKV server address B */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_strB, &svr_addrB);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        margo_addr_free(mid, svr_addrA);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle for provider A */
+    ret = sdskv_provider_handle_create(kvcl, svr_addrA, mplex_idA, &kvphA);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addrA);
+        margo_addr_free(mid, svr_addrB);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle for provider B */
+    ret = sdskv_provider_handle_create(kvcl, svr_addrB, mplex_idB, &kvphB);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        sdskv_provider_handle_release(kvphA);
+        margo_addr_free(mid, svr_addrA);
+        margo_addr_free(mid, svr_addrB);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the databases */
+    sdskv_database_id_t db_idA, db_idB;
+    ret = sdskv_open(kvphA, db_nameA, &db_idA);
+    if(ret != 0) {
+        fprintf(stderr, "Error: could not open database %s\n", db_nameA);
+    } else {
+        ret = sdskv_open(kvphB, db_nameB, &db_idB);
+        if(ret != 0)
+            fprintf(stderr, "Error: could not open database %s\n", db_nameB);
+    }
+
+    /* **** put half of the keys before adding the backup, which gets them
+     * by being copied, and the other half after **** */
+    for(unsigned i=0; ret == 0 && i < num_keys / 2; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvphA, db_idA, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+    if(ret == 0) {
+        ret = sdskv_add_backup(kvphA, db_idA, sdskv_svr_addr_strB, mplex_idB, db_idB, 1);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_add_backup() failed (ret = %d)\n", ret);
+    }
+    for(unsigned i=num_keys / 2; ret == 0 && i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvphA, db_idA, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+    /* erase one key in four */
+    for(unsigned i=0; ret == 0 && i < num_keys; i += 4) {
+        std::string k = "key" + std::to_string(i);
+        ret = sdskv_erase(kvphA, db_idA, k.data(), k.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_erase() failed for key %s\n", k.c_str());
+    }
+
+    /* **** a sync backup has the writes as soon as they return **** */
+    if(ret == 0 && !check_backup(kvphB, db_idB, "key", num_keys, true)) {
+        fprintf(stderr, "Error: sync backup does not match its database\n");
+        ret = -1;
+    }
+
+    /* **** turn the backup into an async one **** */
+    if(ret == 0) {
+        ret = sdskv_remove_backup(kvphA, db_idA, sdskv_svr_addr_strB, mplex_idB, db_idB);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_remove_backup() failed (ret = %d)\n", ret);
+    }
+    if(ret == 0) {
+        ret = sdskv_remove_backup(kvphA, db_idA, sdskv_svr_addr_strB, mplex_idB, db_idB);
+        if(ret != SDSKV_ERR_UNKNOWN_BACKUP) {
+            fprintf(stderr, "Error: removed backup could be removed again\n");
+            ret = -1;
+        } else {
+            ret = 0;
+        }
+    }
+    if(ret == 0) {
+        ret = sdskv_add_backup(kvphA, db_idA, sdskv_svr_addr_strB, mplex_idB, db_idB, 0);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_add_backup() failed (ret = %d)\n", ret);
+    }
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "async" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvphA, db_idA, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+
+    /* **** an async backup gets them eventually **** */
+    if(ret == 0) {
+        for(unsigned i=0; i < 100 && !check_backup(kvphB, db_idB, "async", num_keys, false); i++)
+            margo_thread_sleep(mid, 100);
+        if(!check_backup(kvphB, db_idB, "async", num_keys, false)) {
+            fprintf(stderr, "Error: async backup does not match its database\n");
+            ret = -1;
+        } else {
+            printf("Replicated %u keys\n", 2 * num_keys);
+        }
+    }
+    if(ret == 0) {
+        ret = sdskv_remove_backup(kvphA, db_idA, sdskv_svr_addr_strB, mplex_idB, db_idB);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_remove_backup() failed (ret = %d)\n", ret);
+    }
+
+    /* shutdown the servers */
+    sdskv_shutdown_service(kvcl, svr_addrA);
+    sdskv_shutdown_service(kvcl, svr_addrB);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvphA);
+    sdskv_provider_handle_release(kvphB);
+    margo_addr_free(mid, svr_addrA);
+    margo_addr_free(mid, svr_addrB);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
+
+/* checks that the backup has the keys starting with prefix, without the
+ * ones erased if with_erased is true */
+static bool check_backup(sdskv_provider_handle_t kvph, sdskv_database_id_t db_id,
+        const std::string& prefix, uint32_t num_keys, bool with_erased)
+{
+    for(unsigned i=0; i < num_keys; i++) {
+        std::string k = prefix + std::to_string(i);
+        std::string expected = "value" + std::to_string(i);
+        std::vector<char> v(expected.size() + 16);
+        hg_size_t vsize = v.size();
+        int ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(with_erased && i % 4 == 0) {
+            if(ret != SDSKV_ERR_UNKNOWN_KEY) return false;
+            continue;
+        }
+        if(ret != SDSKV_SUCCESS) return false;
+        if(std::string(v.data(), vsize) != expected) return false;
+    }
+    return true;
+}
@@ -0,0 +1,279 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+#include "sdskv-client.h"
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** fetch-and-add on a counter that does not exist yet **** */
+    std::string counter = "counter";
+    int64_t expected_value = 0;
+    for(unsigned i=0; i < num_keys; i++) {
+        int64_t previous = -1;
+        ret = sdskv_fetch_add(kvph, db_id,
+                (const void*)counter.data(), counter.size(), i, &previous);
+        if(ret != 0 || previous != expected_value) {
+            fprintf(stderr, "Error: sdskv_fetch_add() failed (ret = %d, previous = %ld instead of %ld)\n",
+                    ret, previous, expected_value);
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+        expected_value += i;
+    }
+    int64_t stored = 0;
+    hg_size_t vsize = sizeof(stored);
+    ret = sdskv_get(kvph, db_id,
+            (const void*)counter.data(), counter.size(), &stored, &vsize);
+    if(ret != 0 || vsize != sizeof(stored) || stored != expected_value) {
+        fprintf(stderr, "Error: counter has value %ld instead of %ld\n", stored, expected_value);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly incremented counter to %ld\n", stored);
+
+    /* **** fetch-and-add on a value that is not an integer **** */
+    std::string text_key = "text";
+    std::string text = "abc";
+    ret = sdskv_put(kvph, db_id,
+            (const void*)text_key.data(), text_key.size(),
+            (const void*)text.data(), text.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put() failed\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    ret = sdskv_fetch_add(kvph, db_id,
+            (const void*)text_key.data(), text_key.size(), 1, NULL);
+    if(ret != SDSKV_ERR_SIZE) {
+        fprintf(stderr, "Error: sdskv_fetch_add() on a 3-byte value returned %d\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* **** compare-and-swap **** */
+    std::string cas_key = "cas";
+    std::string v1 = "first value", v2 = "second value";
+    int swapped = 0;
+    /* the key does not exist, so a NULL expected value matches */
+    ret = sdskv_compare_and_swap(kvph, db_id,
+            (const void*)cas_key.data(), cas_key.size(), NULL, 0,
+            (const void*)v1.data(), v1.size(), &swapped);
+    if(ret != 0 || !swapped) {
+        fprintf(stderr, "Error: sdskv_compare_and_swap() did not create the key (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* the key now exists */
+    ret = sdskv_compare_and_swap(kvph, db_id,
+            (const void*)cas_key.data(), cas_key.size(), NULL, 0,
+            (const void*)v2.data(), v2.size(), &swapped);
+    if(ret != 0 || swapped) {
+        fprintf(stderr, "Error: sdskv_compare_and_swap() replaced an existing key (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* wrong expected value */
+    ret = sdskv_compare_and_swap(kvph, db_id,
+            (const void*)cas_key.data(), cas_key.size(),
+            (const void*)v2.data(), v2.size(),
+            (const void*)v2.data(), v2.size(), &swapped);
+    if(ret != 0 || swapped) {
+        fprintf(stderr, "Error: sdskv_compare_and_swap() ignored the expected value (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    /* right expected value */
+    ret = sdskv_compare_and_swap(kvph, db_id,
+            (const void*)cas_key.data(), cas_key.size(),
+            (const void*)v1.data(), v1.size(),
+            (const void*)v2.data(), v2.size(), &swapped);
+    if(ret != 0 || !swapped) {
+        fprintf(stderr, "Error: sdskv_compare_and_swap() did not swap the value (ret = %d)\n", ret);
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    std::vector<char> buffer(64);
+    vsize = buffer.size();
+    ret = sdskv_get(kvph, db_id,
+            (const void*)cas_key.data(), cas_key.size(), buffer.data(), &vsize);
+    if(ret != 0 || std::string(buffer.data(), vsize) != v2) {
+        fprintf(stderr, "Error: value after sdskv_compare_and_swap() is incorrect\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly tested sdskv_compare_and_swap\n");
+
+    /* **** append **** */
+    std::string log_key = "log";
+    std::string record = "record;";
+    std::string expected_log;
+    for(unsigned i=0; i < num_keys; i++) {
+        hg_size_t new_size = 0;
+        ret = sdskv_append(kvph, db_id,
+                (const void*)log_key.data(), log_key.size(),
+                (const void*)record.data(), record.size(), &new_size);
+        expected_log += record;
+        if(ret != 0 || new_size != expected_log.size()) {
+            fprintf(stderr, "Error: sdskv_append() failed (ret = %d, new size = %ld instead of %ld)\n",
+                    ret, new_size, expected_log.size());
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+    }
+    buffer.resize(expected_log.size());
+    vsize = buffer.size();
+    ret = sdskv_get(kvph, db_id,
+            (const void*)log_key.data(), log_key.size(), buffer.data(), &vsize);
+    if(ret != 0 || std::string(buffer.data(), vsize) != expected_log) {
+        fprintf(stderr, "Error: value after sdskv_append() is incorrect\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly appended %d records\n", num_keys);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
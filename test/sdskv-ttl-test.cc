@@ -0,0 +1,178 @@
+/*
+ * (C) 2015 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+
+#include "sdskv-client.h"
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_CLIENT_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database, which has a "ttl" option */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret != 0)
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+
+    /* **** put keys that do not expire and keys that expire soon **** */
+    hg_size_t live_bytes = 0;
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "live" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        live_bytes += v.size();
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+    }
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "ttl" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put_ttl(kvph, db_id, k.data(), k.size(), v.data(), v.size(), 200);
+        if(ret != 0)
+            fprintf(stderr, "Error: sdskv_put_ttl() failed for key %s\n", k.c_str());
+    }
+
+    /* **** the values are returned without their header **** */
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "ttl" + std::to_string(i);
+        std::string expected = "value" + std::to_string(i);
+        std::vector<char> v(expected.size() + 16);
+        hg_size_t vsize = v.size();
+        ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(ret != 0 || std::string(v.data(), vsize) != expected) {
+            fprintf(stderr, "Error: sdskv_get() of key %s returned a wrong value (ret = %d)\n",
+                    k.c_str(), ret);
+            ret = -1;
+        }
+    }
+
+    /* **** once expired, the keys are neither returned nor counted, even
+     * before being reclaimed **** */
+    if(ret == 0)
+        margo_thread_sleep(mid, 500);
+    for(unsigned i=0; ret == 0 && i < num_keys; i++) {
+        std::string k = "ttl" + std::to_string(i);
+        std::vector<char> v(64);
+        hg_size_t vsize = v.size();
+        ret = sdskv_get(kvph, db_id, k.data(), k.size(), v.data(), &vsize);
+        if(ret != SDSKV_ERR_UNKNOWN_KEY) {
+            fprintf(stderr, "Error: expired key %s was returned (ret = %d)\n",
+                    k.c_str(), ret);
+            ret = -1;
+        } else {
+            ret = 0;
+        }
+    }
+    if(ret == 0) {
+        hg_size_t n = 0, key_bytes = 0, value_bytes = 0;
+        ret = sdskv_count_prefixed(kvph, db_id, "ttl", 3, &n, &key_bytes, &value_bytes);
+        if(ret != 0 || n != 0 || value_bytes != 0) {
+            fprintf(stderr, "Error: sdskv_count_prefixed() counted %lu expired keys (ret = %d)\n",
+                    n, ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0) {
+        hg_size_t n = 0, key_bytes = 0, value_bytes = 0;
+        ret = sdskv_count_prefixed(kvph, db_id, "live", 4, &n, &key_bytes, &value_bytes);
+        if(ret != 0 || n != num_keys || value_bytes != live_bytes) {
+            fprintf(stderr, "Error: sdskv_count_prefixed() returned %lu keys and %lu value bytes"
+                    " instead of %u and %lu (ret = %d)\n", n, value_bytes, num_keys, live_bytes, ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0) {
+        hg_size_t n = 0;
+        ret = sdskv_count_range(kvph, db_id, NULL, 0, NULL, 0, &n, NULL, NULL);
+        if(ret != 0 || n != num_keys) {
+            fprintf(stderr, "Error: sdskv_count_range() returned %lu keys instead of %u (ret = %d)\n",
+                    n, num_keys, ret);
+            ret = -1;
+        }
+    }
+    if(ret == 0)
+        printf("Successfuly expired %d keys\n", num_keys);
+
+    /* shutdown the server */
+    sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return ret == 0 ? 0 : -1;
+}
@@ -0,0 +1,230 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <string.h>
+
+#include "sdskv-client.h"
+
+/* last change seen for each key */
+struct watch_state {
+    std::map<std::string, std::pair<int, std::string>> changes;
+    size_t num_events = 0;
+};
+
+static void watch_callback(void* uargs, size_t num_events,
+        const sdskv_watch_event_t* events, int flags);
+static bool check_changes(const watch_state& state, uint32_t num_keys);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id          = atoi(argv[2]);
+    db_name           = argv[3];
+    num_keys          = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** watch the keys starting with "key" **** */
+    watch_state state;
+    sdskv_watch_id_t watch_id;
+    ret = sdskv_watch_prefixed(kvph, db_id, "key", 3, 1, watch_callback, &state, &watch_id);
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_watch_prefixed() failed\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* **** put some keys, erase one in two **** */
+    for(unsigned i=0; i < num_keys; i++) {
+        std::string k = "key" + std::to_string(i);
+        std::string v = "value" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, k.data(), k.size(), v.data(), v.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", k.c_str());
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+        /* keys outside of the prefix are not reported */
+        std::string o = "other" + std::to_string(i);
+        ret = sdskv_put(kvph, db_id, o.data(), o.size(), v.data(), v.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put() failed for key %s\n", o.c_str());
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+    }
+    for(unsigned i=0; i < num_keys; i += 2) {
+        std::string k = "key" + std::to_string(i);
+        ret = sdskv_erase(kvph, db_id, k.data(), k.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_erase() failed for key %s\n", k.c_str());
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+    }
+
+    /* **** wait for the changes to be reported **** */
+    for(unsigned i=0; i < 100 && !check_changes(state, num_keys); i++)
+        margo_thread_sleep(mid, 100);
+    if(!check_changes(state, num_keys)) {
+        fprintf(stderr, "Error: changes not reported (%lu keys, %lu events)\n",
+                state.changes.size(), state.num_events);
+        ret = -1;
+    } else {
+        printf("Received %lu events for %lu keys\n",
+                state.num_events, state.changes.size());
+        ret = sdskv_unwatch(kvph, watch_id);
+        if(ret != 0) fprintf(stderr, "Error: sdskv_unwatch() failed\n");
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static void watch_callback(void* uargs, size_t num_events,
+        const sdskv_watch_event_t* events, int flags)
+{
+    auto state = static_cast<watch_state*>(uargs);
+    if(flags & SDSKV_WATCH_OVERFLOW)
+        fprintf(stderr, "Warning: changes were dropped\n");
+    for(size_t i=0; i < num_events; i++) {
+        std::string k((const char*)events[i].key, events[i].ksize);
+        std::string v;
+        if(events[i].value)
+            v.assign((const char*)events[i].value, events[i].vsize);
+        state->changes[k] = std::make_pair((int)events[i].type, v);
+    }
+    state->num_events += num_events;
+}
+
+static bool check_changes(const watch_state& state, uint32_t num_keys)
+{
+    if(state.changes.size() != num_keys) return false;
+    for(unsigned i=0; i < num_keys; i++) {
+        auto it = state.changes.find("key" + std::to_string(i));
+        if(it == state.changes.end()) return false;
+        if(i % 2 == 0) {
+            if(it->second.first != SDSKV_WATCH_ERASE) return false;
+        } else {
+            if(it->second.first != SDSKV_WATCH_PUT
+            || it->second.second != "value" + std::to_string(i))
+                return false;
+        }
+    }
+    return true;
+}